@@ -0,0 +1,108 @@
+#pragma once
+
+/* Linux-style circular doubly-linked list (include/linux/list.h semantics),
+ * subset used by zf_queue_compare_bench. Written from scratch, so it could be
+ * vendored here without GPL code.
+ */
+
+#include <stddef.h>
+
+struct list_head
+{
+	struct list_head *next, *prev;
+};
+
+#define LIST_HEAD_INIT(name) { &(name), &(name) }
+
+#define container_of(ptr, type, member) \
+	((type *)((char *)(ptr) - offsetof(type, member)))
+#define list_entry(ptr, type, member) container_of(ptr, type, member)
+#define list_first_entry(ptr, type, member) \
+	list_entry((ptr)->next, type, member)
+#define list_for_each_entry(pos, head, member) \
+	for (pos = list_entry((head)->next, __typeof__(*pos), member); \
+		 &pos->member != (head); \
+		 pos = list_entry(pos->member.next, __typeof__(*pos), member))
+
+static inline void INIT_LIST_HEAD(struct list_head *const list)
+{
+	list->next = list;
+	list->prev = list;
+}
+
+static inline int list_empty(const struct list_head *const head)
+{
+	return head->next == head;
+}
+
+static inline void __list_add(struct list_head *const entry,
+							  struct list_head *const prev,
+							  struct list_head *const next)
+{
+	next->prev = entry;
+	entry->next = next;
+	entry->prev = prev;
+	prev->next = entry;
+}
+
+static inline void list_add(struct list_head *const entry,
+							struct list_head *const head)
+{
+	__list_add(entry, head, head->next);
+}
+
+static inline void list_add_tail(struct list_head *const entry,
+								 struct list_head *const head)
+{
+	__list_add(entry, head->prev, head);
+}
+
+static inline void __list_del(struct list_head *const prev,
+							  struct list_head *const next)
+{
+	next->prev = prev;
+	prev->next = next;
+}
+
+static inline void list_del(struct list_head *const entry)
+{
+	__list_del(entry->prev, entry->next);
+	entry->next = NULL;
+	entry->prev = NULL;
+}
+
+static inline void list_move(struct list_head *const list,
+							 struct list_head *const head)
+{
+	__list_del(list->prev, list->next);
+	list_add(list, head);
+}
+
+/* move entries of list to the tail of head and reinitialize list */
+static inline void list_splice_tail_init(struct list_head *const list,
+										 struct list_head *const head)
+{
+	if (!list_empty(list))
+	{
+		struct list_head *const first = list->next;
+		struct list_head *const last = list->prev;
+		first->prev = head->prev;
+		head->prev->next = first;
+		last->next = head;
+		head->prev = last;
+		INIT_LIST_HEAD(list);
+	}
+}
+
+/* move range [first, last] to the tail of head */
+static inline void list_bulk_move_tail(struct list_head *const head,
+									   struct list_head *const first,
+									   struct list_head *const last)
+{
+	first->prev->next = last->next;
+	last->next->prev = first->prev;
+	head->prev->next = first;
+	first->prev = head->prev;
+	last->next = head;
+	head->prev = last;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+namespace zf_bench
+{
+	/* prevents compiler from optimizing away computation of v */
+	template <typename T>
+	inline void keep(const T &v)
+	{
+#if defined(__GNUC__)
+		asm volatile("" : : "g"(&v) : "memory");
+#else
+		static volatile const void *sink;
+		sink = &v;
+#endif
+	}
+
+	/* xorshift64*, good enough to shuffle inputs reproducibly */
+	struct rng
+	{
+		uint64_t s;
+		explicit rng(const uint64_t seed = 0x2545f4914f6cdd1dULL): s(seed) {}
+		uint64_t operator()()
+		{
+			s ^= s >> 12;
+			s ^= s << 25;
+			s ^= s >> 27;
+			return s * 0x2545f4914f6cdd1dULL;
+		}
+	};
+
+	template <typename T>
+	void shuffle(std::vector<T> &v, rng &r)
+	{
+		for (size_t i = v.size(); 1 < i; --i)
+		{
+			std::swap(v[i - 1], v[r() % i]);
+		}
+	}
+
+	/* number of items from argv[1] or default */
+	inline size_t count_arg(const int argc, char *argv[], const size_t def)
+	{
+		return 1 < argc? (size_t)std::strtoull(argv[1], 0, 0): def;
+	}
+
+	/* Runs setup() and then run() repeats times, returns the best time of
+	 * run() in nanoseconds per item. Setup time is not measured.
+	 */
+	template <typename S, typename R>
+	double measure(S setup, R run, const size_t items, const unsigned repeats)
+	{
+		typedef std::chrono::steady_clock clock;
+		double best = 0;
+		for (unsigned i = 0; repeats > i; ++i)
+		{
+			setup();
+			const clock::time_point t0 = clock::now();
+			run();
+			const clock::time_point t1 = clock::now();
+			const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+			if (0 == i || best > ns)
+			{
+				best = ns;
+			}
+		}
+		return 0 == items? best: best / items;
+	}
+
+	inline void report(const char *const name, const size_t items,
+					   const double ns_per_item)
+	{
+		std::printf("%-40s %10zu items %10.2f ns/item\n",
+					name, items, ns_per_item);
+	}
+}
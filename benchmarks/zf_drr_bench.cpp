@@ -0,0 +1,102 @@
+/* Measures deficit round-robin scheduler with many active flows: enqueue of
+ * entries to random flows, dequeue of all of them and steady state where each
+ * dequeued entry is enqueued back to a random flow (so flows keep going idle
+ * and active again). Entry costs are random packet sizes, quantum is the
+ * largest size, every fourth flow has weight 2.
+ * Usage: zf_drr_bench [flows]
+ */
+#include <zf_drr.h>
+#include <zf_bench.hpp>
+
+namespace
+{
+	const unsigned c_repeats = 3;
+	const unsigned c_entries_per_flow = 8;
+	const uint32_t c_quantum = 1500;
+
+	struct entry
+	{
+		zf_drr_node node;
+		uint32_t cost;
+		uint32_t flow;
+	};
+
+	struct flow
+	{
+		zf_drr_flow drr;
+		uint64_t served;
+	};
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t flows = zf_bench::count_arg(argc, argv, 100000);
+	const size_t count = flows * c_entries_per_flow;
+	zf_bench::rng r;
+	std::vector<flow> f(flows);
+	std::vector<entry> entries(count);
+	for (size_t i = 0; count > i; ++i)
+	{
+		entries[i].cost = 64 + (uint32_t)(r() % (c_quantum - 63));
+		entries[i].flow = (uint32_t)(r() % flows);
+	}
+	zf_drr d;
+	zf_drr_init(&d, c_quantum);
+	const auto reset = [&]()
+	{
+		zf_drr_init(&d, c_quantum);
+		for (size_t i = 0; flows > i; ++i)
+		{
+			zf_drr_flow_init(&d, &f[i].drr, 0 == i % 4? 2: 1);
+			f[i].served = 0;
+		}
+	};
+	const auto fill = [&]()
+	{
+		for (entry &e: entries)
+		{
+			zf_drr_enqueue_<entry, &entry::node>(&d, &f[e.flow].drr, &e, e.cost);
+		}
+	};
+	const auto drain = [&]()
+	{
+		zf_drr_flow *p;
+		while (entry *const e = zf_drr_dequeue_<entry, &entry::node>(&d, &p))
+		{
+			zf_entry(p, flow, drr)->served += e->cost;
+		}
+	};
+
+	double ns = zf_bench::measure(reset, fill, count, c_repeats);
+	zf_bench::report("drr enqueue", count, ns);
+	std::printf("%-40s %10zu active flows\n", "", zf_drr_flows(&d));
+
+	ns = zf_bench::measure([&]() { reset(); fill(); }, [&]()
+	{
+		drain();
+		zf_bench::keep(f[0].served);
+	}, count, c_repeats);
+	zf_bench::report("drr dequeue", count, ns);
+
+	/* each dequeued entry goes back to another random flow */
+	std::vector<uint32_t> next(count);
+	for (size_t i = 0; count > i; ++i)
+	{
+		next[i] = (uint32_t)(r() % flows);
+	}
+	ns = zf_bench::measure([&]() { reset(); fill(); }, [&]()
+	{
+		zf_drr_flow *p;
+		for (size_t i = 0; count > i; ++i)
+		{
+			entry *const e = zf_drr_dequeue_<entry, &entry::node>(&d, &p);
+			zf_entry(p, flow, drr)->served += e->cost;
+			e->flow = next[i];
+			zf_drr_enqueue_<entry, &entry::node>(&d, &f[e->flow].drr, e, e->cost);
+		}
+		zf_bench::keep(f[0].served);
+	}, count, c_repeats);
+	zf_bench::report("drr dequeue + enqueue", count, ns);
+	std::printf("%-40s %10zu active flows\n", "", zf_drr_flows(&d));
+	return 0;
+}
@@ -0,0 +1,232 @@
+/* Compares intrusive d-ary heap (zf_heap.h) with std::priority_queue of entry
+ * pointers: push of entries with random keys, pop of all of them and mixed
+ * pop + push (timer wheel like). For zf_heap also measures reschedule (key
+ * update of random entries) and cancel, which std::priority_queue can't do.
+ * Usage: zf_heap_bench [entries]
+ */
+#include <zf_heap.h>
+#include <zf_bench.hpp>
+#include <queue>
+#include <string>
+
+namespace
+{
+	const unsigned c_repeats = 3;
+
+	struct entry
+	{
+		zf_heap_node node;
+		uint64_t key;
+	};
+
+	struct less
+	{
+		bool operator()(const entry *a, const entry *b) const
+		{
+			return a->key < b->key;
+		}
+	};
+
+	/* std::priority_queue is max-heap */
+	struct greater
+	{
+		bool operator()(const entry *a, const entry *b) const
+		{
+			return a->key > b->key;
+		}
+	};
+
+	int cmp(zf_heap_node *const a, zf_heap_node *const b, void *)
+	{
+		const uint64_t ka = zf_entry(a, entry, node)->key;
+		const uint64_t kb = zf_entry(b, entry, node)->key;
+		return ka < kb? -1: ka > kb? 1: 0;
+	}
+
+	struct input
+	{
+		std::vector<entry> entries;
+		std::vector<uint64_t> keys;
+		std::vector<uint64_t> next;
+		std::vector<entry *> random;
+	};
+
+	void report(const std::string &name, const char *const op,
+				const size_t count, const double ns)
+	{
+		zf_bench::report((name + " " + op).c_str(), count, ns);
+	}
+
+	template <unsigned arity>
+	void bench_zf(input &in, const char *const name)
+	{
+		typedef zf_heap_<entry, &entry::node, less, arity> heap;
+		const size_t count = in.entries.size();
+		std::vector<zf_heap_node *> nodes(count);
+		heap h(nodes.data(), count);
+		const auto reset = [&]()
+		{
+			h.count = 0;
+			for (size_t i = 0; count > i; ++i)
+			{
+				in.entries[i].key = in.keys[i];
+			}
+		};
+		const auto fill = [&]()
+		{
+			reset();
+			for (entry &e: in.entries)
+			{
+				zf_heap_insert_(&h, &e);
+			}
+		};
+		double ns = zf_bench::measure(reset, fill, count, c_repeats);
+		report(name, "push", count, ns);
+		ns = zf_bench::measure(fill, [&]()
+		{
+			while (entry *const e = zf_heap_pop_(&h))
+			{
+				zf_bench::keep(e);
+			}
+		}, count, c_repeats);
+		report(name, "pop", count, ns);
+		ns = zf_bench::measure(fill, [&]()
+		{
+			for (size_t i = 0; count > i; ++i)
+			{
+				entry *const e = zf_heap_pop_(&h);
+				e->key += in.next[i];
+				zf_heap_insert_(&h, e);
+			}
+		}, count, c_repeats);
+		report(name, "pop + push", count, ns);
+		ns = zf_bench::measure(fill, [&]()
+		{
+			for (size_t i = 0; count > i; ++i)
+			{
+				entry *const e = in.random[i];
+				e->key = in.next[i];
+				zf_heap_update_(&h, e);
+			}
+		}, count, c_repeats);
+		report(name, "reschedule", count, ns);
+		ns = zf_bench::measure(fill, [&]()
+		{
+			for (entry *const e: in.random)
+			{
+				zf_heap_remove_(&h, e);
+			}
+		}, count, c_repeats);
+		report(name, "cancel", count, ns);
+	}
+
+	void bench_zf_c(input &in)
+	{
+		const size_t count = in.entries.size();
+		std::vector<zf_heap_node *> nodes(count);
+		zf_heap h;
+		zf_heap_init(&h, nodes.data(), count, cmp, 0);
+		const auto reset = [&]()
+		{
+			h.count = 0;
+			for (size_t i = 0; count > i; ++i)
+			{
+				in.entries[i].key = in.keys[i];
+			}
+		};
+		const auto fill = [&]()
+		{
+			reset();
+			for (entry &e: in.entries)
+			{
+				zf_heap_insert(&h, &e.node);
+			}
+		};
+		double ns = zf_bench::measure(reset, fill, count, c_repeats);
+		report("zf_heap C 4-ary", "push", count, ns);
+		ns = zf_bench::measure(fill, [&]()
+		{
+			while (zf_heap_node *const n = zf_heap_pop(&h))
+			{
+				zf_bench::keep(n);
+			}
+		}, count, c_repeats);
+		report("zf_heap C 4-ary", "pop", count, ns);
+	}
+
+	/* storage is reserved like for zf_heap, so allocation is not measured */
+	struct std_heap: std::priority_queue<entry *, std::vector<entry *>, greater>
+	{
+		void reserve(const size_t n) { c.reserve(n); }
+		void clear() { c.clear(); }
+	};
+
+	void bench_std(input &in)
+	{
+		const size_t count = in.entries.size();
+		std_heap h;
+		h.reserve(count);
+		const auto reset = [&]()
+		{
+			h.clear();
+			for (size_t i = 0; count > i; ++i)
+			{
+				in.entries[i].key = in.keys[i];
+			}
+		};
+		const auto fill = [&]()
+		{
+			reset();
+			for (entry &e: in.entries)
+			{
+				h.push(&e);
+			}
+		};
+		double ns = zf_bench::measure(reset, fill, count, c_repeats);
+		report("std::priority_queue", "push", count, ns);
+		ns = zf_bench::measure(fill, [&]()
+		{
+			while (!h.empty())
+			{
+				zf_bench::keep(h.top());
+				h.pop();
+			}
+		}, count, c_repeats);
+		report("std::priority_queue", "pop", count, ns);
+		ns = zf_bench::measure(fill, [&]()
+		{
+			for (size_t i = 0; count > i; ++i)
+			{
+				entry *const e = h.top();
+				h.pop();
+				e->key += in.next[i];
+				h.push(e);
+			}
+		}, count, c_repeats);
+		report("std::priority_queue", "pop + push", count, ns);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count = zf_bench::count_arg(argc, argv, 1 << 20);
+	zf_bench::rng r;
+	input in;
+	in.entries.resize(count);
+	in.keys.resize(count);
+	in.next.resize(count);
+	in.random.resize(count);
+	for (size_t i = 0; count > i; ++i)
+	{
+		in.keys[i] = r() >> 16;
+		in.next[i] = r() >> 24;
+		in.random[i] = &in.entries[i];
+	}
+	zf_bench::shuffle(in.random, r);
+	bench_std(in);
+	bench_zf<2>(in, "zf_heap 2-ary");
+	bench_zf<4>(in, "zf_heap 4-ary");
+	bench_zf<8>(in, "zf_heap 8-ary");
+	bench_zf_c(in);
+	return 0;
+}
@@ -0,0 +1,62 @@
+/* Measures lock/unlock of a contended mutex: zf_mutex_ (parking lot based)
+ * against std::mutex, for 1 to 2 * hardware_concurrency threads.
+ * Usage: zf_parking_lot_bench [operations per thread]
+ */
+#include <zf_parking_lot.h>
+#include <zf_bench.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const unsigned c_repeats = 3;
+
+	void nop() {}
+
+	template <typename M>
+	void bench_mutex(const char *const name, const unsigned threads,
+					 const size_t count)
+	{
+		M m;
+		uint64_t value = 0;
+		const double ns = zf_bench::measure(nop, [&]() {
+			std::vector<std::thread> workers;
+			for (unsigned t = 0; threads > t; ++t)
+			{
+				workers.emplace_back([&]() {
+					for (size_t i = 0; count > i; ++i)
+					{
+						std::lock_guard<M> l(m);
+						++value;
+					}
+				});
+			}
+			for (std::thread &w: workers)
+			{
+				w.join();
+			}
+		}, threads * count, c_repeats);
+		zf_bench::keep(value);
+		const std::string label = std::string(name) + " x" +
+				std::to_string(threads) + " threads";
+		zf_bench::report(label.c_str(), threads * count, ns);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count = zf_bench::count_arg(argc, argv, 1 << 18);
+	unsigned max_threads = 2 * std::thread::hardware_concurrency();
+	if (2 > max_threads)
+	{
+		max_threads = 2;
+	}
+	for (unsigned threads = 1; max_threads >= threads; threads *= 2)
+	{
+		bench_mutex<zf_mutex_>("zf_mutex_", threads, count);
+		bench_mutex<std::mutex>("std::mutex", threads, count);
+	}
+	return 0;
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+/* Hardware performance counters for benchmarks. On Linux counters are opened
+ * with perf_event_open() for the calling thread (user space only, so it works
+ * with perf_event_paranoid up to 2), no external tools are needed. Events that
+ * can't be opened (no PMU in VM, unsupported event, permissions, other OS) are
+ * reported as unavailable and measurement falls back to timing only.
+ *
+ * Usage is the same as zf_bench::measure():
+ *
+ *   zf_perf::counters c;
+ *   const zf_perf::result r = c.measure(setup, run, items, repeats);
+ *   zf_perf::report("name", items, r);
+ *
+ * Each value (and time) is the best of repeats, divided by items.
+ */
+
+#include <zf_bench.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#if defined(__linux__)
+	#include <linux/perf_event.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+namespace zf_perf
+{
+	enum event
+	{
+		cycles,
+		instructions,
+		l1d_misses,
+		llc_misses,
+		dtlb_misses,
+		branch_misses,
+		c_events
+	};
+
+	inline const char *event_name(const unsigned e)
+	{
+		static const char *const names[c_events] =
+		{
+			"cycles", "instructions", "L1d-misses", "LLC-misses",
+			"dTLB-misses", "branch-misses",
+		};
+		return names[e];
+	}
+
+	struct result
+	{
+		double ns;
+		double value[c_events];
+		bool available[c_events];
+	};
+
+	class counters
+	{
+	public:
+		counters()
+		{
+			for (unsigned i = 0; c_events > i; ++i)
+			{
+				fd[i] = open_event((event)i);
+			}
+		}
+		~counters()
+		{
+#if defined(__linux__)
+			for (unsigned i = 0; c_events > i; ++i)
+			{
+				if (0 <= fd[i])
+				{
+					close(fd[i]);
+				}
+			}
+#endif
+		}
+		counters(const counters &) = delete;
+		counters &operator=(const counters &) = delete;
+
+		bool available(const event e) const
+		{
+			return 0 <= fd[e];
+		}
+		/* true when at least one counter is available */
+		bool any() const
+		{
+			for (unsigned i = 0; c_events > i; ++i)
+			{
+				if (0 <= fd[i])
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/* Runs setup() and then run() repeats times, only run() is measured */
+		template <typename S, typename R>
+		result measure(S setup, R run, const size_t items,
+					   const unsigned repeats)
+		{
+			typedef std::chrono::steady_clock clock;
+			result r;
+			std::memset(&r, 0, sizeof(r));
+			for (unsigned i = 0; c_events > i; ++i)
+			{
+				r.available[i] = 0 <= fd[i];
+			}
+			for (unsigned k = 0; repeats > k; ++k)
+			{
+				setup();
+				sample before[c_events], after[c_events];
+				read_all(before);
+				const clock::time_point t0 = clock::now();
+				run();
+				const clock::time_point t1 = clock::now();
+				read_all(after);
+				const double ns =
+						std::chrono::duration<double, std::nano>(t1 - t0).count();
+				if (0 == k || r.ns > ns)
+				{
+					r.ns = ns;
+				}
+				for (unsigned i = 0; c_events > i; ++i)
+				{
+					const double v = after[i].scaled(before[i]);
+					if (0 == k || r.value[i] > v)
+					{
+						r.value[i] = v;
+					}
+				}
+			}
+			if (0 != items)
+			{
+				r.ns /= items;
+				for (unsigned i = 0; c_events > i; ++i)
+				{
+					r.value[i] /= items;
+				}
+			}
+			return r;
+		}
+	private:
+		/* layout of read() with TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING */
+		struct sample
+		{
+			uint64_t value;
+			uint64_t enabled;
+			uint64_t running;
+
+			/* delta since s, extrapolated to the time event was enabled */
+			double scaled(const sample &s) const
+			{
+				const uint64_t running_delta = running - s.running;
+				if (0 == running_delta)
+				{
+					return 0;
+				}
+				return (double)(value - s.value) *
+						(double)(enabled - s.enabled) / (double)running_delta;
+			}
+		};
+
+#if defined(__linux__)
+		static int open_event(const event e)
+		{
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			/* to scale counts when events are multiplexed */
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+					PERF_FORMAT_TOTAL_TIME_RUNNING;
+			switch (e)
+			{
+			case cycles:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CPU_CYCLES;
+				break;
+			case instructions:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+				break;
+			case l1d_misses:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_L1D |
+						(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+						(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case llc_misses:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CACHE_MISSES;
+				break;
+			case dtlb_misses:
+				attr.type = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_DTLB |
+						(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+						(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case branch_misses:
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+				break;
+			default:
+				return -1;
+			}
+			/* counters run all the time, deltas are taken around run() */
+			return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		}
+		void read_all(sample (&v)[c_events]) const
+		{
+			for (unsigned i = 0; c_events > i; ++i)
+			{
+				if (0 > fd[i] ||
+					sizeof(v[i]) != (size_t)read(fd[i], &v[i], sizeof(v[i])))
+				{
+					std::memset(&v[i], 0, sizeof(v[i]));
+				}
+			}
+		}
+#else
+		static int open_event(const event)
+		{
+			return -1;
+		}
+		void read_all(sample (&v)[c_events]) const
+		{
+			std::memset(v, 0, sizeof(v));
+		}
+#endif
+
+		int fd[c_events];
+	};
+
+	/* prints time and available counters per item on one line */
+	inline void report(const char *const name, const size_t items,
+					   const result &r)
+	{
+		std::printf("%-40s %10zu items %10.2f ns", name, items, r.ns);
+		for (unsigned i = 0; c_events > i; ++i)
+		{
+			if (r.available[i])
+			{
+				std::printf(" %8.2f %s", r.value[i], event_name(i));
+			}
+		}
+		std::printf("\n");
+	}
+}
@@ -0,0 +1,639 @@
+/* Compares zf_queue lists with std::list, std::forward_list, BSD sys/queue.h
+ * macros (bsd_queue.h) and Linux-style list.h (linux_list.h). For each list
+ * size (from L1-resident to DRAM-resident) and cache state measures:
+ *  - insert: insert all entries (at the tail when supported, else at the head);
+ *  - remove: remove all entries, in random order for doubly-linked lists and
+ *    from the head for singly-linked ones;
+ *  - iterate: sum values of all entries;
+ *  - move: move entries one by one to the head of another list;
+ *  - splice: move range of all entries but the first to another list in one
+ *    call (only for lists that provide range splice);
+ *  - concat: append list with half of entries to the list with another half
+ *    (only for lists that provide concatenation);
+ *  - sort: sort by value (only for lists that provide sorting).
+ * Splice and concat are O(1) for most lists, so their time per item shrinks
+ * with list size, while O(n) implementations stay flat.
+ * All intrusive lists link the same entries (each entry has a node of every
+ * kind), std containers hold pointers to them, so all variants touch the same
+ * payload. Entries are linked in random order. Cold cache runs evict caches
+ * before each measurement. Results are printed as JSON array, one object per
+ * line, suitable for diffing between runs.
+ * Usage: zf_queue_compare_bench [max entries] [repeats]
+ */
+#include <zf_queue.h>
+#include <zf_bench.hpp>
+#include "bsd_queue.h"
+#include "linux_list.h"
+#include <forward_list>
+#include <list>
+
+namespace
+{
+	struct entry
+	{
+		uint64_t value;
+		zf_slist_node zs;
+		zf_list_node zl;
+		zf_stailq_node zst;
+		zf_tailq_node zt;
+		SLIST_ENTRY(entry) bs;
+		LIST_ENTRY(entry) bl;
+		STAILQ_ENTRY(entry) bst;
+		TAILQ_ENTRY(entry) bt;
+		struct list_head lx;
+		std::list<entry *>::iterator it;
+	};
+
+	typedef std::vector<entry *> entries;
+
+	uint64_t entry_key(entry *const e)
+	{
+		return e->value;
+	}
+
+	struct zf_slist_bench
+	{
+		static const bool sorts = false;
+		static const bool splices = false;
+		static const bool concats = false;
+		zf_slist_head_<entry, &entry::zs> h;
+		void init() { zf_slist_init(&h); }
+		void insert(entry *const e) { zf_slist_insert_head(&h, &e->zs); }
+		void remove(entry *) { zf_slist_remove_head(&h); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			for (entry &e: h)
+			{
+				s += e.value;
+			}
+			return s;
+		}
+		void move(zf_slist_bench &d)
+		{
+			while (!zf_slist_empty(&h))
+			{
+				zf_slist_node *const n = zf_slist_first(&h);
+				zf_slist_remove_head(&h);
+				zf_slist_insert_head(&d.h, n);
+			}
+		}
+		entry *last() { return 0; }
+		void splice(zf_slist_bench &, entry *) {}
+		void concat(zf_slist_bench &) {}
+		void sort() {}
+	};
+
+	struct zf_list_bench
+	{
+		static const bool sorts = false;
+		static const bool splices = true;
+		static const bool concats = true;
+		zf_list_head_<entry, &entry::zl> h;
+		void init() { zf_list_init(&h); }
+		void insert(entry *const e) { zf_list_insert_head(&h, &e->zl); }
+		void remove(entry *const e) { zf_list_remove(&e->zl); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			for (entry &e: h)
+			{
+				s += e.value;
+			}
+			return s;
+		}
+		void move(zf_list_bench &d)
+		{
+			while (!zf_list_empty(&h))
+			{
+				zf_list_node *const n = zf_list_first(&h);
+				zf_list_remove(n);
+				zf_list_insert_head(&d.h, n);
+			}
+		}
+		entry *last()
+		{
+			zf_list_node *n = zf_list_first(&h);
+			while (0 != n->next)
+			{
+				n = n->next;
+			}
+			return zf_entry_(n, &entry::zl);
+		}
+		void splice(zf_list_bench &d, entry *const l)
+		{
+			zf_list_splice_head(&d.h, zf_list_first(&h)->next, &l->zl);
+		}
+		void concat(zf_list_bench &d) { zf_list_concat(&h, &d.h); }
+		void sort() {}
+	};
+
+	struct zf_stailq_bench
+	{
+		static const bool sorts = true;
+		static const bool splices = true;
+		static const bool concats = true;
+		zf_stailq_head_<entry, &entry::zst> h;
+		void init() { zf_stailq_init(&h); }
+		void insert(entry *const e) { zf_stailq_insert_tail(&h, &e->zst); }
+		void remove(entry *) { zf_stailq_remove_head(&h); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			for (entry &e: h)
+			{
+				s += e.value;
+			}
+			return s;
+		}
+		void move(zf_stailq_bench &d)
+		{
+			while (!zf_stailq_empty(&h))
+			{
+				zf_stailq_node *const n = zf_stailq_first(&h);
+				zf_stailq_remove_head(&h);
+				zf_stailq_insert_head(&d.h, n);
+			}
+		}
+		entry *last() { return 0; }
+		void splice(zf_stailq_bench &d, entry *)
+		{
+			zf_stailq_splice_head(&d.h, &h, zf_stailq_first(&h), h.last);
+		}
+		void concat(zf_stailq_bench &d) { zf_stailq_concat(&h, &d.h); }
+		void sort() { zf_stailq_radix_sort_(&h, entry_key); }
+	};
+
+	struct zf_tailq_bench
+	{
+		static const bool sorts = true;
+		static const bool splices = true;
+		static const bool concats = true;
+		zf_tailq_head_<entry, &entry::zt> h;
+		void init() { zf_tailq_init(&h); }
+		void insert(entry *const e) { zf_tailq_insert_tail(&h, &e->zt); }
+		void remove(entry *const e) { zf_tailq_remove(&h, &e->zt); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			for (entry &e: h)
+			{
+				s += e.value;
+			}
+			return s;
+		}
+		void move(zf_tailq_bench &d)
+		{
+			while (!zf_tailq_empty(&h))
+			{
+				zf_tailq_node *const n = zf_tailq_first(&h);
+				zf_tailq_remove(&h, n);
+				zf_tailq_insert_head(&d.h, n);
+			}
+		}
+		entry *last() { return 0; }
+		void splice(zf_tailq_bench &d, entry *)
+		{
+			zf_tailq_splice_head(&d.h, &h, zf_tailq_first(&h)->next,
+								 zf_tailq_last(&h));
+		}
+		void concat(zf_tailq_bench &d) { zf_tailq_concat(&h, &d.h); }
+		void sort() { zf_tailq_radix_sort_(&h, entry_key); }
+	};
+
+	struct std_list_bench
+	{
+		static const bool sorts = true;
+		static const bool splices = true;
+		static const bool concats = true;
+		std::list<entry *> l;
+		void init() { l.clear(); }
+		void insert(entry *const e) { e->it = l.insert(l.end(), e); }
+		void remove(entry *const e) { l.erase(e->it); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			for (entry *const e: l)
+			{
+				s += e->value;
+			}
+			return s;
+		}
+		void move(std_list_bench &d)
+		{
+			while (!l.empty())
+			{
+				d.l.splice(d.l.begin(), l, l.begin());
+			}
+		}
+		entry *last() { return 0; }
+		/* O(n): range splice between lists counts moved entries */
+		void splice(std_list_bench &d, entry *)
+		{
+			d.l.splice(d.l.begin(), l, std::next(l.begin()), l.end());
+		}
+		void concat(std_list_bench &d) { l.splice(l.end(), d.l); }
+		void sort()
+		{
+			l.sort([](const entry *const a, const entry *const b)
+			{
+				return a->value < b->value;
+			});
+		}
+	};
+
+	struct std_forward_list_bench
+	{
+		static const bool sorts = true;
+		static const bool splices = true;
+		static const bool concats = true;
+		std::forward_list<entry *> l;
+		void init() { l.clear(); }
+		void insert(entry *const e) { l.push_front(e); }
+		void remove(entry *) { l.pop_front(); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			for (entry *const e: l)
+			{
+				s += e->value;
+			}
+			return s;
+		}
+		void move(std_forward_list_bench &d)
+		{
+			while (!l.empty())
+			{
+				d.l.splice_after(d.l.before_begin(), l, l.before_begin());
+			}
+		}
+		entry *last() { return 0; }
+		/* O(n): splice_after() looks for the node before end */
+		void splice(std_forward_list_bench &d, entry *)
+		{
+			d.l.splice_after(d.l.before_begin(), l, l.begin(), l.end());
+		}
+		/* O(n): no pointer to the last node */
+		void concat(std_forward_list_bench &d)
+		{
+			auto p = l.before_begin();
+			for (auto i = l.begin(); l.end() != i; ++i)
+			{
+				p = i;
+			}
+			l.splice_after(p, d.l);
+		}
+		void sort()
+		{
+			l.sort([](const entry *const a, const entry *const b)
+			{
+				return a->value < b->value;
+			});
+		}
+	};
+
+	struct bsd_slist_bench
+	{
+		static const bool sorts = false;
+		static const bool splices = false;
+		static const bool concats = false;
+		SLIST_HEAD(head, entry) h;
+		void init() { SLIST_INIT(&h); }
+		void insert(entry *const e) { SLIST_INSERT_HEAD(&h, e, bs); }
+		void remove(entry *) { SLIST_REMOVE_HEAD(&h, bs); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			entry *e;
+			SLIST_FOREACH(e, &h, bs)
+			{
+				s += e->value;
+			}
+			return s;
+		}
+		void move(bsd_slist_bench &d)
+		{
+			while (!SLIST_EMPTY(&h))
+			{
+				entry *const e = SLIST_FIRST(&h);
+				SLIST_REMOVE_HEAD(&h, bs);
+				SLIST_INSERT_HEAD(&d.h, e, bs);
+			}
+		}
+		entry *last() { return 0; }
+		void splice(bsd_slist_bench &, entry *) {}
+		void concat(bsd_slist_bench &) {}
+		void sort() {}
+	};
+
+	struct bsd_list_bench
+	{
+		static const bool sorts = false;
+		static const bool splices = false;
+		static const bool concats = false;
+		LIST_HEAD(head, entry) h;
+		void init() { LIST_INIT(&h); }
+		void insert(entry *const e) { LIST_INSERT_HEAD(&h, e, bl); }
+		void remove(entry *const e) { LIST_REMOVE(e, bl); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			entry *e;
+			LIST_FOREACH(e, &h, bl)
+			{
+				s += e->value;
+			}
+			return s;
+		}
+		void move(bsd_list_bench &d)
+		{
+			while (!LIST_EMPTY(&h))
+			{
+				entry *const e = LIST_FIRST(&h);
+				LIST_REMOVE(e, bl);
+				LIST_INSERT_HEAD(&d.h, e, bl);
+			}
+		}
+		entry *last() { return 0; }
+		void splice(bsd_list_bench &, entry *) {}
+		void concat(bsd_list_bench &) {}
+		void sort() {}
+	};
+
+	struct bsd_stailq_bench
+	{
+		static const bool sorts = false;
+		static const bool splices = false;
+		static const bool concats = true;
+		STAILQ_HEAD(head, entry) h;
+		void init() { STAILQ_INIT(&h); }
+		void insert(entry *const e) { STAILQ_INSERT_TAIL(&h, e, bst); }
+		void remove(entry *) { STAILQ_REMOVE_HEAD(&h, bst); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			entry *e;
+			STAILQ_FOREACH(e, &h, bst)
+			{
+				s += e->value;
+			}
+			return s;
+		}
+		void move(bsd_stailq_bench &d)
+		{
+			while (!STAILQ_EMPTY(&h))
+			{
+				entry *const e = STAILQ_FIRST(&h);
+				STAILQ_REMOVE_HEAD(&h, bst);
+				STAILQ_INSERT_HEAD(&d.h, e, bst);
+			}
+		}
+		entry *last() { return 0; }
+		void splice(bsd_stailq_bench &, entry *) {}
+		void concat(bsd_stailq_bench &d) { STAILQ_CONCAT(&h, &d.h); }
+		void sort() {}
+	};
+
+	struct bsd_tailq_bench
+	{
+		static const bool sorts = false;
+		static const bool splices = false;
+		static const bool concats = true;
+		TAILQ_HEAD(head, entry) h;
+		void init() { TAILQ_INIT(&h); }
+		void insert(entry *const e) { TAILQ_INSERT_TAIL(&h, e, bt); }
+		void remove(entry *const e) { TAILQ_REMOVE(&h, e, bt); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			entry *e;
+			TAILQ_FOREACH(e, &h, bt)
+			{
+				s += e->value;
+			}
+			return s;
+		}
+		void move(bsd_tailq_bench &d)
+		{
+			while (!TAILQ_EMPTY(&h))
+			{
+				entry *const e = TAILQ_FIRST(&h);
+				TAILQ_REMOVE(&h, e, bt);
+				TAILQ_INSERT_HEAD(&d.h, e, bt);
+			}
+		}
+		entry *last() { return 0; }
+		void splice(bsd_tailq_bench &, entry *) {}
+		void concat(bsd_tailq_bench &d) { TAILQ_CONCAT(&h, &d.h, bt); }
+		void sort() {}
+	};
+
+	struct linux_list_bench
+	{
+		static const bool sorts = false;
+		static const bool splices = true;
+		static const bool concats = true;
+		struct list_head h;
+		void init() { INIT_LIST_HEAD(&h); }
+		void insert(entry *const e) { list_add_tail(&e->lx, &h); }
+		void remove(entry *const e) { list_del(&e->lx); }
+		uint64_t sum()
+		{
+			uint64_t s = 0;
+			entry *e;
+			list_for_each_entry(e, &h, lx)
+			{
+				s += e->value;
+			}
+			return s;
+		}
+		void move(linux_list_bench &d)
+		{
+			while (!list_empty(&h))
+			{
+				list_move(h.next, &d.h);
+			}
+		}
+		entry *last() { return 0; }
+		void splice(linux_list_bench &d, entry *)
+		{
+			list_bulk_move_tail(&d.h, h.next->next, h.prev);
+		}
+		void concat(linux_list_bench &d) { list_splice_tail_init(&d.h, &h); }
+		void sort() {}
+	};
+
+	/* evicts data caches by writing buffer larger than the last level cache */
+	void evict_caches()
+	{
+		static std::vector<char> buffer(64 << 20);
+		for (size_t i = 0; buffer.size() > i; i += 64)
+		{
+			++buffer[i];
+		}
+		zf_bench::keep(buffer[0]);
+	}
+
+	class json_output
+	{
+	public:
+		json_output(): count(0) { std::printf("["); }
+		~json_output() { std::printf("\n]\n"); }
+		void add(const char *const container, const char *const op,
+				 const size_t size, const bool cold, const double ns)
+		{
+			std::printf("%s\n  {\"container\": \"%s\", \"op\": \"%s\", "
+						"\"size\": %zu, \"cache\": \"%s\", \"ns_per_item\": %.3f}",
+						0 == count++? "": ",", container, op, size,
+						cold? "cold": "hot", ns);
+			std::fflush(stdout);
+		}
+	private:
+		unsigned count;
+	};
+
+	struct options
+	{
+		unsigned repeats;
+		bool cold;
+		json_output *out;
+	};
+
+	template <typename C>
+	void bench(const char *const name, const entries &order,
+			   const entries &removal, const options &o)
+	{
+		const size_t n = order.size();
+		C a, b;
+		const auto fill = [&]()
+		{
+			a.init();
+			for (entry *const e: order)
+			{
+				a.insert(e);
+			}
+		};
+		const auto evict = [&]()
+		{
+			if (o.cold)
+			{
+				evict_caches();
+			}
+		};
+		const size_t half = n / 2;
+		const auto fill_halves = [&]()
+		{
+			a.init();
+			b.init();
+			for (size_t i = 0; n > i; ++i)
+			{
+				(half > i? a: b).insert(order[i]);
+			}
+		};
+		double ns = zf_bench::measure([&]() { a.init(); evict(); }, [&]()
+		{
+			for (entry *const e: order)
+			{
+				a.insert(e);
+			}
+		}, n, o.repeats);
+		o.out->add(name, "insert", n, o.cold, ns);
+		ns = zf_bench::measure([&]() { fill(); evict(); }, [&]()
+		{
+			for (entry *const e: removal)
+			{
+				a.remove(e);
+			}
+		}, n, o.repeats);
+		o.out->add(name, "remove", n, o.cold, ns);
+		fill();
+		ns = zf_bench::measure(evict, [&]()
+		{
+			const uint64_t s = a.sum();
+			zf_bench::keep(s);
+		}, n, o.repeats);
+		o.out->add(name, "iterate", n, o.cold, ns);
+		ns = zf_bench::measure([&]() { fill(); b.init(); evict(); }, [&]()
+		{
+			a.move(b);
+		}, n, o.repeats);
+		o.out->add(name, "move", n, o.cold, ns);
+		if (C::splices)
+		{
+			/* last entry for lists that can't get it in O(1), not measured */
+			entry *last = 0;
+			ns = zf_bench::measure([&]()
+			{
+				fill();
+				b.init();
+				last = a.last();
+				evict();
+			}, [&]()
+			{
+				a.splice(b, last);
+			}, n, o.repeats);
+			o.out->add(name, "splice", n, o.cold, ns);
+		}
+		if (C::concats)
+		{
+			ns = zf_bench::measure([&]() { fill_halves(); evict(); }, [&]()
+			{
+				a.concat(b);
+			}, n, o.repeats);
+			o.out->add(name, "concat", n, o.cold, ns);
+		}
+		if (C::sorts)
+		{
+			ns = zf_bench::measure([&]() { fill(); evict(); }, [&]()
+			{
+				a.sort();
+			}, n, o.repeats);
+			o.out->add(name, "sort", n, o.cold, ns);
+		}
+		a.init();
+		b.init();
+	}
+
+	void bench_all(const entries &order, const entries &removal,
+				   const options &o)
+	{
+		bench<zf_slist_bench>("zf_slist", order, removal, o);
+		bench<zf_list_bench>("zf_list", order, removal, o);
+		bench<zf_stailq_bench>("zf_stailq", order, removal, o);
+		bench<zf_tailq_bench>("zf_tailq", order, removal, o);
+		bench<std_list_bench>("std::list", order, removal, o);
+		bench<std_forward_list_bench>("std::forward_list", order, removal, o);
+		bench<bsd_slist_bench>("bsd SLIST", order, removal, o);
+		bench<bsd_list_bench>("bsd LIST", order, removal, o);
+		bench<bsd_stailq_bench>("bsd STAILQ", order, removal, o);
+		bench<bsd_tailq_bench>("bsd TAILQ", order, removal, o);
+		bench<linux_list_bench>("linux list_head", order, removal, o);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t max_count = zf_bench::count_arg(argc, argv, 1 << 20);
+	const unsigned repeats = 2 < argc? (unsigned)std::atoi(argv[2]): 3;
+	json_output out;
+	zf_bench::rng r;
+	/* 256 entries fit into L1, 4K into L2, 64K into L3, the rest is DRAM */
+	for (size_t count = 256; max_count >= count; count *= 16)
+	{
+		std::vector<entry> storage(count);
+		entries order(count), removal(count);
+		for (size_t i = 0; count > i; ++i)
+		{
+			storage[i].value = r();
+			order[i] = removal[i] = &storage[i];
+		}
+		zf_bench::shuffle(order, r);
+		zf_bench::shuffle(removal, r);
+		for (unsigned cold = 0; 2 > cold; ++cold)
+		{
+			const options o = {repeats, 0 != cold, &out};
+			bench_all(order, removal, o);
+		}
+	}
+	return 0;
+}
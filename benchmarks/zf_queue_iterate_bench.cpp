@@ -0,0 +1,96 @@
+/* Measures iteration over lists that do not fit into the last level cache:
+ * plain pointer chasing vs prefetching iteration with different distances.
+ * Entries are linked in random order, payload is in a separate cache line.
+ * Usage: zf_queue_iterate_bench [entries]
+ */
+#include <zf_queue.h>
+#include <zf_bench.hpp>
+#include <cstddef>
+#include <string>
+
+namespace
+{
+	struct entry
+	{
+		zf_slist_node snode;
+		zf_tailq_node tnode;
+		char pad[64 - sizeof(zf_slist_node) - sizeof(zf_tailq_node)];
+		/* payload is in the second cache line of the entry */
+		uint64_t value;
+		char payload[56];
+	};
+
+	typedef zf_slist_head_<entry, &entry::snode> slist_head;
+	typedef zf_tailq_head_<entry, &entry::tnode> tailq_head;
+
+	const unsigned c_repeats = 3;
+
+	struct sum
+	{
+		uint64_t *s;
+		void operator()(entry *const e) const { *s += e->value; }
+	};
+
+	void nop() {}
+
+	template <unsigned K>
+	void bench_prefetch(const char *const name, slist_head *const sh,
+						tailq_head *const th, const size_t count)
+	{
+		uint64_t s = 0;
+		const sum f = {&s};
+		const ptrdiff_t offset = offsetof(entry, value);
+		double ns = zf_bench::measure(nop, [&]() {
+			zf_slist_foreach_prefetch_<K>(sh, f, offset);
+			zf_bench::keep(s);
+		}, count, c_repeats);
+		std::string n = std::string("slist foreach_prefetch<") + name + ">";
+		zf_bench::report(n.c_str(), count, ns);
+		ns = zf_bench::measure(nop, [&]() {
+			zf_tailq_foreach_prefetch_<K>(th, f, offset);
+			zf_bench::keep(s);
+		}, count, c_repeats);
+		n = std::string("tailq foreach_prefetch<") + name + ">";
+		zf_bench::report(n.c_str(), count, ns);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count = zf_bench::count_arg(argc, argv, 1 << 21);
+	std::vector<entry> entries(count);
+	std::vector<entry *> shuffled(count);
+	for (size_t i = 0; count > i; ++i)
+	{
+		entries[i].value = i;
+		shuffled[i] = &entries[i];
+	}
+	zf_bench::rng r;
+	zf_bench::shuffle(shuffled, r);
+	slist_head sh = ZF_SLIST_INITIALIZER();
+	zf_slist_insert_head_bulk_(&sh, shuffled.data(), count);
+	tailq_head th = ZF_TAILQ_INITIALIZER(&th);
+	zf_tailq_insert_tail_bulk_(&th, shuffled.data(), count);
+
+	uint64_t s = 0;
+	const sum f = {&s};
+	double ns = zf_bench::measure(nop, [&]() {
+		for (zf_slist_node *n = zf_slist_begin(&sh); 0 != n; n = n->next)
+		{
+			f(zf_entry(n, entry, snode));
+		}
+		zf_bench::keep(s);
+	}, count, c_repeats);
+	zf_bench::report("slist plain", count, ns);
+	ns = zf_bench::measure(nop, [&]() {
+		zf_tailq_foreach_(&th, f);
+		zf_bench::keep(s);
+	}, count, c_repeats);
+	zf_bench::report("tailq foreach_", count, ns);
+	bench_prefetch<1>("1", &sh, &th, count);
+	bench_prefetch<2>("2", &sh, &th, count);
+	bench_prefetch<4>("4", &sh, &th, count);
+	bench_prefetch<8>("8", &sh, &th, count);
+	bench_prefetch<16>("16", &sh, &th, count);
+	return 0;
+}
@@ -0,0 +1,110 @@
+/* Measures cost of loading a queue from an array of entries: one insert per
+ * entry vs bulk insert that pre-links entries with prefetch and updates the
+ * head once. Usage: zf_queue_load_bench [entries]
+ */
+#include <zf_queue.h>
+#include <zf_bench.hpp>
+
+namespace
+{
+	struct entry
+	{
+		unsigned value;
+		zf_stailq_node snode;
+		zf_tailq_node tnode;
+		/* entries are about a cache line each */
+		char payload[40];
+	};
+
+	typedef zf_stailq_head_<entry, &entry::snode> stailq_head;
+	typedef zf_tailq_head_<entry, &entry::tnode> tailq_head;
+
+	const unsigned c_repeats = 5;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count = zf_bench::count_arg(argc, argv, 1 << 20);
+	std::vector<entry> entries(count);
+	std::vector<entry *> shuffled(count);
+	for (size_t i = 0; count > i; ++i)
+	{
+		entries[i].value = (unsigned)i;
+		shuffled[i] = &entries[i];
+	}
+	zf_bench::rng r;
+	zf_bench::shuffle(shuffled, r);
+	entry *const *const sp = shuffled.data();
+	entry *const ep = entries.data();
+
+	stailq_head sh;
+	tailq_head th;
+	const struct stailq_setup
+	{
+		stailq_head *h;
+		void operator()() const { zf_stailq_init(h); }
+	}
+	ss = {&sh};
+	const struct tailq_setup
+	{
+		tailq_head *h;
+		void operator()() const { zf_tailq_init(h); }
+	}
+	ts = {&th};
+
+	double ns;
+	ns = zf_bench::measure(ss, [&]() {
+		for (size_t i = 0; count > i; ++i)
+		{
+			zf_stailq_insert_tail(&sh, &sp[i]->snode);
+		}
+		zf_bench::keep(sh);
+	}, count, c_repeats);
+	zf_bench::report("stailq insert_tail shuffled", count, ns);
+	ns = zf_bench::measure(ss, [&]() {
+		zf_stailq_insert_tail_bulk_(&sh, sp, count);
+		zf_bench::keep(sh);
+	}, count, c_repeats);
+	zf_bench::report("stailq insert_tail_bulk shuffled", count, ns);
+	ns = zf_bench::measure(ss, [&]() {
+		for (size_t i = 0; count > i; ++i)
+		{
+			zf_stailq_insert_tail(&sh, &ep[i].snode);
+		}
+		zf_bench::keep(sh);
+	}, count, c_repeats);
+	zf_bench::report("stailq insert_tail contiguous", count, ns);
+	ns = zf_bench::measure(ss, [&]() {
+		zf_stailq_insert_tail_bulk_(&sh, ep, count);
+		zf_bench::keep(sh);
+	}, count, c_repeats);
+	zf_bench::report("stailq insert_tail_bulk contiguous", count, ns);
+
+	ns = zf_bench::measure(ts, [&]() {
+		for (size_t i = 0; count > i; ++i)
+		{
+			zf_tailq_insert_tail_(&th, sp[i]);
+		}
+		zf_bench::keep(th);
+	}, count, c_repeats);
+	zf_bench::report("tailq insert_tail shuffled", count, ns);
+	ns = zf_bench::measure(ts, [&]() {
+		zf_tailq_insert_tail_bulk_(&th, sp, count);
+		zf_bench::keep(th);
+	}, count, c_repeats);
+	zf_bench::report("tailq insert_tail_bulk shuffled", count, ns);
+	ns = zf_bench::measure(ts, [&]() {
+		for (size_t i = 0; count > i; ++i)
+		{
+			zf_tailq_insert_tail_(&th, ep + i);
+		}
+		zf_bench::keep(th);
+	}, count, c_repeats);
+	zf_bench::report("tailq insert_tail contiguous", count, ns);
+	ns = zf_bench::measure(ts, [&]() {
+		zf_tailq_insert_tail_bulk_(&th, ep, count);
+		zf_bench::keep(th);
+	}, count, c_repeats);
+	zf_bench::report("tailq insert_tail_bulk contiguous", count, ns);
+	return 0;
+}
@@ -0,0 +1,154 @@
+/* Runs list operation scenarios under hardware performance counters (see
+ * zf_perf.hpp) and reports cycles, instructions, L1d/LLC/dTLB misses and branch
+ * misses per operation. Falls back to timing only when counters are not
+ * available.
+ *
+ * Scenarios are templates over entry type, list operations and access
+ * pattern. To measure own entries, define entry type with a node, pick
+ * xxx_ops<Entry, &Entry::node>, build vector of entry pointers in the order
+ * of interest and call run_scenarios<Ops>(counters, pattern, order, visit),
+ * where visit(e) is what iteration does with each entry.
+ * Usage: zf_queue_perf_bench [entries]
+ */
+#include <zf_queue.h>
+#include <zf_bench.hpp>
+#include <zf_perf.hpp>
+#include <string>
+
+namespace
+{
+	const unsigned c_repeats = 3;
+
+	template <typename E, zf_slist_node E:: *node>
+	struct slist_ops
+	{
+		typedef E entry;
+		typedef zf_slist_head_<E, node> head;
+		static const char *name() { return "slist"; }
+		static void init(head *const h) { zf_slist_init(h); }
+		static void insert(head *const h, E *const e) { zf_slist_insert_head_(h, e); }
+		static void remove(head *const h, E *) { zf_slist_remove_head(h); }
+	};
+
+	template <typename E, zf_list_node E:: *node>
+	struct list_ops
+	{
+		typedef E entry;
+		typedef zf_list_head_<E, node> head;
+		static const char *name() { return "list"; }
+		static void init(head *const h) { zf_list_init(h); }
+		static void insert(head *const h, E *const e) { zf_list_insert_head_(h, e); }
+		static void remove(head *const h, E *const e) { zf_list_remove_(h, e); }
+	};
+
+	template <typename E, zf_stailq_node E:: *node>
+	struct stailq_ops
+	{
+		typedef E entry;
+		typedef zf_stailq_head_<E, node> head;
+		static const char *name() { return "stailq"; }
+		static void init(head *const h) { zf_stailq_init(h); }
+		static void insert(head *const h, E *const e) { zf_stailq_insert_tail_(h, e); }
+		static void remove(head *const h, E *) { zf_stailq_remove_head(h); }
+	};
+
+	template <typename E, zf_tailq_node E:: *node>
+	struct tailq_ops
+	{
+		typedef E entry;
+		typedef zf_tailq_head_<E, node> head;
+		static const char *name() { return "tailq"; }
+		static void init(head *const h) { zf_tailq_init(h); }
+		static void insert(head *const h, E *const e) { zf_tailq_insert_tail_(h, e); }
+		static void remove(head *const h, E *const e) { zf_tailq_remove_(h, e); }
+	};
+
+	/* Measures insert of all entries in order, iteration over them and
+	 * removal (of head for singly-linked lists, in order for others).
+	 */
+	template <typename Ops, typename V>
+	void run_scenarios(zf_perf::counters &c, const char *const pattern,
+					   const std::vector<typename Ops::entry *> &order, V visit)
+	{
+		typedef typename Ops::entry entry;
+		typename Ops::head h;
+		const size_t count = order.size();
+		const auto init = [&]() { Ops::init(&h); };
+		const auto fill = [&]()
+		{
+			Ops::init(&h);
+			for (entry *const e: order)
+			{
+				Ops::insert(&h, e);
+			}
+		};
+		const auto nop = []() {};
+		const std::string prefix = std::string(Ops::name()) + " " + pattern + " ";
+		zf_perf::result r = c.measure(init, fill, count, c_repeats);
+		zf_perf::report((prefix + "insert").c_str(), count, r);
+		fill();
+		r = c.measure(nop, [&]()
+		{
+			for (entry &e: h)
+			{
+				visit(&e);
+			}
+		}, count, c_repeats);
+		zf_perf::report((prefix + "iterate").c_str(), count, r);
+		r = c.measure(fill, [&]()
+		{
+			for (entry *const e: order)
+			{
+				Ops::remove(&h, e);
+			}
+			zf_bench::keep(h);
+		}, count, c_repeats);
+		zf_perf::report((prefix + "remove").c_str(), count, r);
+	}
+
+	struct entry
+	{
+		zf_slist_node snode;
+		zf_list_node lnode;
+		zf_stailq_node sqnode;
+		zf_tailq_node tqnode;
+		uint64_t value;
+		char payload[8];
+	};
+
+	template <typename Ops>
+	void run_patterns(zf_perf::counters &c, const std::vector<entry *> &seq,
+					  const std::vector<entry *> &random)
+	{
+		uint64_t s = 0;
+		const auto visit = [&s](entry *const e) { s += e->value; };
+		run_scenarios<Ops>(c, "sequential", seq, visit);
+		run_scenarios<Ops>(c, "random", random, visit);
+		zf_bench::keep(s);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count = zf_bench::count_arg(argc, argv, 1 << 20);
+	std::vector<entry> entries(count);
+	std::vector<entry *> seq(count), random(count);
+	for (size_t i = 0; count > i; ++i)
+	{
+		entries[i].value = i;
+		seq[i] = random[i] = &entries[i];
+	}
+	zf_bench::rng r;
+	zf_bench::shuffle(random, r);
+
+	zf_perf::counters c;
+	if (!c.any())
+	{
+		std::printf("hardware counters are not available, timing only\n");
+	}
+	run_patterns<slist_ops<entry, &entry::snode>>(c, seq, random);
+	run_patterns<list_ops<entry, &entry::lnode>>(c, seq, random);
+	run_patterns<stailq_ops<entry, &entry::sqnode>>(c, seq, random);
+	run_patterns<tailq_ops<entry, &entry::tqnode>>(c, seq, random);
+	return 0;
+}
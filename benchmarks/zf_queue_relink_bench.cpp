@@ -0,0 +1,82 @@
+/* Measures traversal of a tail queue that links entries in random memory
+ * order, then after zf_tailq_relink_() and after zf_tailq_compact_().
+ * Usage: zf_queue_relink_bench [entries]
+ */
+#include <zf_queue.h>
+#include <zf_bench.hpp>
+
+namespace
+{
+	struct entry
+	{
+		zf_tailq_node node;
+		uint64_t value;
+		char payload[40];
+	};
+
+	typedef zf_tailq_head_<entry, &entry::node> tailq_head;
+
+	const unsigned c_repeats = 3;
+
+	struct sum
+	{
+		uint64_t *s;
+		void operator()(entry *const e) const { *s += e->value; }
+	};
+
+	struct move
+	{
+		void operator()(entry *const dst, entry *const src) const { *dst = *src; }
+	};
+
+	void nop() {}
+
+	void bench_traverse(const char *const name, tailq_head *const h,
+						const size_t count)
+	{
+		uint64_t s = 0;
+		const sum f = {&s};
+		const double ns = zf_bench::measure(nop, [&]() {
+			zf_tailq_foreach_(h, f);
+			zf_bench::keep(s);
+		}, count, c_repeats);
+		size_t total = 0;
+		const size_t breaks = zf_tailq_disorder_(h, sizeof(entry), &total);
+		zf_bench::report(name, count, ns);
+		std::printf("%-40s %10zu breaks\n", "", breaks);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count = zf_bench::count_arg(argc, argv, 1 << 21);
+	std::vector<entry> entries(count);
+	std::vector<entry *> shuffled(count);
+	for (size_t i = 0; count > i; ++i)
+	{
+		entries[i].value = i;
+		shuffled[i] = &entries[i];
+	}
+	zf_bench::rng r;
+	zf_bench::shuffle(shuffled, r);
+	tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+	zf_tailq_insert_tail_bulk_(&h, shuffled.data(), count);
+	bench_traverse("tailq shuffled", &h, count);
+
+	double ns = zf_bench::measure(nop, [&]() {
+		zf_tailq_relink_(&h);
+	}, count, 1);
+	zf_bench::report("tailq relink", count, ns);
+	bench_traverse("tailq after relink", &h, count);
+
+	/* restore random order, then compact into a new slab */
+	zf_tailq_init(&h);
+	zf_tailq_insert_tail_bulk_(&h, shuffled.data(), count);
+	std::vector<entry> slab(count);
+	ns = zf_bench::measure(nop, [&]() {
+		zf_tailq_compact_(&h, slab.data(), count, move());
+	}, count, 1);
+	zf_bench::report("tailq compact", count, ns);
+	bench_traverse("tailq after compact", &h, count);
+	return 0;
+}
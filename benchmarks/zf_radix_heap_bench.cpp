@@ -0,0 +1,211 @@
+/* Runs Dijkstra shortest paths over synthetic random graph with radix heap
+ * (zf_radix_heap.h), binary heap with decrease key (zf_heap.h with arity 2)
+ * and std::priority_queue with lazy deletion (duplicates are pushed instead
+ * of decrease key and skipped on pop). Distances of all three are compared.
+ * Usage: zf_radix_heap_bench [vertices]
+ */
+#include <zf_radix_heap.h>
+#include <zf_heap.h>
+#include <zf_bench.hpp>
+#include <functional>
+#include <queue>
+
+namespace
+{
+	const unsigned c_repeats = 3;
+	const unsigned c_degree = 8;
+	const uint64_t c_max_weight = 1000;
+	const uint64_t c_infinity = ~(uint64_t)0;
+
+	struct vertex
+	{
+		zf_radix_heap_node rnode;
+		zf_heap_node hnode;
+		uint64_t dist;
+	};
+
+	/* adjacency lists in compressed sparse row format */
+	struct graph
+	{
+		std::vector<size_t> first;
+		std::vector<uint32_t> to;
+		std::vector<uint32_t> weight;
+	};
+
+	graph make_graph(const size_t n, zf_bench::rng &r)
+	{
+		graph g;
+		g.first.resize(n + 1);
+		g.to.resize(n * c_degree);
+		g.weight.resize(n * c_degree);
+		for (size_t v = 0; n > v; ++v)
+		{
+			g.first[v] = v * c_degree;
+			for (size_t k = 0; c_degree > k; ++k)
+			{
+				/* first edge makes a ring, so all vertices are reachable */
+				g.to[v * c_degree + k] =
+						(uint32_t)(0 == k? (v + 1) % n: r() % n);
+				g.weight[v * c_degree + k] = (uint32_t)(1 + r() % c_max_weight);
+			}
+		}
+		g.first[n] = n * c_degree;
+		return g;
+	}
+
+	void reset(std::vector<vertex> &vs)
+	{
+		for (vertex &v: vs)
+		{
+			v.dist = c_infinity;
+			zf_heap_node_init(&v.hnode);
+		}
+	}
+
+	void dijkstra_radix(const graph &g, std::vector<vertex> &vs)
+	{
+		zf_radix_heap h;
+		zf_radix_heap_init(&h);
+		vs[0].dist = 0;
+		zf_radix_heap_insert_<vertex, &vertex::rnode>(&h, &vs[0], 0);
+		while (vertex *const v = zf_radix_heap_pop_<vertex, &vertex::rnode>(&h))
+		{
+			const size_t i = (size_t)(v - vs.data());
+			for (size_t e = g.first[i]; g.first[i + 1] > e; ++e)
+			{
+				vertex *const u = &vs[g.to[e]];
+				const uint64_t d = v->dist + g.weight[e];
+				if (u->dist > d)
+				{
+					if (c_infinity == u->dist)
+					{
+						zf_radix_heap_insert_<vertex, &vertex::rnode>(&h, u, d);
+					}
+					else
+					{
+						zf_radix_heap_update_<vertex, &vertex::rnode>(&h, u, d);
+					}
+					u->dist = d;
+				}
+			}
+		}
+	}
+
+	struct dist_less
+	{
+		bool operator()(const vertex *a, const vertex *b) const
+		{
+			return a->dist < b->dist;
+		}
+	};
+
+	void dijkstra_binary(const graph &g, std::vector<vertex> &vs,
+						 std::vector<zf_heap_node *> &nodes)
+	{
+		zf_heap_<vertex, &vertex::hnode, dist_less, 2> h(nodes.data(),
+														  nodes.size());
+		vs[0].dist = 0;
+		zf_heap_insert_(&h, &vs[0]);
+		while (vertex *const v = zf_heap_pop_(&h))
+		{
+			const size_t i = (size_t)(v - vs.data());
+			for (size_t e = g.first[i]; g.first[i + 1] > e; ++e)
+			{
+				vertex *const u = &vs[g.to[e]];
+				const uint64_t d = v->dist + g.weight[e];
+				if (u->dist > d)
+				{
+					const bool queued = c_infinity != u->dist;
+					u->dist = d;
+					if (queued)
+					{
+						zf_heap_update_(&h, u);
+					}
+					else
+					{
+						zf_heap_insert_(&h, u);
+					}
+				}
+			}
+		}
+	}
+
+	typedef std::pair<uint64_t, uint32_t> item;
+
+	/* storage is reserved once, so allocation is not measured */
+	struct std_heap:
+			std::priority_queue<item, std::vector<item>, std::greater<item> >
+	{
+		void reserve(const size_t n) { c.reserve(n); }
+		void clear() { c.clear(); }
+	};
+
+	void dijkstra_std(const graph &g, std::vector<vertex> &vs, std_heap &h)
+	{
+		h.clear();
+		vs[0].dist = 0;
+		h.push(item(0, 0));
+		while (!h.empty())
+		{
+			const item t = h.top();
+			h.pop();
+			if (vs[t.second].dist != t.first)
+			{
+				continue;
+			}
+			for (size_t e = g.first[t.second]; g.first[t.second + 1] > e; ++e)
+			{
+				const uint64_t d = t.first + g.weight[e];
+				if (vs[g.to[e]].dist > d)
+				{
+					vs[g.to[e]].dist = d;
+					h.push(item(d, g.to[e]));
+				}
+			}
+		}
+	}
+
+	std::vector<uint64_t> distances(const std::vector<vertex> &vs)
+	{
+		std::vector<uint64_t> d(vs.size());
+		for (size_t i = 0; vs.size() > i; ++i)
+		{
+			d[i] = vs[i].dist;
+		}
+		return d;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t n = zf_bench::count_arg(argc, argv, 1 << 18);
+	zf_bench::rng r;
+	const graph g = make_graph(n, r);
+	std::vector<vertex> vs(n);
+	const auto setup = [&]() { reset(vs); };
+
+	double ns = zf_bench::measure(setup, [&]() { dijkstra_radix(g, vs); },
+								  n, c_repeats);
+	zf_bench::report("dijkstra radix heap", n, ns);
+	const std::vector<uint64_t> expected = distances(vs);
+
+	std::vector<zf_heap_node *> nodes(n);
+	ns = zf_bench::measure(setup, [&]() { dijkstra_binary(g, vs, nodes); },
+						   n, c_repeats);
+	zf_bench::report("dijkstra binary heap", n, ns);
+	bool same = expected == distances(vs);
+
+	std_heap h;
+	h.reserve(n * c_degree);
+	ns = zf_bench::measure(setup, [&]() { dijkstra_std(g, vs, h); },
+						   n, c_repeats);
+	zf_bench::report("dijkstra std::priority_queue", n, ns);
+	same = same && expected == distances(vs);
+
+	if (!same)
+	{
+		std::printf("distances differ\n");
+		return 1;
+	}
+	return 0;
+}
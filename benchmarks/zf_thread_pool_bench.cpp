@@ -0,0 +1,207 @@
+/* Compares zf_thread_pool_ (intrusive tasks, no allocations) against a
+ * classic pool of std::function in std::deque guarded by std::mutex:
+ *  - tasks/sec: submit all tasks one by one (or as one prelinked list) and
+ *    wait until all of them are done, ns/item is the inverse throughput;
+ *  - latency: submit a single task and wait for it, ns/item is the average
+ *    time from submit() to the start of the task.
+ * Usage: zf_thread_pool_bench [tasks count]
+ */
+#include <zf_thread_pool.h>
+#include <zf_bench.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	const unsigned c_repeats = 5;
+	typedef std::chrono::steady_clock clock;
+
+	class std_pool
+	{
+	public:
+		explicit std_pool(const unsigned count): stopping(false)
+		{
+			for (unsigned i = 0; count > i; ++i)
+			{
+				threads.emplace_back(&std_pool::work, this);
+			}
+		}
+		~std_pool()
+		{
+			{
+				std::lock_guard<std::mutex> l(lock);
+				stopping = true;
+			}
+			wakeup.notify_all();
+			for (std::thread &t: threads)
+			{
+				t.join();
+			}
+		}
+		void submit(std::function<void()> f)
+		{
+			{
+				std::lock_guard<std::mutex> l(lock);
+				tasks.push_back(std::move(f));
+			}
+			wakeup.notify_one();
+		}
+	private:
+		void work()
+		{
+			for (;;)
+			{
+				std::function<void()> f;
+				{
+					std::unique_lock<std::mutex> l(lock);
+					wakeup.wait(l, [this]() { return stopping || !tasks.empty(); });
+					if (tasks.empty())
+					{
+						return;
+					}
+					f = std::move(tasks.front());
+					tasks.pop_front();
+				}
+				f();
+			}
+		}
+
+		std::mutex lock;
+		std::condition_variable wakeup;
+		std::deque<std::function<void()>> tasks;
+		bool stopping;
+		std::vector<std::thread> threads;
+	};
+
+	struct entry
+	{
+		zf_task_ task;
+		std::atomic<size_t> *done;
+		clock::time_point submitted;
+		uint64_t latency;
+	};
+
+	void wait_for(const std::atomic<size_t> &done, const size_t count)
+	{
+		while (count != done.load(std::memory_order_acquire))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	void run_entry(zf_task_ *const t)
+	{
+		entry *const e = zf_entry_(t, &entry::task);
+		e->done->fetch_add(1, std::memory_order_release);
+	}
+
+	void run_entry_latency(zf_task_ *const t)
+	{
+		entry *const e = zf_entry_(t, &entry::task);
+		e->latency += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+				clock::now() - e->submitted).count();
+		e->done->fetch_add(1, std::memory_order_release);
+	}
+
+	void bench_throughput(const unsigned threads, const size_t count)
+	{
+		std::atomic<size_t> done(0);
+		std::vector<entry> entries(count);
+		for (entry &e: entries)
+		{
+			e.task.run = run_entry;
+			e.done = &done;
+		}
+		const auto reset = [&]() { done.store(0); };
+		{
+			zf_thread_pool_ pool(threads);
+			const double ns = zf_bench::measure(reset, [&]()
+			{
+				for (entry &e: entries)
+				{
+					pool.submit(&e.task);
+				}
+				wait_for(done, count);
+			}, count, c_repeats);
+			zf_bench::report("zf_thread_pool_ submit", count, ns);
+			const double bulk_ns = zf_bench::measure(reset, [&]()
+			{
+				zf_task_list_ h;
+				zf_stailq_init(&h);
+				for (entry &e: entries)
+				{
+					zf_stailq_insert_tail(&h, &e.task.node);
+				}
+				pool.submit_all(&h);
+				wait_for(done, count);
+			}, count, c_repeats);
+			zf_bench::report("zf_thread_pool_ submit_all", count, bulk_ns);
+		}
+		{
+			std_pool pool(threads);
+			const double ns = zf_bench::measure(reset, [&]()
+			{
+				for (entry &e: entries)
+				{
+					entry *const p = &e;
+					pool.submit([p]() { run_entry(&p->task); });
+				}
+				wait_for(done, count);
+			}, count, c_repeats);
+			zf_bench::report("std::function + std::deque submit", count, ns);
+		}
+	}
+
+	void bench_latency(const unsigned threads, const size_t count)
+	{
+		std::atomic<size_t> done(0);
+		entry e;
+		e.task.run = run_entry_latency;
+		e.done = &done;
+		{
+			zf_thread_pool_ pool(threads);
+			e.latency = 0;
+			done.store(0);
+			for (size_t i = 0; count > i; ++i)
+			{
+				e.submitted = clock::now();
+				pool.submit(&e.task);
+				wait_for(done, i + 1);
+			}
+			zf_bench::report("zf_thread_pool_ latency", count,
+							 (double)e.latency / count);
+		}
+		{
+			std_pool pool(threads);
+			e.latency = 0;
+			done.store(0);
+			for (size_t i = 0; count > i; ++i)
+			{
+				entry *const p = &e;
+				e.submitted = clock::now();
+				pool.submit([p]() { run_entry_latency(&p->task); });
+				wait_for(done, i + 1);
+			}
+			zf_bench::report("std::function + std::deque latency", count,
+							 (double)e.latency / count);
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count = zf_bench::count_arg(argc, argv, 1 << 18);
+	unsigned threads = std::thread::hardware_concurrency();
+	if (0 == threads)
+	{
+		threads = 1;
+	}
+	bench_throughput(threads, count);
+	bench_latency(threads, count / 64 + 1);
+	return 0;
+}
@@ -1,4 +1,5 @@
 #include <string>
+#include <stdexcept>
 #include <vector>
 #include <stdio.h>
 #include <zf_queue.h>
@@ -15,10 +16,9 @@ namespace
 	std::string to_string(items_t &items)
 	{
 		std::string s;
-		for (item *i = zf_tailq_begin_(&items), *e = zf_tailq_end_(&items);
-			 e != i; i = zf_tailq_next_(&items, i))
+		for (const item &i: items)
 		{
-			s.push_back(i->v);
+			s.push_back(i.v);
 		}
 		return s;
 	}
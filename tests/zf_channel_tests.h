@@ -0,0 +1,203 @@
+#pragma once
+
+#include "zf_test.hpp"
+#include "zf_channel.h"
+
+#include <exception>
+#include <mutex>
+#include <thread>
+
+struct channel_test_entry
+{
+	unsigned value;
+	zf_stailq_node node;
+};
+
+typedef zf_channel_<channel_test_entry, &channel_test_entry::node>
+		channel_test_channel;
+typedef zf_channel_<channel_test_entry, &channel_test_entry::node, std::mutex>
+		channel_test_mt_channel;
+
+/* Coroutine that starts immediately and destroys itself when done */
+struct channel_test_task
+{
+	struct promise_type
+	{
+		channel_test_task get_return_object() noexcept { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+	};
+};
+
+/* Pops entries until channel is closed */
+template <typename Channel>
+static channel_test_task test_zf_channel_consume(Channel *const ch,
+												 std::vector<unsigned> *out,
+												 unsigned *const done)
+{
+	while (channel_test_entry *const e = co_await ch->pop())
+	{
+		out->push_back(e->value);
+	}
+	++*done;
+}
+
+static void test_zf_channel_fifo()
+{
+	channel_test_entry a[8];
+	for (unsigned i = 0; 8 > i; ++i)
+	{
+		a[i].value = i;
+	}
+	channel_test_channel ch;
+	std::vector<unsigned> out1, out2;
+	unsigned done = 0;
+	test_zf_channel_consume(&ch, &out1, &done);
+	test_zf_channel_consume(&ch, &out2, &done);
+	TEST_VERIFY_EQUAL(nullptr, ch.try_pop());
+	/* waiters are resumed in FIFO order and wait again at the tail */
+	ch.push(&a[0]);
+	ch.push(&a[1]);
+	ch.push(&a[2]);
+	TEST_VERIFY_TRUE(std::vector<unsigned>({0, 2}) == out1);
+	TEST_VERIFY_TRUE(std::vector<unsigned>({1}) == out2);
+	zf_stailq_head_<channel_test_entry, &channel_test_entry::node> h =
+			ZF_STAILQ_INITIALIZER(&h);
+	for (unsigned i = 3; 6 > i; ++i)
+	{
+		zf_stailq_insert_tail(&h, &a[i].node);
+	}
+	/* each push resumes consumer that waits again, so all are handed over */
+	TEST_VERIFY_EQUAL(3u, ch.push_all(&h));
+	TEST_VERIFY_TRUE(zf_stailq_empty(&h));
+	TEST_VERIFY_TRUE(std::vector<unsigned>({1, 3, 5}) == out2);
+	TEST_VERIFY_TRUE(std::vector<unsigned>({0, 2, 4}) == out1);
+	TEST_VERIFY_EQUAL(0u, done);
+	ch.close();
+	TEST_VERIFY_EQUAL(2u, done);
+	TEST_VERIFY_TRUE(ch.is_closed());
+	/* entries pushed without waiters are queued */
+	ch.push(&a[6]);
+	zf_stailq_insert_tail(&h, &a[7].node);
+	TEST_VERIFY_EQUAL(0u, ch.push_all(&h));
+	TEST_VERIFY_EQUAL(&a[6], ch.try_pop());
+	std::vector<unsigned> out3;
+	test_zf_channel_consume(&ch, &out3, &done);
+	TEST_VERIFY_EQUAL(3u, done);
+	TEST_VERIFY_TRUE(std::vector<unsigned>({7}) == out3);
+}
+
+/* Coroutine that starts immediately and stays suspended at the end, so it
+ * could be destroyed by the caller at any suspension point */
+struct channel_test_handle
+{
+	struct promise_type
+	{
+		channel_test_handle get_return_object() noexcept
+		{
+			return {std::coroutine_handle<promise_type>::from_promise(*this)};
+		}
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { std::terminate(); }
+	};
+	std::coroutine_handle<promise_type> h;
+};
+
+template <typename Channel>
+static channel_test_handle test_zf_channel_consume_one(Channel *const ch,
+													   unsigned *const out)
+{
+	channel_test_entry *const e = co_await ch->pop();
+	*out = 0 == e? ~0u: e->value;
+}
+
+template <typename Channel>
+static void test_zf_channel_destroy_()
+{
+	channel_test_entry a[2];
+	a[0].value = 0;
+	a[1].value = 1;
+	Channel ch;
+	unsigned out1 = 100, out2 = 100, out3 = 100;
+	channel_test_handle c1 = test_zf_channel_consume_one(&ch, &out1);
+	channel_test_handle c2 = test_zf_channel_consume_one(&ch, &out2);
+	channel_test_handle c3 = test_zf_channel_consume_one(&ch, &out3);
+	TEST_VERIFY_FALSE(c1.h.done());
+	/* destroyed consumers are not resumed with entries */
+	c1.h.destroy();
+	ch.push(&a[0]);
+	TEST_VERIFY_EQUAL(100u, out1);
+	TEST_VERIFY_EQUAL(0u, out2);
+	TEST_VERIFY_TRUE(c2.h.done());
+	c3.h.destroy();
+	ch.push(&a[1]);
+	TEST_VERIFY_EQUAL(100u, out3);
+	TEST_VERIFY_EQUAL(&a[1], ch.try_pop());
+	/* nor by close() */
+	channel_test_handle c4 = test_zf_channel_consume_one(&ch, &out1);
+	c4.h.destroy();
+	ch.close();
+	TEST_VERIFY_EQUAL(100u, out1);
+	c2.h.destroy();
+}
+
+static void test_zf_channel_destroy()
+{
+	test_zf_channel_destroy_<channel_test_channel>();
+	test_zf_channel_destroy_<channel_test_mt_channel>();
+}
+
+static void test_zf_channel_threads()
+{
+	const unsigned producers = 4;
+	const unsigned count = 2000;
+	std::vector<channel_test_entry> a(producers * count);
+	channel_test_mt_channel ch;
+	std::vector<unsigned> out1, out2;
+	unsigned done = 0;
+	test_zf_channel_consume(&ch, &out1, &done);
+	test_zf_channel_consume(&ch, &out2, &done);
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; producers > t; ++t)
+	{
+		threads.emplace_back([&ch, &a, t, count]()
+		{
+			for (unsigned i = 0; count > i; ++i)
+			{
+				channel_test_entry *const e = &a[t * count + i];
+				e->value = t * count + i;
+				ch.push(e);
+			}
+		});
+	}
+	for (std::thread &t: threads)
+	{
+		t.join();
+	}
+	ch.close();
+	TEST_VERIFY_EQUAL(2u, done);
+	std::vector<unsigned> all(out1);
+	all.insert(all.end(), out2.begin(), out2.end());
+	TEST_VERIFY_EQUAL(producers * count, (unsigned)all.size());
+	std::sort(all.begin(), all.end());
+	for (unsigned i = 0; all.size() > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(i, all[i]);
+	}
+}
+
+static void test_zf_channel(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_channel_fifo());
+	TEST_EXECUTE(test_zf_channel_destroy());
+	TEST_EXECUTE(test_zf_channel_threads());
+}
+
+static void test_zf_channel_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE_SUITE(test_zf_channel);
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#if defined(__cplusplus)
+#include "zf_test.hpp"
+#else
+#include "zf_test.h"
+#endif
+#include "zf_codel.h"
+
+typedef struct codel_test_entry
+{
+	unsigned key;
+	zf_codel_node node;
+}
+codel_test_entry;
+
+static unsigned test_zf_codel_key(zf_codel_node *const n)
+{
+	return 0 == n? ~0u: zf_entry(n, codel_test_entry, node)->key;
+}
+
+static unsigned test_zf_codel_drop_key(zf_stailq_node *const n)
+{
+	return zf_codel_entry(n, codel_test_entry, node)->key;
+}
+
+static void test_zf_codel_fill(zf_codel *const c, codel_test_entry *const a,
+							   const unsigned count)
+{
+	for (unsigned i = 0; count > i; ++i)
+	{
+		a[i].key = i;
+		zf_codel_enqueue(c, &a[i].node, 0);
+	}
+}
+
+static void test_zf_codel_isqrt()
+{
+	TEST_VERIFY_EQUAL(0u, _zf_codel_isqrt(0));
+	TEST_VERIFY_EQUAL(1u, _zf_codel_isqrt(1));
+	TEST_VERIFY_EQUAL(1u, _zf_codel_isqrt(3));
+	TEST_VERIFY_EQUAL(2u, _zf_codel_isqrt(4));
+	TEST_VERIFY_EQUAL(65536u, _zf_codel_isqrt((uint64_t)1 << 32));
+	TEST_VERIFY_EQUAL(92681u, _zf_codel_isqrt((uint64_t)2 << 32));
+	TEST_VERIFY_EQUAL(4294967295u, _zf_codel_isqrt(~(uint64_t)0));
+}
+
+static void test_zf_codel_fifo()
+{
+	codel_test_entry a[4];
+	zf_stailq_head drops = ZF_STAILQ_INITIALIZER(&drops);
+	zf_codel c;
+	zf_codel_init(&c, ZF_CODEL_TARGET, ZF_CODEL_INTERVAL);
+	TEST_VERIFY_TRUE(zf_codel_empty(&c));
+	TEST_VERIFY_EQUAL(~0u, test_zf_codel_key(zf_codel_dequeue(&c, 0, &drops)));
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].key = i;
+		zf_codel_enqueue(&c, &a[i].node, 1000 * i);
+	}
+	TEST_VERIFY_FALSE(zf_codel_empty(&c));
+	TEST_VERIFY_EQUAL(4u, zf_codel_length(&c));
+	/* sojourn times 4000, 3000, 2000, 1000 are all below target */
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(i, test_zf_codel_key(zf_codel_dequeue(&c, 4000, &drops)));
+	}
+	TEST_VERIFY_TRUE(zf_codel_empty(&c));
+	TEST_VERIFY_EQUAL(0u, zf_codel_length(&c));
+	TEST_VERIFY_TRUE(zf_stailq_empty(&drops));
+	TEST_VERIFY_EQUAL(4u, c.dequeued);
+	TEST_VERIFY_EQUAL(0u, c.dropped);
+	TEST_VERIFY_EQUAL(1u, c.histogram[zf_codel_bucket(1000)]);
+	TEST_VERIFY_EQUAL(1u, c.histogram[zf_codel_bucket(2000)]);
+	TEST_VERIFY_EQUAL(2u, c.histogram[zf_codel_bucket(4000)]);
+	TEST_VERIFY_FALSE(c.dropping);
+}
+
+static void test_zf_codel_drop()
+{
+	codel_test_entry a[10];
+	zf_stailq_head drops = ZF_STAILQ_INITIALIZER(&drops);
+	zf_codel c;
+	zf_codel_init(&c, 10, 100);
+	test_zf_codel_fill(&c, a, 10);
+	/* above target, drops start one interval later */
+	TEST_VERIFY_EQUAL(0u, test_zf_codel_key(zf_codel_dequeue(&c, 20, &drops)));
+	TEST_VERIFY_EQUAL(120u, c.first_above_time);
+	TEST_VERIFY_EQUAL(1u, test_zf_codel_key(zf_codel_dequeue(&c, 50, &drops)));
+	TEST_VERIFY_FALSE(c.dropping);
+	TEST_VERIFY_EQUAL(3u, test_zf_codel_key(zf_codel_dequeue(&c, 120, &drops)));
+	TEST_VERIFY_TRUE(c.dropping);
+	TEST_VERIFY_EQUAL(1u, c.count);
+	TEST_VERIFY_EQUAL(220u, c.drop_next);
+	TEST_VERIFY_EQUAL(2u, test_zf_codel_drop_key(zf_stailq_first(&drops)));
+	/* next drop is due at 220, then interval / sqrt(2) later */
+	TEST_VERIFY_EQUAL(4u, test_zf_codel_key(zf_codel_dequeue(&c, 200, &drops)));
+	TEST_VERIFY_EQUAL(6u, test_zf_codel_key(zf_codel_dequeue(&c, 220, &drops)));
+	TEST_VERIFY_EQUAL(2u, c.count);
+	TEST_VERIFY_EQUAL(290u, c.drop_next);
+	TEST_VERIFY_EQUAL(5u, test_zf_codel_drop_key(zf_stailq_last(&drops)));
+	/* late dequeue catches up with all drops that are due */
+	TEST_VERIFY_EQUAL(9u, test_zf_codel_key(zf_codel_dequeue(&c, 400, &drops)));
+	TEST_VERIFY_FALSE(c.dropping);
+	TEST_VERIFY_EQUAL(4u, c.dropped);
+	TEST_VERIFY_EQUAL(10u, c.dequeued);
+	TEST_VERIFY_EQUAL(8u, test_zf_codel_drop_key(zf_stailq_last(&drops)));
+	TEST_VERIFY_TRUE(zf_codel_empty(&c));
+	/* entry that didn't wait long is delivered */
+	a[0].key = 0;
+	zf_codel_enqueue(&c, &a[0].node, 1000);
+	TEST_VERIFY_EQUAL(0u, test_zf_codel_key(zf_codel_dequeue(&c, 1001, &drops)));
+	TEST_VERIFY_EQUAL(4u, c.dropped);
+	TEST_VERIFY_EQUAL(1u, c.histogram[zf_codel_bucket(1)]);
+}
+
+static void test_zf_codel_mark()
+{
+	codel_test_entry a[6];
+	zf_codel c;
+	zf_codel_init(&c, 10, 100);
+	c.mark = true;
+	test_zf_codel_fill(&c, a, 6);
+	TEST_VERIFY_EQUAL(0u, test_zf_codel_key(zf_codel_dequeue(&c, 20, 0)));
+	TEST_VERIFY_EQUAL(1u, test_zf_codel_key(zf_codel_dequeue(&c, 120, 0)));
+	TEST_VERIFY_TRUE(a[1].node.marked);
+	TEST_VERIFY_TRUE(c.dropping);
+	TEST_VERIFY_EQUAL(220u, c.drop_next);
+	TEST_VERIFY_EQUAL(2u, test_zf_codel_key(zf_codel_dequeue(&c, 200, 0)));
+	TEST_VERIFY_FALSE(a[2].node.marked);
+	TEST_VERIFY_EQUAL(3u, test_zf_codel_key(zf_codel_dequeue(&c, 220, 0)));
+	TEST_VERIFY_TRUE(a[3].node.marked);
+	TEST_VERIFY_EQUAL(290u, c.drop_next);
+	TEST_VERIFY_EQUAL(2u, c.marked);
+	TEST_VERIFY_EQUAL(0u, c.dropped);
+	TEST_VERIFY_EQUAL(2u, zf_codel_length(&c));
+}
+
+static void test_zf_codel_histogram()
+{
+	zf_codel c;
+	zf_codel_init(&c, ZF_CODEL_TARGET, ZF_CODEL_INTERVAL);
+	TEST_VERIFY_EQUAL(0u, zf_codel_bucket(0));
+	TEST_VERIFY_EQUAL(1u, zf_codel_bucket(1));
+	TEST_VERIFY_EQUAL(2u, zf_codel_bucket(2));
+	TEST_VERIFY_EQUAL(2u, zf_codel_bucket(3));
+	TEST_VERIFY_EQUAL(3u, zf_codel_bucket(4));
+	TEST_VERIFY_EQUAL(ZF_CODEL_HISTOGRAM_BUCKETS - 1u,
+					  zf_codel_bucket(~(uint64_t)0));
+	TEST_VERIFY_EQUAL(0u, zf_codel_bucket_limit(0));
+	TEST_VERIFY_EQUAL(3u, zf_codel_bucket_limit(2));
+	TEST_VERIFY_EQUAL(0u, zf_codel_percentile(&c, 99));
+	c.histogram[zf_codel_bucket(1)] = 90;
+	c.histogram[zf_codel_bucket(1000)] = 9;
+	c.histogram[zf_codel_bucket(100000)] = 1;
+	TEST_VERIFY_EQUAL(1u, zf_codel_percentile(&c, 0));
+	TEST_VERIFY_EQUAL(1u, zf_codel_percentile(&c, 90));
+	TEST_VERIFY_EQUAL(1023u, zf_codel_percentile(&c, 99));
+	TEST_VERIFY_EQUAL(131071u, zf_codel_percentile(&c, 100));
+	zf_codel_reset_stats(&c);
+	TEST_VERIFY_EQUAL(0u, zf_codel_percentile(&c, 100));
+}
+
+#ifdef __cplusplus
+static void test_zf_codel_cpp()
+{
+	codel_test_entry a[2];
+	zf_stailq_head drops = ZF_STAILQ_INITIALIZER(&drops);
+	zf_codel c;
+	zf_codel_init(&c, ZF_CODEL_TARGET, ZF_CODEL_INTERVAL);
+	zf_codel_enqueue_<codel_test_entry, &codel_test_entry::node>(&c, &a[0], 0);
+	zf_codel_enqueue_<codel_test_entry, &codel_test_entry::node>(&c, &a[1], 0);
+	TEST_VERIFY_EQUAL(&a[0], (zf_codel_dequeue_<codel_test_entry,
+							  &codel_test_entry::node>(&c, 0, &drops)));
+	TEST_VERIFY_EQUAL(&a[1], (zf_codel_dequeue_<codel_test_entry,
+							  &codel_test_entry::node>(&c, 0, &drops)));
+	TEST_VERIFY_TRUE((0 == zf_codel_dequeue_<codel_test_entry,
+					  &codel_test_entry::node>(&c, 0, &drops)));
+}
+#endif
+
+static void test_zf_codel_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_codel_isqrt());
+	TEST_EXECUTE(test_zf_codel_fifo());
+	TEST_EXECUTE(test_zf_codel_drop());
+	TEST_EXECUTE(test_zf_codel_mark());
+	TEST_EXECUTE(test_zf_codel_histogram());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_codel_cpp());
+#endif
+}
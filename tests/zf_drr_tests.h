@@ -0,0 +1,186 @@
+#pragma once
+
+#if defined(__cplusplus)
+#include "zf_test.hpp"
+#else
+#include "zf_test.h"
+#endif
+#include "zf_drr.h"
+
+typedef struct drr_test_entry
+{
+	unsigned key;
+	zf_drr_node node;
+}
+drr_test_entry;
+
+static unsigned test_zf_drr_next(zf_drr *const d, zf_drr_flow **const flow)
+{
+	zf_drr_node *const n = zf_drr_dequeue(d, flow);
+	return 0 == n? ~0u: zf_entry(n, drr_test_entry, node)->key;
+}
+
+static void test_zf_drr_weights()
+{
+	static const unsigned order[] = {0, 10, 11, 1, 12, 13, 2, 3};
+	drr_test_entry a[8];
+	zf_drr d;
+	zf_drr_flow f1, f2, *f = 0;
+	zf_drr_init(&d, 1);
+	zf_drr_flow_init(&d, &f1, 1);
+	zf_drr_flow_init(&d, &f2, 2);
+	TEST_VERIFY_TRUE(zf_drr_empty(&d));
+	TEST_VERIFY_EQUAL(~0u, test_zf_drr_next(&d, &f));
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].key = i;
+		a[4 + i].key = 10 + i;
+		zf_drr_enqueue(&d, &f1, &a[i].node, 1);
+		zf_drr_enqueue(&d, &f2, &a[4 + i].node, 1);
+	}
+	TEST_VERIFY_EQUAL(2u, zf_drr_flows(&d));
+	TEST_VERIFY_TRUE(zf_drr_flow_active(&f1));
+	for (unsigned i = 0; 8 > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(order[i], test_zf_drr_next(&d, &f));
+		TEST_VERIFY_TRUE(10 > order[i]? &f1 == f: &f2 == f);
+	}
+	TEST_VERIFY_TRUE(zf_drr_empty(&d));
+	TEST_VERIFY_EQUAL(0u, zf_drr_flows(&d));
+	TEST_VERIFY_FALSE(zf_drr_flow_active(&f1));
+	TEST_VERIFY_FALSE(zf_drr_flow_active(&f2));
+}
+
+static void test_zf_drr_cost()
+{
+	drr_test_entry a[16], b[16];
+	uint64_t served[2] = {0, 0};
+	zf_drr d;
+	zf_drr_flow f[2], *p = 0;
+	zf_drr_init(&d, 100);
+	zf_drr_flow_init(&d, &f[0], 1);
+	zf_drr_flow_init(&d, &f[1], 1);
+	for (unsigned i = 0; 16 > i; ++i)
+	{
+		a[i].key = 0;
+		b[i].key = 1;
+		zf_drr_enqueue(&d, &f[0], &a[i].node, 100);
+		zf_drr_enqueue(&d, &f[1], &b[i].node, 50);
+	}
+	/* both flows get the same cost per round, not the same entries */
+	for (unsigned i = 0; 24 > i; ++i)
+	{
+		const unsigned k = test_zf_drr_next(&d, &p);
+		TEST_VERIFY_TRUE(2 > k);
+		TEST_VERIFY_TRUE(&f[k] == p);
+		served[k] += 0 == k? 100: 50;
+	}
+	TEST_VERIFY_EQUAL(800u, served[0]);
+	TEST_VERIFY_EQUAL(800u, served[1]);
+	/* entry that costs more than quantum waits for several rounds */
+	TEST_VERIFY_FALSE(zf_drr_flow_active(&f[1]));
+	zf_drr_flow_remove(&d, &f[0]);
+	TEST_VERIFY_TRUE(zf_drr_empty(&d));
+	zf_drr_flow_init(&d, &f[0], 1);
+	zf_drr_enqueue(&d, &f[0], &a[0].node, 250);
+	for (unsigned i = 0; 6 > i; ++i)
+	{
+		zf_drr_enqueue(&d, &f[1], &b[i].node, 50);
+	}
+	TEST_VERIFY_EQUAL(2u, zf_drr_flows(&d));
+	unsigned before = 0;
+	while (1 == test_zf_drr_next(&d, &p))
+	{
+		++before;
+	}
+	TEST_VERIFY_EQUAL(&f[0], p);
+	TEST_VERIFY_EQUAL(4u, before);
+	TEST_VERIFY_EQUAL(1u, zf_drr_flows(&d));
+}
+
+static void test_zf_drr_idle()
+{
+	drr_test_entry a[3];
+	zf_drr d;
+	zf_drr_flow f1, f2;
+	zf_drr_init(&d, 10);
+	zf_drr_flow_init(&d, &f1, 1);
+	zf_drr_flow_init(&d, &f2, 3);
+	a[0].key = 0;
+	a[1].key = 1;
+	a[2].key = 2;
+	zf_drr_enqueue(&d, &f1, &a[0].node, 4);
+	TEST_VERIFY_EQUAL(10u, f1.deficit);
+	TEST_VERIFY_EQUAL(0u, test_zf_drr_next(&d, 0));
+	TEST_VERIFY_FALSE(zf_drr_flow_active(&f1));
+	/* flow that becomes active again starts with fresh quantum */
+	zf_drr_enqueue(&d, &f2, &a[1].node, 1);
+	zf_drr_enqueue(&d, &f1, &a[2].node, 1);
+	TEST_VERIFY_EQUAL(10u, f1.deficit);
+	TEST_VERIFY_EQUAL(30u, f2.deficit);
+	TEST_VERIFY_EQUAL(2u, zf_drr_flows(&d));
+	TEST_VERIFY_EQUAL(1u, test_zf_drr_next(&d, 0));
+	TEST_VERIFY_EQUAL(1u, zf_drr_flows(&d));
+	zf_drr_flow_set_weight(&d, &f1, 2);
+	TEST_VERIFY_EQUAL(20u, f1.quantum);
+	TEST_VERIFY_EQUAL(2u, test_zf_drr_next(&d, 0));
+	TEST_VERIFY_TRUE(zf_drr_empty(&d));
+}
+
+static void test_zf_drr_quantum()
+{
+	drr_test_entry a[2];
+	zf_drr d;
+	zf_drr_flow f1, f2;
+	/* zero quantum or weight would make dequeue spin forever */
+	zf_drr_init(&d, 0);
+	TEST_VERIFY_EQUAL(1u, d.quantum);
+	zf_drr_flow_init(&d, &f1, 0);
+	TEST_VERIFY_EQUAL(1u, f1.quantum);
+	a[0].key = 0;
+	zf_drr_enqueue(&d, &f1, &a[0].node, 3);
+	TEST_VERIFY_EQUAL(0u, test_zf_drr_next(&d, 0));
+	/* quantum * weight is clamped, deficit saturates */
+	zf_drr_init(&d, 0x10000u);
+	zf_drr_flow_init(&d, &f2, 0x10000u);
+	TEST_VERIFY_EQUAL(0xffffffffu, f2.quantum);
+	zf_drr_flow_set_weight(&d, &f1, 0);
+	TEST_VERIFY_EQUAL(0x10000u, f1.quantum);
+	a[1].key = 1;
+	zf_drr_enqueue(&d, &f2, &a[0].node, 0xffffffffu);
+	zf_drr_enqueue(&d, &f2, &a[1].node, 0xffffffffu);
+	TEST_VERIFY_EQUAL(0u, test_zf_drr_next(&d, 0));
+	TEST_VERIFY_EQUAL(1u, test_zf_drr_next(&d, 0));
+	TEST_VERIFY_TRUE(zf_drr_empty(&d));
+}
+
+#ifdef __cplusplus
+static void test_zf_drr_cpp()
+{
+	drr_test_entry a[2];
+	zf_drr d;
+	zf_drr_flow f, *p = 0;
+	zf_drr_init(&d, 1);
+	zf_drr_flow_init(&d, &f, 1);
+	zf_drr_enqueue_<drr_test_entry, &drr_test_entry::node>(&d, &f, &a[0], 1);
+	zf_drr_enqueue_<drr_test_entry, &drr_test_entry::node>(&d, &f, &a[1], 1);
+	TEST_VERIFY_EQUAL(&a[0], (zf_drr_dequeue_<drr_test_entry,
+							  &drr_test_entry::node>(&d, &p)));
+	TEST_VERIFY_EQUAL(&f, p);
+	TEST_VERIFY_EQUAL(&a[1], (zf_drr_dequeue_<drr_test_entry,
+							  &drr_test_entry::node>(&d)));
+	TEST_VERIFY_TRUE((0 == zf_drr_dequeue_<drr_test_entry,
+					  &drr_test_entry::node>(&d)));
+}
+#endif
+
+static void test_zf_drr_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_drr_weights());
+	TEST_EXECUTE(test_zf_drr_cost());
+	TEST_EXECUTE(test_zf_drr_idle());
+	TEST_EXECUTE(test_zf_drr_quantum());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_drr_cpp());
+#endif
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#if defined(__cplusplus)
+#include "zf_test.hpp"
+#else
+#include "zf_test.h"
+#endif
+#include "zf_heap.h"
+
+typedef struct heap_test_entry
+{
+	unsigned key;
+	zf_heap_node node;
+}
+heap_test_entry;
+
+static heap_test_entry *test_zf_heap_entry(zf_heap_node *const n)
+{
+	return zf_entry(n, heap_test_entry, node);
+}
+
+static int test_zf_heap_cmp(zf_heap_node *const a, zf_heap_node *const b,
+							void *const ctx)
+{
+	const unsigned ka = test_zf_heap_entry(a)->key;
+	const unsigned kb = test_zf_heap_entry(b)->key;
+	(void)ctx;
+	return ka < kb? -1: ka > kb? 1: 0;
+}
+
+/* heap order and back references of all nodes */
+static void test_zf_heap_verify(zf_heap *const h, const unsigned arity)
+{
+	for (size_t i = 0; h->count > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(i, h->nodes[i]->index);
+		if (0 < i)
+		{
+			TEST_VERIFY_TRUE(test_zf_heap_entry(h->nodes[(i - 1) / arity])->key <=
+							 test_zf_heap_entry(h->nodes[i])->key);
+		}
+	}
+}
+
+static void test_zf_heap_pop_sorted(zf_heap *const h, const unsigned count)
+{
+	unsigned last = 0;
+	for (unsigned i = 0; count > i; ++i)
+	{
+		zf_heap_node *const n = zf_heap_pop(h);
+		TEST_VERIFY_TRUE(0 != n);
+		TEST_VERIFY_FALSE(zf_heap_linked(n));
+		TEST_VERIFY_TRUE(last <= test_zf_heap_entry(n)->key);
+		last = test_zf_heap_entry(n)->key;
+	}
+	TEST_VERIFY_TRUE(zf_heap_empty(h));
+	TEST_VERIFY_TRUE(0 == zf_heap_pop(h));
+}
+
+static void test_zf_heap_insert_pop()
+{
+	heap_test_entry a[64];
+	zf_heap_node *nodes[64];
+	zf_heap h;
+	zf_heap_init(&h, nodes, 64, test_zf_heap_cmp, 0);
+	TEST_VERIFY_TRUE(zf_heap_empty(&h));
+	TEST_VERIFY_TRUE(0 == zf_heap_top(&h));
+	for (unsigned i = 0; 64 > i; ++i)
+	{
+		/* with duplicates */
+		a[i].key = (i * 37) % 50;
+		zf_heap_node_init(&a[i].node);
+		TEST_VERIFY_FALSE(zf_heap_linked(&a[i].node));
+		TEST_VERIFY_TRUE(zf_heap_insert(&h, &a[i].node));
+		TEST_VERIFY_TRUE(zf_heap_linked(&a[i].node));
+	}
+	test_zf_heap_verify(&h, ZF_HEAP_ARITY);
+	TEST_VERIFY_EQUAL(64u, zf_heap_count(&h));
+	TEST_VERIFY_EQUAL(0u, test_zf_heap_entry(zf_heap_top(&h))->key);
+	test_zf_heap_pop_sorted(&h, 64);
+}
+
+static void test_zf_heap_remove_update()
+{
+	heap_test_entry a[32];
+	zf_heap_node *nodes[32];
+	zf_heap h;
+	zf_heap_init(&h, nodes, 32, test_zf_heap_cmp, 0);
+	for (unsigned i = 0; 32 > i; ++i)
+	{
+		a[i].key = 100 + (i * 7) % 32;
+		zf_heap_insert(&h, &a[i].node);
+	}
+	/* cancel */
+	zf_heap_remove(&h, &a[5].node);
+	zf_heap_remove(&h, &a[31].node);
+	TEST_VERIFY_FALSE(zf_heap_linked(&a[5].node));
+	TEST_VERIFY_EQUAL(30u, zf_heap_count(&h));
+	test_zf_heap_verify(&h, ZF_HEAP_ARITY);
+	/* reschedule earlier and later */
+	a[20].key = 1;
+	zf_heap_update(&h, &a[20].node);
+	test_zf_heap_verify(&h, ZF_HEAP_ARITY);
+	TEST_VERIFY_EQUAL(&a[20].node, zf_heap_top(&h));
+	a[20].key = 1000;
+	zf_heap_update(&h, &a[20].node);
+	a[0].key = 500;
+	zf_heap_update(&h, &a[0].node);
+	test_zf_heap_verify(&h, ZF_HEAP_ARITY);
+	/* cancel of the last node */
+	zf_heap_remove(&h, h.nodes[h.count - 1]);
+	test_zf_heap_verify(&h, ZF_HEAP_ARITY);
+	test_zf_heap_pop_sorted(&h, 29);
+}
+
+static void test_zf_heap_full()
+{
+	heap_test_entry a[4];
+	zf_heap_node *small[2], *large[4];
+	zf_heap h;
+	zf_heap_init(&h, small, 2, test_zf_heap_cmp, 0);
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].key = 4 - i;
+	}
+	TEST_VERIFY_TRUE(zf_heap_insert(&h, &a[0].node));
+	TEST_VERIFY_TRUE(zf_heap_insert(&h, &a[1].node));
+	TEST_VERIFY_FALSE(zf_heap_insert(&h, &a[2].node));
+	zf_heap_reserve(&h, large, 4);
+	TEST_VERIFY_TRUE(zf_heap_insert(&h, &a[2].node));
+	TEST_VERIFY_TRUE(zf_heap_insert(&h, &a[3].node));
+	TEST_VERIFY_TRUE(large == h.nodes);
+	test_zf_heap_verify(&h, ZF_HEAP_ARITY);
+	TEST_VERIFY_EQUAL(&a[3].node, zf_heap_pop(&h));
+	test_zf_heap_pop_sorted(&h, 3);
+}
+
+#ifdef __cplusplus
+struct heap_test_less
+{
+	bool operator()(const heap_test_entry *a, const heap_test_entry *b) const
+	{
+		return a->key < b->key;
+	}
+};
+
+template <unsigned arity>
+static void test_zf_heap_arity_()
+{
+	typedef zf_heap_<heap_test_entry, &heap_test_entry::node,
+					 heap_test_less, arity> heap;
+	heap_test_entry a[100];
+	zf_heap_node *nodes[100];
+	heap h(nodes, 100);
+	for (unsigned i = 0; 100 > i; ++i)
+	{
+		a[i].key = 1 + (i * 61) % 100;
+		TEST_VERIFY_TRUE(zf_heap_insert_(&h, &a[i]));
+	}
+	test_zf_heap_verify(&h, arity);
+	TEST_VERIFY_EQUAL(1u, zf_heap_top_(&h)->key);
+	zf_heap_remove_(&h, &a[10]);
+	a[50].key = 1000;
+	zf_heap_update_(&h, &a[50]);
+	a[51].key = 0;
+	zf_heap_update_(&h, &a[51]);
+	test_zf_heap_verify(&h, arity);
+	TEST_VERIFY_EQUAL(&a[51], zf_heap_pop_(&h));
+	unsigned last = 0;
+	for (unsigned i = 0; 98 > i; ++i)
+	{
+		heap_test_entry *const e = zf_heap_pop_(&h);
+		TEST_VERIFY_TRUE(last <= e->key);
+		last = e->key;
+	}
+	TEST_VERIFY_EQUAL(1000u, last);
+	TEST_VERIFY_TRUE(0 == zf_heap_pop_(&h));
+}
+
+static void test_zf_heap_cpp()
+{
+	test_zf_heap_arity_<2>();
+	test_zf_heap_arity_<3>();
+	test_zf_heap_arity_<4>();
+	test_zf_heap_arity_<8>();
+}
+#endif
+
+static void test_zf_heap_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_heap_insert_pop());
+	TEST_EXECUTE(test_zf_heap_remove_update());
+	TEST_EXECUTE(test_zf_heap_full());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_heap_cpp());
+#endif
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#if defined(__cplusplus)
+#include "zf_test.hpp"
+#else
+#include "zf_test.h"
+#endif
+#include "zf_interval_tree.h"
+
+typedef struct interval_tree_test_entry
+{
+	unsigned id;
+	bool linked;
+	zf_interval_node node;
+}
+interval_tree_test_entry;
+
+/* checks order, parent links, subtree max and red-black properties, returns
+ * black height of the subtree */
+static unsigned test_zf_interval_tree_verify_node(zf_interval_node *const n,
+												  size_t *const count)
+{
+	if (0 == n)
+	{
+		return 1;
+	}
+	++*count;
+	uint64_t max = n->last;
+	TEST_VERIFY_TRUE(n->start <= n->last);
+	if (0 != n->left)
+	{
+		TEST_VERIFY_EQUAL(n, n->left->parent);
+		TEST_VERIFY_TRUE(n->left->start <= n->start);
+		TEST_VERIFY_FALSE(n->red && n->left->red);
+		max = max < n->left->max? n->left->max: max;
+	}
+	if (0 != n->right)
+	{
+		TEST_VERIFY_EQUAL(n, n->right->parent);
+		TEST_VERIFY_TRUE(n->right->start >= n->start);
+		TEST_VERIFY_FALSE(n->red && n->right->red);
+		max = max < n->right->max? n->right->max: max;
+	}
+	TEST_VERIFY_EQUAL(max, n->max);
+	const unsigned lh = test_zf_interval_tree_verify_node(n->left, count);
+	const unsigned rh = test_zf_interval_tree_verify_node(n->right, count);
+	TEST_VERIFY_EQUAL(lh, rh);
+	return lh + (n->red? 0: 1);
+}
+
+static void test_zf_interval_tree_verify(zf_interval_tree *const t)
+{
+	size_t count = 0;
+	if (0 != t->root)
+	{
+		TEST_VERIFY_TRUE(0 == t->root->parent);
+		TEST_VERIFY_FALSE(t->root->red);
+	}
+	test_zf_interval_tree_verify_node(t->root, &count);
+	TEST_VERIFY_EQUAL(t->count, count);
+}
+
+/* query result must match linear scan over linked entries, in start order */
+static void test_zf_interval_tree_query(zf_interval_tree *const t,
+										interval_tree_test_entry *const a,
+										const unsigned n,
+										const uint64_t start, const uint64_t last)
+{
+	unsigned expected = 0, found = 0;
+	for (unsigned i = 0; n > i; ++i)
+	{
+		if (a[i].linked && a[i].node.start <= last && start <= a[i].node.last)
+		{
+			++expected;
+		}
+	}
+	uint64_t prev = 0;
+	zf_interval_tree_foreach_overlap(t, start, last, it)
+	{
+		TEST_VERIFY_TRUE(it->start <= last && start <= it->last);
+		TEST_VERIFY_TRUE(prev <= it->start);
+		TEST_VERIFY_TRUE(zf_entry(it, interval_tree_test_entry, node)->linked);
+		prev = it->start;
+		++found;
+	}
+	TEST_VERIFY_EQUAL(expected, found);
+}
+
+static void test_zf_interval_tree_basic()
+{
+	interval_tree_test_entry a[4];
+	zf_interval_tree t;
+	zf_interval_tree_init(&t);
+	TEST_VERIFY_TRUE(zf_interval_tree_empty(&t));
+	TEST_VERIFY_TRUE(0 == zf_interval_tree_stab(&t, 0));
+	zf_interval_tree_insert(&t, &a[0].node, 10, 20);
+	zf_interval_tree_insert(&t, &a[1].node, 15, 15);
+	zf_interval_tree_insert(&t, &a[2].node, 30, 40);
+	zf_interval_tree_insert(&t, &a[3].node, 0, 100);
+	test_zf_interval_tree_verify(&t);
+	TEST_VERIFY_EQUAL(4u, zf_interval_tree_count(&t));
+	TEST_VERIFY_EQUAL(100u, t.root->max);
+	/* intervals are closed */
+	TEST_VERIFY_EQUAL(&a[3].node, zf_interval_tree_stab(&t, 20));
+	zf_interval_node *n = zf_interval_tree_first(&t, 20, 30);
+	TEST_VERIFY_EQUAL(&a[3].node, n);
+	n = zf_interval_tree_next(n, 20, 30);
+	TEST_VERIFY_EQUAL(&a[0].node, n);
+	n = zf_interval_tree_next(n, 20, 30);
+	TEST_VERIFY_EQUAL(&a[2].node, n);
+	TEST_VERIFY_TRUE(0 == zf_interval_tree_next(n, 20, 30));
+	zf_interval_tree_remove(&t, &a[3].node);
+	test_zf_interval_tree_verify(&t);
+	TEST_VERIFY_EQUAL(40u, t.root->max);
+	TEST_VERIFY_TRUE(0 == zf_interval_tree_stab(&t, 25));
+	TEST_VERIFY_TRUE(0 == zf_interval_tree_first(&t, 41, 1000));
+	n = zf_interval_tree_first(&t, 14, 15);
+	TEST_VERIFY_EQUAL(&a[0].node, n);
+	TEST_VERIFY_EQUAL(&a[1].node, zf_interval_tree_next(n, 14, 15));
+	zf_interval_tree_remove(&t, &a[0].node);
+	zf_interval_tree_remove(&t, &a[1].node);
+	zf_interval_tree_remove(&t, &a[2].node);
+	TEST_VERIFY_TRUE(zf_interval_tree_empty(&t));
+}
+
+static void test_zf_interval_tree_random()
+{
+	interval_tree_test_entry a[300];
+	zf_interval_tree t;
+	zf_interval_tree_init(&t);
+	unsigned seed = 12345;
+	for (unsigned i = 0; 300 > i; ++i)
+	{
+		/* with duplicate starts */
+		seed = seed * 1103515245u + 12345u;
+		const uint64_t start = (seed >> 8) % 1000;
+		seed = seed * 1103515245u + 12345u;
+		const uint64_t length = 0 == i % 7? 0: (seed >> 8) % 50;
+		a[i].id = i;
+		a[i].linked = true;
+		zf_interval_tree_insert(&t, &a[i].node, start, start + length);
+	}
+	test_zf_interval_tree_verify(&t);
+	for (uint64_t q = 0; 1100 > q; q += 37)
+	{
+		test_zf_interval_tree_query(&t, a, 300, q, q);
+		test_zf_interval_tree_query(&t, a, 300, q, q + 25);
+	}
+	/* remove every other entry, then the rest in random order */
+	for (unsigned i = 0; 300 > i; i += 2)
+	{
+		zf_interval_tree_remove(&t, &a[i].node);
+		a[i].linked = false;
+	}
+	test_zf_interval_tree_verify(&t);
+	for (uint64_t q = 0; 1100 > q; q += 29)
+	{
+		test_zf_interval_tree_query(&t, a, 300, q, q + 10);
+	}
+	for (unsigned k = 0; 300 > k; ++k)
+	{
+		const unsigned i = (k * 151) % 300;
+		if (a[i].linked)
+		{
+			zf_interval_tree_remove(&t, &a[i].node);
+			a[i].linked = false;
+			if (0 == k % 16)
+			{
+				test_zf_interval_tree_verify(&t);
+				test_zf_interval_tree_query(&t, a, 300, k, k + 100);
+			}
+		}
+	}
+	TEST_VERIFY_TRUE(zf_interval_tree_empty(&t));
+	TEST_VERIFY_EQUAL(0u, zf_interval_tree_count(&t));
+}
+
+#ifdef __cplusplus
+struct interval_tree_test_visitor
+{
+	unsigned *ids;
+	void operator()(interval_tree_test_entry *e) { *ids = *ids * 10 + e->id + 1; }
+};
+
+static void test_zf_interval_tree_cpp()
+{
+	typedef interval_tree_test_entry entry;
+	entry a[3];
+	zf_interval_tree_<entry, &entry::node> t;
+	for (unsigned i = 0; 3 > i; ++i)
+	{
+		a[i].id = i;
+		zf_interval_tree_insert_(&t, &a[i], 10 * i, 10 * i + 15);
+	}
+	TEST_VERIFY_EQUAL(&a[1], zf_interval_tree_stab_(&t, 22));
+	TEST_VERIFY_EQUAL(&a[0], zf_interval_tree_first_(&t, 12, 20));
+	TEST_VERIFY_EQUAL(&a[1], zf_interval_tree_next_(&t, &a[0], 12, 20));
+	TEST_VERIFY_EQUAL(&a[2], zf_interval_tree_next_(&t, &a[1], 12, 20));
+	TEST_VERIFY_TRUE(0 == zf_interval_tree_next_(&t, &a[2], 12, 20));
+	zf_interval_tree_remove_(&t, &a[1]);
+	unsigned ids = 0;
+	interval_tree_test_visitor v = {&ids};
+	TEST_VERIFY_EQUAL(2u, zf_interval_tree_foreach_overlap_(&t, 12, 20, v));
+	TEST_VERIFY_EQUAL(13u, ids);
+}
+#endif
+
+static void test_zf_interval_tree_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_interval_tree_basic());
+	TEST_EXECUTE(test_zf_interval_tree_random());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_interval_tree_cpp());
+#endif
+}
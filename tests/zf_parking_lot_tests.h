@@ -0,0 +1,218 @@
+#pragma once
+
+#include "zf_test.hpp"
+#include "zf_parking_lot.h"
+
+#include <atomic>
+#include <thread>
+
+/* unpark thread parked on addr, waits until it is parked */
+static zf_unpark_result_ test_zf_parking_lot_unpark(const void *const addr,
+													const uintptr_t token)
+{
+	for (;;)
+	{
+		const zf_unpark_result_ r = zf_unpark_one_(addr,
+				[token](const zf_unpark_result_ &) { return token; });
+		if (r.did_unpark)
+		{
+			return r;
+		}
+		std::this_thread::yield();
+	}
+}
+
+static void test_zf_parking_lot_park()
+{
+	int word = 0;
+	/* validation fails, thread is not parked */
+	zf_park_result_ r = zf_park_(&word, []() { return false; },
+								 _zf_parking_nop);
+	TEST_VERIFY_FALSE(r.was_unparked);
+	/* deadline expires */
+	const zf_park_deadline_ deadline =
+			std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+	r = zf_park_(&word, _zf_parking_true, _zf_parking_nop, &deadline);
+	TEST_VERIFY_FALSE(r.was_unparked);
+	TEST_VERIFY_TRUE(std::chrono::steady_clock::now() >= deadline);
+	TEST_VERIFY_FALSE(zf_unpark_one_(&word));
+	/* token is passed to unparked thread */
+	std::atomic<unsigned> before_sleep(0);
+	zf_park_result_ r2 = {false, 0};
+	std::thread t([&]()
+	{
+		r2 = zf_park_(&word, _zf_parking_true, [&]() { ++before_sleep; });
+	});
+	const zf_unpark_result_ u = test_zf_parking_lot_unpark(&word, 42);
+	t.join();
+	TEST_VERIFY_FALSE(u.may_have_more);
+	TEST_VERIFY_TRUE(r2.was_unparked);
+	TEST_VERIFY_EQUAL(42u, (unsigned)r2.token);
+	TEST_VERIFY_EQUAL(1u, before_sleep.load());
+}
+
+static void test_zf_parking_lot_unpark_all()
+{
+	const unsigned count = 4;
+	int word = 0, other = 0;
+	std::atomic<unsigned> parked(0), unparked(0);
+	std::vector<std::thread> threads;
+	for (unsigned i = 0; count > i; ++i)
+	{
+		threads.emplace_back([&]()
+		{
+			const zf_park_result_ r = zf_park_(&word, _zf_parking_true,
+											   [&]() { ++parked; });
+			if (r.was_unparked)
+			{
+				++unparked;
+			}
+		});
+	}
+	while (count != parked.load())
+	{
+		std::this_thread::yield();
+	}
+	TEST_VERIFY_EQUAL(0u, (unsigned)zf_unpark_all_(&other));
+	const zf_unpark_result_ u = test_zf_parking_lot_unpark(&word, 0);
+	TEST_VERIFY_TRUE(u.may_have_more);
+	TEST_VERIFY_EQUAL(count - 1, (unsigned)zf_unpark_all_(&word));
+	for (std::thread &t: threads)
+	{
+		t.join();
+	}
+	TEST_VERIFY_EQUAL(count, unparked.load());
+}
+
+static void test_zf_parking_lot_mutex()
+{
+	TEST_VERIFY_EQUAL(1u, (unsigned)sizeof(zf_mutex_));
+	TEST_VERIFY_EQUAL(1u, (unsigned)sizeof(zf_condvar_));
+	const unsigned threads_count = 8;
+	const unsigned count = 20000;
+	zf_mutex_ m;
+	unsigned value = 0;
+	TEST_VERIFY_TRUE(m.try_lock());
+	TEST_VERIFY_FALSE(m.try_lock());
+	m.unlock();
+	std::vector<std::thread> threads;
+	for (unsigned i = 0; threads_count > i; ++i)
+	{
+		threads.emplace_back([&]()
+		{
+			for (unsigned k = 0; count > k; ++k)
+			{
+				std::lock_guard<zf_mutex_> l(m);
+				++value;
+			}
+		});
+	}
+	for (std::thread &t: threads)
+	{
+		t.join();
+	}
+	TEST_VERIFY_EQUAL(threads_count * count, value);
+	TEST_VERIFY_TRUE(m.try_lock());
+	m.unlock();
+}
+
+static void test_zf_parking_lot_condvar()
+{
+	zf_mutex_ m;
+	zf_condvar_ cv;
+	unsigned queue = 0, consumed = 0;
+	bool done = false;
+	const unsigned count = 10000;
+	std::thread consumer([&]()
+	{
+		std::unique_lock<zf_mutex_> l(m);
+		for (;;)
+		{
+			cv.wait(l, [&]() { return 0 != queue || done; });
+			if (0 == queue)
+			{
+				break;
+			}
+			--queue;
+			++consumed;
+		}
+	});
+	for (unsigned i = 0; count > i; ++i)
+	{
+		std::lock_guard<zf_mutex_> l(m);
+		++queue;
+		cv.notify_one();
+	}
+	{
+		std::lock_guard<zf_mutex_> l(m);
+		done = true;
+	}
+	cv.notify_all();
+	consumer.join();
+	TEST_VERIFY_EQUAL(count, consumed);
+	/* timeout */
+	std::unique_lock<zf_mutex_> l(m);
+	const zf_park_deadline_ deadline =
+			std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+	TEST_VERIFY_FALSE(cv.wait_until(l, deadline));
+	TEST_VERIFY_TRUE(l.owns_lock());
+}
+
+static void test_zf_parking_lot_condvar_waiters()
+{
+	/* first woken waiter leaves, the rest must still be woken by notify_all()
+	 * (waiters flag must not be lost while another thread is about to park)
+	 */
+	const unsigned waiters_count = 3;
+	const unsigned rounds = 1000;
+	for (unsigned round = 0; rounds > round; ++round)
+	{
+		zf_mutex_ m;
+		zf_condvar_ cv;
+		unsigned tokens = 0, taken = 0;
+		bool done = false;
+		std::vector<std::thread> threads;
+		for (unsigned i = 0; waiters_count > i; ++i)
+		{
+			threads.emplace_back([&]()
+			{
+				std::unique_lock<zf_mutex_> l(m);
+				cv.wait(l, [&]() { return 0 != tokens || done; });
+				if (0 != tokens)
+				{
+					--tokens;
+					++taken;
+				}
+			});
+		}
+		{
+			std::lock_guard<zf_mutex_> l(m);
+			tokens = 1;
+		}
+		cv.notify_one();
+		{
+			std::lock_guard<zf_mutex_> l(m);
+			done = true;
+		}
+		cv.notify_all();
+		for (std::thread &t: threads)
+		{
+			t.join();
+		}
+		TEST_VERIFY_EQUAL(1u, taken);
+	}
+}
+
+static void test_zf_parking_lot(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_parking_lot_park());
+	TEST_EXECUTE(test_zf_parking_lot_unpark_all());
+	TEST_EXECUTE(test_zf_parking_lot_mutex());
+	TEST_EXECUTE(test_zf_parking_lot_condvar());
+	TEST_EXECUTE(test_zf_parking_lot_condvar_waiters());
+}
+
+static void test_zf_parking_lot_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE_SUITE(test_zf_parking_lot);
+}
@@ -0,0 +1,82 @@
+# Compiles SOURCE to assembly and verifies that functions NAME_c and NAME_cpp
+# have the same instructions (up to local label names) for each NAME in NAMES.
+# Identical functions must not be merged by the compiler (e.g. GCC needs
+# -fno-ipa-icf), otherwise one of them becomes a jump to the other.
+# Usage:
+#   cmake -DCOMPILER=... -DFLAGS=... -DSOURCE=... -DNAMES=a,b -P this_file
+
+separate_arguments(flags UNIX_COMMAND "${FLAGS}")
+execute_process(
+	COMMAND ${COMPILER} ${flags} -S -o - ${SOURCE}
+	OUTPUT_VARIABLE asm
+	ERROR_VARIABLE err
+	RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+	message(FATAL_ERROR "compilation failed:\n${err}")
+endif()
+
+# returns instructions of function name in out_var
+function(extract_function name out_var)
+	string(REGEX MATCH "\n_?${name}:\n(.*)" tail "${asm}")
+	if(NOT tail)
+		message(FATAL_ERROR "function ${name} not found")
+	endif()
+	string(REGEX REPLACE "^\n_?${name}:\n" "" tail "${tail}")
+	string(REPLACE ";" "\;" tail "${tail}")
+	string(REPLACE "\n" ";" lines "${tail}")
+	set(body "")
+	foreach(line IN LISTS lines)
+		string(STRIP "${line}" line)
+		if(line MATCHES "^\\.cfi_endproc" OR line MATCHES "^\\.size" OR
+		   line MATCHES "^\\.seh_endproc" OR line MATCHES "^\\.end")
+			break()
+		endif()
+		# skip directives, keep local labels and instructions
+		if(line STREQUAL "" OR line MATCHES "^\\.(cfi|p2align|align|loc)")
+			continue()
+		endif()
+		string(REGEX REPLACE "\\.L[A-Za-z_]*[0-9]+" ".L" line "${line}")
+		string(REGEX REPLACE "[ \t]+" " " line "${line}")
+		list(APPEND body "${line}")
+	endforeach()
+	set(${out_var} "${body}" PARENT_SCOPE)
+endfunction()
+
+# returns number of instructions (lines that are not labels) in out_var
+function(count_instructions body out_var)
+	set(count 0)
+	foreach(line IN LISTS body)
+		if(NOT line MATCHES ":$")
+			math(EXPR count "${count} + 1")
+		endif()
+	endforeach()
+	set(${out_var} ${count} PARENT_SCOPE)
+endfunction()
+
+# Instruction sequences must match up to register allocation, fails only when
+# C++ version has more instructions than C one.
+string(REPLACE "," ";" names "${NAMES}")
+set(failed "")
+foreach(name IN LISTS names)
+	extract_function(${name}_c c_body)
+	extract_function(${name}_cpp cpp_body)
+	count_instructions("${c_body}" c_count)
+	count_instructions("${cpp_body}" cpp_count)
+	if(c_body STREQUAL cpp_body)
+		message(STATUS "${name}: same code, ${c_count} instructions")
+		continue()
+	endif()
+	string(REPLACE ";" "\n\t" c_text "${c_body}")
+	string(REPLACE ";" "\n\t" cpp_text "${cpp_body}")
+	set(text "${name}: code differs (C: ${c_count} instructions, C++: "
+		"${cpp_count} instructions)\nC:\n\t${c_text}\nC++:\n\t${cpp_text}")
+	if(cpp_count GREATER c_count)
+		message(SEND_ERROR ${text})
+		list(APPEND failed ${name})
+	else()
+		message(STATUS ${text})
+	endif()
+endforeach()
+if(failed)
+	message(FATAL_ERROR "C++ wrappers add overhead in: ${failed}")
+endif()
@@ -0,0 +1,274 @@
+/* Pairs of functions that must compile to the same instructions: code written
+ * with C functions (suffix _c) and the same code written with C++ iterators and
+ * wrappers (suffix _cpp). Checked by zf_queue_codegen.cmake at several
+ * optimization levels, not executed. New pairs go to ZF_QUEUE_CODEGEN_NAMES in
+ * CMakeLists.txt.
+ */
+#include "zf_queue.h"
+#include "zf_snapshot.h"
+#include <stddef.h>
+
+struct codegen_entry
+{
+	unsigned value;
+	zf_slist_node snode;
+	zf_list_node lnode;
+	zf_stailq_node sqnode;
+	zf_tailq_node tqnode;
+};
+
+typedef zf_slist_head_t(codegen_entry, snode) codegen_slist;
+typedef zf_list_head_t(codegen_entry, lnode) codegen_list;
+typedef zf_stailq_head_t(codegen_entry, sqnode) codegen_stailq;
+typedef zf_tailq_head_t(codegen_entry, tqnode) codegen_tailq;
+
+struct codegen_sum
+{
+	unsigned *sum;
+	void operator()(codegen_entry *const e) const { *sum += e->value; }
+};
+
+extern "C"
+{
+
+unsigned zf_codegen_slist_c(codegen_slist *const h)
+{
+	unsigned sum = 0;
+	for (zf_slist_node *n = zf_slist_begin(h); zf_slist_end(h) != n;
+		 n = zf_slist_next(n))
+	{
+		sum += zf_entry(n, codegen_entry, snode)->value;
+	}
+	return sum;
+}
+
+unsigned zf_codegen_slist_cpp(codegen_slist *const h)
+{
+	unsigned sum = 0;
+	for (codegen_slist::iterator i = h->begin(); h->end() != i; ++i)
+	{
+		sum += i->value;
+	}
+	return sum;
+}
+
+unsigned zf_codegen_list_c(codegen_list *const h)
+{
+	unsigned sum = 0;
+	for (zf_list_node *n = zf_list_begin(h); zf_list_end(h) != n;
+		 n = zf_list_next(n))
+	{
+		sum += zf_entry(n, codegen_entry, lnode)->value;
+	}
+	return sum;
+}
+
+unsigned zf_codegen_list_cpp(codegen_list *const h)
+{
+	unsigned sum = 0;
+	for (codegen_list::iterator i = h->begin(); h->end() != i; ++i)
+	{
+		sum += i->value;
+	}
+	return sum;
+}
+
+unsigned zf_codegen_stailq_c(codegen_stailq *const h)
+{
+	unsigned sum = 0;
+	for (zf_stailq_node *n = zf_stailq_begin(h); zf_stailq_end(h) != n;
+		 n = zf_stailq_next(n))
+	{
+		sum += zf_entry(n, codegen_entry, sqnode)->value;
+	}
+	return sum;
+}
+
+unsigned zf_codegen_stailq_cpp(codegen_stailq *const h)
+{
+	unsigned sum = 0;
+	for (codegen_stailq::iterator i = h->begin(); h->end() != i; ++i)
+	{
+		sum += i->value;
+	}
+	return sum;
+}
+
+unsigned zf_codegen_tailq_c(codegen_tailq *const h)
+{
+	unsigned sum = 0;
+	for (zf_tailq_node *n = zf_tailq_begin(h); zf_tailq_end(h) != n;
+		 n = zf_tailq_next(n))
+	{
+		sum += zf_entry(n, codegen_entry, tqnode)->value;
+	}
+	return sum;
+}
+
+unsigned zf_codegen_tailq_cpp(codegen_tailq *const h)
+{
+	unsigned sum = 0;
+	for (codegen_tailq::iterator i = h->begin(); h->end() != i; ++i)
+	{
+		sum += i->value;
+	}
+	return sum;
+}
+
+/* default (fast) link policy adds nothing to removal */
+void zf_codegen_list_remove_c(codegen_list *const, codegen_entry *const e)
+{
+	zf_list_remove(&e->lnode);
+}
+
+void zf_codegen_list_remove_cpp(codegen_list *const h, codegen_entry *const e)
+{
+	zf_list_remove_(h, e);
+}
+
+void zf_codegen_tailq_remove_c(codegen_tailq *const h, codegen_entry *const e)
+{
+	zf_tailq_remove(h, &e->tqnode);
+}
+
+void zf_codegen_tailq_remove_cpp(codegen_tailq *const h, codegen_entry *const e)
+{
+	zf_tailq_remove_(h, e);
+}
+
+/* zf_entry_() must fold member pointer into a constant offset */
+unsigned zf_codegen_entry_c(zf_tailq_node *const n)
+{
+	return zf_entry(n, codegen_entry, tqnode)->value;
+}
+
+unsigned zf_codegen_entry_cpp(zf_tailq_node *const n)
+{
+	return zf_entry_(n, &codegen_entry::tqnode)->value;
+}
+
+void zf_codegen_slist_insert_c(codegen_slist *const h, codegen_entry *const a,
+							   codegen_entry *const b)
+{
+	zf_slist_insert_head(h, &a->snode);
+	zf_slist_insert_after(&a->snode, &b->snode);
+}
+
+void zf_codegen_slist_insert_cpp(codegen_slist *const h, codegen_entry *const a,
+								 codegen_entry *const b)
+{
+	zf_slist_insert_head_(h, a);
+	zf_slist_insert_after_(h, a, b);
+}
+
+void zf_codegen_list_insert_c(codegen_list *const h, codegen_entry *const a,
+							  codegen_entry *const b, codegen_entry *const c)
+{
+	zf_list_insert_head(h, &a->lnode);
+	zf_list_insert_after(&a->lnode, &b->lnode);
+	zf_list_insert_before(&a->lnode, &c->lnode);
+}
+
+void zf_codegen_list_insert_cpp(codegen_list *const h, codegen_entry *const a,
+								codegen_entry *const b, codegen_entry *const c)
+{
+	zf_list_insert_head_(h, a);
+	zf_list_insert_after_(h, a, b);
+	zf_list_insert_before_(h, a, c);
+}
+
+void zf_codegen_tailq_insert_c(codegen_tailq *const h, codegen_entry *const a,
+							   codegen_entry *const b, codegen_entry *const c)
+{
+	zf_tailq_insert_head(h, &a->tqnode);
+	zf_tailq_insert_tail(h, &b->tqnode);
+	zf_tailq_insert_after(h, &a->tqnode, &c->tqnode);
+}
+
+void zf_codegen_tailq_insert_cpp(codegen_tailq *const h, codegen_entry *const a,
+								 codegen_entry *const b, codegen_entry *const c)
+{
+	zf_tailq_insert_head_(h, a);
+	zf_tailq_insert_tail_(h, b);
+	zf_tailq_insert_after_(h, a, c);
+}
+
+/* hot loop: move all entries to the head of other queue (reverses order) */
+void zf_codegen_tailq_drain_c(codegen_tailq *const h, codegen_tailq *const h2)
+{
+	while (!zf_tailq_empty(h))
+	{
+		zf_tailq_node *const n = zf_tailq_first(h);
+		zf_entry(n, codegen_entry, tqnode)->value += 1;
+		zf_tailq_remove(h, n);
+		zf_tailq_insert_head(h2, n);
+	}
+}
+
+void zf_codegen_tailq_drain_cpp(codegen_tailq *const h, codegen_tailq *const h2)
+{
+	while (!zf_tailq_empty(h))
+	{
+		codegen_entry *const e = zf_tailq_first_(h);
+		e->value += 1;
+		zf_tailq_remove_(h, e);
+		zf_tailq_insert_head_(h2, e);
+	}
+}
+
+/* hot loop: FIFO that moves entries from one queue to the tail of another */
+void zf_codegen_stailq_drain_c(codegen_stailq *const h,
+							   codegen_stailq *const h2)
+{
+	while (!zf_stailq_empty(h))
+	{
+		zf_stailq_node *const n = zf_stailq_first(h);
+		zf_entry(n, codegen_entry, sqnode)->value += 1;
+		zf_stailq_remove_head(h);
+		zf_stailq_insert_tail(h2, n);
+	}
+}
+
+void zf_codegen_stailq_drain_cpp(codegen_stailq *const h,
+								 codegen_stailq *const h2)
+{
+	while (!zf_stailq_empty(h))
+	{
+		codegen_entry *const e = zf_stailq_first_(h);
+		e->value += 1;
+		zf_stailq_remove_head(h);
+		zf_stailq_insert_tail_(h2, e);
+	}
+}
+
+/* offsets of wrappers that take member pointer must fold to constants too */
+unsigned zf_codegen_tailq_prefetch_c(codegen_tailq *const h)
+{
+	unsigned sum = 0;
+	zf_tailq_foreach_prefetch(h, n, 4, (ptrdiff_t)offsetof(codegen_entry, value) -
+							  (ptrdiff_t)offsetof(codegen_entry, tqnode))
+	{
+		sum += zf_entry(n, codegen_entry, tqnode)->value;
+	}
+	return sum;
+}
+
+unsigned zf_codegen_tailq_prefetch_cpp(codegen_tailq *const h)
+{
+	unsigned sum = 0;
+	const codegen_sum f = {&sum};
+	zf_tailq_foreach_prefetch_<4>(h, f, offsetof(codegen_entry, value));
+	return sum;
+}
+
+size_t zf_codegen_snapshot_c(zf_snapshot *const s, codegen_tailq *const h)
+{
+	return zf_snapshot_tailq(s, h, offsetof(codegen_entry, tqnode));
+}
+
+size_t zf_codegen_snapshot_cpp(zf_snapshot *const s, codegen_tailq *const h)
+{
+	return zf_snapshot_tailq_(s, h);
+}
+
+}
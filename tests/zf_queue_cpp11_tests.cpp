@@ -1,10 +1,28 @@
 #include "zf_queue_tests.h"
+#include "zf_tailq_index_tests.h"
+#include "zf_snapshot_tests.h"
+#include "zf_codel_tests.h"
+#include "zf_drr_tests.h"
+#include "zf_heap_tests.h"
+#include "zf_radix_heap_tests.h"
+#include "zf_interval_tree_tests.h"
+#include "zf_parking_lot_tests.h"
+#include "zf_thread_pool_tests.h"
 
 int main(int argc, char *argv[])
 {
 	TEST_RUNNER_CREATE(argc, argv);
 
 	TEST_EXECUTE_SUITE(test_zf_queue_h);
+	TEST_EXECUTE_SUITE(test_zf_tailq_index_h);
+	TEST_EXECUTE_SUITE(test_zf_snapshot_h);
+	TEST_EXECUTE_SUITE(test_zf_codel_h);
+	TEST_EXECUTE_SUITE(test_zf_drr_h);
+	TEST_EXECUTE_SUITE(test_zf_heap_h);
+	TEST_EXECUTE_SUITE(test_zf_radix_heap_h);
+	TEST_EXECUTE_SUITE(test_zf_interval_tree_h);
+	TEST_EXECUTE_SUITE(test_zf_parking_lot_h);
+	TEST_EXECUTE_SUITE(test_zf_thread_pool_h);
 
 	return TEST_RUNNER_EXIT_CODE();
 }
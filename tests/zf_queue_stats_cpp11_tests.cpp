@@ -0,0 +1,12 @@
+#include "zf_queue_tests.h"
+#include "zf_queue_stats_tests.h"
+
+int main(int argc, char *argv[])
+{
+	TEST_RUNNER_CREATE(argc, argv);
+
+	TEST_EXECUTE_SUITE(test_zf_queue_h);
+	TEST_EXECUTE_SUITE(test_zf_stats_h);
+
+	return TEST_RUNNER_EXIT_CODE();
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+/* Operation statistics, runners that include this file define ZF_QUEUE_STATS
+ * (via compiler command line) and also run all zf_queue tests with it.
+ */
+#if !defined(ZF_QUEUE_STATS)
+	#error ZF_QUEUE_STATS must be defined
+#endif
+
+#include "zf_queue_tests.h"
+#if defined(__cplusplus)
+#include <thread>
+#include <vector>
+#endif
+
+static void test_zf_stats_verify(const struct zf_queue_stats *const s,
+								 const size_t inserts, const size_t removes,
+								 const size_t length, const size_t max_length)
+{
+	const struct zf_queue_stats r = zf_queue_stats_snapshot(s);
+	TEST_VERIFY_EQUAL(inserts, r.inserts);
+	TEST_VERIFY_EQUAL(removes, r.removes);
+	TEST_VERIFY_EQUAL(length, r.length);
+	TEST_VERIFY_EQUAL(max_length, r.max_length);
+}
+
+static void test_zf_stats_initializer()
+{
+	slist_test_entry e;
+	zf_slist_head sh = ZF_SLIST_INITIALIZER();
+	zf_list_head lh = ZF_LIST_INITIALIZER();
+	zf_stailq_head sqh = ZF_STAILQ_INITIALIZER(&sqh);
+	zf_tailq_head tqh = ZF_TAILQ_INITIALIZER(&tqh);
+	test_zf_stats_verify(&sh.stats, 0, 0, 0, 0);
+	test_zf_stats_verify(&lh.stats, 0, 0, 0, 0);
+	test_zf_stats_verify(&sqh.stats, 0, 0, 0, 0);
+	test_zf_stats_verify(&tqh.stats, 0, 0, 0, 0);
+	TEST_VERIFY_EQUAL(0u, sqh.stats.steps);
+	zf_slist_insert_head(&sh, &e.node);
+	test_zf_stats_verify(&sh.stats, 1, 0, 1, 1);
+	zf_slist_init(&sh);
+	test_zf_stats_verify(&sh.stats, 0, 0, 0, 0);
+}
+
+static void test_zf_stats_insert_remove()
+{
+	stailq_test_entry a[4];
+	zf_stailq_node *n[2];
+	zf_stailq_head h;
+	zf_stailq_init(&h);
+	zf_stailq_insert_tail(&h, &a[0].node);
+	zf_stailq_insert_head(&h, &a[1].node);
+	zf_stailq_insert_after(&h, &a[0].node, &a[2].node);
+	test_zf_stats_verify(&h.stats, 3, 0, 3, 3);
+	zf_stailq_remove_head(&h);
+	zf_stailq_remove_after(&h, &a[0].node);
+	test_zf_stats_verify(&h.stats, 3, 2, 1, 3);
+	n[0] = &a[2].node;
+	n[1] = &a[3].node;
+	zf_stailq_insert_tail_bulk(&h, n, 2);
+	test_zf_stats_verify(&h.stats, 5, 2, 3, 3);
+	zf_stailq_insert_head(&h, &a[1].node);
+	test_zf_stats_verify(&h.stats, 6, 2, 4, 4);
+	zf_queue_stats_reset(&h.stats);
+	test_zf_stats_verify(&h.stats, 0, 0, 4, 4);
+	zf_stailq_remove_head(&h);
+	test_zf_stats_verify(&h.stats, 0, 1, 3, 4);
+}
+
+static void test_zf_stats_steps()
+{
+	tailq_test_entry a[5];
+	zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+	size_t count = 0;
+	for (unsigned i = 0; 5 > i; ++i)
+	{
+		zf_tailq_insert_tail(&h, &a[i].node);
+	}
+	zf_tailq_foreach(&h, n)
+	{
+		++count;
+	}
+	TEST_VERIFY_EQUAL(5u, count);
+	TEST_VERIFY_EQUAL(5u, zf_queue_stats_snapshot(&h.stats).steps);
+	zf_tailq_foreach_prefetch(&h, n, 2, 0)
+	{
+		++count;
+	}
+	TEST_VERIFY_EQUAL(10u, zf_queue_stats_snapshot(&h.stats).steps);
+	zf_tailq_disorder(&h, 64, &count);
+	TEST_VERIFY_EQUAL(15u, zf_queue_stats_snapshot(&h.stats).steps);
+	zf_queue_stats_reset(&h.stats);
+	TEST_VERIFY_EQUAL(0u, zf_queue_stats_snapshot(&h.stats).steps);
+}
+
+static void test_zf_stats_move()
+{
+	tailq_test_entry a[6];
+	zf_tailq_head h1 = ZF_TAILQ_INITIALIZER(&h1);
+	zf_tailq_head h2 = ZF_TAILQ_INITIALIZER(&h2);
+	for (unsigned i = 0; 6 > i; ++i)
+	{
+		a[i].a[0] = i;
+		zf_tailq_insert_tail(&h1, &a[i].node);
+	}
+	/* h1: 0 1 2 3 4 5 */
+	zf_tailq_split(&h1, &a[4].node, &h2);
+	test_zf_stats_verify(&h1.stats, 6, 2, 4, 6);
+	test_zf_stats_verify(&h2.stats, 2, 0, 2, 2);
+	/* h1: 0 1 2 3, h2: 4 5 */
+	zf_tailq_splice_tail(&h2, &h1, &a[1].node, &a[2].node);
+	test_zf_stats_verify(&h1.stats, 6, 4, 2, 6);
+	test_zf_stats_verify(&h2.stats, 4, 0, 4, 4);
+	/* range moved within the same list is not counted */
+	zf_tailq_splice_head(&h2, &h2, &a[2].node, &a[2].node);
+	test_zf_stats_verify(&h2.stats, 4, 0, 4, 4);
+	/* h1: 0 3, h2: 2 4 5 1 */
+	zf_tailq_swap(&h1, &h2);
+	test_zf_stats_verify(&h1.stats, 6, 4, 4, 6);
+	test_zf_stats_verify(&h2.stats, 4, 0, 2, 4);
+	/* h1: 2 4 5 1, h2: 0 3 */
+	zf_tailq_concat(&h1, &h2);
+	test_zf_stats_verify(&h1.stats, 8, 4, 6, 6);
+	test_zf_stats_verify(&h2.stats, 4, 2, 0, 4);
+	/* h1: 2 4 5 1 0 3 */
+	TEST_VERIFY_EQUAL(3u, zf_tailq_partition(&h1, &h2, tailq_test_odd, 0));
+	test_zf_stats_verify(&h1.stats, 8, 7, 3, 6);
+	test_zf_stats_verify(&h2.stats, 7, 2, 3, 4);
+	/* h1: 2 4 0, h2: 5 1 3 */
+	TEST_VERIFY_EQUAL(3u, zf_tailq_remove_if(&h2, tailq_test_odd, 0, 0));
+	test_zf_stats_verify(&h2.stats, 7, 5, 0, 4);
+	/* partition discards previous content of h2 */
+	zf_tailq_insert_tail(&h2, &a[1].node);
+	TEST_VERIFY_EQUAL(0u, zf_tailq_partition(&h1, &h2, tailq_test_odd, 0));
+	test_zf_stats_verify(&h2.stats, 8, 6, 0, 4);
+}
+
+static void test_zf_stats_keep()
+{
+	stailq_test_entry a[8];
+	stailq_test_entry slab[8];
+	size_t size = sizeof(stailq_test_entry);
+	zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+	for (unsigned i = 0; 8 > i; ++i)
+	{
+		a[i].a[0] = i;
+		zf_stailq_insert_head(&h, &a[i].node);
+	}
+	zf_stailq_remove_head(&h);
+	test_zf_stats_verify(&h.stats, 8, 1, 7, 8);
+	zf_stailq_radix_sort(&h, stailq_test_key, nullptr);
+	test_zf_stats_verify(&h.stats, 8, 1, 7, 8);
+	zf_stailq_relink(&h);
+	test_zf_stats_verify(&h.stats, 8, 1, 7, 8);
+	TEST_VERIFY_EQUAL(7u, zf_stailq_compact(&h, slab, 8, size,
+											offsetof(stailq_test_entry, node),
+											test_move, &size));
+	test_zf_stats_verify(&h.stats, 8, 1, 7, 8);
+}
+
+#ifdef __cplusplus
+static void test_zf_stats_cpp()
+{
+	slist_test_entry s[3];
+	slist_test_head_ sh = ZF_SLIST_INITIALIZER();
+	zf_slist_insert_head_(&sh, &s[0]);
+	zf_slist_insert_after_(&sh, &s[0], &s[1]);
+	zf_slist_insert_after_(&sh, &s[1], &s[2]);
+	zf_slist_remove_after_(&sh, &s[0]);
+	test_zf_stats_verify(&sh.stats, 3, 1, 2, 3);
+	unsigned count = 0;
+	for (slist_test_head_::iterator i = sh.begin(); sh.end() != i; ++i)
+	{
+		++count;
+	}
+	TEST_VERIFY_EQUAL(2u, count);
+	TEST_VERIFY_EQUAL(2u, zf_queue_stats_snapshot(&sh.stats).steps);
+
+	list_test_entry l[3];
+	list_test_head_ lh = ZF_LIST_INITIALIZER();
+	zf_list_insert_head_(&lh, &l[0]);
+	zf_list_insert_before_(&lh, &l[0], &l[1]);
+	zf_list_insert_after_(&lh, &l[0], &l[2]);
+	zf_list_remove_(&lh, &l[1]);
+	test_zf_stats_verify(&lh.stats, 3, 1, 2, 3);
+
+	tailq_test_entry t[4];
+	tailq_test_entry *e[4];
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		t[i].a[0] = i;
+		e[i] = &t[i];
+	}
+	tailq_test_head_ th = ZF_TAILQ_INITIALIZER(&th);
+	tailq_test_head_ th2 = ZF_TAILQ_INITIALIZER(&th2);
+	zf_tailq_insert_tail_bulk_(&th, e, 3);
+	zf_tailq_insert_before_(&th, &t[0], &t[3]);
+	test_zf_stats_verify(&th.stats, 4, 0, 4, 4);
+	const test_odd_<tailq_test_entry> odd = test_odd_<tailq_test_entry>();
+	TEST_VERIFY_EQUAL(2u, zf_tailq_partition_(&th, &th2, odd));
+	test_zf_stats_verify(&th.stats, 4, 2, 2, 4);
+	test_zf_stats_verify(&th2.stats, 2, 0, 2, 2);
+	count = 0;
+	for (tailq_test_head_::reverse_iterator r = th.rbegin(); th.rend() != r; ++r)
+	{
+		++count;
+	}
+	TEST_VERIFY_EQUAL(2u, count);
+	TEST_VERIFY_EQUAL(2u, zf_queue_stats_snapshot(&th.stats).steps);
+}
+
+/* readers that traverse const head concurrently don't lose steps */
+static void test_zf_stats_readers()
+{
+	tailq_test_entry t[100];
+	tailq_test_head_ h = ZF_TAILQ_INITIALIZER(&h);
+	for (unsigned i = 0; 100 > i; ++i)
+	{
+		zf_tailq_insert_tail_(&h, &t[i]);
+	}
+	const tailq_test_head_ &c = h;
+	std::vector<std::thread> readers;
+	for (unsigned k = 0; 4 > k; ++k)
+	{
+		readers.push_back(std::thread([&c]()
+		{
+			for (unsigned round = 0; 1000 > round; ++round)
+			{
+				for (const tailq_test_entry &e: c)
+				{
+					(void)e;
+				}
+			}
+		}));
+	}
+	for (size_t k = 0; readers.size() > k; ++k)
+	{
+		readers[k].join();
+	}
+	TEST_VERIFY_EQUAL(4u * 1000u * 100u,
+					  zf_queue_stats_snapshot(&h.stats).steps);
+}
+#endif
+
+static void test_zf_stats_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_stats_initializer());
+	TEST_EXECUTE(test_zf_stats_insert_remove());
+	TEST_EXECUTE(test_zf_stats_steps());
+	TEST_EXECUTE(test_zf_stats_move());
+	TEST_EXECUTE(test_zf_stats_keep());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_stats_cpp());
+	TEST_EXECUTE(test_zf_stats_readers());
+#endif
+}
@@ -2,15 +2,77 @@
 
 #if defined(__cplusplus)
 #include "zf_test.hpp"
+#include <algorithm>
+#include <new>
 #else
 #include "zf_test.h"
 #endif
 #include "zf_queue.h"
+#include <string.h>
 
 #if !defined(__cplusplus)
 #define nullptr NULL
 #endif
 
+/* Radix sort keys with duplicates and with several constant bytes */
+static uint64_t test_radix_key(const unsigned i)
+{
+	return ((uint64_t)((i * 37) % 11) << 40) | ((i * 13) % 7) |
+		   ((uint64_t)((i * 5) % 3) << 16);
+}
+
+/* Copies entry of *(size_t *)ctx bytes */
+static void test_move(void *const dst, void *const src, void *const ctx)
+{
+	memcpy(dst, src, *(size_t *)ctx);
+}
+
+#ifdef __cplusplus
+/* Copies entry with assignment */
+struct test_move_
+{
+	template <typename T>
+	void operator()(T *const dst, T *const src) const { *dst = *src; }
+};
+
+/* Predicates for entries with value in a[0] */
+template <typename T>
+struct test_odd_
+{
+	bool operator()(T *const e) const { return 0 != (1 & e->a[0]); }
+};
+
+template <typename T>
+struct test_equal_
+{
+	bool operator()(T *const a, T *const b) const { return a->a[0] == b->a[0]; }
+};
+
+struct test_count_
+{
+	unsigned *count;
+	template <typename T>
+	void operator()(T *const) const { ++*count; }
+};
+
+/* Matches entries with a[0] == value */
+struct test_value_is_
+{
+	unsigned value;
+	template <typename T>
+	bool operator()(const T &e) const { return value == e.a[0]; }
+};
+
+/* Appends visited entries to out[] */
+template <typename T>
+struct test_collect_
+{
+	T **out;
+	unsigned *count;
+	void operator()(T *const e) const { out[(*count)++] = e; }
+};
+#endif
+
 /*
  * Singly-linked list
  */
@@ -292,6 +354,373 @@ static void test_zf_slist_swap()
 	TEST_VERIFY_EQUAL(&na0, zf_slist_next(&na1));
 }
 
+static void test_zf_slist_verify(zf_slist_head *const h,
+								 zf_slist_node *const *const n,
+								 const unsigned count)
+{
+	zf_slist_node *i = zf_slist_begin(h);
+	for (unsigned k = 0; count > k; ++k, i = zf_slist_next(i))
+	{
+		TEST_VERIFY_EQUAL(n[k], i);
+	}
+	TEST_VERIFY_EQUAL(zf_slist_end(h), i);
+}
+
+static void test_zf_slist_insert_bulk()
+{
+	{
+		zf_slist_node a[12], b[2], c[3];
+		zf_slist_node *pa[12], *pb[2], *x[17];
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			pa[i] = &a[i];
+			x[i + 2] = &a[i];
+		}
+		pb[0] = x[0] = &b[0];
+		pb[1] = x[1] = &b[1];
+		zf_slist_head h = ZF_SLIST_INITIALIZER();
+		zf_slist_insert_head_bulk(&h, pa, 0);
+		TEST_VERIFY_TRUE(zf_slist_empty(&h));
+		zf_slist_insert_head_bulk(&h, pa, 12);
+		test_zf_slist_verify(&h, pa, 12);
+		zf_slist_insert_head_bulk(&h, pb, 2);
+		test_zf_slist_verify(&h, x, 14);
+		zf_slist_insert_after_bulk(&a[11], pb, 0);
+		test_zf_slist_verify(&h, x, 14);
+		zf_slist_insert_after_bulk_strided(&a[11], &c[0], sizeof(c[0]), 3);
+		x[14] = &c[0];
+		x[15] = &c[1];
+		x[16] = &c[2];
+		test_zf_slist_verify(&h, x, 17);
+		zf_slist_init(&h);
+		zf_slist_insert_head_bulk_strided(&h, &c[0], sizeof(c[0]), 0);
+		TEST_VERIFY_TRUE(zf_slist_empty(&h));
+		zf_slist_insert_head_bulk_strided(&h, &c[0], sizeof(c[0]), 3);
+		test_zf_slist_verify(&h, x + 14, 3);
+		zf_slist_insert_after_bulk(&c[0], pb, 2);
+		zf_slist_node *const y[] = {&c[0], &b[0], &b[1], &c[1], &c[2]};
+		test_zf_slist_verify(&h, y, 5);
+	}
+#ifdef __cplusplus
+	{
+		slist_test_entry a[10], c[2];
+		slist_test_entry *pa[10];
+		zf_slist_node *x[12];
+		for (unsigned i = 0; 10 > i; ++i)
+		{
+			pa[i] = &a[i];
+			x[i + 2] = &a[i].node;
+		}
+		x[0] = &c[0].node;
+		x[1] = &c[1].node;
+		slist_test_head_ h = ZF_SLIST_INITIALIZER();
+		zf_slist_insert_head_bulk_(&h, pa, 10);
+		test_zf_slist_verify(&h, x + 2, 10);
+		zf_slist_insert_head_bulk_(&h, c, 2);
+		test_zf_slist_verify(&h, x, 12);
+		zf_slist_init(&h);
+		zf_slist_insert_head_bulk_(&h, pa, 1);
+		zf_slist_insert_after_bulk_(&h, &a[0], c, 2);
+		zf_slist_insert_after_bulk_(&h, &c[1], pa + 1, 9);
+		zf_slist_node *y[12];
+		y[0] = &a[0].node;
+		y[1] = &c[0].node;
+		y[2] = &c[1].node;
+		for (unsigned i = 1; 10 > i; ++i)
+		{
+			y[i + 2] = &a[i].node;
+		}
+		test_zf_slist_verify(&h, y, 12);
+	}
+#endif
+}
+
+static void test_zf_slist_foreach_prefetch()
+{
+	{
+		zf_slist_node a[12];
+		zf_slist_node *x[12];
+		unsigned count = 0;
+		zf_slist_head h = ZF_SLIST_INITIALIZER();
+		zf_slist_foreach_prefetch(&h, n, 4, 0)
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_slist_insert_head_bulk_strided(&h, &a[0], sizeof(a[0]), 12);
+		zf_slist_foreach_prefetch(&h, n, 4, sizeof(a[0]))
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(12u, count);
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(&a[i], x[i]);
+		}
+		count = 0;
+		zf_slist_foreach_prefetch(&h, n, 0, -1)
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(12u, count);
+		TEST_VERIFY_EQUAL(&a[11], x[11]);
+	}
+#ifdef __cplusplus
+	{
+		slist_test_entry a[12];
+		slist_test_entry *x[12];
+		unsigned count = 0;
+		slist_test_head_ h = ZF_SLIST_INITIALIZER();
+		test_collect_<slist_test_entry> f = {x, &count};
+		zf_slist_foreach_prefetch_<4>(&h, f);
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_slist_insert_head_bulk_(&h, a, 12);
+		zf_slist_foreach_prefetch_<4>(&h, f, offsetof(slist_test_entry, b));
+		TEST_VERIFY_EQUAL(12u, count);
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(&a[i], x[i]);
+		}
+		count = 0;
+		zf_slist_foreach_prefetch_<16>(&h, f);
+		TEST_VERIFY_EQUAL(12u, count);
+		TEST_VERIFY_EQUAL(&a[11], x[11]);
+	}
+#endif
+}
+
+static void test_zf_slist_relink()
+{
+	static const unsigned order[] = {5, 2, 7, 0, 3, 6, 1, 4};
+	{
+		zf_slist_node a[8];
+		zf_slist_node *x[8], *y[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			x[i] = &a[order[i]];
+			y[i] = &a[i];
+		}
+		zf_slist_head h = ZF_SLIST_INITIALIZER();
+		size_t count = 1;
+		TEST_VERIFY_EQUAL(0u, zf_slist_disorder(&h, sizeof(a[0]), &count));
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_slist_relink(&h);
+		test_zf_slist_verify(&h, y, 0);
+		zf_slist_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(7u, zf_slist_disorder(&h, sizeof(a[0]), &count));
+		TEST_VERIFY_EQUAL(8u, count);
+		TEST_VERIFY_EQUAL(4u, zf_slist_disorder(&h, 3 * sizeof(a[0]), 0));
+		zf_slist_relink(&h);
+		test_zf_slist_verify(&h, y, 8);
+		TEST_VERIFY_EQUAL(0u, zf_slist_disorder(&h, sizeof(a[0]), 0));
+	}
+	{
+		slist_test_entry a[8], slab[8];
+		zf_slist_node *x[8], *y[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			a[i].a[0] = i;
+			x[i] = &a[order[i]].node;
+			y[i] = &slab[i].node;
+		}
+		zf_slist_head h = ZF_SLIST_INITIALIZER();
+		zf_slist_insert_head_bulk(&h, x, 8);
+		size_t size = sizeof(slist_test_entry);
+		TEST_VERIFY_EQUAL(8u, zf_slist_compact(&h, slab, 7, size,
+						  offsetof(slist_test_entry, node), test_move, &size));
+		test_zf_slist_verify(&h, x, 8);
+		TEST_VERIFY_EQUAL(8u, zf_slist_compact(&h, slab, 8, size,
+						  offsetof(slist_test_entry, node), test_move, &size));
+		test_zf_slist_verify(&h, y, 8);
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(order[i], slab[i].a[0]);
+		}
+		TEST_VERIFY_EQUAL(0u, zf_slist_disorder(&h, size, 0));
+	}
+#ifdef __cplusplus
+	{
+		slist_test_entry a[8], slab[8];
+		slist_test_entry *x[8];
+		zf_slist_node *y[8], *z[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			a[i].a[0] = i;
+			x[i] = &a[order[i]];
+			y[i] = &a[i].node;
+			z[i] = &slab[i].node;
+		}
+		slist_test_head_ h = ZF_SLIST_INITIALIZER();
+		zf_slist_insert_head_bulk_(&h, x, 8);
+		TEST_VERIFY_EQUAL(7u, zf_slist_disorder_(&h, sizeof(a[0])));
+		zf_slist_relink_(&h);
+		test_zf_slist_verify(&h, y, 8);
+		TEST_VERIFY_EQUAL(8u, zf_slist_compact_(&h, slab, 8, test_move_()));
+		test_zf_slist_verify(&h, z, 8);
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(i, slab[i].a[0]);
+		}
+	}
+#endif
+}
+
+static bool slist_test_odd(zf_slist_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return 0 != (1 & zf_entry(n, slist_test_entry, node)->a[0]);
+}
+
+static bool slist_test_three(zf_slist_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return 3 == zf_entry(n, slist_test_entry, node)->a[0];
+}
+
+static void slist_test_dispose(zf_slist_node *const n, void *const ctx)
+{
+	(void)n;
+	++*(unsigned *)ctx;
+}
+
+static bool slist_test_equal(zf_slist_node *const a, zf_slist_node *const b,
+							 void *const ctx)
+{
+	(void)ctx;
+	return zf_entry(a, slist_test_entry, node)->a[0] ==
+		   zf_entry(b, slist_test_entry, node)->a[0];
+}
+
+static void test_zf_slist_filter()
+{
+	static const unsigned values[] = {1, 1, 2, 3, 3, 3, 4, 1};
+	slist_test_entry a[8];
+	zf_slist_node *x[8];
+	for (unsigned i = 0; 8 > i; ++i)
+	{
+		a[i].a[0] = values[i];
+		x[i] = &a[i].node;
+	}
+	{
+		zf_slist_head h = ZF_SLIST_INITIALIZER();
+		zf_slist_head h2 = ZF_SLIST_INITIALIZER();
+		TEST_VERIFY_EQUAL(0u, zf_slist_partition(&h, &h2, slist_test_odd, 0));
+		test_zf_slist_verify(&h, x, 0);
+		test_zf_slist_verify(&h2, x, 0);
+		zf_slist_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(6u, zf_slist_partition(&h, &h2, slist_test_odd, 0));
+		zf_slist_node *const y[] = {x[2], x[6]};
+		test_zf_slist_verify(&h, y, 2);
+		zf_slist_node *const z[] = {x[0], x[1], x[3], x[4], x[5], x[7]};
+		test_zf_slist_verify(&h2, z, 6);
+		zf_slist_insert_head_bulk(&h, x, 0);
+		test_zf_slist_verify(&h, y, 2);
+	}
+	{
+		unsigned disposed = 0;
+		zf_slist_head h = ZF_SLIST_INITIALIZER();
+		zf_slist_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(3u, zf_slist_remove_if(&h, slist_test_three,
+						  slist_test_dispose, &disposed));
+		TEST_VERIFY_EQUAL(3u, disposed);
+		zf_slist_node *const y[] = {x[0], x[1], x[2], x[6], x[7]};
+		test_zf_slist_verify(&h, y, 5);
+		TEST_VERIFY_EQUAL(3u, zf_slist_remove_if(&h, slist_test_odd, 0, 0));
+	}
+	{
+		zf_slist_head h = ZF_SLIST_INITIALIZER();
+		zf_slist_head h2 = ZF_SLIST_INITIALIZER();
+		zf_slist_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(3u, zf_slist_unique(&h, &h2, slist_test_equal, 0));
+		zf_slist_node *const y[] = {x[0], x[2], x[3], x[6], x[7]};
+		test_zf_slist_verify(&h, y, 5);
+		zf_slist_node *const z[] = {x[1], x[4], x[5]};
+		test_zf_slist_verify(&h2, z, 3);
+	}
+#ifdef __cplusplus
+	{
+		slist_test_entry *e[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			e[i] = &a[i];
+		}
+		slist_test_head_ h = ZF_SLIST_INITIALIZER();
+		slist_test_head_ h2 = ZF_SLIST_INITIALIZER();
+		zf_slist_insert_head_bulk_(&h, e, 8);
+		TEST_VERIFY_EQUAL(6u, zf_slist_partition_(&h, &h2,
+						  test_odd_<slist_test_entry>()));
+		zf_slist_node *const y[] = {x[2], x[6]};
+		test_zf_slist_verify(&h, y, 2);
+		zf_slist_init(&h);
+		zf_slist_insert_head_bulk_(&h, e, 8);
+		TEST_VERIFY_EQUAL(3u, zf_slist_unique_(&h, &h2,
+						  test_equal_<slist_test_entry>()));
+		zf_slist_node *const z[] = {x[1], x[4], x[5]};
+		test_zf_slist_verify(&h2, z, 3);
+		unsigned disposed = 0;
+		const test_count_ dispose = {&disposed};
+		TEST_VERIFY_EQUAL(3u, zf_slist_remove_if_(&h, test_odd_<slist_test_entry>(),
+						  dispose));
+		TEST_VERIFY_EQUAL(3u, disposed);
+		test_zf_slist_verify(&h, y, 2);
+		TEST_VERIFY_EQUAL(0u, zf_slist_remove_if_(&h, test_odd_<slist_test_entry>()));
+	}
+#endif
+}
+
+#ifdef __cplusplus
+static void test_zf_slist_iterator()
+{
+	slist_test_entry a[4];
+	slist_test_entry *e[4];
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].a[0] = 10 + i;
+		e[i] = &a[i];
+	}
+	slist_test_head_ h = ZF_SLIST_INITIALIZER();
+	TEST_VERIFY_TRUE(h.begin() == h.end());
+	zf_slist_insert_head_bulk_(&h, e, 4);
+	unsigned k = 0;
+	for (slist_test_head_::iterator i = h.begin(); h.end() != i; ++k, i++)
+	{
+		TEST_VERIFY_EQUAL(&a[k], &*i);
+		TEST_VERIFY_EQUAL(10 + k, i->a[0]);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+	TEST_VERIFY_EQUAL(4, (int)std::distance(h.begin(), h.end()));
+	const test_value_is_ v12 = {12};
+	TEST_VERIFY_EQUAL(&a[2], &*std::find_if(h.begin(), h.end(), v12));
+	const test_value_is_ v42 = {42};
+	TEST_VERIFY_TRUE(h.end() == std::find_if(h.begin(), h.end(), v42));
+	slist_test_head_::iterator i = h.begin();
+	std::advance(i, 3);
+	TEST_VERIFY_EQUAL(&a[3], &*i);
+	const slist_test_head_ &c = h;
+	TEST_VERIFY_EQUAL(4, (int)std::distance(c.begin(), c.end()));
+	TEST_VERIFY_EQUAL(&a[2], &*std::find_if(c.cbegin(), c.cend(), v12));
+	slist_test_head_::const_iterator ci = h.begin();
+	TEST_VERIFY_TRUE(c.begin() == ci);
+	TEST_VERIFY_EQUAL(11u, (++ci)->a[0]);
+	TEST_VERIFY_TRUE(ci != h.begin() && h.begin() != ci);
+	TEST_VERIFY_TRUE(++h.begin() == ci && ci == ++h.begin());
+#if __cplusplus >= 201103L
+	k = 0;
+	for (slist_test_entry &x: h)
+	{
+		TEST_VERIFY_EQUAL(&a[k++], &x);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+	k = 0;
+	for (const slist_test_entry &x: c)
+	{
+		TEST_VERIFY_EQUAL(&a[k++], &x);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+#endif
+}
+#endif
+
 static void test_zf_slist(TEST_SUIT_ARGUMENTS)
 {
 	TEST_EXECUTE(test_zf_slist_entry());
@@ -302,6 +731,13 @@ static void test_zf_slist(TEST_SUIT_ARGUMENTS)
 	TEST_EXECUTE(test_zf_slist_remove_head());
 	TEST_EXECUTE(test_zf_slist_remove_after());
 	TEST_EXECUTE(test_zf_slist_swap());
+	TEST_EXECUTE(test_zf_slist_insert_bulk());
+	TEST_EXECUTE(test_zf_slist_foreach_prefetch());
+	TEST_EXECUTE(test_zf_slist_relink());
+	TEST_EXECUTE(test_zf_slist_filter());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_slist_iterator());
+#endif
 }
 
 /*
@@ -624,6 +1060,641 @@ static void test_zf_list_remove()
 #endif
 }
 
+static void test_zf_list_verify(zf_list_head *const h,
+								zf_list_node *const *const n,
+								const unsigned count)
+{
+	zf_list_node *i = zf_list_begin(h);
+	for (unsigned k = 0; count > k; ++k, i = zf_list_next(i))
+	{
+		TEST_VERIFY_EQUAL(n[k], i);
+		TEST_VERIFY_EQUAL(0 == k? zf_list_rend(h): n[k - 1], zf_list_prev(h, i));
+	}
+	TEST_VERIFY_EQUAL(zf_list_end(h), i);
+}
+
+static void test_zf_list_swap()
+{
+	{
+		zf_list_node a[2], b[1];
+		zf_list_head ha = ZF_LIST_INITIALIZER();
+		zf_list_insert_head(&ha, &a[1]);
+		zf_list_insert_head(&ha, &a[0]);
+		zf_list_head hb = ZF_LIST_INITIALIZER();
+		zf_list_insert_head(&hb, &b[0]);
+		zf_list_swap(&ha, &hb);
+		zf_list_node *const x0[] = {&b[0]};
+		test_zf_list_verify(&ha, x0, 1);
+		zf_list_node *const x1[] = {&a[0], &a[1]};
+		test_zf_list_verify(&hb, x1, 2);
+		zf_list_head hc = ZF_LIST_INITIALIZER();
+		zf_list_swap(&ha, &hc);
+		TEST_VERIFY_TRUE(zf_list_empty(&ha));
+		test_zf_list_verify(&hc, x0, 1);
+	}
+#ifdef __cplusplus
+	{
+		list_test_entry a[2];
+		list_test_head_ ha = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_(&ha, &a[1]);
+		zf_list_insert_head_(&ha, &a[0]);
+		list_test_head_ hb = ZF_LIST_INITIALIZER();
+		zf_list_swap_(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_list_empty(&ha));
+		zf_list_node *const x[] = {&a[0].node, &a[1].node};
+		test_zf_list_verify(&hb, x, 2);
+	}
+#endif
+}
+
+static void test_zf_list_concat()
+{
+	{
+		zf_list_node a[2], b[2];
+		zf_list_head ha = ZF_LIST_INITIALIZER();
+		zf_list_head hb = ZF_LIST_INITIALIZER();
+		zf_list_concat(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_list_empty(&ha));
+		zf_list_insert_head(&hb, &b[1]);
+		zf_list_insert_head(&hb, &b[0]);
+		zf_list_concat(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_list_empty(&hb));
+		zf_list_node *const x0[] = {&b[0], &b[1]};
+		test_zf_list_verify(&ha, x0, 2);
+		zf_list_insert_head(&hb, &a[1]);
+		zf_list_insert_head(&hb, &a[0]);
+		zf_list_concat(&hb, &ha);
+		TEST_VERIFY_TRUE(zf_list_empty(&ha));
+		zf_list_node *const x1[] = {&a[0], &a[1], &b[0], &b[1]};
+		test_zf_list_verify(&hb, x1, 4);
+		zf_list_concat(&hb, &ha);
+		test_zf_list_verify(&hb, x1, 4);
+	}
+#ifdef __cplusplus
+	{
+		list_test_entry a[2];
+		list_test_head_ ha = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_(&ha, &a[0]);
+		list_test_head_ hb = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_(&hb, &a[1]);
+		zf_list_concat_(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_list_empty(&hb));
+		zf_list_node *const x[] = {&a[0].node, &a[1].node};
+		test_zf_list_verify(&ha, x, 2);
+	}
+#endif
+}
+
+static void test_zf_list_splice()
+{
+	{
+		zf_list_node a[5], b[2];
+		zf_list_head ha = ZF_LIST_INITIALIZER();
+		for (unsigned i = 5; 0 < i--;)
+		{
+			zf_list_insert_head(&ha, &a[i]);
+		}
+		zf_list_head hb = ZF_LIST_INITIALIZER();
+		zf_list_insert_head(&hb, &b[1]);
+		zf_list_insert_head(&hb, &b[0]);
+		zf_list_splice_head(&hb, &a[1], &a[2]);
+		zf_list_node *const x0[] = {&a[0], &a[3], &a[4]};
+		test_zf_list_verify(&ha, x0, 3);
+		zf_list_node *const x1[] = {&a[1], &a[2], &b[0], &b[1]};
+		test_zf_list_verify(&hb, x1, 4);
+		zf_list_splice_after(&b[1], &a[3], &a[4]);
+		zf_list_node *const x2[] = {&a[0]};
+		test_zf_list_verify(&ha, x2, 1);
+		zf_list_node *const x3[] = {&a[1], &a[2], &b[0], &b[1], &a[3], &a[4]};
+		test_zf_list_verify(&hb, x3, 6);
+		zf_list_splice_head(&hb, &b[0], &b[1]);
+		zf_list_node *const x4[] = {&b[0], &b[1], &a[1], &a[2], &a[3], &a[4]};
+		test_zf_list_verify(&hb, x4, 6);
+		zf_list_splice_after(&a[0], &b[0], &a[4]);
+		TEST_VERIFY_TRUE(zf_list_empty(&hb));
+		zf_list_node *const x5[] = {&a[0], &b[0], &b[1], &a[1], &a[2], &a[3], &a[4]};
+		test_zf_list_verify(&ha, x5, 7);
+	}
+#ifdef __cplusplus
+	{
+		list_test_entry a[3];
+		list_test_head_ ha = ZF_LIST_INITIALIZER();
+		for (unsigned i = 3; 0 < i--;)
+		{
+			zf_list_insert_head_(&ha, &a[i]);
+		}
+		list_test_head_ hb = ZF_LIST_INITIALIZER();
+		zf_list_splice_head_(&hb, &a[1], &a[2]);
+		zf_list_splice_after_(&hb, &a[2], &a[0], &a[0]);
+		TEST_VERIFY_TRUE(zf_list_empty(&ha));
+		zf_list_node *const x[] = {&a[1].node, &a[2].node, &a[0].node};
+		test_zf_list_verify(&hb, x, 3);
+	}
+#endif
+}
+
+static void test_zf_list_split()
+{
+	{
+		zf_list_node a[3];
+		zf_list_head ha = ZF_LIST_INITIALIZER();
+		for (unsigned i = 3; 0 < i--;)
+		{
+			zf_list_insert_head(&ha, &a[i]);
+		}
+		zf_list_head hb;
+		zf_list_split(&ha, &a[1], &hb);
+		zf_list_node *const x0[] = {&a[0]};
+		test_zf_list_verify(&ha, x0, 1);
+		zf_list_node *const x1[] = {&a[1], &a[2]};
+		test_zf_list_verify(&hb, x1, 2);
+		zf_list_split(&ha, &a[0], &hb);
+		TEST_VERIFY_TRUE(zf_list_empty(&ha));
+		test_zf_list_verify(&hb, x0, 1);
+	}
+#ifdef __cplusplus
+	{
+		list_test_entry a[2];
+		list_test_head_ ha = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_(&ha, &a[1]);
+		zf_list_insert_head_(&ha, &a[0]);
+		list_test_head_ hb;
+		zf_list_split_(&ha, &a[1], &hb);
+		zf_list_node *const x0[] = {&a[0].node};
+		test_zf_list_verify(&ha, x0, 1);
+		zf_list_node *const x1[] = {&a[1].node};
+		test_zf_list_verify(&hb, x1, 1);
+	}
+#endif
+}
+
+static void test_zf_list_insert_bulk()
+{
+	{
+		zf_list_node a[12], b[2], c[3];
+		zf_list_node *pa[12], *pb[2], *x[17];
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			pa[i] = &a[i];
+			x[i + 2] = &a[i];
+		}
+		pb[0] = x[0] = &b[0];
+		pb[1] = x[1] = &b[1];
+		zf_list_head h = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_bulk(&h, pa, 0);
+		TEST_VERIFY_TRUE(zf_list_empty(&h));
+		zf_list_insert_head_bulk(&h, pa, 12);
+		test_zf_list_verify(&h, pa, 12);
+		zf_list_insert_head_bulk(&h, pb, 2);
+		test_zf_list_verify(&h, x, 14);
+		zf_list_insert_after_bulk(&a[11], pb, 0);
+		test_zf_list_verify(&h, x, 14);
+		zf_list_insert_after_bulk_strided(&a[11], &c[0], sizeof(c[0]), 3);
+		x[14] = &c[0];
+		x[15] = &c[1];
+		x[16] = &c[2];
+		test_zf_list_verify(&h, x, 17);
+		zf_list_init(&h);
+		zf_list_insert_head_bulk_strided(&h, &c[0], sizeof(c[0]), 0);
+		TEST_VERIFY_TRUE(zf_list_empty(&h));
+		zf_list_insert_head_bulk_strided(&h, &c[0], sizeof(c[0]), 3);
+		test_zf_list_verify(&h, x + 14, 3);
+		zf_list_insert_after_bulk(&c[0], pb, 2);
+		zf_list_node *const y[] = {&c[0], &b[0], &b[1], &c[1], &c[2]};
+		test_zf_list_verify(&h, y, 5);
+	}
+#ifdef __cplusplus
+	{
+		list_test_entry a[10], c[2];
+		list_test_entry *pa[10];
+		zf_list_node *x[12];
+		for (unsigned i = 0; 10 > i; ++i)
+		{
+			pa[i] = &a[i];
+			x[i + 2] = &a[i].node;
+		}
+		x[0] = &c[0].node;
+		x[1] = &c[1].node;
+		list_test_head_ h = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_bulk_(&h, pa, 10);
+		test_zf_list_verify(&h, x + 2, 10);
+		zf_list_insert_head_bulk_(&h, c, 2);
+		test_zf_list_verify(&h, x, 12);
+		zf_list_init(&h);
+		zf_list_insert_head_bulk_(&h, pa, 1);
+		zf_list_insert_after_bulk_(&h, &a[0], c, 2);
+		zf_list_insert_after_bulk_(&h, &c[1], pa + 1, 9);
+		zf_list_node *y[12];
+		y[0] = &a[0].node;
+		y[1] = &c[0].node;
+		y[2] = &c[1].node;
+		for (unsigned i = 1; 10 > i; ++i)
+		{
+			y[i + 2] = &a[i].node;
+		}
+		test_zf_list_verify(&h, y, 12);
+	}
+#endif
+}
+
+static void test_zf_list_foreach_prefetch()
+{
+	{
+		zf_list_node a[12];
+		zf_list_node *x[12];
+		unsigned count = 0;
+		zf_list_head h = ZF_LIST_INITIALIZER();
+		zf_list_foreach_prefetch(&h, n, 4, 0)
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_list_insert_head_bulk_strided(&h, &a[0], sizeof(a[0]), 12);
+		zf_list_foreach_prefetch(&h, n, 4, sizeof(a[0]))
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(12u, count);
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(&a[i], x[i]);
+		}
+		count = 0;
+		zf_list_foreach_prefetch(&h, n, 0, -1)
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(12u, count);
+		TEST_VERIFY_EQUAL(&a[11], x[11]);
+	}
+#ifdef __cplusplus
+	{
+		list_test_entry a[12];
+		list_test_entry *x[12];
+		unsigned count = 0;
+		list_test_head_ h = ZF_LIST_INITIALIZER();
+		test_collect_<list_test_entry> f = {x, &count};
+		zf_list_foreach_prefetch_<4>(&h, f);
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_list_insert_head_bulk_(&h, a, 12);
+		zf_list_foreach_prefetch_<4>(&h, f, offsetof(list_test_entry, b));
+		TEST_VERIFY_EQUAL(12u, count);
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(&a[i], x[i]);
+		}
+		count = 0;
+		zf_list_foreach_prefetch_<16>(&h, f);
+		TEST_VERIFY_EQUAL(12u, count);
+		TEST_VERIFY_EQUAL(&a[11], x[11]);
+	}
+#endif
+}
+
+static void test_zf_list_relink()
+{
+	static const unsigned order[] = {5, 2, 7, 0, 3, 6, 1, 4};
+	{
+		zf_list_node a[8];
+		zf_list_node *x[8], *y[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			x[i] = &a[order[i]];
+			y[i] = &a[i];
+		}
+		zf_list_head h = ZF_LIST_INITIALIZER();
+		size_t count = 1;
+		TEST_VERIFY_EQUAL(0u, zf_list_disorder(&h, sizeof(a[0]), &count));
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_list_relink(&h);
+		test_zf_list_verify(&h, y, 0);
+		zf_list_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(7u, zf_list_disorder(&h, sizeof(a[0]), &count));
+		TEST_VERIFY_EQUAL(8u, count);
+		TEST_VERIFY_EQUAL(4u, zf_list_disorder(&h, 3 * sizeof(a[0]), 0));
+		zf_list_relink(&h);
+		test_zf_list_verify(&h, y, 8);
+		TEST_VERIFY_EQUAL(0u, zf_list_disorder(&h, sizeof(a[0]), 0));
+	}
+	{
+		list_test_entry a[8], slab[8];
+		zf_list_node *x[8], *y[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			a[i].a[0] = i;
+			x[i] = &a[order[i]].node;
+			y[i] = &slab[i].node;
+		}
+		zf_list_head h = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_bulk(&h, x, 8);
+		size_t size = sizeof(list_test_entry);
+		TEST_VERIFY_EQUAL(8u, zf_list_compact(&h, slab, 7, size,
+						  offsetof(list_test_entry, node), test_move, &size));
+		test_zf_list_verify(&h, x, 8);
+		TEST_VERIFY_EQUAL(8u, zf_list_compact(&h, slab, 8, size,
+						  offsetof(list_test_entry, node), test_move, &size));
+		test_zf_list_verify(&h, y, 8);
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(order[i], slab[i].a[0]);
+		}
+		TEST_VERIFY_EQUAL(0u, zf_list_disorder(&h, size, 0));
+	}
+#ifdef __cplusplus
+	{
+		list_test_entry a[8], slab[8];
+		list_test_entry *x[8];
+		zf_list_node *y[8], *z[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			a[i].a[0] = i;
+			x[i] = &a[order[i]];
+			y[i] = &a[i].node;
+			z[i] = &slab[i].node;
+		}
+		list_test_head_ h = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_bulk_(&h, x, 8);
+		TEST_VERIFY_EQUAL(7u, zf_list_disorder_(&h, sizeof(a[0])));
+		zf_list_relink_(&h);
+		test_zf_list_verify(&h, y, 8);
+		TEST_VERIFY_EQUAL(8u, zf_list_compact_(&h, slab, 8, test_move_()));
+		test_zf_list_verify(&h, z, 8);
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(i, slab[i].a[0]);
+		}
+	}
+#endif
+}
+
+static bool list_test_odd(zf_list_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return 0 != (1 & zf_entry(n, list_test_entry, node)->a[0]);
+}
+
+static bool list_test_three(zf_list_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return 3 == zf_entry(n, list_test_entry, node)->a[0];
+}
+
+static void list_test_dispose(zf_list_node *const n, void *const ctx)
+{
+	(void)n;
+	++*(unsigned *)ctx;
+}
+
+static bool list_test_equal(zf_list_node *const a, zf_list_node *const b,
+							void *const ctx)
+{
+	(void)ctx;
+	return zf_entry(a, list_test_entry, node)->a[0] ==
+		   zf_entry(b, list_test_entry, node)->a[0];
+}
+
+static void test_zf_list_filter()
+{
+	static const unsigned values[] = {1, 1, 2, 3, 3, 3, 4, 1};
+	list_test_entry a[8];
+	zf_list_node *x[8];
+	for (unsigned i = 0; 8 > i; ++i)
+	{
+		a[i].a[0] = values[i];
+		x[i] = &a[i].node;
+	}
+	{
+		zf_list_head h = ZF_LIST_INITIALIZER();
+		zf_list_head h2 = ZF_LIST_INITIALIZER();
+		TEST_VERIFY_EQUAL(0u, zf_list_partition(&h, &h2, list_test_odd, 0));
+		test_zf_list_verify(&h, x, 0);
+		test_zf_list_verify(&h2, x, 0);
+		zf_list_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(6u, zf_list_partition(&h, &h2, list_test_odd, 0));
+		zf_list_node *const y[] = {x[2], x[6]};
+		test_zf_list_verify(&h, y, 2);
+		zf_list_node *const z[] = {x[0], x[1], x[3], x[4], x[5], x[7]};
+		test_zf_list_verify(&h2, z, 6);
+		zf_list_insert_head_bulk(&h, x, 0);
+		test_zf_list_verify(&h, y, 2);
+	}
+	{
+		unsigned disposed = 0;
+		zf_list_head h = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(3u, zf_list_remove_if(&h, list_test_three,
+						  list_test_dispose, &disposed));
+		TEST_VERIFY_EQUAL(3u, disposed);
+		zf_list_node *const y[] = {x[0], x[1], x[2], x[6], x[7]};
+		test_zf_list_verify(&h, y, 5);
+		TEST_VERIFY_EQUAL(3u, zf_list_remove_if(&h, list_test_odd, 0, 0));
+	}
+	{
+		zf_list_head h = ZF_LIST_INITIALIZER();
+		zf_list_head h2 = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(3u, zf_list_unique(&h, &h2, list_test_equal, 0));
+		zf_list_node *const y[] = {x[0], x[2], x[3], x[6], x[7]};
+		test_zf_list_verify(&h, y, 5);
+		zf_list_node *const z[] = {x[1], x[4], x[5]};
+		test_zf_list_verify(&h2, z, 3);
+	}
+#ifdef __cplusplus
+	{
+		list_test_entry *e[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			e[i] = &a[i];
+		}
+		list_test_head_ h = ZF_LIST_INITIALIZER();
+		list_test_head_ h2 = ZF_LIST_INITIALIZER();
+		zf_list_insert_head_bulk_(&h, e, 8);
+		TEST_VERIFY_EQUAL(6u, zf_list_partition_(&h, &h2,
+						  test_odd_<list_test_entry>()));
+		zf_list_node *const y[] = {x[2], x[6]};
+		test_zf_list_verify(&h, y, 2);
+		zf_list_init(&h);
+		zf_list_insert_head_bulk_(&h, e, 8);
+		TEST_VERIFY_EQUAL(3u, zf_list_unique_(&h, &h2,
+						  test_equal_<list_test_entry>()));
+		zf_list_node *const z[] = {x[1], x[4], x[5]};
+		test_zf_list_verify(&h2, z, 3);
+		unsigned disposed = 0;
+		const test_count_ dispose = {&disposed};
+		TEST_VERIFY_EQUAL(3u, zf_list_remove_if_(&h, test_odd_<list_test_entry>(),
+						  dispose));
+		TEST_VERIFY_EQUAL(3u, disposed);
+		test_zf_list_verify(&h, y, 2);
+		TEST_VERIFY_EQUAL(0u, zf_list_remove_if_(&h, test_odd_<list_test_entry>()));
+	}
+#endif
+}
+
+#ifdef __cplusplus
+static void test_zf_list_link_policy()
+{
+	typedef zf_list_head_<list_test_entry, &list_test_entry::node,
+						  zf_link_safe_> safe_head_;
+	list_test_entry a[4];
+	memset(a, 0, sizeof(a));
+	safe_head_ h = ZF_LIST_INITIALIZER();
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].a[0] = i;
+		TEST_VERIFY_FALSE(zf_list_linked_(&h, &a[i]));
+		zf_list_insert_head_(&h, &a[i]);
+		TEST_VERIFY_TRUE(zf_list_linked_(&h, &a[i]));
+	}
+	zf_list_remove_(&h, &a[1]);
+	TEST_VERIFY_FALSE(zf_list_linked_(&h, &a[1]));
+	TEST_VERIFY_EQUAL(nullptr, a[1].node.next);
+	TEST_VERIFY_TRUE(zf_list_linked_(&h, &a[0]));
+	TEST_VERIFY_TRUE(zf_list_linked_(&h, &a[2]));
+	unsigned disposed = 0;
+	const test_count_ dispose = {&disposed};
+	TEST_VERIFY_EQUAL(1u, zf_list_remove_if_(&h, test_odd_<list_test_entry>(),
+											 dispose));
+	TEST_VERIFY_EQUAL(1u, disposed);
+	TEST_VERIFY_FALSE(zf_list_linked_(&h, &a[3]));
+	a[2].a[0] = 5;
+	TEST_VERIFY_EQUAL(1u, zf_list_remove_if_(&h, test_odd_<list_test_entry>()));
+	TEST_VERIFY_FALSE(zf_list_linked_(&h, &a[2]));
+	TEST_VERIFY_EQUAL(&a[0], zf_list_first_(&h));
+	TEST_VERIFY_EQUAL(nullptr, a[0].node.next);
+	/* fast head leaves stale pointers */
+	list_test_head_ f = ZF_LIST_INITIALIZER();
+	zf_list_insert_head_(&f, &a[1]);
+	zf_list_remove_(&f, &a[1]);
+	TEST_VERIFY_NOT_EQUAL(nullptr, a[1].node.pprev);
+#if __cplusplus >= 201103L
+	typedef zf_list_head_<list_test_entry, &list_test_entry::node,
+						  zf_link_auto_> auto_head_;
+	typedef zf_list_auto_unlink_<list_test_entry,
+								 &list_test_entry::node> auto_entry_;
+	/* head functions take entries as list_test_entry */
+	auto_entry_ x;
+	list_test_entry *const px = &x;
+	{
+		auto_head_ ah = ZF_LIST_INITIALIZER();
+		auto_entry_ y;
+		TEST_VERIFY_FALSE(zf_list_linked_(&ah, px));
+		zf_list_insert_head_(&ah, px);
+		zf_list_insert_head_<list_test_entry>(&ah, &y);
+		{
+			auto_entry_ z;
+			list_test_entry *const pz = &z;
+			zf_list_insert_after_(&ah, px, pz);
+			TEST_VERIFY_EQUAL(pz, zf_list_next_(&ah, px));
+		}
+		/* z removed itself */
+		TEST_VERIFY_EQUAL(nullptr, x.node.next);
+		TEST_VERIFY_EQUAL(&y, zf_list_first_(&ah));
+	}
+	/* y removed itself, then head unlinked x */
+	TEST_VERIFY_EQUAL(nullptr, x.node.pprev);
+	TEST_VERIFY_EQUAL(nullptr, x.node.next);
+#endif
+}
+
+#if __cplusplus >= 201103L
+struct list_test_value_entry
+{
+	explicit list_test_value_entry(const unsigned v): value(v) {}
+	unsigned value;
+	zf_list_node node;
+};
+
+static void test_zf_list_auto_unlink()
+{
+	typedef zf_list_head_<list_test_value_entry, &list_test_value_entry::node,
+						  zf_link_auto_> auto_head_;
+	typedef zf_list_auto_unlink_<list_test_value_entry,
+								 &list_test_value_entry::node> auto_entry_;
+	/* constructor with arguments starts unlinked over garbage */
+	alignas(auto_entry_) unsigned char buffer[sizeof(auto_entry_)];
+	memset(buffer, 0xab, sizeof(buffer));
+	auto_entry_ *const p = new (buffer) auto_entry_(4u);
+	TEST_VERIFY_EQUAL(4u, p->value);
+	TEST_VERIFY_EQUAL(nullptr, p->node.next);
+	TEST_VERIFY_EQUAL(nullptr, p->node.pprev);
+	p->~auto_entry_();
+	/* assignment keeps position of both entries */
+	auto_head_ h = ZF_LIST_INITIALIZER();
+	{
+		auto_entry_ a(1u), b(2u);
+		{
+			auto_entry_ c(3u);
+			zf_list_insert_head_<list_test_value_entry>(&h, &a);
+			zf_list_insert_head_<list_test_value_entry>(&h, &c);
+			zf_list_insert_head_<list_test_value_entry>(&h, &b);
+			c = a;
+			TEST_VERIFY_EQUAL(1u, c.value);
+			TEST_VERIFY_EQUAL(&a.node, c.node.next);
+			TEST_VERIFY_EQUAL(&b.node.next, c.node.pprev);
+		}
+		/* c removed itself, b and a still linked */
+		TEST_VERIFY_EQUAL(&a.node, b.node.next);
+		TEST_VERIFY_EQUAL(&b.node.next, a.node.pprev);
+		b = a;
+		TEST_VERIFY_EQUAL(&b.node, h.first);
+		TEST_VERIFY_EQUAL(&a.node, b.node.next);
+	}
+	TEST_VERIFY_TRUE(zf_list_empty(&h));
+}
+#endif
+
+static void test_zf_list_iterator()
+{
+	list_test_entry a[4];
+	list_test_entry *e[4];
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].a[0] = 10 + i;
+		e[i] = &a[i];
+	}
+	list_test_head_ h = ZF_LIST_INITIALIZER();
+	TEST_VERIFY_TRUE(h.begin() == h.end());
+	zf_list_insert_head_bulk_(&h, e, 4);
+	unsigned k = 0;
+	for (list_test_head_::iterator i = h.begin(); h.end() != i; ++k, i++)
+	{
+		TEST_VERIFY_EQUAL(&a[k], &*i);
+		TEST_VERIFY_EQUAL(10 + k, i->a[0]);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+	TEST_VERIFY_EQUAL(4, (int)std::distance(h.begin(), h.end()));
+	const test_value_is_ v12 = {12};
+	TEST_VERIFY_EQUAL(&a[2], &*std::find_if(h.begin(), h.end(), v12));
+	const test_value_is_ v42 = {42};
+	TEST_VERIFY_TRUE(h.end() == std::find_if(h.begin(), h.end(), v42));
+	list_test_head_::iterator i = h.begin();
+	std::advance(i, 3);
+	TEST_VERIFY_EQUAL(&a[3], &*i);
+	const list_test_head_ &c = h;
+	TEST_VERIFY_EQUAL(4, (int)std::distance(c.begin(), c.end()));
+	TEST_VERIFY_EQUAL(&a[2], &*std::find_if(c.cbegin(), c.cend(), v12));
+	list_test_head_::const_iterator ci = h.begin();
+	TEST_VERIFY_TRUE(c.begin() == ci);
+	TEST_VERIFY_EQUAL(11u, (++ci)->a[0]);
+	TEST_VERIFY_TRUE(ci != h.begin() && h.begin() != ci);
+	TEST_VERIFY_TRUE(++h.begin() == ci && ci == ++h.begin());
+#if __cplusplus >= 201103L
+	k = 0;
+	for (list_test_entry &x: h)
+	{
+		TEST_VERIFY_EQUAL(&a[k++], &x);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+	k = 0;
+	for (const list_test_entry &x: c)
+	{
+		TEST_VERIFY_EQUAL(&a[k++], &x);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+#endif
+}
+#endif
+
 static void test_zf_list(TEST_SUIT_ARGUMENTS)
 {
 	TEST_EXECUTE(test_zf_list_entry());
@@ -633,6 +1704,21 @@ static void test_zf_list(TEST_SUIT_ARGUMENTS)
 	TEST_EXECUTE(test_zf_list_insert_before());
 	TEST_EXECUTE(test_zf_list_insert_after());
 	TEST_EXECUTE(test_zf_list_remove());
+	TEST_EXECUTE(test_zf_list_swap());
+	TEST_EXECUTE(test_zf_list_concat());
+	TEST_EXECUTE(test_zf_list_splice());
+	TEST_EXECUTE(test_zf_list_split());
+	TEST_EXECUTE(test_zf_list_insert_bulk());
+	TEST_EXECUTE(test_zf_list_foreach_prefetch());
+	TEST_EXECUTE(test_zf_list_relink());
+	TEST_EXECUTE(test_zf_list_filter());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_list_link_policy());
+#if __cplusplus >= 201103L
+	TEST_EXECUTE(test_zf_list_auto_unlink());
+#endif
+	TEST_EXECUTE(test_zf_list_iterator());
+#endif
 }
 
 /*
@@ -776,10 +1862,26 @@ static void test_zf_stailq_insert_after()
 	TEST_VERIFY_EQUAL(&n1, zf_stailq_next(&n2));
 	TEST_VERIFY_EQUAL(&n3, zf_stailq_next(&n1));
 	TEST_VERIFY_EQUAL(nullptr, zf_stailq_next(&n3));
-}
-
-static void test_zf_stailq_remove_head()
-{
+#ifdef __cplusplus
+	{
+		stailq_test_head_ hpp = ZF_STAILQ_INITIALIZER(&hpp);
+		stailq_test_entry e0, e1, e2, e3;
+		zf_stailq_insert_tail_(&hpp, &e1);
+		zf_stailq_insert_head_(&hpp, &e0);
+		zf_stailq_insert_tail_(&hpp, &e3);
+		zf_stailq_insert_after_(&hpp, &e1, &e2);
+		TEST_VERIFY_EQUAL(&e0, zf_stailq_first_(&hpp));
+		TEST_VERIFY_EQUAL(&e3, zf_stailq_last_(&hpp));
+		TEST_VERIFY_EQUAL(&e1, zf_stailq_next_(&hpp, &e0));
+		TEST_VERIFY_EQUAL(&e2, zf_stailq_next_(&hpp, &e1));
+		TEST_VERIFY_EQUAL(&e3, zf_stailq_next_(&hpp, &e2));
+		TEST_VERIFY_EQUAL(zf_stailq_end_(&hpp), zf_stailq_next_(&hpp, &e3));
+	}
+#endif
+}
+
+static void test_zf_stailq_remove_head()
+{
 	zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
 	zf_stailq_node n0;
 	zf_stailq_insert_tail(&h, &n0);
@@ -835,6 +1937,721 @@ static void test_zf_stailq_remove_after()
 	TEST_VERIFY_EQUAL(nullptr, zf_stailq_next(&n0));
 }
 
+static uint64_t stailq_test_key(zf_stailq_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return test_radix_key(zf_entry(n, stailq_test_entry, node)->a[0]);
+}
+
+#ifdef __cplusplus
+struct stailq_test_key_
+{
+	uint64_t operator()(const stailq_test_entry *const e) const
+	{
+		return test_radix_key(e->a[0]);
+	}
+};
+#endif
+
+/* Verify that h has count entries sorted by key, equal keys in insertion order */
+static void test_zf_stailq_verify_sorted(zf_stailq_head *const h,
+										 const unsigned count)
+{
+	unsigned n = 0;
+	zf_stailq_node *last = nullptr;
+	for (zf_stailq_node *i = zf_stailq_begin(h); zf_stailq_end(h) != i;
+		 i = zf_stailq_next(i))
+	{
+		if (nullptr != last)
+		{
+			const stailq_test_entry *const p = zf_entry(last, stailq_test_entry, node);
+			const stailq_test_entry *const e = zf_entry(i, stailq_test_entry, node);
+			const uint64_t pk = test_radix_key(p->a[0]);
+			const uint64_t ek = test_radix_key(e->a[0]);
+			TEST_VERIFY_TRUE(pk < ek || (pk == ek && p->a[0] < e->a[0]));
+		}
+		last = i;
+		++n;
+	}
+	TEST_VERIFY_EQUAL(count, n);
+	TEST_VERIFY_EQUAL(last, zf_stailq_last(h));
+}
+
+static void test_zf_stailq_radix_sort()
+{
+	stailq_test_entry e[100];
+	const unsigned count = sizeof(e) / sizeof(e[0]);
+	{
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_radix_sort(&h, stailq_test_key, nullptr);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&h));
+		for (unsigned i = 0; count > i; ++i)
+		{
+			e[i].a[0] = i;
+			zf_stailq_insert_tail(&h, &e[i].node);
+		}
+		zf_stailq_radix_sort(&h, stailq_test_key, nullptr);
+		test_zf_stailq_verify_sorted(&h, count);
+		zf_stailq_radix_sort(&h, stailq_test_key, nullptr);
+		test_zf_stailq_verify_sorted(&h, count);
+		zf_stailq_node n0;
+		zf_stailq_insert_tail(&h, &n0);
+		TEST_VERIFY_EQUAL(&n0, zf_stailq_last(&h));
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_head_ hpp = ZF_STAILQ_INITIALIZER(&hpp);
+		for (unsigned i = 0; count > i; ++i)
+		{
+			e[i].a[0] = i;
+			zf_stailq_insert_tail(&hpp, &e[i].node);
+		}
+		zf_stailq_radix_sort_(&hpp, stailq_test_key_());
+		test_zf_stailq_verify_sorted(&hpp, count);
+	}
+#endif
+}
+
+static int stailq_test_cmp(zf_stailq_node *const a, zf_stailq_node *const b,
+						   void *const ctx)
+{
+	const unsigned ka = zf_entry(a, stailq_test_entry, node)->a[0];
+	const unsigned kb = zf_entry(b, stailq_test_entry, node)->a[0];
+	(void)ctx;
+	return ka < kb? -1: kb < ka? 1: 0;
+}
+
+#ifdef __cplusplus
+struct stailq_test_less_
+{
+	bool operator()(const stailq_test_entry *const a,
+					const stailq_test_entry *const b) const
+	{
+		return a->a[0] < b->a[0];
+	}
+};
+#endif
+
+/* Entry i goes to list i % k (except list 2 which stays empty) with key i / 3,
+ * list index is stored in a[1].
+ */
+static void test_zf_stailq_merge_fill(zf_stailq_head *const in, const unsigned k,
+									  stailq_test_entry *const e,
+									  const unsigned count)
+{
+	for (unsigned i = 0; k > i; ++i)
+	{
+		zf_stailq_init(&in[i]);
+	}
+	for (unsigned i = 0; count > i; ++i)
+	{
+		const unsigned l = 2 == i % k? 0: i % k;
+		e[i].a[0] = i / 3;
+		e[i].a[1] = l;
+		e[i].a[2] = i;
+		zf_stailq_insert_tail(&in[l], &e[i].node);
+	}
+}
+
+static void test_zf_stailq_merge_verify(zf_stailq_head *const h,
+										const unsigned count)
+{
+	unsigned n = 0;
+	const stailq_test_entry *p = nullptr;
+	for (zf_stailq_node *i = zf_stailq_begin(h); zf_stailq_end(h) != i;
+		 i = zf_stailq_next(i), ++n)
+	{
+		const stailq_test_entry *const e = zf_entry(i, stailq_test_entry, node);
+		if (nullptr != p)
+		{
+			TEST_VERIFY_TRUE(p->a[0] < e->a[0] ||
+							 (p->a[0] == e->a[0] && p->a[1] < e->a[1]) ||
+							 (p->a[0] == e->a[0] && p->a[1] == e->a[1] &&
+							  p->a[2] < e->a[2]));
+		}
+		p = e;
+	}
+	TEST_VERIFY_EQUAL(count, n);
+}
+
+static void test_zf_stailq_merge()
+{
+	stailq_test_entry e[60];
+	const unsigned count = sizeof(e) / sizeof(e[0]);
+	zf_stailq_head in[5];
+	const unsigned k = sizeof(in) / sizeof(in[0]);
+	size_t tree[sizeof(in) / sizeof(in[0])];
+	{
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		TEST_VERIFY_EQUAL(0u, zf_stailq_merge(&h, in, 0, tree, stailq_test_cmp,
+											  nullptr, ZF_MERGE_ALL));
+		test_zf_stailq_merge_fill(in, k, e, count);
+		TEST_VERIFY_EQUAL(count, zf_stailq_merge(&h, in, k, tree, stailq_test_cmp,
+												 nullptr, ZF_MERGE_ALL));
+		test_zf_stailq_merge_verify(&h, count);
+		for (unsigned i = 0; k > i; ++i)
+		{
+			TEST_VERIFY_TRUE(zf_stailq_empty(&in[i]));
+		}
+	}
+	{
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		test_zf_stailq_merge_fill(in, k, e, count);
+		TEST_VERIFY_EQUAL(7u, zf_stailq_merge(&h, in, k, tree, stailq_test_cmp,
+											  nullptr, 7));
+		test_zf_stailq_merge_verify(&h, 7);
+		TEST_VERIFY_EQUAL(2u, zf_entry(zf_stailq_last(&h), stailq_test_entry, node)->a[0]);
+		zf_stailq_head rest = ZF_STAILQ_INITIALIZER(&rest);
+		TEST_VERIFY_EQUAL(count - 7, zf_stailq_merge(&rest, in, k, tree, stailq_test_cmp,
+													 nullptr, ZF_MERGE_ALL));
+		test_zf_stailq_merge_verify(&rest, count - 7);
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_head_ hpp = ZF_STAILQ_INITIALIZER(&hpp);
+		stailq_test_head_ inpp[sizeof(in) / sizeof(in[0])];
+		test_zf_stailq_merge_fill(inpp, k, e, count);
+		TEST_VERIFY_EQUAL(count, zf_stailq_merge_(&hpp, inpp, k, tree,
+												  stailq_test_less_()));
+		test_zf_stailq_merge_verify(&hpp, count);
+	}
+#endif
+}
+
+static void test_zf_stailq_verify(zf_stailq_head *const h,
+								  zf_stailq_node *const *const n,
+								  const unsigned count)
+{
+	zf_stailq_node *i = zf_stailq_begin(h);
+	for (unsigned k = 0; count > k; ++k, i = zf_stailq_next(i))
+	{
+		TEST_VERIFY_EQUAL(n[k], i);
+	}
+	TEST_VERIFY_EQUAL(zf_stailq_end(h), i);
+	TEST_VERIFY_EQUAL(0 == count? nullptr: n[count - 1], zf_stailq_last(h));
+}
+
+static void test_zf_stailq_swap()
+{
+	{
+		zf_stailq_node a[2], b[1];
+		zf_stailq_head ha = ZF_STAILQ_INITIALIZER(&ha);
+		zf_stailq_insert_tail(&ha, &a[0]);
+		zf_stailq_insert_tail(&ha, &a[1]);
+		zf_stailq_head hb = ZF_STAILQ_INITIALIZER(&hb);
+		zf_stailq_insert_tail(&hb, &b[0]);
+		zf_stailq_swap(&ha, &hb);
+		zf_stailq_node *const x0[] = {&b[0]};
+		test_zf_stailq_verify(&ha, x0, 1);
+		zf_stailq_node *const x1[] = {&a[0], &a[1]};
+		test_zf_stailq_verify(&hb, x1, 2);
+		zf_stailq_head hc = ZF_STAILQ_INITIALIZER(&hc);
+		zf_stailq_swap(&ha, &hc);
+		test_zf_stailq_verify(&ha, x0, 0);
+		test_zf_stailq_verify(&hc, x0, 1);
+		zf_stailq_insert_tail(&ha, &a[0]);
+		test_zf_stailq_verify(&ha, x1, 1);
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_entry a[2];
+		stailq_test_head_ ha = ZF_STAILQ_INITIALIZER(&ha);
+		zf_stailq_insert_tail(&ha, &a[0].node);
+		zf_stailq_insert_tail(&ha, &a[1].node);
+		stailq_test_head_ hb = ZF_STAILQ_INITIALIZER(&hb);
+		zf_stailq_swap_(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&ha));
+		zf_stailq_node *const x[] = {&a[0].node, &a[1].node};
+		test_zf_stailq_verify(&hb, x, 2);
+	}
+#endif
+}
+
+static void test_zf_stailq_concat()
+{
+	{
+		zf_stailq_node a[2], b[2];
+		zf_stailq_head ha = ZF_STAILQ_INITIALIZER(&ha);
+		zf_stailq_head hb = ZF_STAILQ_INITIALIZER(&hb);
+		zf_stailq_concat(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&ha));
+		zf_stailq_insert_tail(&hb, &b[0]);
+		zf_stailq_insert_tail(&hb, &b[1]);
+		zf_stailq_concat(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&hb));
+		zf_stailq_node *const x0[] = {&b[0], &b[1]};
+		test_zf_stailq_verify(&ha, x0, 2);
+		zf_stailq_insert_tail(&hb, &a[0]);
+		zf_stailq_insert_tail(&hb, &a[1]);
+		zf_stailq_concat(&hb, &ha);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&ha));
+		zf_stailq_node *const x1[] = {&a[0], &a[1], &b[0], &b[1]};
+		test_zf_stailq_verify(&hb, x1, 4);
+		zf_stailq_concat(&hb, &ha);
+		test_zf_stailq_verify(&hb, x1, 4);
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_entry a[2];
+		stailq_test_head_ ha = ZF_STAILQ_INITIALIZER(&ha);
+		zf_stailq_insert_tail(&ha, &a[0].node);
+		stailq_test_head_ hb = ZF_STAILQ_INITIALIZER(&hb);
+		zf_stailq_insert_tail(&hb, &a[1].node);
+		zf_stailq_concat_(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&hb));
+		zf_stailq_node *const x[] = {&a[0].node, &a[1].node};
+		test_zf_stailq_verify(&ha, x, 2);
+	}
+#endif
+}
+
+static void test_zf_stailq_splice()
+{
+	{
+		zf_stailq_node a[5], b[2];
+		zf_stailq_head ha = ZF_STAILQ_INITIALIZER(&ha);
+		for (unsigned i = 0; 5 > i; ++i)
+		{
+			zf_stailq_insert_tail(&ha, &a[i]);
+		}
+		zf_stailq_head hb = ZF_STAILQ_INITIALIZER(&hb);
+		zf_stailq_insert_tail(&hb, &b[0]);
+		zf_stailq_insert_tail(&hb, &b[1]);
+		zf_stailq_splice_head(&hb, &ha, &a[0], &a[2]);
+		zf_stailq_node *const x0[] = {&a[0], &a[3], &a[4]};
+		test_zf_stailq_verify(&ha, x0, 3);
+		zf_stailq_node *const x1[] = {&a[1], &a[2], &b[0], &b[1]};
+		test_zf_stailq_verify(&hb, x1, 4);
+		zf_stailq_splice_tail(&hb, &ha, &a[0], &a[4]);
+		zf_stailq_node *const x2[] = {&a[0]};
+		test_zf_stailq_verify(&ha, x2, 1);
+		zf_stailq_node *const x3[] = {&a[1], &a[2], &b[0], &b[1], &a[3], &a[4]};
+		test_zf_stailq_verify(&hb, x3, 6);
+		zf_stailq_splice_head(&hb, &hb, &a[2], &b[1]);
+		zf_stailq_node *const x4[] = {&b[0], &b[1], &a[1], &a[2], &a[3], &a[4]};
+		test_zf_stailq_verify(&hb, x4, 6);
+		zf_stailq_splice_tail(&hb, &hb, &a[3], &a[4]);
+		test_zf_stailq_verify(&hb, x4, 6);
+		zf_stailq_splice_tail(&hb, &hb, nullptr, &b[1]);
+		zf_stailq_node *const x5[] = {&a[1], &a[2], &a[3], &a[4], &b[0], &b[1]};
+		test_zf_stailq_verify(&hb, x5, 6);
+		zf_stailq_splice_after(&ha, &a[0], &hb, nullptr, &b[1]);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&hb));
+		zf_stailq_node *const x6[] = {&a[0], &a[1], &a[2], &a[3], &a[4], &b[0], &b[1]};
+		test_zf_stailq_verify(&ha, x6, 7);
+		zf_stailq_splice_head(&hb, &ha, &a[4], &b[1]);
+		test_zf_stailq_verify(&ha, x6, 5);
+		test_zf_stailq_verify(&hb, x6 + 5, 2);
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_entry a[3];
+		stailq_test_head_ ha = ZF_STAILQ_INITIALIZER(&ha);
+		for (unsigned i = 0; 3 > i; ++i)
+		{
+			zf_stailq_insert_tail(&ha, &a[i].node);
+		}
+		stailq_test_head_ hb = ZF_STAILQ_INITIALIZER(&hb);
+		zf_stailq_splice_head_(&hb, &ha, &a[0], &a[2]);
+		zf_stailq_splice_tail_(&hb, &ha, (stailq_test_entry *)nullptr, &a[0]);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&ha));
+		zf_stailq_splice_after_(&hb, &a[1], &hb, &a[2], &a[0]);
+		zf_stailq_node *const x[] = {&a[1].node, &a[0].node, &a[2].node};
+		test_zf_stailq_verify(&hb, x, 3);
+	}
+#endif
+}
+
+static void test_zf_stailq_split_after()
+{
+	{
+		zf_stailq_node a[3];
+		zf_stailq_head ha = ZF_STAILQ_INITIALIZER(&ha);
+		for (unsigned i = 0; 3 > i; ++i)
+		{
+			zf_stailq_insert_tail(&ha, &a[i]);
+		}
+		zf_stailq_head hb;
+		zf_stailq_split_after(&ha, &a[2], &hb);
+		zf_stailq_node *const x0[] = {&a[0], &a[1], &a[2]};
+		test_zf_stailq_verify(&ha, x0, 3);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&hb));
+		zf_stailq_split_after(&ha, &a[0], &hb);
+		test_zf_stailq_verify(&ha, x0, 1);
+		test_zf_stailq_verify(&hb, x0 + 1, 2);
+		zf_stailq_split_after(&ha, nullptr, &hb);
+		TEST_VERIFY_TRUE(zf_stailq_empty(&ha));
+		test_zf_stailq_verify(&hb, x0, 1);
+		zf_stailq_insert_tail(&ha, &a[1]);
+		test_zf_stailq_verify(&ha, x0 + 1, 1);
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_entry a[2];
+		stailq_test_head_ ha = ZF_STAILQ_INITIALIZER(&ha);
+		zf_stailq_insert_tail(&ha, &a[0].node);
+		zf_stailq_insert_tail(&ha, &a[1].node);
+		stailq_test_head_ hb;
+		zf_stailq_split_after_(&ha, &a[0], &hb);
+		zf_stailq_node *const x[] = {&a[0].node, &a[1].node};
+		test_zf_stailq_verify(&ha, x, 1);
+		test_zf_stailq_verify(&hb, x + 1, 1);
+	}
+#endif
+}
+
+static void test_zf_stailq_insert_bulk()
+{
+	{
+		zf_stailq_node a[12], b[2], c[3];
+		zf_stailq_node *pa[12], *pb[2], *x[17];
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			pa[i] = &a[i];
+			x[i + 2] = &a[i];
+		}
+		pb[0] = x[0] = &b[0];
+		pb[1] = x[1] = &b[1];
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_insert_tail_bulk(&h, pa, 0);
+		test_zf_stailq_verify(&h, pa, 0);
+		zf_stailq_insert_tail_bulk(&h, pa, 12);
+		test_zf_stailq_verify(&h, pa, 12);
+		zf_stailq_insert_head_bulk(&h, pb, 2);
+		test_zf_stailq_verify(&h, x, 14);
+		zf_stailq_insert_after_bulk(&h, &a[11], pb, 0);
+		test_zf_stailq_verify(&h, x, 14);
+		zf_stailq_insert_after_bulk_strided(&h, &a[11], &c[0], sizeof(c[0]), 3);
+		x[14] = &c[0];
+		x[15] = &c[1];
+		x[16] = &c[2];
+		test_zf_stailq_verify(&h, x, 17);
+		zf_stailq_init(&h);
+		zf_stailq_insert_head_bulk_strided(&h, &c[1], sizeof(c[0]), 2);
+		test_zf_stailq_verify(&h, x + 15, 2);
+		zf_stailq_insert_head_bulk_strided(&h, &c[0], sizeof(c[0]), 1);
+		test_zf_stailq_verify(&h, x + 14, 3);
+		zf_stailq_insert_after_bulk(&h, &c[0], pb, 2);
+		zf_stailq_insert_tail_bulk_strided(&h, &a[0], sizeof(a[0]), 2);
+		zf_stailq_node *const y[] = {&c[0], &b[0], &b[1], &c[1], &c[2], &a[0], &a[1]};
+		test_zf_stailq_verify(&h, y, 7);
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_entry a[10], c[2];
+		stailq_test_entry *pa[10];
+		zf_stailq_node *x[14];
+		for (unsigned i = 0; 10 > i; ++i)
+		{
+			pa[i] = &a[i];
+			x[i + 2] = &a[i].node;
+		}
+		x[0] = &c[0].node;
+		x[1] = &c[1].node;
+		stailq_test_head_ h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_insert_tail_bulk_(&h, pa, 10);
+		test_zf_stailq_verify(&h, x + 2, 10);
+		zf_stailq_insert_head_bulk_(&h, c, 2);
+		test_zf_stailq_verify(&h, x, 12);
+		zf_stailq_init(&h);
+		zf_stailq_insert_head_bulk_(&h, pa + 8, 2);
+		zf_stailq_insert_tail_bulk_(&h, c, 2);
+		zf_stailq_insert_after_bulk_(&h, &a[9], pa, 2);
+		zf_stailq_insert_after_bulk_(&h, &c[1], a + 2, 2);
+		zf_stailq_node *const y[] = {&a[8].node, &a[9].node, &a[0].node,
+								 &a[1].node, &c[0].node, &c[1].node,
+								 &a[2].node, &a[3].node};
+		test_zf_stailq_verify(&h, y, 8);
+	}
+#endif
+}
+
+static void test_zf_stailq_foreach_prefetch()
+{
+	{
+		zf_stailq_node a[12];
+		zf_stailq_node *x[12];
+		unsigned count = 0;
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_foreach_prefetch(&h, n, 4, 0)
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_stailq_insert_head_bulk_strided(&h, &a[0], sizeof(a[0]), 12);
+		zf_stailq_foreach_prefetch(&h, n, 4, sizeof(a[0]))
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(12u, count);
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(&a[i], x[i]);
+		}
+		count = 0;
+		zf_stailq_foreach_prefetch(&h, n, 0, -1)
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(12u, count);
+		TEST_VERIFY_EQUAL(&a[11], x[11]);
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_entry a[12];
+		stailq_test_entry *x[12];
+		unsigned count = 0;
+		stailq_test_head_ h = ZF_STAILQ_INITIALIZER(&h);
+		test_collect_<stailq_test_entry> f = {x, &count};
+		zf_stailq_foreach_prefetch_<4>(&h, f);
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_stailq_insert_head_bulk_(&h, a, 12);
+		zf_stailq_foreach_prefetch_<4>(&h, f, offsetof(stailq_test_entry, b));
+		TEST_VERIFY_EQUAL(12u, count);
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(&a[i], x[i]);
+		}
+		count = 0;
+		zf_stailq_foreach_prefetch_<16>(&h, f);
+		TEST_VERIFY_EQUAL(12u, count);
+		TEST_VERIFY_EQUAL(&a[11], x[11]);
+	}
+#endif
+}
+
+static void test_zf_stailq_relink()
+{
+	static const unsigned order[] = {5, 2, 7, 0, 3, 6, 1, 4};
+	{
+		zf_stailq_node a[8];
+		zf_stailq_node *x[8], *y[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			x[i] = &a[order[i]];
+			y[i] = &a[i];
+		}
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		size_t count = 1;
+		TEST_VERIFY_EQUAL(0u, zf_stailq_disorder(&h, sizeof(a[0]), &count));
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_stailq_relink(&h);
+		test_zf_stailq_verify(&h, y, 0);
+		zf_stailq_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(7u, zf_stailq_disorder(&h, sizeof(a[0]), &count));
+		TEST_VERIFY_EQUAL(8u, count);
+		TEST_VERIFY_EQUAL(4u, zf_stailq_disorder(&h, 3 * sizeof(a[0]), 0));
+		zf_stailq_relink(&h);
+		test_zf_stailq_verify(&h, y, 8);
+		TEST_VERIFY_EQUAL(0u, zf_stailq_disorder(&h, sizeof(a[0]), 0));
+	}
+	{
+		stailq_test_entry a[8], slab[8];
+		zf_stailq_node *x[8], *y[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			a[i].a[0] = i;
+			x[i] = &a[order[i]].node;
+			y[i] = &slab[i].node;
+		}
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_insert_head_bulk(&h, x, 8);
+		size_t size = sizeof(stailq_test_entry);
+		TEST_VERIFY_EQUAL(8u, zf_stailq_compact(&h, slab, 7, size,
+						  offsetof(stailq_test_entry, node), test_move, &size));
+		test_zf_stailq_verify(&h, x, 8);
+		TEST_VERIFY_EQUAL(8u, zf_stailq_compact(&h, slab, 8, size,
+						  offsetof(stailq_test_entry, node), test_move, &size));
+		test_zf_stailq_verify(&h, y, 8);
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(order[i], slab[i].a[0]);
+		}
+		TEST_VERIFY_EQUAL(0u, zf_stailq_disorder(&h, size, 0));
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_entry a[8], slab[8];
+		stailq_test_entry *x[8];
+		zf_stailq_node *y[8], *z[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			a[i].a[0] = i;
+			x[i] = &a[order[i]];
+			y[i] = &a[i].node;
+			z[i] = &slab[i].node;
+		}
+		stailq_test_head_ h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_insert_head_bulk_(&h, x, 8);
+		TEST_VERIFY_EQUAL(7u, zf_stailq_disorder_(&h, sizeof(a[0])));
+		zf_stailq_relink_(&h);
+		test_zf_stailq_verify(&h, y, 8);
+		TEST_VERIFY_EQUAL(8u, zf_stailq_compact_(&h, slab, 8, test_move_()));
+		test_zf_stailq_verify(&h, z, 8);
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(i, slab[i].a[0]);
+		}
+	}
+#endif
+}
+
+static bool stailq_test_odd(zf_stailq_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return 0 != (1 & zf_entry(n, stailq_test_entry, node)->a[0]);
+}
+
+static bool stailq_test_three(zf_stailq_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return 3 == zf_entry(n, stailq_test_entry, node)->a[0];
+}
+
+static void stailq_test_dispose(zf_stailq_node *const n, void *const ctx)
+{
+	(void)n;
+	++*(unsigned *)ctx;
+}
+
+static bool stailq_test_equal(zf_stailq_node *const a, zf_stailq_node *const b,
+							  void *const ctx)
+{
+	(void)ctx;
+	return zf_entry(a, stailq_test_entry, node)->a[0] ==
+		   zf_entry(b, stailq_test_entry, node)->a[0];
+}
+
+static void test_zf_stailq_filter()
+{
+	static const unsigned values[] = {1, 1, 2, 3, 3, 3, 4, 1};
+	stailq_test_entry a[8];
+	zf_stailq_node *x[8];
+	for (unsigned i = 0; 8 > i; ++i)
+	{
+		a[i].a[0] = values[i];
+		x[i] = &a[i].node;
+	}
+	{
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_head h2 = ZF_STAILQ_INITIALIZER(&h2);
+		TEST_VERIFY_EQUAL(0u, zf_stailq_partition(&h, &h2, stailq_test_odd, 0));
+		test_zf_stailq_verify(&h, x, 0);
+		test_zf_stailq_verify(&h2, x, 0);
+		zf_stailq_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(6u, zf_stailq_partition(&h, &h2, stailq_test_odd, 0));
+		zf_stailq_node *const y[] = {x[2], x[6]};
+		test_zf_stailq_verify(&h, y, 2);
+		zf_stailq_node *const z[] = {x[0], x[1], x[3], x[4], x[5], x[7]};
+		test_zf_stailq_verify(&h2, z, 6);
+		zf_stailq_insert_head_bulk(&h, x, 0);
+		test_zf_stailq_verify(&h, y, 2);
+	}
+	{
+		unsigned disposed = 0;
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(3u, zf_stailq_remove_if(&h, stailq_test_three,
+						  stailq_test_dispose, &disposed));
+		TEST_VERIFY_EQUAL(3u, disposed);
+		zf_stailq_node *const y[] = {x[0], x[1], x[2], x[6], x[7]};
+		test_zf_stailq_verify(&h, y, 5);
+		TEST_VERIFY_EQUAL(3u, zf_stailq_remove_if(&h, stailq_test_odd, 0, 0));
+	}
+	{
+		zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+		zf_stailq_head h2 = ZF_STAILQ_INITIALIZER(&h2);
+		zf_stailq_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(3u, zf_stailq_unique(&h, &h2, stailq_test_equal, 0));
+		zf_stailq_node *const y[] = {x[0], x[2], x[3], x[6], x[7]};
+		test_zf_stailq_verify(&h, y, 5);
+		zf_stailq_node *const z[] = {x[1], x[4], x[5]};
+		test_zf_stailq_verify(&h2, z, 3);
+	}
+#ifdef __cplusplus
+	{
+		stailq_test_entry *e[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			e[i] = &a[i];
+		}
+		stailq_test_head_ h = ZF_STAILQ_INITIALIZER(&h);
+		stailq_test_head_ h2 = ZF_STAILQ_INITIALIZER(&h2);
+		zf_stailq_insert_head_bulk_(&h, e, 8);
+		TEST_VERIFY_EQUAL(6u, zf_stailq_partition_(&h, &h2,
+						  test_odd_<stailq_test_entry>()));
+		zf_stailq_node *const y[] = {x[2], x[6]};
+		test_zf_stailq_verify(&h, y, 2);
+		zf_stailq_init(&h);
+		zf_stailq_insert_head_bulk_(&h, e, 8);
+		TEST_VERIFY_EQUAL(3u, zf_stailq_unique_(&h, &h2,
+						  test_equal_<stailq_test_entry>()));
+		zf_stailq_node *const z[] = {x[1], x[4], x[5]};
+		test_zf_stailq_verify(&h2, z, 3);
+		unsigned disposed = 0;
+		const test_count_ dispose = {&disposed};
+		TEST_VERIFY_EQUAL(3u, zf_stailq_remove_if_(&h, test_odd_<stailq_test_entry>(),
+						  dispose));
+		TEST_VERIFY_EQUAL(3u, disposed);
+		test_zf_stailq_verify(&h, y, 2);
+		TEST_VERIFY_EQUAL(0u, zf_stailq_remove_if_(&h, test_odd_<stailq_test_entry>()));
+	}
+#endif
+}
+
+#ifdef __cplusplus
+static void test_zf_stailq_iterator()
+{
+	stailq_test_entry a[4];
+	stailq_test_entry *e[4];
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].a[0] = 10 + i;
+		e[i] = &a[i];
+	}
+	stailq_test_head_ h = ZF_STAILQ_INITIALIZER(&h);
+	TEST_VERIFY_TRUE(h.begin() == h.end());
+	zf_stailq_insert_head_bulk_(&h, e, 4);
+	unsigned k = 0;
+	for (stailq_test_head_::iterator i = h.begin(); h.end() != i; ++k, i++)
+	{
+		TEST_VERIFY_EQUAL(&a[k], &*i);
+		TEST_VERIFY_EQUAL(10 + k, i->a[0]);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+	TEST_VERIFY_EQUAL(4, (int)std::distance(h.begin(), h.end()));
+	const test_value_is_ v12 = {12};
+	TEST_VERIFY_EQUAL(&a[2], &*std::find_if(h.begin(), h.end(), v12));
+	const test_value_is_ v42 = {42};
+	TEST_VERIFY_TRUE(h.end() == std::find_if(h.begin(), h.end(), v42));
+	stailq_test_head_::iterator i = h.begin();
+	std::advance(i, 3);
+	TEST_VERIFY_EQUAL(&a[3], &*i);
+	const stailq_test_head_ &c = h;
+	TEST_VERIFY_EQUAL(4, (int)std::distance(c.begin(), c.end()));
+	TEST_VERIFY_EQUAL(&a[2], &*std::find_if(c.cbegin(), c.cend(), v12));
+	stailq_test_head_::const_iterator ci = h.begin();
+	TEST_VERIFY_TRUE(c.begin() == ci);
+	TEST_VERIFY_EQUAL(11u, (++ci)->a[0]);
+	TEST_VERIFY_TRUE(ci != h.begin() && h.begin() != ci);
+	TEST_VERIFY_TRUE(++h.begin() == ci && ci == ++h.begin());
+#if __cplusplus >= 201103L
+	k = 0;
+	for (stailq_test_entry &x: h)
+	{
+		TEST_VERIFY_EQUAL(&a[k++], &x);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+	k = 0;
+	for (const stailq_test_entry &x: c)
+	{
+		TEST_VERIFY_EQUAL(&a[k++], &x);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+#endif
+}
+#endif
+
 static void test_zf_stailq(TEST_SUIT_ARGUMENTS)
 {
 	TEST_EXECUTE(test_zf_stailq_entry());
@@ -845,11 +2662,35 @@ static void test_zf_stailq(TEST_SUIT_ARGUMENTS)
 	TEST_EXECUTE(test_zf_stailq_insert_after());
 	TEST_EXECUTE(test_zf_stailq_remove_head());
 	TEST_EXECUTE(test_zf_stailq_remove_after());
+	TEST_EXECUTE(test_zf_stailq_swap());
+	TEST_EXECUTE(test_zf_stailq_concat());
+	TEST_EXECUTE(test_zf_stailq_splice());
+	TEST_EXECUTE(test_zf_stailq_split_after());
+	TEST_EXECUTE(test_zf_stailq_radix_sort());
+	TEST_EXECUTE(test_zf_stailq_merge());
+	TEST_EXECUTE(test_zf_stailq_insert_bulk());
+	TEST_EXECUTE(test_zf_stailq_foreach_prefetch());
+	TEST_EXECUTE(test_zf_stailq_relink());
+	TEST_EXECUTE(test_zf_stailq_filter());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_stailq_iterator());
+#endif
 }
 
 /*
  * Tail queue
  */
+typedef struct tailq_test_entry
+{
+	unsigned a[3];
+	zf_tailq_node node;
+	unsigned b[5];
+}
+tailq_test_entry;
+#ifdef __cplusplus
+typedef zf_tailq_head_t(tailq_test_entry, node) tailq_test_head_;
+#endif
+
 static void test_zf_tailq_initializer()
 {
 	zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
@@ -1027,6 +2868,774 @@ static void test_zf_tailq_remove()
 	TEST_VERIFY_TRUE(zf_tailq_empty(&h));
 }
 
+static void test_zf_tailq_verify(zf_tailq_head *const h,
+								 zf_tailq_node *const *const n,
+								 const unsigned count)
+{
+	zf_tailq_node *i = zf_tailq_begin(h);
+	for (unsigned k = 0; count > k; ++k, i = zf_tailq_next(i))
+	{
+		TEST_VERIFY_EQUAL(n[k], i);
+		TEST_VERIFY_EQUAL(0 == k? nullptr: n[k - 1], zf_tailq_prev(i));
+	}
+	TEST_VERIFY_EQUAL(zf_tailq_end(h), i);
+	TEST_VERIFY_EQUAL(0 == count? nullptr: n[count - 1], zf_tailq_last(h));
+}
+
+static void test_zf_tailq_swap()
+{
+	{
+		zf_tailq_node a[2], b[1];
+		zf_tailq_head ha = ZF_TAILQ_INITIALIZER(&ha);
+		zf_tailq_insert_tail(&ha, &a[0]);
+		zf_tailq_insert_tail(&ha, &a[1]);
+		zf_tailq_head hb = ZF_TAILQ_INITIALIZER(&hb);
+		zf_tailq_insert_tail(&hb, &b[0]);
+		zf_tailq_swap(&ha, &hb);
+		zf_tailq_node *const x0[] = {&b[0]};
+		test_zf_tailq_verify(&ha, x0, 1);
+		zf_tailq_node *const x1[] = {&a[0], &a[1]};
+		test_zf_tailq_verify(&hb, x1, 2);
+		zf_tailq_head hc = ZF_TAILQ_INITIALIZER(&hc);
+		zf_tailq_swap(&ha, &hc);
+		test_zf_tailq_verify(&ha, x0, 0);
+		test_zf_tailq_verify(&hc, x0, 1);
+		zf_tailq_insert_tail(&ha, &a[0]);
+		test_zf_tailq_verify(&ha, x1, 1);
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_entry a[2];
+		tailq_test_head_ ha = ZF_TAILQ_INITIALIZER(&ha);
+		zf_tailq_insert_tail_(&ha, &a[0]);
+		zf_tailq_insert_tail_(&ha, &a[1]);
+		tailq_test_head_ hb = ZF_TAILQ_INITIALIZER(&hb);
+		zf_tailq_swap_(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&ha));
+		zf_tailq_node *const x[] = {&a[0].node, &a[1].node};
+		test_zf_tailq_verify(&hb, x, 2);
+	}
+#endif
+}
+
+static void test_zf_tailq_concat()
+{
+	{
+		zf_tailq_node a[2], b[2];
+		zf_tailq_head ha = ZF_TAILQ_INITIALIZER(&ha);
+		zf_tailq_head hb = ZF_TAILQ_INITIALIZER(&hb);
+		zf_tailq_concat(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&ha));
+		zf_tailq_insert_tail(&hb, &b[0]);
+		zf_tailq_insert_tail(&hb, &b[1]);
+		zf_tailq_concat(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&hb));
+		zf_tailq_node *const x0[] = {&b[0], &b[1]};
+		test_zf_tailq_verify(&ha, x0, 2);
+		zf_tailq_insert_tail(&hb, &a[0]);
+		zf_tailq_insert_tail(&hb, &a[1]);
+		zf_tailq_concat(&hb, &ha);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&ha));
+		zf_tailq_node *const x1[] = {&a[0], &a[1], &b[0], &b[1]};
+		test_zf_tailq_verify(&hb, x1, 4);
+		zf_tailq_concat(&hb, &ha);
+		test_zf_tailq_verify(&hb, x1, 4);
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_entry a[2];
+		tailq_test_head_ ha = ZF_TAILQ_INITIALIZER(&ha);
+		zf_tailq_insert_tail_(&ha, &a[0]);
+		tailq_test_head_ hb = ZF_TAILQ_INITIALIZER(&hb);
+		zf_tailq_insert_tail_(&hb, &a[1]);
+		zf_tailq_concat_(&ha, &hb);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&hb));
+		zf_tailq_node *const x[] = {&a[0].node, &a[1].node};
+		test_zf_tailq_verify(&ha, x, 2);
+	}
+#endif
+}
+
+static void test_zf_tailq_splice()
+{
+	{
+		zf_tailq_node a[5], b[2];
+		zf_tailq_head ha = ZF_TAILQ_INITIALIZER(&ha);
+		for (unsigned i = 0; 5 > i; ++i)
+		{
+			zf_tailq_insert_tail(&ha, &a[i]);
+		}
+		zf_tailq_head hb = ZF_TAILQ_INITIALIZER(&hb);
+		zf_tailq_insert_tail(&hb, &b[0]);
+		zf_tailq_insert_tail(&hb, &b[1]);
+		zf_tailq_splice_head(&hb, &ha, &a[1], &a[2]);
+		zf_tailq_node *const x0[] = {&a[0], &a[3], &a[4]};
+		test_zf_tailq_verify(&ha, x0, 3);
+		zf_tailq_node *const x1[] = {&a[1], &a[2], &b[0], &b[1]};
+		test_zf_tailq_verify(&hb, x1, 4);
+		zf_tailq_splice_tail(&hb, &ha, &a[3], &a[4]);
+		zf_tailq_node *const x2[] = {&a[0]};
+		test_zf_tailq_verify(&ha, x2, 1);
+		zf_tailq_node *const x3[] = {&a[1], &a[2], &b[0], &b[1], &a[3], &a[4]};
+		test_zf_tailq_verify(&hb, x3, 6);
+		zf_tailq_splice_head(&hb, &hb, &b[0], &b[1]);
+		zf_tailq_node *const x4[] = {&b[0], &b[1], &a[1], &a[2], &a[3], &a[4]};
+		test_zf_tailq_verify(&hb, x4, 6);
+		zf_tailq_splice_tail(&hb, &hb, &a[3], &a[4]);
+		test_zf_tailq_verify(&hb, x4, 6);
+		zf_tailq_splice_tail(&hb, &hb, &b[0], &b[1]);
+		zf_tailq_node *const x5[] = {&a[1], &a[2], &a[3], &a[4], &b[0], &b[1]};
+		test_zf_tailq_verify(&hb, x5, 6);
+		zf_tailq_splice_after(&ha, &a[0], &hb, &a[1], &b[1]);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&hb));
+		zf_tailq_node *const x6[] = {&a[0], &a[1], &a[2], &a[3], &a[4], &b[0], &b[1]};
+		test_zf_tailq_verify(&ha, x6, 7);
+		zf_tailq_splice_after(&ha, &a[2], &ha, &a[4], &b[1]);
+		zf_tailq_node *const x7[] = {&a[0], &a[1], &a[2], &a[4], &b[0], &b[1], &a[3]};
+		test_zf_tailq_verify(&ha, x7, 7);
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_entry a[3];
+		tailq_test_head_ ha = ZF_TAILQ_INITIALIZER(&ha);
+		for (unsigned i = 0; 3 > i; ++i)
+		{
+			zf_tailq_insert_tail_(&ha, &a[i]);
+		}
+		tailq_test_head_ hb = ZF_TAILQ_INITIALIZER(&hb);
+		zf_tailq_splice_head_(&hb, &ha, &a[1], &a[2]);
+		zf_tailq_splice_tail_(&hb, &ha, &a[0], &a[0]);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&ha));
+		zf_tailq_splice_after_(&hb, &a[0], &hb, &a[1], &a[1]);
+		zf_tailq_node *const x[] = {&a[2].node, &a[0].node, &a[1].node};
+		test_zf_tailq_verify(&hb, x, 3);
+	}
+#endif
+}
+
+static void test_zf_tailq_split()
+{
+	{
+		zf_tailq_node a[3];
+		zf_tailq_head ha = ZF_TAILQ_INITIALIZER(&ha);
+		for (unsigned i = 0; 3 > i; ++i)
+		{
+			zf_tailq_insert_tail(&ha, &a[i]);
+		}
+		zf_tailq_head hb;
+		zf_tailq_split(&ha, &a[1], &hb);
+		zf_tailq_node *const x0[] = {&a[0], &a[1], &a[2]};
+		test_zf_tailq_verify(&ha, x0, 1);
+		test_zf_tailq_verify(&hb, x0 + 1, 2);
+		zf_tailq_split(&ha, &a[0], &hb);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&ha));
+		test_zf_tailq_verify(&hb, x0, 1);
+		zf_tailq_insert_tail(&ha, &a[1]);
+		test_zf_tailq_verify(&ha, x0 + 1, 1);
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_entry a[2];
+		tailq_test_head_ ha = ZF_TAILQ_INITIALIZER(&ha);
+		zf_tailq_insert_tail_(&ha, &a[0]);
+		zf_tailq_insert_tail_(&ha, &a[1]);
+		tailq_test_head_ hb;
+		zf_tailq_split_(&ha, &a[1], &hb);
+		zf_tailq_node *const x[] = {&a[0].node, &a[1].node};
+		test_zf_tailq_verify(&ha, x, 1);
+		test_zf_tailq_verify(&hb, x + 1, 1);
+	}
+#endif
+}
+
+static uint64_t tailq_test_key(zf_tailq_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return test_radix_key(zf_entry(n, tailq_test_entry, node)->a[0]);
+}
+
+#ifdef __cplusplus
+struct tailq_test_key_
+{
+	uint64_t operator()(const tailq_test_entry *const e) const
+	{
+		return test_radix_key(e->a[0]);
+	}
+};
+#endif
+
+/* Verify that h has count entries sorted by key, equal keys in insertion order */
+static void test_zf_tailq_verify_sorted(zf_tailq_head *const h,
+										const unsigned count)
+{
+	unsigned n = 0;
+	zf_tailq_node *last = nullptr;
+	for (zf_tailq_node *i = zf_tailq_begin(h); zf_tailq_end(h) != i;
+		 i = zf_tailq_next(i))
+	{
+		TEST_VERIFY_EQUAL(last, zf_tailq_prev(i));
+		if (nullptr != last)
+		{
+			const tailq_test_entry *const p = zf_entry(last, tailq_test_entry, node);
+			const tailq_test_entry *const e = zf_entry(i, tailq_test_entry, node);
+			const uint64_t pk = test_radix_key(p->a[0]);
+			const uint64_t ek = test_radix_key(e->a[0]);
+			TEST_VERIFY_TRUE(pk < ek || (pk == ek && p->a[0] < e->a[0]));
+		}
+		last = i;
+		++n;
+	}
+	TEST_VERIFY_EQUAL(count, n);
+	TEST_VERIFY_EQUAL(last, zf_tailq_last(h));
+}
+
+static void test_zf_tailq_radix_sort()
+{
+	tailq_test_entry e[100];
+	const unsigned count = sizeof(e) / sizeof(e[0]);
+	{
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_radix_sort(&h, tailq_test_key, nullptr);
+		TEST_VERIFY_TRUE(zf_tailq_empty(&h));
+		for (unsigned i = 0; count > i; ++i)
+		{
+			e[i].a[0] = i;
+			zf_tailq_insert_tail(&h, &e[i].node);
+		}
+		zf_tailq_radix_sort(&h, tailq_test_key, nullptr);
+		test_zf_tailq_verify_sorted(&h, count);
+		zf_tailq_radix_sort(&h, tailq_test_key, nullptr);
+		test_zf_tailq_verify_sorted(&h, count);
+		zf_tailq_node n0;
+		zf_tailq_insert_tail(&h, &n0);
+		TEST_VERIFY_EQUAL(&n0, zf_tailq_last(&h));
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_head_ hpp = ZF_TAILQ_INITIALIZER(&hpp);
+		for (unsigned i = 0; count > i; ++i)
+		{
+			e[i].a[0] = i;
+			zf_tailq_insert_tail_(&hpp, &e[i]);
+		}
+		zf_tailq_radix_sort_(&hpp, tailq_test_key_());
+		test_zf_tailq_verify_sorted(&hpp, count);
+	}
+#endif
+}
+
+static int tailq_test_cmp(zf_tailq_node *const a, zf_tailq_node *const b,
+						  void *const ctx)
+{
+	const unsigned ka = zf_entry(a, tailq_test_entry, node)->a[0];
+	const unsigned kb = zf_entry(b, tailq_test_entry, node)->a[0];
+	(void)ctx;
+	return ka < kb? -1: kb < ka? 1: 0;
+}
+
+#ifdef __cplusplus
+struct tailq_test_less_
+{
+	bool operator()(const tailq_test_entry *const a,
+					const tailq_test_entry *const b) const
+	{
+		return a->a[0] < b->a[0];
+	}
+};
+#endif
+
+/* Entry i goes to list i % k (except list 2 which stays empty) with key i / 3,
+ * list index is stored in a[1].
+ */
+static void test_zf_tailq_merge_fill(zf_tailq_head *const in, const unsigned k,
+									 tailq_test_entry *const e,
+									 const unsigned count)
+{
+	for (unsigned i = 0; k > i; ++i)
+	{
+		zf_tailq_init(&in[i]);
+	}
+	for (unsigned i = 0; count > i; ++i)
+	{
+		const unsigned l = 2 == i % k? 0: i % k;
+		e[i].a[0] = i / 3;
+		e[i].a[1] = l;
+		e[i].a[2] = i;
+		zf_tailq_insert_tail(&in[l], &e[i].node);
+	}
+}
+
+static void test_zf_tailq_merge_verify(zf_tailq_head *const h,
+									   const unsigned count)
+{
+	unsigned n = 0;
+	const tailq_test_entry *p = nullptr;
+	for (zf_tailq_node *i = zf_tailq_begin(h); zf_tailq_end(h) != i;
+		 i = zf_tailq_next(i), ++n)
+	{
+		const tailq_test_entry *const e = zf_entry(i, tailq_test_entry, node);
+		TEST_VERIFY_EQUAL(nullptr == p? nullptr: &p->node, zf_tailq_prev(i));
+		if (nullptr != p)
+		{
+			TEST_VERIFY_TRUE(p->a[0] < e->a[0] ||
+							 (p->a[0] == e->a[0] && p->a[1] < e->a[1]) ||
+							 (p->a[0] == e->a[0] && p->a[1] == e->a[1] &&
+							  p->a[2] < e->a[2]));
+		}
+		p = e;
+	}
+	TEST_VERIFY_EQUAL(count, n);
+}
+
+static void test_zf_tailq_merge()
+{
+	tailq_test_entry e[60];
+	const unsigned count = sizeof(e) / sizeof(e[0]);
+	zf_tailq_head in[5];
+	const unsigned k = sizeof(in) / sizeof(in[0]);
+	size_t tree[sizeof(in) / sizeof(in[0])];
+	{
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		TEST_VERIFY_EQUAL(0u, zf_tailq_merge(&h, in, 0, tree, tailq_test_cmp,
+											 nullptr, ZF_MERGE_ALL));
+		test_zf_tailq_merge_fill(in, k, e, count);
+		TEST_VERIFY_EQUAL(count, zf_tailq_merge(&h, in, k, tree, tailq_test_cmp,
+												nullptr, ZF_MERGE_ALL));
+		test_zf_tailq_merge_verify(&h, count);
+		for (unsigned i = 0; k > i; ++i)
+		{
+			TEST_VERIFY_TRUE(zf_tailq_empty(&in[i]));
+		}
+	}
+	{
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		test_zf_tailq_merge_fill(in, k, e, count);
+		TEST_VERIFY_EQUAL(7u, zf_tailq_merge(&h, in, k, tree, tailq_test_cmp,
+											 nullptr, 7));
+		test_zf_tailq_merge_verify(&h, 7);
+		TEST_VERIFY_EQUAL(2u, zf_entry(zf_tailq_last(&h), tailq_test_entry, node)->a[0]);
+		zf_tailq_head rest = ZF_TAILQ_INITIALIZER(&rest);
+		TEST_VERIFY_EQUAL(count - 7, zf_tailq_merge(&rest, in, k, tree, tailq_test_cmp,
+													nullptr, ZF_MERGE_ALL));
+		test_zf_tailq_merge_verify(&rest, count - 7);
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_head_ hpp = ZF_TAILQ_INITIALIZER(&hpp);
+		tailq_test_head_ inpp[sizeof(in) / sizeof(in[0])];
+		test_zf_tailq_merge_fill(inpp, k, e, count);
+		TEST_VERIFY_EQUAL(count, zf_tailq_merge_(&hpp, inpp, k, tree,
+												 tailq_test_less_()));
+		test_zf_tailq_merge_verify(&hpp, count);
+	}
+#endif
+}
+
+static void test_zf_tailq_insert_bulk()
+{
+	{
+		zf_tailq_node a[12], b[2], c[3];
+		zf_tailq_node *pa[12], *pb[2], *x[17];
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			pa[i] = &a[i];
+			x[i + 2] = &a[i];
+		}
+		pb[0] = x[0] = &b[0];
+		pb[1] = x[1] = &b[1];
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_insert_tail_bulk(&h, pa, 0);
+		test_zf_tailq_verify(&h, pa, 0);
+		zf_tailq_insert_tail_bulk(&h, pa, 12);
+		test_zf_tailq_verify(&h, pa, 12);
+		zf_tailq_insert_head_bulk(&h, pb, 2);
+		test_zf_tailq_verify(&h, x, 14);
+		zf_tailq_insert_after_bulk(&h, &a[11], pb, 0);
+		test_zf_tailq_verify(&h, x, 14);
+		zf_tailq_insert_after_bulk_strided(&h, &a[11], &c[0], sizeof(c[0]), 3);
+		x[14] = &c[0];
+		x[15] = &c[1];
+		x[16] = &c[2];
+		test_zf_tailq_verify(&h, x, 17);
+		zf_tailq_init(&h);
+		zf_tailq_insert_head_bulk_strided(&h, &c[1], sizeof(c[0]), 2);
+		test_zf_tailq_verify(&h, x + 15, 2);
+		zf_tailq_insert_head_bulk_strided(&h, &c[0], sizeof(c[0]), 1);
+		test_zf_tailq_verify(&h, x + 14, 3);
+		zf_tailq_insert_after_bulk(&h, &c[0], pb, 2);
+		zf_tailq_insert_tail_bulk_strided(&h, &a[0], sizeof(a[0]), 2);
+		zf_tailq_node *const y[] = {&c[0], &b[0], &b[1], &c[1], &c[2], &a[0], &a[1]};
+		test_zf_tailq_verify(&h, y, 7);
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_entry a[10], c[2];
+		tailq_test_entry *pa[10];
+		zf_tailq_node *x[14];
+		for (unsigned i = 0; 10 > i; ++i)
+		{
+			pa[i] = &a[i];
+			x[i + 2] = &a[i].node;
+		}
+		x[0] = &c[0].node;
+		x[1] = &c[1].node;
+		tailq_test_head_ h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_insert_tail_bulk_(&h, pa, 10);
+		test_zf_tailq_verify(&h, x + 2, 10);
+		zf_tailq_insert_head_bulk_(&h, c, 2);
+		test_zf_tailq_verify(&h, x, 12);
+		zf_tailq_init(&h);
+		zf_tailq_insert_head_bulk_(&h, pa + 8, 2);
+		zf_tailq_insert_tail_bulk_(&h, c, 2);
+		zf_tailq_insert_after_bulk_(&h, &a[9], pa, 2);
+		zf_tailq_insert_after_bulk_(&h, &c[1], a + 2, 2);
+		zf_tailq_node *const y[] = {&a[8].node, &a[9].node, &a[0].node,
+								 &a[1].node, &c[0].node, &c[1].node,
+								 &a[2].node, &a[3].node};
+		test_zf_tailq_verify(&h, y, 8);
+	}
+#endif
+}
+
+static void test_zf_tailq_foreach_prefetch()
+{
+	{
+		zf_tailq_node a[12];
+		zf_tailq_node *x[12];
+		unsigned count = 0;
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_foreach_prefetch(&h, n, 4, 0)
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_tailq_insert_head_bulk_strided(&h, &a[0], sizeof(a[0]), 12);
+		zf_tailq_foreach_prefetch(&h, n, 4, sizeof(a[0]))
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(12u, count);
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(&a[i], x[i]);
+		}
+		count = 0;
+		zf_tailq_foreach_prefetch(&h, n, 0, -1)
+		{
+			x[count++] = n;
+		}
+		TEST_VERIFY_EQUAL(12u, count);
+		TEST_VERIFY_EQUAL(&a[11], x[11]);
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_entry a[12];
+		tailq_test_entry *x[12];
+		unsigned count = 0;
+		tailq_test_head_ h = ZF_TAILQ_INITIALIZER(&h);
+		test_collect_<tailq_test_entry> f = {x, &count};
+		zf_tailq_foreach_prefetch_<4>(&h, f);
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_tailq_insert_head_bulk_(&h, a, 12);
+		zf_tailq_foreach_prefetch_<4>(&h, f, offsetof(tailq_test_entry, b));
+		TEST_VERIFY_EQUAL(12u, count);
+		for (unsigned i = 0; 12 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(&a[i], x[i]);
+		}
+		count = 0;
+		zf_tailq_foreach_prefetch_<16>(&h, f);
+		TEST_VERIFY_EQUAL(12u, count);
+		TEST_VERIFY_EQUAL(&a[11], x[11]);
+	}
+#endif
+}
+
+static void test_zf_tailq_relink()
+{
+	static const unsigned order[] = {5, 2, 7, 0, 3, 6, 1, 4};
+	{
+		zf_tailq_node a[8];
+		zf_tailq_node *x[8], *y[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			x[i] = &a[order[i]];
+			y[i] = &a[i];
+		}
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		size_t count = 1;
+		TEST_VERIFY_EQUAL(0u, zf_tailq_disorder(&h, sizeof(a[0]), &count));
+		TEST_VERIFY_EQUAL(0u, count);
+		zf_tailq_relink(&h);
+		test_zf_tailq_verify(&h, y, 0);
+		zf_tailq_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(7u, zf_tailq_disorder(&h, sizeof(a[0]), &count));
+		TEST_VERIFY_EQUAL(8u, count);
+		TEST_VERIFY_EQUAL(4u, zf_tailq_disorder(&h, 3 * sizeof(a[0]), 0));
+		zf_tailq_relink(&h);
+		test_zf_tailq_verify(&h, y, 8);
+		TEST_VERIFY_EQUAL(0u, zf_tailq_disorder(&h, sizeof(a[0]), 0));
+	}
+	{
+		tailq_test_entry a[8], slab[8];
+		zf_tailq_node *x[8], *y[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			a[i].a[0] = i;
+			x[i] = &a[order[i]].node;
+			y[i] = &slab[i].node;
+		}
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_insert_head_bulk(&h, x, 8);
+		size_t size = sizeof(tailq_test_entry);
+		TEST_VERIFY_EQUAL(8u, zf_tailq_compact(&h, slab, 7, size,
+						  offsetof(tailq_test_entry, node), test_move, &size));
+		test_zf_tailq_verify(&h, x, 8);
+		TEST_VERIFY_EQUAL(8u, zf_tailq_compact(&h, slab, 8, size,
+						  offsetof(tailq_test_entry, node), test_move, &size));
+		test_zf_tailq_verify(&h, y, 8);
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(order[i], slab[i].a[0]);
+		}
+		TEST_VERIFY_EQUAL(0u, zf_tailq_disorder(&h, size, 0));
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_entry a[8], slab[8];
+		tailq_test_entry *x[8];
+		zf_tailq_node *y[8], *z[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			a[i].a[0] = i;
+			x[i] = &a[order[i]];
+			y[i] = &a[i].node;
+			z[i] = &slab[i].node;
+		}
+		tailq_test_head_ h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_insert_head_bulk_(&h, x, 8);
+		TEST_VERIFY_EQUAL(7u, zf_tailq_disorder_(&h, sizeof(a[0])));
+		zf_tailq_relink_(&h);
+		test_zf_tailq_verify(&h, y, 8);
+		TEST_VERIFY_EQUAL(8u, zf_tailq_compact_(&h, slab, 8, test_move_()));
+		test_zf_tailq_verify(&h, z, 8);
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			TEST_VERIFY_EQUAL(i, slab[i].a[0]);
+		}
+	}
+#endif
+}
+
+static bool tailq_test_odd(zf_tailq_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return 0 != (1 & zf_entry(n, tailq_test_entry, node)->a[0]);
+}
+
+static bool tailq_test_three(zf_tailq_node *const n, void *const ctx)
+{
+	(void)ctx;
+	return 3 == zf_entry(n, tailq_test_entry, node)->a[0];
+}
+
+static void tailq_test_dispose(zf_tailq_node *const n, void *const ctx)
+{
+	(void)n;
+	++*(unsigned *)ctx;
+}
+
+static bool tailq_test_equal(zf_tailq_node *const a, zf_tailq_node *const b,
+							 void *const ctx)
+{
+	(void)ctx;
+	return zf_entry(a, tailq_test_entry, node)->a[0] ==
+		   zf_entry(b, tailq_test_entry, node)->a[0];
+}
+
+static void test_zf_tailq_filter()
+{
+	static const unsigned values[] = {1, 1, 2, 3, 3, 3, 4, 1};
+	tailq_test_entry a[8];
+	zf_tailq_node *x[8];
+	for (unsigned i = 0; 8 > i; ++i)
+	{
+		a[i].a[0] = values[i];
+		x[i] = &a[i].node;
+	}
+	{
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_head h2 = ZF_TAILQ_INITIALIZER(&h2);
+		TEST_VERIFY_EQUAL(0u, zf_tailq_partition(&h, &h2, tailq_test_odd, 0));
+		test_zf_tailq_verify(&h, x, 0);
+		test_zf_tailq_verify(&h2, x, 0);
+		zf_tailq_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(6u, zf_tailq_partition(&h, &h2, tailq_test_odd, 0));
+		zf_tailq_node *const y[] = {x[2], x[6]};
+		test_zf_tailq_verify(&h, y, 2);
+		zf_tailq_node *const z[] = {x[0], x[1], x[3], x[4], x[5], x[7]};
+		test_zf_tailq_verify(&h2, z, 6);
+		zf_tailq_insert_head_bulk(&h, x, 0);
+		test_zf_tailq_verify(&h, y, 2);
+	}
+	{
+		unsigned disposed = 0;
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(3u, zf_tailq_remove_if(&h, tailq_test_three,
+						  tailq_test_dispose, &disposed));
+		TEST_VERIFY_EQUAL(3u, disposed);
+		zf_tailq_node *const y[] = {x[0], x[1], x[2], x[6], x[7]};
+		test_zf_tailq_verify(&h, y, 5);
+		TEST_VERIFY_EQUAL(3u, zf_tailq_remove_if(&h, tailq_test_odd, 0, 0));
+	}
+	{
+		zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+		zf_tailq_head h2 = ZF_TAILQ_INITIALIZER(&h2);
+		zf_tailq_insert_head_bulk(&h, x, 8);
+		TEST_VERIFY_EQUAL(3u, zf_tailq_unique(&h, &h2, tailq_test_equal, 0));
+		zf_tailq_node *const y[] = {x[0], x[2], x[3], x[6], x[7]};
+		test_zf_tailq_verify(&h, y, 5);
+		zf_tailq_node *const z[] = {x[1], x[4], x[5]};
+		test_zf_tailq_verify(&h2, z, 3);
+	}
+#ifdef __cplusplus
+	{
+		tailq_test_entry *e[8];
+		for (unsigned i = 0; 8 > i; ++i)
+		{
+			e[i] = &a[i];
+		}
+		tailq_test_head_ h = ZF_TAILQ_INITIALIZER(&h);
+		tailq_test_head_ h2 = ZF_TAILQ_INITIALIZER(&h2);
+		zf_tailq_insert_head_bulk_(&h, e, 8);
+		TEST_VERIFY_EQUAL(6u, zf_tailq_partition_(&h, &h2,
+						  test_odd_<tailq_test_entry>()));
+		zf_tailq_node *const y[] = {x[2], x[6]};
+		test_zf_tailq_verify(&h, y, 2);
+		zf_tailq_init(&h);
+		zf_tailq_insert_head_bulk_(&h, e, 8);
+		TEST_VERIFY_EQUAL(3u, zf_tailq_unique_(&h, &h2,
+						  test_equal_<tailq_test_entry>()));
+		zf_tailq_node *const z[] = {x[1], x[4], x[5]};
+		test_zf_tailq_verify(&h2, z, 3);
+		unsigned disposed = 0;
+		const test_count_ dispose = {&disposed};
+		TEST_VERIFY_EQUAL(3u, zf_tailq_remove_if_(&h, test_odd_<tailq_test_entry>(),
+						  dispose));
+		TEST_VERIFY_EQUAL(3u, disposed);
+		test_zf_tailq_verify(&h, y, 2);
+		TEST_VERIFY_EQUAL(0u, zf_tailq_remove_if_(&h, test_odd_<tailq_test_entry>()));
+	}
+#endif
+}
+
+#ifdef __cplusplus
+static void test_zf_tailq_link_policy()
+{
+	typedef zf_tailq_head_<tailq_test_entry, &tailq_test_entry::node,
+						   zf_link_safe_> safe_head_;
+	tailq_test_entry a[4];
+	memset(a, 0, sizeof(a));
+	safe_head_ h = ZF_TAILQ_INITIALIZER(&h);
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].a[0] = i;
+		TEST_VERIFY_FALSE(zf_tailq_linked_(&h, &a[i]));
+		zf_tailq_insert_tail_(&h, &a[i]);
+		TEST_VERIFY_TRUE(zf_tailq_linked_(&h, &a[i]));
+	}
+	zf_tailq_remove_(&h, &a[3]);
+	TEST_VERIFY_FALSE(zf_tailq_linked_(&h, &a[3]));
+	TEST_VERIFY_EQUAL(nullptr, a[3].node.next);
+	TEST_VERIFY_EQUAL(&a[2], zf_tailq_last_(&h));
+	unsigned disposed = 0;
+	const test_count_ dispose = {&disposed};
+	TEST_VERIFY_EQUAL(1u, zf_tailq_remove_if_(&h, test_odd_<tailq_test_entry>(),
+											  dispose));
+	TEST_VERIFY_EQUAL(1u, disposed);
+	TEST_VERIFY_FALSE(zf_tailq_linked_(&h, &a[1]));
+	a[0].a[0] = 7;
+	TEST_VERIFY_EQUAL(1u, zf_tailq_remove_if_(&h, test_odd_<tailq_test_entry>()));
+	TEST_VERIFY_FALSE(zf_tailq_linked_(&h, &a[0]));
+	TEST_VERIFY_TRUE(zf_tailq_linked_(&h, &a[2]));
+	TEST_VERIFY_EQUAL(&a[2], zf_tailq_first_(&h));
+	TEST_VERIFY_EQUAL(&a[2], zf_tailq_last_(&h));
+	/* fast head leaves stale pointers */
+	tailq_test_head_ f = ZF_TAILQ_INITIALIZER(&f);
+	zf_tailq_insert_head_(&f, &a[1]);
+	zf_tailq_remove_(&f, &a[1]);
+	TEST_VERIFY_NOT_EQUAL(nullptr, a[1].node.prev);
+}
+
+static void test_zf_tailq_iterator()
+{
+	tailq_test_entry a[4];
+	tailq_test_entry *e[4];
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].a[0] = 10 + i;
+		e[i] = &a[i];
+	}
+	tailq_test_head_ h = ZF_TAILQ_INITIALIZER(&h);
+	TEST_VERIFY_TRUE(h.begin() == h.end());
+	zf_tailq_insert_head_bulk_(&h, e, 4);
+	unsigned k = 0;
+	for (tailq_test_head_::iterator i = h.begin(); h.end() != i; ++k, i++)
+	{
+		TEST_VERIFY_EQUAL(&a[k], &*i);
+		TEST_VERIFY_EQUAL(10 + k, i->a[0]);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+	TEST_VERIFY_EQUAL(4, (int)std::distance(h.begin(), h.end()));
+	const test_value_is_ v12 = {12};
+	TEST_VERIFY_EQUAL(&a[2], &*std::find_if(h.begin(), h.end(), v12));
+	const test_value_is_ v42 = {42};
+	TEST_VERIFY_TRUE(h.end() == std::find_if(h.begin(), h.end(), v42));
+	tailq_test_head_::iterator i = h.begin();
+	std::advance(i, 3);
+	TEST_VERIFY_EQUAL(&a[3], &*i);
+	const tailq_test_head_ &c = h;
+	TEST_VERIFY_EQUAL(4, (int)std::distance(c.begin(), c.end()));
+	TEST_VERIFY_EQUAL(&a[2], &*std::find_if(c.cbegin(), c.cend(), v12));
+	tailq_test_head_::const_iterator ci = h.begin();
+	TEST_VERIFY_TRUE(c.begin() == ci);
+	TEST_VERIFY_EQUAL(11u, (++ci)->a[0]);
+	TEST_VERIFY_TRUE(ci != h.begin() && h.begin() != ci);
+	TEST_VERIFY_TRUE(++h.begin() == ci && ci == ++h.begin());
+	TEST_VERIFY_TRUE(h.rbegin() == c.crbegin() && c.crbegin() == h.rbegin());
+	k = 4;
+	for (tailq_test_head_::const_reverse_iterator r = c.crbegin();
+		 c.rend() != r; ++r)
+	{
+		TEST_VERIFY_EQUAL(&a[--k], &*r);
+	}
+	TEST_VERIFY_EQUAL(0u, k);
+	TEST_VERIFY_EQUAL(&a[2], &*--i);
+	TEST_VERIFY_EQUAL(&a[3], &*--h.end());
+	k = 4;
+	for (tailq_test_head_::reverse_iterator r = h.rbegin(); h.rend() != r; ++r)
+	{
+		TEST_VERIFY_EQUAL(&a[--k], &*r);
+	}
+	TEST_VERIFY_EQUAL(0u, k);
+#if __cplusplus >= 201103L
+	k = 0;
+	for (tailq_test_entry &x: h)
+	{
+		TEST_VERIFY_EQUAL(&a[k++], &x);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+	k = 0;
+	for (const tailq_test_entry &x: c)
+	{
+		TEST_VERIFY_EQUAL(&a[k++], &x);
+	}
+	TEST_VERIFY_EQUAL(4u, k);
+#endif
+}
+#endif
+
 static void test_zf_tailq(TEST_SUIT_ARGUMENTS)
 {
 	TEST_EXECUTE(test_zf_tailq_initializer());
@@ -1036,6 +3645,20 @@ static void test_zf_tailq(TEST_SUIT_ARGUMENTS)
 	TEST_EXECUTE(test_zf_tailq_insert_before());
 	TEST_EXECUTE(test_zf_tailq_insert_after());
 	TEST_EXECUTE(test_zf_tailq_remove());
+	TEST_EXECUTE(test_zf_tailq_swap());
+	TEST_EXECUTE(test_zf_tailq_concat());
+	TEST_EXECUTE(test_zf_tailq_splice());
+	TEST_EXECUTE(test_zf_tailq_split());
+	TEST_EXECUTE(test_zf_tailq_radix_sort());
+	TEST_EXECUTE(test_zf_tailq_merge());
+	TEST_EXECUTE(test_zf_tailq_insert_bulk());
+	TEST_EXECUTE(test_zf_tailq_foreach_prefetch());
+	TEST_EXECUTE(test_zf_tailq_relink());
+	TEST_EXECUTE(test_zf_tailq_filter());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_tailq_link_policy());
+	TEST_EXECUTE(test_zf_tailq_iterator());
+#endif
 }
 
 static void test_zf_queue_h(TEST_SUIT_ARGUMENTS)
@@ -0,0 +1,46 @@
+/* Calls every operation that has USDT probe, so probes end up in ELF notes of
+ * this executable (see zf_queue_usdt.cmake). Built with ZF_QUEUE_USDT.
+ */
+#include <zf_queue.h>
+
+int main(void)
+{
+	zf_slist_node sn[2];
+	zf_slist_head sh = ZF_SLIST_INITIALIZER();
+	zf_slist_insert_head(&sh, &sn[0]);
+	zf_slist_insert_after(&sn[0], &sn[1]);
+	zf_slist_remove_after(&sn[0]);
+	zf_slist_remove_head(&sh);
+
+	zf_list_node ln[3];
+	zf_list_head lh = ZF_LIST_INITIALIZER();
+	zf_list_head lh2 = ZF_LIST_INITIALIZER();
+	zf_list_insert_head(&lh, &ln[0]);
+	zf_list_insert_before(&ln[0], &ln[1]);
+	zf_list_insert_after(&ln[0], &ln[2]);
+	zf_list_remove(&ln[1]);
+	zf_list_concat(&lh2, &lh);
+
+	zf_stailq_node sqn[3];
+	zf_stailq_head sqh = ZF_STAILQ_INITIALIZER(&sqh);
+	zf_stailq_head sqh2 = ZF_STAILQ_INITIALIZER(&sqh2);
+	zf_stailq_insert_head(&sqh, &sqn[0]);
+	zf_stailq_insert_tail(&sqh, &sqn[1]);
+	zf_stailq_insert_after(&sqh, &sqn[0], &sqn[2]);
+	zf_stailq_remove_after(&sqh, &sqn[0]);
+	zf_stailq_remove_head(&sqh);
+	zf_stailq_concat(&sqh2, &sqh);
+
+	zf_tailq_node tqn[4];
+	zf_tailq_head tqh = ZF_TAILQ_INITIALIZER(&tqh);
+	zf_tailq_head tqh2 = ZF_TAILQ_INITIALIZER(&tqh2);
+	zf_tailq_insert_head(&tqh, &tqn[0]);
+	zf_tailq_insert_tail(&tqh, &tqn[1]);
+	zf_tailq_insert_before(&tqn[1], &tqn[2]);
+	zf_tailq_insert_after(&tqh, &tqn[1], &tqn[3]);
+	zf_tailq_remove(&tqh, &tqn[2]);
+	zf_tailq_concat(&tqh2, &tqh);
+
+	return zf_stailq_empty(&sqh2) || zf_tailq_empty(&tqh2) ||
+		   zf_list_empty(&lh2)? 1: 0;
+}
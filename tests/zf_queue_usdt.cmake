@@ -0,0 +1,37 @@
+# Verifies that ELF notes of FILE have USDT probe zf_queue:NAME for each NAME
+# in NAMES and that ELF notes of PLAIN_FILE (built without ZF_QUEUE_USDT) have
+# no zf_queue probes.
+# Usage:
+#   cmake -DREADELF=... -DFILE=... -DPLAIN_FILE=... -DNAMES=a,b -P this_file
+
+# returns readelf -n output for file in out_var
+function(read_notes file out_var)
+	execute_process(
+		COMMAND ${READELF} -n ${file}
+		OUTPUT_VARIABLE notes
+		ERROR_VARIABLE err
+		RESULT_VARIABLE rc)
+	if(NOT rc EQUAL 0)
+		message(FATAL_ERROR "readelf failed:\n${err}")
+	endif()
+	set(${out_var} "${notes}" PARENT_SCOPE)
+endfunction()
+
+read_notes(${FILE} notes)
+string(REPLACE "," ";" names "${NAMES}")
+set(missing "")
+foreach(name IN LISTS names)
+	if(notes MATCHES "Provider: zf_queue[ \t\r]*\n[ \t]*Name: ${name}[ \t\r]*\n")
+		message(STATUS "${name}: found")
+	else()
+		list(APPEND missing ${name})
+	endif()
+endforeach()
+if(missing)
+	message(FATAL_ERROR "probes not found: ${missing}\n${notes}")
+endif()
+
+read_notes(${PLAIN_FILE} notes)
+if(notes MATCHES "Provider: zf_queue")
+	message(FATAL_ERROR "probes found in build without ZF_QUEUE_USDT:\n${notes}")
+endif()
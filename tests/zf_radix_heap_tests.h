@@ -0,0 +1,176 @@
+#pragma once
+
+#if defined(__cplusplus)
+#include "zf_test.hpp"
+#else
+#include "zf_test.h"
+#endif
+#include "zf_radix_heap.h"
+
+typedef struct radix_heap_test_entry
+{
+	unsigned id;
+	zf_radix_heap_node node;
+}
+radix_heap_test_entry;
+
+static unsigned test_zf_radix_heap_pop(zf_radix_heap *const h)
+{
+	zf_radix_heap_node *const n = zf_radix_heap_pop(h);
+	return 0 == n? ~0u: zf_entry(n, radix_heap_test_entry, node)->id;
+}
+
+static void test_zf_radix_heap_bucket()
+{
+	zf_radix_heap h;
+	zf_radix_heap_init(&h);
+	TEST_VERIFY_EQUAL(0u, _zf_radix_heap_bucket(&h, 0));
+	TEST_VERIFY_EQUAL(1u, _zf_radix_heap_bucket(&h, 1));
+	TEST_VERIFY_EQUAL(3u, _zf_radix_heap_bucket(&h, 7));
+	TEST_VERIFY_EQUAL(64u, _zf_radix_heap_bucket(&h, ~(uint64_t)0));
+	h.last = 6;
+	TEST_VERIFY_EQUAL(0u, _zf_radix_heap_bucket(&h, 6));
+	TEST_VERIFY_EQUAL(1u, _zf_radix_heap_bucket(&h, 7));
+	TEST_VERIFY_EQUAL(4u, _zf_radix_heap_bucket(&h, 8));
+}
+
+static void test_zf_radix_heap_sorted()
+{
+	radix_heap_test_entry a[100];
+	zf_radix_heap h;
+	zf_radix_heap_init(&h);
+	TEST_VERIFY_TRUE(zf_radix_heap_empty(&h));
+	TEST_VERIFY_EQUAL(~0u, test_zf_radix_heap_pop(&h));
+	for (unsigned i = 0; 100 > i; ++i)
+	{
+		/* with duplicates */
+		a[i].id = i;
+		zf_radix_heap_insert(&h, &a[i].node, (i * 37) % 60);
+	}
+	TEST_VERIFY_EQUAL(100u, zf_radix_heap_count(&h));
+	uint64_t last = 0;
+	for (unsigned i = 0; 100 > i; ++i)
+	{
+		zf_radix_heap_node *const n = zf_radix_heap_pop(&h);
+		TEST_VERIFY_TRUE(last <= n->key);
+		TEST_VERIFY_EQUAL(n->key, zf_radix_heap_last(&h));
+		last = n->key;
+	}
+	TEST_VERIFY_EQUAL(59u, last);
+	TEST_VERIFY_TRUE(zf_radix_heap_empty(&h));
+	TEST_VERIFY_EQUAL(0u, h.used);
+}
+
+static void test_zf_radix_heap_monotone()
+{
+	radix_heap_test_entry a[4];
+	zf_radix_heap h;
+	zf_radix_heap_init(&h);
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].id = i;
+	}
+	zf_radix_heap_insert(&h, &a[0].node, 100);
+	zf_radix_heap_insert(&h, &a[1].node, (uint64_t)1 << 63);
+	TEST_VERIFY_EQUAL(&a[0].node, zf_radix_heap_top(&h));
+	TEST_VERIFY_EQUAL(0u, test_zf_radix_heap_pop(&h));
+	/* keys not less than the last popped one */
+	zf_radix_heap_insert(&h, &a[2].node, 100);
+	zf_radix_heap_insert(&h, &a[3].node, 101);
+	TEST_VERIFY_EQUAL(2u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL(3u, test_zf_radix_heap_pop(&h));
+	zf_radix_heap_insert(&h, &a[0].node, ~(uint64_t)0);
+	TEST_VERIFY_EQUAL(1u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL((uint64_t)1 << 63, zf_radix_heap_last(&h));
+	TEST_VERIFY_EQUAL(0u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL(~0u, test_zf_radix_heap_pop(&h));
+}
+
+static void test_zf_radix_heap_update()
+{
+	radix_heap_test_entry a[8];
+	zf_radix_heap h;
+	zf_radix_heap_init(&h);
+	for (unsigned i = 0; 8 > i; ++i)
+	{
+		a[i].id = i;
+		zf_radix_heap_insert(&h, &a[i].node, 1000 + 10 * i);
+	}
+	TEST_VERIFY_EQUAL(0u, test_zf_radix_heap_pop(&h));
+	/* decrease key (to the last popped one), increase key, remove */
+	zf_radix_heap_update(&h, &a[7].node, 1000);
+	zf_radix_heap_update(&h, &a[1].node, 5000);
+	zf_radix_heap_remove(&h, &a[3].node);
+	TEST_VERIFY_EQUAL(6u, zf_radix_heap_count(&h));
+	TEST_VERIFY_EQUAL(7u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL(2u, test_zf_radix_heap_pop(&h));
+	/* entries after redistribution are still found by their key */
+	zf_radix_heap_update(&h, &a[6].node, 1021);
+	zf_radix_heap_remove(&h, &a[4].node);
+	TEST_VERIFY_EQUAL(6u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL(5u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL(1u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_TRUE(zf_radix_heap_empty(&h));
+	TEST_VERIFY_EQUAL(0u, h.used);
+}
+
+static void test_zf_radix_heap_peek()
+{
+	radix_heap_test_entry a[4];
+	zf_radix_heap h;
+	zf_radix_heap_init(&h);
+	for (unsigned i = 0; 4 > i; ++i)
+	{
+		a[i].id = i;
+	}
+	/* peek doesn't move the last popped key */
+	zf_radix_heap_insert(&h, &a[0].node, 10);
+	TEST_VERIFY_EQUAL(&a[0].node, zf_radix_heap_top(&h));
+	TEST_VERIFY_EQUAL(0u, zf_radix_heap_last(&h));
+	zf_radix_heap_insert(&h, &a[1].node, 5);
+	TEST_VERIFY_EQUAL(&a[1].node, zf_radix_heap_top(&h));
+	/* and update to a key below the peeked one */
+	zf_radix_heap_insert(&h, &a[2].node, 7);
+	zf_radix_heap_update(&h, &a[2].node, 3);
+	TEST_VERIFY_EQUAL(&a[2].node, zf_radix_heap_top(&h));
+	TEST_VERIFY_EQUAL(2u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL(3u, zf_radix_heap_last(&h));
+	zf_radix_heap_insert(&h, &a[3].node, 5);
+	/* equal keys are popped in insertion order, top agrees with pop */
+	TEST_VERIFY_EQUAL(&a[1].node, zf_radix_heap_top(&h));
+	TEST_VERIFY_EQUAL(1u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL(3u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_EQUAL(0u, test_zf_radix_heap_pop(&h));
+	TEST_VERIFY_TRUE(0 == zf_radix_heap_top(&h));
+}
+
+#ifdef __cplusplus
+static void test_zf_radix_heap_cpp()
+{
+	typedef radix_heap_test_entry entry;
+	entry a[3];
+	zf_radix_heap h;
+	zf_radix_heap_init(&h);
+	zf_radix_heap_insert_<entry, &entry::node>(&h, &a[0], 30);
+	zf_radix_heap_insert_<entry, &entry::node>(&h, &a[1], 20);
+	zf_radix_heap_insert_<entry, &entry::node>(&h, &a[2], 10);
+	zf_radix_heap_update_<entry, &entry::node>(&h, &a[0], 5);
+	zf_radix_heap_remove_<entry, &entry::node>(&h, &a[2]);
+	TEST_VERIFY_EQUAL(&a[0], (zf_radix_heap_top_<entry, &entry::node>(&h)));
+	TEST_VERIFY_EQUAL(&a[0], (zf_radix_heap_pop_<entry, &entry::node>(&h)));
+	TEST_VERIFY_EQUAL(&a[1], (zf_radix_heap_pop_<entry, &entry::node>(&h)));
+	TEST_VERIFY_TRUE((0 == zf_radix_heap_pop_<entry, &entry::node>(&h)));
+}
+#endif
+
+static void test_zf_radix_heap_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_radix_heap_bucket());
+	TEST_EXECUTE(test_zf_radix_heap_sorted());
+	TEST_EXECUTE(test_zf_radix_heap_monotone());
+	TEST_EXECUTE(test_zf_radix_heap_update());
+	TEST_EXECUTE(test_zf_radix_heap_peek());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_radix_heap_cpp());
+#endif
+}
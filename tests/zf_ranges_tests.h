@@ -0,0 +1,163 @@
+#pragma once
+
+#include "zf_test.hpp"
+#include "zf_ranges.h"
+
+#include <algorithm>
+
+struct ranges_test_entry
+{
+	unsigned value;
+	zf_slist_node snode;
+	zf_list_node lnode;
+	zf_stailq_node sqnode;
+	zf_tailq_node tqnode;
+};
+
+typedef zf_slist_head_t(ranges_test_entry, snode) ranges_test_slist;
+typedef zf_list_head_t(ranges_test_entry, lnode) ranges_test_list;
+typedef zf_stailq_head_t(ranges_test_entry, sqnode) ranges_test_stailq;
+typedef zf_tailq_head_t(ranges_test_entry, tqnode) ranges_test_tailq;
+
+static_assert(std::ranges::forward_range<ranges_test_slist>);
+static_assert(std::ranges::forward_range<ranges_test_list>);
+static_assert(std::ranges::forward_range<ranges_test_stailq>);
+static_assert(std::ranges::bidirectional_range<ranges_test_tailq>);
+static_assert(std::ranges::common_range<ranges_test_tailq>);
+static_assert(std::ranges::borrowed_range<ranges_test_slist>);
+static_assert(std::ranges::borrowed_range<ranges_test_list>);
+static_assert(std::ranges::borrowed_range<ranges_test_stailq>);
+static_assert(std::ranges::borrowed_range<ranges_test_tailq &>);
+static_assert(std::ranges::view<
+		decltype(zf_tailq_safe_((ranges_test_tailq *)0))>);
+static_assert(std::ranges::borrowed_range<
+		decltype(zf_tailq_reverse_((ranges_test_tailq *)0))>);
+
+template <typename R>
+static std::vector<unsigned> test_zf_ranges_values(R &&r)
+{
+	std::vector<unsigned> values;
+	for (const ranges_test_entry &e: r)
+	{
+		values.push_back(e.value);
+	}
+	return values;
+}
+
+static void test_zf_ranges_pipeline()
+{
+	ranges_test_entry a[6];
+	ranges_test_slist sh = ZF_SLIST_INITIALIZER();
+	ranges_test_list lh = ZF_LIST_INITIALIZER();
+	ranges_test_stailq sqh = ZF_STAILQ_INITIALIZER(&sqh);
+	ranges_test_tailq tqh = ZF_TAILQ_INITIALIZER(&tqh);
+	for (unsigned i = 0; 6 > i; ++i)
+	{
+		a[i].value = 6 - i;
+		zf_slist_insert_head_(&sh, &a[i]);
+		zf_list_insert_head_(&lh, &a[i]);
+		zf_stailq_insert_head(&sqh, &a[i].sqnode);
+		zf_tailq_insert_head_(&tqh, &a[i]);
+	}
+	const auto odd = [](const ranges_test_entry &e) { return 0 != e.value % 2; };
+	const std::vector<unsigned> x = {1, 3};
+	TEST_VERIFY_TRUE(x == test_zf_ranges_values(
+			sh | std::views::filter(odd) | std::views::take(2)));
+	TEST_VERIFY_TRUE(x == test_zf_ranges_values(
+			lh | std::views::filter(odd) | std::views::take(2)));
+	TEST_VERIFY_TRUE(x == test_zf_ranges_values(
+			sqh | std::views::filter(odd) | std::views::take(2)));
+	TEST_VERIFY_TRUE(x == test_zf_ranges_values(
+			tqh | std::views::filter(odd) | std::views::take(2)));
+	const std::vector<unsigned> r = {5, 3, 1};
+	TEST_VERIFY_TRUE(r == test_zf_ranges_values(
+			tqh | std::views::reverse | std::views::filter(odd)));
+	TEST_VERIFY_TRUE(r == test_zf_ranges_values(
+			zf_tailq_reverse_(&tqh) | std::views::filter(odd)));
+	/* iterators of borrowed ranges don't dangle */
+	const auto i = std::ranges::find(std::views::all(tqh), 4u,
+									 &ranges_test_entry::value);
+	TEST_VERIFY_EQUAL(&a[2], &*i);
+	TEST_VERIFY_EQUAL(&a[2], &*std::ranges::find(zf_tailq_reverse_(&tqh), 4u,
+												 &ranges_test_entry::value));
+	TEST_VERIFY_EQUAL(3, (int)std::ranges::count_if(sh, odd));
+	TEST_VERIFY_EQUAL(6, (int)std::ranges::distance(zf_stailq_safe_(&sqh)));
+}
+
+static void test_zf_ranges_safe()
+{
+	ranges_test_entry a[6];
+	ranges_test_slist sh = ZF_SLIST_INITIALIZER();
+	ranges_test_list lh = ZF_LIST_INITIALIZER();
+	ranges_test_stailq sqh = ZF_STAILQ_INITIALIZER(&sqh);
+	ranges_test_tailq tqh = ZF_TAILQ_INITIALIZER(&tqh);
+	for (unsigned i = 0; 6 > i; ++i)
+	{
+		a[i].value = i;
+		zf_slist_insert_head_(&sh, &a[i]);
+		zf_list_insert_head_(&lh, &a[i]);
+		zf_stailq_insert_head(&sqh, &a[i].sqnode);
+		zf_tailq_insert_head_(&tqh, &a[i]);
+	}
+	const auto odd = [](const ranges_test_entry &e) { return 0 != e.value % 2; };
+	const std::vector<unsigned> x = {4, 2, 0};
+	/* views are created before entries are removed, list is read on begin() */
+	auto ss = zf_slist_safe_(&sh);
+	auto ls = zf_list_safe_(&lh);
+	auto sqs = zf_stailq_safe_(&sqh);
+	auto tqs = zf_tailq_safe_(&tqh);
+	/* no removal of arbitrary nodes, move all entries to other list instead */
+	ranges_test_slist sh2 = ZF_SLIST_INITIALIZER();
+	for (ranges_test_entry &e: ss)
+	{
+		zf_slist_insert_head_(&sh2, &e);
+	}
+	zf_slist_init(&sh);
+	TEST_VERIFY_EQUAL(6, (int)std::ranges::distance(sh2));
+	TEST_VERIFY_EQUAL(&a[0], zf_slist_first_(&sh2));
+	for (ranges_test_entry &e: ls | std::views::filter(odd))
+	{
+		zf_list_remove(&e.lnode);
+		e.lnode.next = 0;
+	}
+	TEST_VERIFY_TRUE(x == test_zf_ranges_values(lh));
+	ranges_test_stailq sqh2 = ZF_STAILQ_INITIALIZER(&sqh2);
+	for (ranges_test_entry &e: sqs)
+	{
+		zf_stailq_insert_head(&sqh2, &e.sqnode);
+	}
+	zf_stailq_init(&sqh);
+	TEST_VERIFY_EQUAL(6, (int)std::ranges::distance(sqh2));
+	TEST_VERIFY_EQUAL(&a[0].sqnode, zf_stailq_first(&sqh2));
+	TEST_VERIFY_TRUE(sqs.empty());
+	for (ranges_test_entry &e: tqs | std::views::filter(odd))
+	{
+		zf_tailq_remove_(&tqh, &e);
+		e.tqnode.next = e.tqnode.prev = 0;
+	}
+	TEST_VERIFY_TRUE(x == test_zf_ranges_values(tqh));
+	const std::vector<unsigned> r = {0, 2, 4};
+	TEST_VERIFY_TRUE(r == test_zf_ranges_values(zf_tailq_reverse_(&tqh)));
+	std::vector<unsigned> removed;
+	for (ranges_test_entry &e: zf_tailq_safe_reverse_(&tqh))
+	{
+		removed.push_back(e.value);
+		zf_tailq_remove_(&tqh, &e);
+		e.tqnode.next = e.tqnode.prev = 0;
+	}
+	TEST_VERIFY_TRUE(r == removed);
+	TEST_VERIFY_TRUE(zf_tailq_empty(&tqh));
+	TEST_VERIFY_TRUE(zf_tailq_reverse_(&tqh).empty());
+	TEST_VERIFY_TRUE(zf_tailq_safe_reverse_(&tqh).empty());
+}
+
+static void test_zf_ranges(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_ranges_pipeline());
+	TEST_EXECUTE(test_zf_ranges_safe());
+}
+
+static void test_zf_ranges_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE_SUITE(test_zf_ranges);
+}
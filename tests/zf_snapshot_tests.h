@@ -0,0 +1,223 @@
+#pragma once
+
+#if defined(__cplusplus)
+#include "zf_test.hpp"
+#else
+#include "zf_test.h"
+#endif
+#include "zf_snapshot.h"
+
+typedef struct snapshot_test_entry
+{
+	unsigned key;
+	zf_slist_node snode;
+	zf_list_node lnode;
+	zf_stailq_node sqnode;
+	zf_tailq_node tqnode;
+}
+snapshot_test_entry;
+
+static void test_zf_snapshot_verify(zf_snapshot *const s,
+									snapshot_test_entry *const *const e,
+									const unsigned count)
+{
+	TEST_VERIFY_EQUAL(count, zf_snapshot_count(s));
+	for (unsigned i = 0; count > i; ++i)
+	{
+		TEST_VERIFY_EQUAL((void *)e[i], zf_snapshot_entry(s, i));
+		if (0 != s->keys)
+		{
+			TEST_VERIFY_EQUAL(e[i]->key, *(unsigned *)zf_snapshot_key(s, i));
+		}
+	}
+}
+
+static void test_zf_snapshot_stailq()
+{
+	snapshot_test_entry a[4];
+	snapshot_test_entry *x[4] = {0};
+	void *entries[4];
+	unsigned keys[4];
+	uint64_t generation = 0;
+	zf_stailq_head h = ZF_STAILQ_INITIALIZER(&h);
+	zf_snapshot s;
+	zf_snapshot_init(&s, entries, 4, &generation);
+	TEST_VERIFY_TRUE(zf_snapshot_stale(&s));
+	TEST_VERIFY_EQUAL(0u, zf_snapshot_stailq(&s, &h,
+						offsetof(snapshot_test_entry, sqnode)));
+	TEST_VERIFY_FALSE(zf_snapshot_stale(&s));
+	test_zf_snapshot_verify(&s, x, 0);
+	for (unsigned i = 0; 3 > i; ++i)
+	{
+		a[i].key = 10 + i;
+		zf_stailq_insert_head(&h, &a[i].sqnode);
+		x[2 - i] = &a[i];
+	}
+	++generation;
+	TEST_VERIFY_TRUE(zf_snapshot_stale(&s));
+	zf_snapshot_set_keys(&s, keys, offsetof(snapshot_test_entry, key),
+						 sizeof(unsigned));
+	TEST_VERIFY_EQUAL(3u, zf_snapshot_stailq(&s, &h,
+						offsetof(snapshot_test_entry, sqnode)));
+	TEST_VERIFY_FALSE(zf_snapshot_stale(&s));
+	test_zf_snapshot_verify(&s, x, 3);
+	/* snapshot is truncated when list doesn't fit */
+	zf_snapshot_init(&s, entries, 2, &generation);
+	TEST_VERIFY_EQUAL(3u, zf_snapshot_stailq(&s, &h,
+						offsetof(snapshot_test_entry, sqnode)));
+	TEST_VERIFY_TRUE(zf_snapshot_stale(&s));
+	test_zf_snapshot_verify(&s, x, 2);
+}
+
+static void test_zf_snapshot_tailq()
+{
+	snapshot_test_entry a[3];
+	snapshot_test_entry *x[3];
+	void *entries[3];
+	unsigned keys[3];
+	uint64_t generation = 7;
+	zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+	for (unsigned i = 0; 3 > i; ++i)
+	{
+		a[i].key = 20 + i;
+		zf_tailq_insert_tail(&h, &a[i].tqnode);
+		x[i] = &a[i];
+	}
+	zf_snapshot s;
+	zf_snapshot_init(&s, entries, 3, &generation);
+	zf_snapshot_set_keys(&s, keys, offsetof(snapshot_test_entry, key),
+						 sizeof(unsigned));
+	TEST_VERIFY_EQUAL(3u, zf_snapshot_tailq(&s, &h,
+						offsetof(snapshot_test_entry, tqnode)));
+	test_zf_snapshot_verify(&s, x, 3);
+	zf_tailq_remove(&h, &a[1].tqnode);
+	++generation;
+	TEST_VERIFY_TRUE(zf_snapshot_stale(&s));
+	/* snapshot still has old content */
+	test_zf_snapshot_verify(&s, x, 3);
+	TEST_VERIFY_EQUAL(2u, zf_snapshot_tailq(&s, &h,
+						offsetof(snapshot_test_entry, tqnode)));
+	TEST_VERIFY_FALSE(zf_snapshot_stale(&s));
+	x[1] = &a[2];
+	test_zf_snapshot_verify(&s, x, 2);
+}
+
+static void test_zf_snapshot_slist_list()
+{
+	snapshot_test_entry a[2];
+	snapshot_test_entry *const x[] = {&a[1], &a[0]};
+	void *entries[2];
+	uint64_t generation = 0;
+	zf_slist_head sh = ZF_SLIST_INITIALIZER();
+	zf_list_head lh = ZF_LIST_INITIALIZER();
+	for (unsigned i = 0; 2 > i; ++i)
+	{
+		zf_slist_insert_head(&sh, &a[i].snode);
+		zf_list_insert_head(&lh, &a[i].lnode);
+	}
+	zf_snapshot s;
+	zf_snapshot_init(&s, entries, 2, &generation);
+	TEST_VERIFY_EQUAL(2u, zf_snapshot_slist(&s, &sh,
+						offsetof(snapshot_test_entry, snode)));
+	test_zf_snapshot_verify(&s, x, 2);
+	TEST_VERIFY_EQUAL(2u, zf_snapshot_list(&s, &lh,
+						offsetof(snapshot_test_entry, lnode)));
+	test_zf_snapshot_verify(&s, x, 2);
+#ifdef __cplusplus
+	zf_slist_head_t(snapshot_test_entry, snode) shpp = ZF_SLIST_INITIALIZER();
+	zf_slist_insert_head_(&shpp, &a[0]);
+	TEST_VERIFY_EQUAL(1u, zf_snapshot_slist_(&s, &shpp));
+	TEST_VERIFY_EQUAL(&a[0], zf_snapshot_entry_<snapshot_test_entry>(&s, 0));
+	zf_list_head_t(snapshot_test_entry, lnode) lhpp = ZF_LIST_INITIALIZER();
+	zf_list_insert_head_(&lhpp, &a[1]);
+	TEST_VERIFY_EQUAL(1u, zf_snapshot_list_(&s, &lhpp));
+	TEST_VERIFY_EQUAL(&a[1], zf_snapshot_entry_<snapshot_test_entry>(&s, 0));
+#endif
+}
+
+#ifdef __cplusplus
+static void test_zf_snapshot_cpp()
+{
+	snapshot_test_entry a[3];
+	void *entries[3];
+	unsigned keys[3];
+	uint64_t generation = 0;
+	zf_stailq_head_t(snapshot_test_entry, sqnode) sqh =
+			ZF_STAILQ_INITIALIZER(&sqh);
+	zf_tailq_head_t(snapshot_test_entry, tqnode) tqh =
+			ZF_TAILQ_INITIALIZER(&tqh);
+	for (unsigned i = 0; 3 > i; ++i)
+	{
+		a[i].key = 30 + i;
+		zf_stailq_insert_tail(&sqh, &a[i].sqnode);
+		zf_tailq_insert_head_(&tqh, &a[i]);
+	}
+	zf_snapshot s;
+	zf_snapshot_init(&s, entries, 3, &generation);
+	zf_snapshot_set_keys(&s, keys, offsetof(snapshot_test_entry, key),
+						 sizeof(unsigned));
+	TEST_VERIFY_EQUAL(3u, zf_snapshot_stailq_(&s, &sqh));
+	for (unsigned i = 0; 3 > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(&a[i], zf_snapshot_entry_<snapshot_test_entry>(&s, i));
+		TEST_VERIFY_EQUAL(30 + i, *zf_snapshot_key_<unsigned>(&s, i));
+	}
+	TEST_VERIFY_EQUAL(3u, zf_snapshot_tailq_(&s, &tqh));
+	for (unsigned i = 0; 3 > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(&a[2 - i],
+						  zf_snapshot_entry_<snapshot_test_entry>(&s, i));
+		TEST_VERIFY_EQUAL(32 - i, *zf_snapshot_key_<unsigned>(&s, i));
+	}
+}
+#endif
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+static void test_zf_snapshot_source()
+{
+	typedef zf_tailq_head_t(snapshot_test_entry, tqnode) head_t;
+	snapshot_test_entry a[3];
+	void *entries[3];
+	zf_snapshot_source_<head_t> src;
+	zf_snapshot s;
+	src.init(&s, entries, 3);
+	TEST_VERIFY_EQUAL(0u, src.take(&s));
+	TEST_VERIFY_FALSE(zf_snapshot_stale(&s));
+	/* modification through modify() makes snapshot stale */
+	src.modify([&a](head_t *const h)
+	{
+		for (unsigned i = 0; 3 > i; ++i)
+		{
+			zf_tailq_insert_tail_(h, &a[i]);
+		}
+	});
+	TEST_VERIFY_TRUE(zf_snapshot_stale(&s));
+	TEST_VERIFY_EQUAL(3u, src.take(&s));
+	TEST_VERIFY_FALSE(zf_snapshot_stale(&s));
+	src.read([](head_t *) {});
+	TEST_VERIFY_FALSE(zf_snapshot_stale(&s));
+	src.modify([&a](head_t *const h) { zf_tailq_remove_(h, &a[1]); });
+	TEST_VERIFY_TRUE(zf_snapshot_stale(&s));
+	TEST_VERIFY_EQUAL(2u, src.take(&s));
+	TEST_VERIFY_EQUAL(&a[2], zf_snapshot_entry_<snapshot_test_entry>(&s, 1));
+	TEST_VERIFY_EQUAL((uint64_t)2, *src.counter());
+}
+#endif
+
+static void test_zf_snapshot(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_snapshot_stailq());
+	TEST_EXECUTE(test_zf_snapshot_tailq());
+	TEST_EXECUTE(test_zf_snapshot_slist_list());
+#ifdef __cplusplus
+	TEST_EXECUTE(test_zf_snapshot_cpp());
+#endif
+#if defined(__cplusplus) && __cplusplus >= 201103L
+	TEST_EXECUTE(test_zf_snapshot_source());
+#endif
+}
+
+static void test_zf_snapshot_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE_SUITE(test_zf_snapshot);
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#if defined(__cplusplus)
+#include "zf_test.hpp"
+#else
+#include "zf_test.h"
+#endif
+#include "zf_tailq_index.h"
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#include "zf_thread_pool.h"
+#include <atomic>
+#endif
+
+typedef struct tailq_index_test_entry
+{
+	unsigned value;
+	zf_tailq_node node;
+}
+tailq_index_test_entry;
+
+/* segments must be disjoint and cover all nodes in list order */
+static void test_zf_tailq_index_verify(zf_tailq_index *const ix,
+									   zf_tailq_node *const *const n,
+									   const unsigned count)
+{
+	unsigned k = 0;
+	for (size_t i = 0; zf_tailq_index_segments(ix) > i; ++i)
+	{
+		zf_tailq_node *const end = zf_tailq_index_end(ix, i);
+		for (zf_tailq_node *j = zf_tailq_index_begin(ix, i); end != j;
+			 j = zf_tailq_next(j))
+		{
+			TEST_VERIFY_TRUE(count > k);
+			TEST_VERIFY_EQUAL(n[k], j);
+			++k;
+		}
+	}
+	TEST_VERIFY_EQUAL(count, k);
+}
+
+static void test_zf_tailq_index_build()
+{
+	zf_tailq_node a[10];
+	zf_tailq_node *marks[3];
+	size_t order[3];
+	zf_tailq_node *x[10] = {0};
+	zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+	uint64_t modified = 0;
+	zf_tailq_index ix;
+	zf_tailq_index_init(&ix, &h, marks, order, 3, &modified);
+	TEST_VERIFY_TRUE(zf_tailq_index_stale(&ix));
+	TEST_VERIFY_EQUAL(1u, zf_tailq_index_build(&ix));
+	TEST_VERIFY_FALSE(zf_tailq_index_stale(&ix));
+	test_zf_tailq_index_verify(&ix, x, 0);
+	for (unsigned i = 0; 10 > i; ++i)
+	{
+		zf_tailq_insert_tail(&h, &a[i]);
+		x[i] = &a[i];
+	}
+	/* inserted nodes go to the only segment */
+	test_zf_tailq_index_verify(&ix, x, 10);
+	const uint64_t generation = ix.generation;
+	TEST_VERIFY_EQUAL(4u, zf_tailq_index_build(&ix));
+	TEST_VERIFY_NOT_EQUAL(generation, ix.generation);
+	TEST_VERIFY_EQUAL(3u, ix.stride);
+	TEST_VERIFY_EQUAL(&a[3], marks[0]);
+	TEST_VERIFY_EQUAL(&a[6], marks[1]);
+	TEST_VERIFY_EQUAL(&a[9], marks[2]);
+	test_zf_tailq_index_verify(&ix, x, 10);
+	/* single segment when there is no space for marks */
+	zf_tailq_index_init(&ix, &h, marks, order, 0, &modified);
+	TEST_VERIFY_EQUAL(1u, zf_tailq_index_build(&ix));
+	test_zf_tailq_index_verify(&ix, x, 10);
+}
+
+static void test_zf_tailq_index_insert_remove()
+{
+	zf_tailq_node a[12];
+	zf_tailq_node *marks[3];
+	size_t order[3];
+	zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+	for (unsigned i = 1; 11 > i; ++i)
+	{
+		zf_tailq_insert_tail(&h, &a[i]);
+	}
+	uint64_t modified = 0;
+	zf_tailq_index ix;
+	zf_tailq_index_init(&ix, &h, marks, order, 3, &modified);
+	zf_tailq_index_build(&ix);
+	/* marks are 4, 7, 10 */
+	zf_tailq_insert_head(&h, &a[0]);
+	zf_tailq_insert_tail(&h, &a[11]);
+	zf_tailq_node *const x0[] = {&a[0], &a[1], &a[2], &a[3], &a[4], &a[5],
+								 &a[6], &a[7], &a[8], &a[9], &a[10], &a[11]};
+	test_zf_tailq_index_verify(&ix, x0, 12);
+	TEST_VERIFY_FALSE(zf_tailq_index_stale(&ix));
+	uint64_t generation = ix.generation;
+	zf_tailq_index_remove(&ix, &a[2]);
+	TEST_VERIFY_EQUAL(generation, ix.generation);
+	zf_tailq_index_remove(&ix, &a[4]);
+	TEST_VERIFY_NOT_EQUAL(generation, ix.generation);
+	TEST_VERIFY_EQUAL(&a[5], marks[0]);
+	zf_tailq_node *const x1[] = {&a[0], &a[1], &a[3], &a[5], &a[6], &a[7],
+								 &a[8], &a[9], &a[10], &a[11]};
+	test_zf_tailq_index_verify(&ix, x1, 10);
+	/* segment becomes empty, mark is dropped */
+	zf_tailq_index_remove(&ix, &a[5]);
+	zf_tailq_index_remove(&ix, &a[6]);
+	TEST_VERIFY_EQUAL(3u, zf_tailq_index_segments(&ix));
+	TEST_VERIFY_EQUAL(&a[7], marks[0]);
+	TEST_VERIFY_EQUAL(&a[10], marks[1]);
+	zf_tailq_index_remove(&ix, &a[11]);
+	zf_tailq_index_remove(&ix, &a[10]);
+	TEST_VERIFY_EQUAL(2u, zf_tailq_index_segments(&ix));
+	zf_tailq_node *const x2[] = {&a[0], &a[1], &a[3], &a[7], &a[8], &a[9]};
+	test_zf_tailq_index_verify(&ix, x2, 6);
+	/* mark removed with plain zf_tailq_remove() is detected */
+	TEST_VERIFY_TRUE(zf_tailq_index_check(&ix));
+	generation = ix.generation;
+	zf_tailq_remove(&h, &a[7]);
+	TEST_VERIFY_FALSE(zf_tailq_index_check(&ix));
+	TEST_VERIFY_TRUE(zf_tailq_index_stale(&ix));
+	TEST_VERIFY_NOT_EQUAL(generation, ix.generation);
+	/* stale index doesn't track marks */
+	zf_tailq_index_remove(&ix, &a[8]);
+	zf_tailq_index_build(&ix);
+	zf_tailq_node *const x3[] = {&a[0], &a[1], &a[3], &a[9]};
+	test_zf_tailq_index_verify(&ix, x3, 4);
+	/* mark removed and inserted again is detected by modification counter */
+	TEST_VERIFY_EQUAL(&a[3], marks[1]);
+	zf_tailq_remove(&h, &a[3]);
+	zf_tailq_insert_tail(&h, &a[3]);
+	++modified;
+	generation = ix.generation;
+	TEST_VERIFY_FALSE(zf_tailq_index_check(&ix));
+	TEST_VERIFY_NOT_EQUAL(generation, ix.generation);
+	zf_tailq_index_build(&ix);
+	TEST_VERIFY_TRUE(zf_tailq_index_check(&ix));
+	zf_tailq_node *const x4[] = {&a[0], &a[1], &a[9], &a[3]};
+	test_zf_tailq_index_verify(&ix, x4, 4);
+}
+
+static void test_zf_tailq_index_remove_many()
+{
+	/* queue order is reverse of address order, marks are looked up by address */
+	zf_tailq_node a[64];
+	zf_tailq_node *x[64];
+	zf_tailq_node *marks[7];
+	size_t order[7];
+	bool linked[64];
+	zf_tailq_head h = ZF_TAILQ_INITIALIZER(&h);
+	for (unsigned i = 0; 64 > i; ++i)
+	{
+		zf_tailq_insert_head(&h, &a[i]);
+		linked[i] = true;
+	}
+	uint64_t modified = 0;
+	zf_tailq_index ix;
+	zf_tailq_index_init(&ix, &h, marks, order, 7, &modified);
+	TEST_VERIFY_EQUAL(8u, zf_tailq_index_build(&ix));
+	for (size_t j = 0; ix.count > j + 1; ++j)
+	{
+		TEST_VERIFY_TRUE(marks[order[j]] < marks[order[j + 1]]);
+	}
+	for (unsigned k = 0; 64 > k; ++k)
+	{
+		const unsigned r = (k * 37) % 64;
+		zf_tailq_index_remove(&ix, &a[r]);
+		linked[r] = false;
+		TEST_VERIFY_TRUE(zf_tailq_index_check(&ix));
+		for (size_t j = 0; ix.count > j + 1; ++j)
+		{
+			TEST_VERIFY_TRUE(marks[order[j]] < marks[order[j + 1]]);
+		}
+		unsigned count = 0;
+		for (unsigned i = 64; 0 < i--;)
+		{
+			if (linked[i])
+			{
+				x[count++] = &a[i];
+			}
+		}
+		test_zf_tailq_index_verify(&ix, x, count);
+	}
+	TEST_VERIFY_TRUE(zf_tailq_empty(&h));
+}
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+static void test_zf_tailq_index_for_each()
+{
+	typedef zf_tailq_head_t(tailq_index_test_entry, node) head_t;
+	const unsigned count = 1000;
+	std::vector<tailq_index_test_entry> a(count);
+	head_t h = ZF_TAILQ_INITIALIZER(&h);
+	for (unsigned i = 0; count > i; ++i)
+	{
+		a[i].value = i;
+		zf_tailq_insert_tail_(&h, &a[i]);
+	}
+	zf_tailq_node *marks[15];
+	size_t order[15];
+	uint64_t modified = 0;
+	zf_tailq_index ix;
+	zf_tailq_index_init(&ix, &h, marks, order, 15, &modified);
+	zf_thread_pool_ pool(4);
+	for (unsigned round = 0; 3 > round; ++round)
+	{
+		std::atomic<unsigned> visited(0);
+		std::atomic<unsigned> sum(0);
+		const auto f = [&](tailq_index_test_entry *const e)
+		{
+			++visited;
+			sum += e->value;
+		};
+		if (0 == round)
+		{
+			zf_tailq_index_for_each_(&ix, &h, f);
+		}
+		else
+		{
+			zf_tailq_index_for_each_(&ix, &h, f, pool);
+		}
+		TEST_VERIFY_FALSE(zf_tailq_index_stale(&ix));
+		TEST_VERIFY_EQUAL(count, visited.load());
+		TEST_VERIFY_EQUAL(count * (count - 1) / 2, sum.load());
+	}
+	/* mark removed without the index is detected and index is rebuilt */
+	const uint64_t generation = ix.generation;
+	zf_tailq_remove_(&h, zf_tailq_entry_(&h, marks[3]));
+	std::atomic<unsigned> removed(0);
+	zf_tailq_index_for_each_(&ix, &h, [&](tailq_index_test_entry *)
+	{
+		++removed;
+	}, pool);
+	TEST_VERIFY_NOT_EQUAL(generation, ix.generation);
+	TEST_VERIFY_EQUAL(count - 1, removed.load());
+	/* entries inserted after build are visited too */
+	tailq_index_test_entry b;
+	b.value = count;
+	zf_tailq_insert_head_(&h, &b);
+	std::atomic<unsigned> visited(0);
+	zf_tailq_index_for_each_(&ix, &h, [&](tailq_index_test_entry *)
+	{
+		++visited;
+	}, pool);
+	TEST_VERIFY_EQUAL(count, visited.load());
+	/* mark moved to the tail without counter increment is not detected, but
+	 * walk stops at the tail */
+	tailq_index_test_entry *const m = zf_tailq_entry_(&h, marks[0]);
+	zf_tailq_remove_(&h, m);
+	zf_tailq_insert_tail_(&h, m);
+	TEST_VERIFY_TRUE(zf_tailq_index_check(&ix));
+	zf_tailq_index_for_each_(&ix, &h, [](tailq_index_test_entry *) {}, pool);
+	/* with increment it is rebuilt */
+	++modified;
+	std::atomic<unsigned> moved(0);
+	zf_tailq_index_for_each_(&ix, &h, [&](tailq_index_test_entry *)
+	{
+		++moved;
+	}, pool);
+	TEST_VERIFY_EQUAL(count, moved.load());
+}
+#endif
+
+static void test_zf_tailq_index(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_tailq_index_build());
+	TEST_EXECUTE(test_zf_tailq_index_insert_remove());
+	TEST_EXECUTE(test_zf_tailq_index_remove_many());
+#if defined(__cplusplus) && __cplusplus >= 201103L
+	TEST_EXECUTE(test_zf_tailq_index_for_each());
+#endif
+}
+
+static void test_zf_tailq_index_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE_SUITE(test_zf_tailq_index);
+}
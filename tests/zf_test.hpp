@@ -1,20 +1,45 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <list>
+#include <utility>
 #include <cmath>
+#include <cstdio>
+#include <cstdarg>
 
 #if !defined(STRINGIFY) && !defined(_STRINGIFY)
 #define _STRINGIFY(x) #x
 #define STRINGIFY(x) _STRINGIFY(x)
 #endif
 
+#if __cplusplus < 201103L
+	/* Tests are shared with C++11 code and use nullptr in comparisons. Below is
+	 * a minimal replacement that is good enough for that purpose (requires
+	 * -Wno-c++11-compat).
+	 */
+	namespace zf_test
+	{
+		class nullptr_t
+		{
+		public:
+			template <typename T>
+			operator T *() const { return 0; }
+			template <typename T>
+			bool operator==(T *const p) const { return 0 == p; }
+			template <typename T>
+			bool operator!=(T *const p) const { return 0 != p; }
+		};
+	}
+	static const zf_test::nullptr_t nullptr = zf_test::nullptr_t();
+#endif
+
 namespace zf_test
 {
 	extern inline std::string strformat(const char *const fmt, ...)
 	{
 		char stack_buf[256];
-		std::unique_ptr<char[]> heap_buf;
+		std::vector<char> heap_buf;
 		char *buf = stack_buf;
 		int buf_sz = sizeof(stack_buf);
 
@@ -30,8 +55,8 @@ namespace zf_test
 				break;
 			}
 			buf_sz = len + 1;
-			heap_buf.reset(new char[buf_sz]);
-			buf = heap_buf.get();
+			heap_buf.resize(buf_sz);
+			buf = &heap_buf[0];
 		}
 		return 0 < len? std::string(buf, len): std::string();
 	}
@@ -112,7 +137,7 @@ namespace zf_test
 			{
 				m_max_name_len = p.first.size();
 			}
-			m_pairs.push_back(std::move(p));
+			m_pairs.push_back(p);
 		}
 
 		void fprint(FILE *const f, const char *const indent) const
@@ -168,8 +193,8 @@ namespace zf_test
 		test_runner(const unsigned argc, const char *const argv[]):
 			error_count(0),
 			verbosity(0),
-			suite_name(nullptr),
-			test_name(nullptr)
+			suite_name(0),
+			test_name(0)
 		{
 			(void)argc; (void)argv;
 		}
@@ -310,7 +335,7 @@ namespace zf_test
 		{ \
 			++test_runner_instance.error_count; \
 			zf_test::test_result result(e.result); \
-			if (nullptr != test_runner_instance.suite_name) \
+			if (0 != test_runner_instance.suite_name) \
 			{ \
 				result.add("suite", test_runner_instance.suite_name); \
 			} \
@@ -0,0 +1,293 @@
+#pragma once
+
+#include "zf_test.hpp"
+#include "zf_thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+struct thread_pool_test_task
+{
+	zf_task_ task;
+	unsigned index;
+	unsigned runs;
+	std::atomic<unsigned> *done;
+	std::vector<unsigned> *order;
+};
+
+static void thread_pool_test_run(zf_task_ *const t)
+{
+	thread_pool_test_task *const e = zf_entry_(t, &thread_pool_test_task::task);
+	++e->runs;
+	if (0 != e->order)
+	{
+		e->order->push_back(e->index);
+	}
+	++*e->done;
+}
+
+static void init_thread_pool_test_tasks(std::vector<thread_pool_test_task> &v,
+										std::atomic<unsigned> *const done,
+										std::vector<unsigned> *const order)
+{
+	for (unsigned i = 0; v.size() > i; ++i)
+	{
+		v[i].task.run = thread_pool_test_run;
+		v[i].index = i;
+		v[i].runs = 0;
+		v[i].done = done;
+		v[i].order = order;
+	}
+}
+
+static void test_zf_thread_pool_submit()
+{
+	const unsigned count = 10000;
+	std::atomic<unsigned> done(0);
+	std::vector<thread_pool_test_task> tasks(count);
+	init_thread_pool_test_tasks(tasks, &done, 0);
+	{
+		zf_thread_pool_ pool(4);
+		TEST_VERIFY_EQUAL(4u, pool.size());
+		for (unsigned i = 0; count > i; ++i)
+		{
+			pool.submit(&tasks[i].task);
+		}
+	}
+	TEST_VERIFY_EQUAL(count, done.load());
+	for (unsigned i = 0; count > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(1u, tasks[i].runs);
+	}
+}
+
+static void test_zf_thread_pool_submit_all()
+{
+	const unsigned count = 10000;
+	std::atomic<unsigned> done(0);
+	std::vector<thread_pool_test_task> tasks(count);
+	init_thread_pool_test_tasks(tasks, &done, 0);
+	{
+		zf_thread_pool_ pool(4);
+		for (unsigned round = 0; 2 > round; ++round)
+		{
+			zf_task_list_ h;
+			zf_stailq_init(&h);
+			for (unsigned i = round; count > i; i += 2)
+			{
+				zf_stailq_insert_tail(&h, &tasks[i].task.node);
+			}
+			pool.submit_all(&h);
+			TEST_VERIFY_TRUE(zf_stailq_empty(&h));
+		}
+		/* empty list is fine */
+		zf_task_list_ h;
+		zf_stailq_init(&h);
+		pool.submit_all(&h);
+	}
+	TEST_VERIFY_EQUAL(count, done.load());
+	for (unsigned i = 0; count > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(1u, tasks[i].runs);
+	}
+}
+
+static void test_zf_thread_pool_order()
+{
+	/* single worker runs tasks submitted from outside in FIFO order */
+	const unsigned count = 1000;
+	std::atomic<unsigned> done(0);
+	std::vector<unsigned> order;
+	std::vector<thread_pool_test_task> tasks(count);
+	init_thread_pool_test_tasks(tasks, &done, &order);
+	{
+		zf_thread_pool_ pool(1);
+		for (unsigned i = 0; count > i; ++i)
+		{
+			pool.submit(&tasks[i].task);
+		}
+	}
+	TEST_VERIFY_EQUAL(count, (unsigned)order.size());
+	for (unsigned i = 0; count > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(i, order[i]);
+	}
+}
+
+/* task that submits fanout children until depth is reached */
+struct thread_pool_test_tree
+{
+	zf_task_ task;
+	zf_thread_pool_ *pool;
+	thread_pool_test_tree *children;
+	unsigned depth;
+	std::atomic<unsigned> *done;
+};
+
+static void thread_pool_test_tree_run(zf_task_ *const t)
+{
+	thread_pool_test_tree *const e = zf_entry_(t, &thread_pool_test_tree::task);
+	++*e->done;
+	if (0 != e->depth)
+	{
+		e->children->depth = e->depth - 1;
+		e->pool->submit(&e->children->task);
+	}
+}
+
+static void test_zf_thread_pool_nested()
+{
+	/* root submits more tasks than local queue holds, rest goes to shared
+	 * queue, each of them submits a chain of tasks from the worker thread
+	 */
+	const unsigned fanout = 2 * ZF_THREAD_POOL_LOCAL_MAX;
+	const unsigned depth = 16;
+	std::atomic<unsigned> done(0);
+	std::vector<thread_pool_test_tree> nodes(fanout * (depth + 1));
+	for (unsigned i = 0; nodes.size() > i; ++i)
+	{
+		nodes[i].task.run = thread_pool_test_tree_run;
+		nodes[i].children = (depth + 1) * fanout > i + fanout?
+				&nodes[i + fanout]: 0;
+		nodes[i].depth = 0;
+		nodes[i].done = &done;
+	}
+	{
+		zf_thread_pool_ pool(3);
+		for (unsigned i = 0; nodes.size() > i; ++i)
+		{
+			nodes[i].pool = &pool;
+		}
+		struct root_task
+		{
+			zf_task_ task;
+			zf_thread_pool_ *pool;
+			thread_pool_test_tree *first;
+			unsigned fanout, depth;
+			static void run(zf_task_ *const t)
+			{
+				root_task *const r = zf_entry_(t, &root_task::task);
+				for (unsigned i = 0; r->fanout > i; ++i)
+				{
+					r->first[i].depth = r->depth;
+					r->pool->submit(&r->first[i].task);
+				}
+			}
+		} root = {{{0}, root_task::run}, &pool, &nodes[0], fanout, depth};
+		pool.submit(&root.task);
+	}
+	TEST_VERIFY_EQUAL((unsigned)nodes.size(), done.load());
+}
+
+static void test_zf_thread_pool_idle()
+{
+	/* workers go to sleep between rounds and must be woken up for the next
+	 * one, lost wakeup would leave tasks in the shared queue forever
+	 */
+	const unsigned rounds = 500;
+	const unsigned count = 8;
+	std::atomic<unsigned> done(0);
+	std::vector<thread_pool_test_task> tasks(count);
+	init_thread_pool_test_tasks(tasks, &done, 0);
+	zf_thread_pool_ pool(4);
+	for (unsigned round = 0; rounds > round; ++round)
+	{
+		for (unsigned i = 0; count > i; ++i)
+		{
+			pool.submit(&tasks[i].task);
+		}
+		const unsigned expected = (round + 1) * count;
+		const std::chrono::steady_clock::time_point deadline =
+				std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (expected != done.load() &&
+			   std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::yield();
+		}
+		TEST_VERIFY_EQUAL(expected, done.load());
+		if (0 == round % 10)
+		{
+			/* let all workers park */
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+	}
+}
+
+struct thread_pool_test_parallel
+{
+	zf_task_ task;
+	zf_thread_pool_ *pool;
+	std::vector<unsigned> *calls;
+	std::atomic<unsigned> *done;
+};
+
+static void thread_pool_test_parallel_run(zf_task_ *const t)
+{
+	thread_pool_test_parallel *const e =
+			zf_entry_(t, &thread_pool_test_parallel::task);
+	/* nested call from a worker must not deadlock */
+	std::vector<unsigned> &calls = *e->calls;
+	e->pool->parallel_for(calls.size(), [&calls](const size_t i)
+	{
+		++calls[i];
+	});
+	++*e->done;
+}
+
+static void test_zf_thread_pool_parallel_for()
+{
+	zf_thread_pool_ pool(3);
+	std::vector<std::atomic<unsigned>> calls(1000);
+	for (unsigned round = 0; 20 > round; ++round)
+	{
+		pool.parallel_for(calls.size() - round, [&calls](const size_t i)
+		{
+			++calls[i];
+		});
+	}
+	for (unsigned i = 0; calls.size() > i; ++i)
+	{
+		TEST_VERIFY_EQUAL(calls.size() - i < 20? calls.size() - i: 20u,
+						  calls[i].load());
+	}
+	pool.parallel_for(0, [](size_t) {});
+	std::atomic<unsigned> done(0);
+	std::vector<std::vector<unsigned>> nested(8, std::vector<unsigned>(100));
+	std::vector<thread_pool_test_parallel> tasks(nested.size());
+	for (unsigned i = 0; tasks.size() > i; ++i)
+	{
+		tasks[i].task.run = thread_pool_test_parallel_run;
+		tasks[i].pool = &pool;
+		tasks[i].calls = &nested[i];
+		tasks[i].done = &done;
+		pool.submit(&tasks[i].task);
+	}
+	while (tasks.size() != done.load())
+	{
+		std::this_thread::yield();
+	}
+	for (unsigned i = 0; nested.size() > i; ++i)
+	{
+		for (unsigned k = 0; nested[i].size() > k; ++k)
+		{
+			TEST_VERIFY_EQUAL(1u, nested[i][k]);
+		}
+	}
+}
+
+static void test_zf_thread_pool(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE(test_zf_thread_pool_submit());
+	TEST_EXECUTE(test_zf_thread_pool_submit_all());
+	TEST_EXECUTE(test_zf_thread_pool_order());
+	TEST_EXECUTE(test_zf_thread_pool_nested());
+	TEST_EXECUTE(test_zf_thread_pool_idle());
+	TEST_EXECUTE(test_zf_thread_pool_parallel_for());
+}
+
+static void test_zf_thread_pool_h(TEST_SUIT_ARGUMENTS)
+{
+	TEST_EXECUTE_SUITE(test_zf_thread_pool);
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#ifndef _ZF_CHANNEL_H_
+#define _ZF_CHANNEL_H_
+
+/* Awaitable intrusive queue for C++20 coroutines. Producers push entries
+ * linked through embedded zf_stailq_node, consumers do:
+ *
+ *   T *const e = co_await channel.pop();
+ *
+ * Suspended consumers are linked into tail queue through the node embedded
+ * into the awaiter object that lives in the coroutine frame, so neither push
+ * nor suspension allocates memory. Waiting consumers are served in FIFO
+ * order. When entry is pushed and there is a waiting consumer, entry is handed
+ * over to it directly and consumer is resumed inline, on the thread that
+ * called push() (before push() returns).
+ *
+ * Mutex template parameter selects the flavour:
+ *  - zf_channel_null_mutex_ (default): single-threaded, no synchronization.
+ *  - std::mutex (or anything with lock() and unlock()): push(), pop() and
+ *    close() could be called from different threads. Consumer could be resumed
+ *    on the producer thread.
+ *
+ * close() resumes all waiting consumers with 0. Entries that are already in
+ * the channel still could be popped, pop() on empty closed channel returns 0
+ * without suspension.
+ *
+ * Suspended consumer could be destroyed (coroutine_handle::destroy()), its
+ * awaiter is unlinked from waiters, so it is not resumed by push() or close().
+ * It must not be destroyed concurrently with push() or close() that already
+ * took it from waiters.
+ */
+
+#include "zf_queue.h"
+
+#if defined(__cplusplus) && __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#include <coroutine>
+
+struct zf_channel_null_mutex_
+{
+	void lock() noexcept {}
+	void unlock() noexcept {}
+};
+
+template <typename T, zf_stailq_node T:: *node,
+		  typename Mutex = zf_channel_null_mutex_>
+class zf_channel_
+{
+public:
+	class pop_awaiter
+	{
+	public:
+		explicit pop_awaiter(zf_channel_ *const ch) noexcept: ch(ch) {}
+		pop_awaiter(const pop_awaiter &) = delete;
+		pop_awaiter &operator=(const pop_awaiter &) = delete;
+		/* suspended coroutine could be destroyed (cancelled), so awaiter
+		 * must not stay in the waiters queue */
+		~pop_awaiter()
+		{
+			if (!coroutine)
+			{
+				return;
+			}
+			ch->mutex.lock();
+			if (0 != waiter.prev)
+			{
+				zf_tailq_remove(&ch->waiters, &waiter);
+			}
+			ch->mutex.unlock();
+		}
+		bool await_ready() noexcept
+		{
+			return 0 != (e = ch->try_pop());
+		}
+		bool await_suspend(const std::coroutine_handle<> h) noexcept
+		{
+			ch->mutex.lock();
+			if (!zf_stailq_empty(&ch->entries) || ch->closed)
+			{
+				e = ch->take();
+				ch->mutex.unlock();
+				return false;
+			}
+			coroutine = h;
+			zf_tailq_insert_tail(&ch->waiters, &waiter);
+			/* awaiter could be resumed and destroyed right after unlock */
+			ch->mutex.unlock();
+			return true;
+		}
+		T *await_resume() const noexcept
+		{
+			return e;
+		}
+	private:
+		friend class zf_channel_;
+		zf_channel_ *ch;
+		/* prev is 0 when awaiter is not in the waiters queue */
+		zf_tailq_node waiter = {0, 0};
+		std::coroutine_handle<> coroutine;
+		T *e = 0;
+	};
+
+	zf_channel_() noexcept
+	{
+		zf_stailq_init(&entries);
+		zf_tailq_init(&waiters);
+	}
+	zf_channel_(const zf_channel_ &) = delete;
+	zf_channel_ &operator=(const zf_channel_ &) = delete;
+
+	void push(T *const e) noexcept
+	{
+		mutex.lock();
+		pop_awaiter *const w = take_waiter();
+		if (0 == w)
+		{
+			zf_stailq_insert_tail(&entries, &(e->*node));
+			mutex.unlock();
+			return;
+		}
+		mutex.unlock();
+		w->e = e;
+		w->coroutine.resume();
+	}
+	/* push prelinked entries, returns number of resumed consumers */
+	size_t push_all(zf_stailq_head_<T, node> *const h) noexcept
+	{
+		size_t resumed = 0;
+		while (!zf_stailq_empty(h))
+		{
+			T *const e = zf_entry_(zf_stailq_first(h), node);
+			zf_stailq_remove_head(h);
+			mutex.lock();
+			pop_awaiter *const w = take_waiter();
+			if (0 == w)
+			{
+				zf_stailq_insert_tail(&entries, &(e->*node));
+				zf_stailq_concat(&entries, h);
+				mutex.unlock();
+				break;
+			}
+			mutex.unlock();
+			w->e = e;
+			w->coroutine.resume();
+			++resumed;
+		}
+		return resumed;
+	}
+	pop_awaiter pop() noexcept
+	{
+		return pop_awaiter(this);
+	}
+	/* returns 0 when channel is empty */
+	T *try_pop() noexcept
+	{
+		mutex.lock();
+		T *const e = take();
+		mutex.unlock();
+		return e;
+	}
+	void close() noexcept
+	{
+		mutex.lock();
+		closed = true;
+		zf_tailq_head resume;
+		zf_tailq_init(&resume);
+		zf_tailq_concat(&resume, &waiters);
+		for (zf_tailq_node *n = zf_tailq_first(&resume); 0 != n; n = n->next)
+		{
+			n->prev = 0;
+		}
+		mutex.unlock();
+		for (zf_tailq_node *n = zf_tailq_first(&resume), *next; 0 != n;
+			 n = next)
+		{
+			next = n->next;
+			zf_entry_(n, &pop_awaiter::waiter)->coroutine.resume();
+		}
+	}
+	bool is_closed() noexcept
+	{
+		mutex.lock();
+		const bool c = closed;
+		mutex.unlock();
+		return c;
+	}
+private:
+	/* must be called with mutex locked */
+	T *take() noexcept
+	{
+		zf_stailq_node *const n = zf_stailq_first(&entries);
+		if (0 == n)
+		{
+			return 0;
+		}
+		zf_stailq_remove_head(&entries);
+		return zf_entry_(n, node);
+	}
+	pop_awaiter *take_waiter() noexcept
+	{
+		zf_tailq_node *const n = zf_tailq_first(&waiters);
+		if (0 == n)
+		{
+			return 0;
+		}
+		zf_tailq_remove(&waiters, n);
+		n->prev = 0;
+		return zf_entry_(n, &pop_awaiter::waiter);
+	}
+
+	Mutex mutex;
+	zf_stailq_head entries;
+	zf_tailq_head waiters;
+	bool closed = false;
+};
+
+#endif // __cplusplus
+
+#endif // _ZF_CHANNEL_H_
@@ -0,0 +1,333 @@
+#pragma once
+
+#ifndef _ZF_CODEL_H_
+#define _ZF_CODEL_H_
+
+/* CoDel (Controlled Delay, RFC 8289) active queue management on top of
+ * intrusive FIFO. Entries embed zf_codel_node, which is stailq node plus
+ * enqueue time. Queue bounds time entries spend in it (sojourn time) instead
+ * of its length: when sojourn time of dequeued entries stays above target for
+ * at least interval, zf_codel_dequeue() starts to drop entries at head, each
+ * next drop sooner than previous one (interval / sqrt(count)), until sojourn
+ * time goes below target again.
+ *
+ * Queue doesn't read clock. Caller passes current time to enqueue and dequeue,
+ * target and interval are in the same units (nanoseconds for RFC defaults
+ * ZF_CODEL_TARGET and ZF_CODEL_INTERVAL), interval must be below 2^48. Queue
+ * doesn't own entries either: dropped entries are moved to caller provided
+ * stailq, caller releases them.
+ * When mark is set, entries are never dropped, instead the entry that should
+ * be dropped is returned with marked flag set (like ECN CE mark), so caller
+ * could signal congestion to the producer.
+ *
+ * Sojourn time of each dequeued entry (delivered, dropped or marked) is
+ * counted in log2 histogram: bucket 0 is for 0, bucket i is for
+ * [2^(i-1), 2^i), last bucket also counts everything above.
+ */
+
+#include <string.h>
+#include "zf_queue.h"
+
+#define ZF_CODEL_TARGET 5000000u
+#define ZF_CODEL_INTERVAL 100000000u
+#define ZF_CODEL_HISTOGRAM_BUCKETS 48
+
+typedef struct zf_codel_node
+{
+	struct zf_stailq_node node;
+	uint64_t time;
+	bool marked;
+}
+zf_codel_node;
+
+typedef struct zf_codel
+{
+	struct zf_stailq_head queue;
+	size_t length;
+	/* parameters */
+	uint64_t target;
+	uint64_t interval;
+	bool mark;
+	/* control state */
+	bool dropping;
+	uint32_t count;
+	uint32_t lastcount;
+	uint64_t first_above_time;
+	uint64_t drop_next;
+	/* statistics */
+	uint64_t dequeued;
+	uint64_t dropped;
+	uint64_t marked;
+	uint64_t histogram[ZF_CODEL_HISTOGRAM_BUCKETS];
+}
+zf_codel;
+
+#define zf_codel_entry(n, entry_type, entry_member) \
+	zf_entry(zf_entry((n), zf_codel_node, node), entry_type, entry_member)
+
+_ZF_QUEUE_DECL
+void zf_codel_init(struct zf_codel *const c,
+				   const uint64_t target, const uint64_t interval)
+	_ZF_QUEUE_NOEXCEPT
+{
+	memset(c, 0, sizeof(*c));
+	zf_stailq_init(&c->queue);
+	c->target = target;
+	c->interval = interval;
+}
+
+_ZF_QUEUE_DECL
+bool zf_codel_empty(struct zf_codel *const c)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_stailq_empty(&c->queue);
+}
+
+_ZF_QUEUE_DECL
+size_t zf_codel_length(const struct zf_codel *const c)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return c->length;
+}
+
+_ZF_QUEUE_DECL
+void zf_codel_enqueue(struct zf_codel *const c, struct zf_codel_node *const n,
+					  const uint64_t now)
+	_ZF_QUEUE_NOEXCEPT
+{
+	n->time = now;
+	n->marked = false;
+	zf_stailq_insert_tail(&c->queue, &n->node);
+	++c->length;
+}
+
+/* histogram bucket for sojourn time t, that is number of significant bits */
+_ZF_QUEUE_DECL
+unsigned zf_codel_bucket(const uint64_t t)
+	_ZF_QUEUE_NOEXCEPT
+{
+	unsigned i;
+#if defined(__GNUC__)
+	i = 0 == t? 0: 64 - (unsigned)__builtin_clzll(t);
+#else
+	uint64_t v = t;
+	for (i = 0; 0 != v; v >>= 1)
+	{
+		++i;
+	}
+#endif
+	return ZF_CODEL_HISTOGRAM_BUCKETS > i? i: ZF_CODEL_HISTOGRAM_BUCKETS - 1;
+}
+
+/* largest sojourn time counted in bucket i (except for the last one) */
+_ZF_QUEUE_DECL
+uint64_t zf_codel_bucket_limit(const unsigned i)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return ((uint64_t)1 << i) - 1;
+}
+
+/* upper limit of sojourn time for percent of dequeued entries */
+_ZF_QUEUE_DECL
+uint64_t zf_codel_percentile(const struct zf_codel *const c,
+							 const unsigned percent)
+	_ZF_QUEUE_NOEXCEPT
+{
+	uint64_t total = 0;
+	for (unsigned i = 0; ZF_CODEL_HISTOGRAM_BUCKETS > i; ++i)
+	{
+		total += c->histogram[i];
+	}
+	uint64_t rank = (total * percent + 99) / 100;
+	if (0 == rank)
+	{
+		rank = 1;
+	}
+	uint64_t seen = 0;
+	for (unsigned i = 0; ZF_CODEL_HISTOGRAM_BUCKETS > i; ++i)
+	{
+		if (rank <= (seen += c->histogram[i]))
+		{
+			return zf_codel_bucket_limit(i);
+		}
+	}
+	return 0;
+}
+
+/* zero statistics, control state is kept */
+_ZF_QUEUE_DECL
+void zf_codel_reset_stats(struct zf_codel *const c)
+	_ZF_QUEUE_NOEXCEPT
+{
+	c->dequeued = 0;
+	c->dropped = 0;
+	c->marked = 0;
+	memset(c->histogram, 0, sizeof(c->histogram));
+}
+
+_ZF_QUEUE_DECL
+uint64_t _zf_codel_isqrt(uint64_t x)
+	_ZF_QUEUE_NOEXCEPT
+{
+	uint64_t r = 0;
+	uint64_t b = (uint64_t)1 << 62;
+	while (b > x)
+	{
+		b >>= 2;
+	}
+	for (; 0 != b; b >>= 2)
+	{
+		if (x >= r + b)
+		{
+			x -= r + b;
+			r = (r >> 1) + b;
+		}
+		else
+		{
+			r >>= 1;
+		}
+	}
+	return r;
+}
+
+/* t + interval / sqrt(count), in 16.16 fixed point */
+_ZF_QUEUE_DECL
+uint64_t _zf_codel_control_law(const struct zf_codel *const c,
+							   const uint64_t t)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return t + (c->interval << 16) /
+			_zf_codel_isqrt((uint64_t)c->count << 32);
+}
+
+/* removes head and tells whether sojourn time is above target long enough */
+_ZF_QUEUE_DECL
+struct zf_codel_node *_zf_codel_pop(struct zf_codel *const c,
+									const uint64_t now, bool *const ok_to_drop)
+	_ZF_QUEUE_NOEXCEPT
+{
+	*ok_to_drop = false;
+	struct zf_stailq_node *const n = zf_stailq_first(&c->queue);
+	if (0 == n)
+	{
+		c->first_above_time = 0;
+		return 0;
+	}
+	zf_stailq_remove_head(&c->queue);
+	--c->length;
+	struct zf_codel_node *const e = zf_entry(n, zf_codel_node, node);
+	const uint64_t sojourn = now > e->time? now - e->time: 0;
+	++c->histogram[zf_codel_bucket(sojourn)];
+	++c->dequeued;
+	/* don't drop the last entry, there is no queue behind it */
+	if (c->target > sojourn || 0 == c->length)
+	{
+		c->first_above_time = 0;
+	}
+	else if (0 == c->first_above_time)
+	{
+		c->first_above_time = now + c->interval;
+	}
+	else if (now >= c->first_above_time)
+	{
+		*ok_to_drop = true;
+	}
+	return e;
+}
+
+_ZF_QUEUE_DECL
+void _zf_codel_drop(struct zf_codel *const c, struct zf_codel_node *const e,
+					struct zf_stailq_head *const drops)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_stailq_insert_tail(drops, &e->node);
+	++c->dropped;
+}
+
+/* Returns next entry to deliver or 0 when queue is empty. Entries dropped on
+ * the way are appended to drops (not used when mark is set).
+ */
+_ZF_QUEUE_DECL
+struct zf_codel_node *zf_codel_dequeue(struct zf_codel *const c,
+									   const uint64_t now,
+									   struct zf_stailq_head *const drops)
+	_ZF_QUEUE_NOEXCEPT
+{
+	bool ok_to_drop;
+	struct zf_codel_node *e = _zf_codel_pop(c, now, &ok_to_drop);
+	if (c->dropping)
+	{
+		if (!ok_to_drop)
+		{
+			c->dropping = false;
+		}
+		while (c->dropping && now >= c->drop_next)
+		{
+			++c->count;
+			if (c->mark)
+			{
+				e->marked = true;
+				++c->marked;
+				c->drop_next = _zf_codel_control_law(c, c->drop_next);
+				break;
+			}
+			_zf_codel_drop(c, e, drops);
+			e = _zf_codel_pop(c, now, &ok_to_drop);
+			if (!ok_to_drop)
+			{
+				c->dropping = false;
+			}
+			else
+			{
+				c->drop_next = _zf_codel_control_law(c, c->drop_next);
+			}
+		}
+	}
+	else if (ok_to_drop)
+	{
+		if (c->mark)
+		{
+			e->marked = true;
+			++c->marked;
+		}
+		else
+		{
+			_zf_codel_drop(c, e, drops);
+			e = _zf_codel_pop(c, now, &ok_to_drop);
+		}
+		c->dropping = true;
+		/* resume with drop rate close to the last one if it was recent */
+		const uint32_t delta = c->count - c->lastcount;
+		c->count = 1;
+		if (1 < delta && now < c->drop_next + 16 * c->interval)
+		{
+			c->count = delta;
+		}
+		c->drop_next = _zf_codel_control_law(c, now);
+		c->lastcount = c->count;
+	}
+	return e;
+}
+
+/* C++ support */
+#ifdef __cplusplus
+
+template <typename T, zf_codel_node T:: *node>
+void zf_codel_enqueue_(zf_codel *const c, T *const e, const uint64_t now)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_codel_enqueue(c, &(e->*node), now);
+}
+
+template <typename T, zf_codel_node T:: *node>
+T *zf_codel_dequeue_(zf_codel *const c, const uint64_t now,
+					 zf_stailq_head *const drops)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_codel_node *const n = zf_codel_dequeue(c, now, drops);
+	return 0 == n? 0: zf_entry_(n, node);
+}
+
+#endif // __cplusplus
+
+#endif // _ZF_CODEL_H_
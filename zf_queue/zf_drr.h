@@ -0,0 +1,205 @@
+#pragma once
+
+#ifndef _ZF_DRR_H_
+#define _ZF_DRR_H_
+
+/* Deficit round-robin (DRR) scheduler that fairly multiplexes many flows of
+ * entries without sorting them. Each flow (zf_drr_flow, usually embedded into
+ * caller's flow object) has tail queue of pending entries and node that links
+ * it into scheduler's ring of active flows. Entries embed zf_drr_node, which
+ * is tailq node plus entry cost (e.g. size in bytes, or 1 to count entries).
+ *
+ * Flow joins the ring when its first entry is enqueued and leaves it when its
+ * last entry is dequeued, so idle flows cost nothing. On each visit flow gets
+ * its quantum of credit (deficit) and dequeues entries while their cost fits
+ * into it, then goes to the tail of the ring. Quantum of the flow is base
+ * quantum of the scheduler multiplied by flow weight, so flows get share of
+ * service proportional to their weights (weighted DRR).
+ *
+ * Enqueue is O(1), dequeue is O(1) when base quantum is not less than cost of
+ * the largest entry (otherwise flow might need several visits to accumulate
+ * enough credit for one entry).
+ *
+ * Quantum never becomes 0 (flow with no credit would be visited forever): base
+ * quantum 0 and weight 0 are treated as 1, quantum that doesn't fit into
+ * uint32_t is clamped to UINT32_MAX, deficit saturates at UINT32_MAX.
+ */
+
+#include "zf_queue.h"
+
+typedef struct zf_drr_node
+{
+	struct zf_tailq_node node;
+	uint32_t cost;
+}
+zf_drr_node;
+
+typedef struct zf_drr_flow
+{
+	/* pending entries */
+	struct zf_tailq_head queue;
+	/* link in the ring of active flows */
+	struct zf_tailq_node node;
+	uint32_t quantum;
+	uint32_t deficit;
+}
+zf_drr_flow;
+
+typedef struct zf_drr
+{
+	/* ring of active flows, the first one is served next */
+	struct zf_tailq_head active;
+	size_t flows;
+	uint32_t quantum;
+}
+zf_drr;
+
+#define zf_drr_entry(n, entry_type, entry_member) \
+	zf_entry(zf_entry((n), zf_drr_node, node), entry_type, entry_member)
+
+/* base quantum 0 is treated as 1 */
+_ZF_QUEUE_DECL
+void zf_drr_init(struct zf_drr *const d, const uint32_t quantum)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_tailq_init(&d->active);
+	d->flows = 0;
+	d->quantum = 0 == quantum? 1: quantum;
+}
+
+/* base quantum * weight, weight 0 is treated as 1, clamped to UINT32_MAX */
+_ZF_QUEUE_DECL
+uint32_t _zf_drr_quantum(const struct zf_drr *const d, const uint32_t weight)
+	_ZF_QUEUE_NOEXCEPT
+{
+	const uint64_t q = (uint64_t)d->quantum * (0 == weight? 1: weight);
+	return 0xffffffffu < q? 0xffffffffu: (uint32_t)q;
+}
+
+/* number of active flows */
+_ZF_QUEUE_DECL
+size_t zf_drr_flows(const struct zf_drr *const d)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return d->flows;
+}
+
+_ZF_QUEUE_DECL
+bool zf_drr_empty(struct zf_drr *const d)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_tailq_empty(&d->active);
+}
+
+_ZF_QUEUE_DECL
+void zf_drr_flow_init(const struct zf_drr *const d, struct zf_drr_flow *const f,
+					  const uint32_t weight)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_tailq_init(&f->queue);
+	f->quantum = _zf_drr_quantum(d, weight);
+	f->deficit = 0;
+}
+
+/* new weight takes effect on the next visit of the flow */
+_ZF_QUEUE_DECL
+void zf_drr_flow_set_weight(const struct zf_drr *const d,
+							struct zf_drr_flow *const f, const uint32_t weight)
+	_ZF_QUEUE_NOEXCEPT
+{
+	f->quantum = _zf_drr_quantum(d, weight);
+}
+
+/* flow is active (in the ring) when it has pending entries */
+_ZF_QUEUE_DECL
+bool zf_drr_flow_active(struct zf_drr_flow *const f)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return !zf_tailq_empty(&f->queue);
+}
+
+_ZF_QUEUE_DECL
+void zf_drr_enqueue(struct zf_drr *const d, struct zf_drr_flow *const f,
+					struct zf_drr_node *const n, const uint32_t cost)
+	_ZF_QUEUE_NOEXCEPT
+{
+	n->cost = cost;
+	if (zf_tailq_empty(&f->queue))
+	{
+		f->deficit = f->quantum;
+		zf_tailq_insert_tail(&d->active, &f->node);
+		++d->flows;
+	}
+	zf_tailq_insert_tail(&f->queue, &n->node);
+}
+
+/* Removes active flow from the ring, its pending entries stay in f->queue and
+ * must be removed by the caller before flow is used again.
+ */
+_ZF_QUEUE_DECL
+void zf_drr_flow_remove(struct zf_drr *const d, struct zf_drr_flow *const f)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_tailq_remove(&d->active, &f->node);
+	--d->flows;
+}
+
+/* Returns next entry or 0 when all flows are idle. Flow of the entry is
+ * stored in flow (when it is not 0).
+ */
+_ZF_QUEUE_DECL
+struct zf_drr_node *zf_drr_dequeue(struct zf_drr *const d,
+								   struct zf_drr_flow **const flow)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_tailq_node *fn;
+	while (0 != (fn = zf_tailq_first(&d->active)))
+	{
+		struct zf_drr_flow *const f = zf_entry(fn, zf_drr_flow, node);
+		struct zf_drr_node *const n =
+				zf_entry(zf_tailq_first(&f->queue), zf_drr_node, node);
+		if (n->cost <= f->deficit)
+		{
+			f->deficit -= n->cost;
+			zf_tailq_remove(&f->queue, &n->node);
+			if (zf_tailq_empty(&f->queue))
+			{
+				zf_drr_flow_remove(d, f);
+			}
+			if (0 != flow)
+			{
+				*flow = f;
+			}
+			return n;
+		}
+		/* out of credit, next visit gets another quantum */
+		f->deficit = 0xffffffffu - f->deficit < f->quantum?
+				0xffffffffu: f->deficit + f->quantum;
+		zf_tailq_remove(&d->active, fn);
+		zf_tailq_insert_tail(&d->active, fn);
+	}
+	return 0;
+}
+
+/* C++ support */
+#ifdef __cplusplus
+
+template <typename T, zf_drr_node T:: *node>
+void zf_drr_enqueue_(zf_drr *const d, zf_drr_flow *const f, T *const e,
+					 const uint32_t cost)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_drr_enqueue(d, f, &(e->*node), cost);
+}
+
+template <typename T, zf_drr_node T:: *node>
+T *zf_drr_dequeue_(zf_drr *const d, zf_drr_flow **const flow = 0)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_drr_node *const n = zf_drr_dequeue(d, flow);
+	return 0 == n? 0: zf_entry_(n, node);
+}
+
+#endif // __cplusplus
+
+#endif // _ZF_DRR_H_
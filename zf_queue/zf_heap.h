@@ -0,0 +1,382 @@
+#pragma once
+
+#ifndef _ZF_HEAP_H_
+#define _ZF_HEAP_H_
+
+/* Intrusive d-ary min-heap (priority queue) over caller provided array of node
+ * pointers. Entries embed zf_heap_node, which holds current position of the
+ * entry in the array, so entry could be removed (cancel) or moved after its
+ * key changed (reschedule) in O(log n) without searching for it.
+ *
+ * Arity is compile-time constant: ZF_HEAP_ARITY (4 when not defined before
+ * include) for C functions and template parameter for C++ heads. 4-ary heap
+ * is usually faster than binary one: it is two times shallower and children
+ * of a node are in the same cache line.
+ *
+ * C functions order entries with cmp(a, b, ctx), which is negative when a
+ * goes before b (like zf_xxx_merge()). C++ heads use less(a, b) on entries
+ * instead, which is inlined.
+ *
+ * Heap doesn't allocate memory. Insert returns false when array is full, the
+ * caller could then provide larger array with zf_heap_reserve().
+ */
+
+#include <string.h>
+#include "zf_queue.h"
+
+#ifndef ZF_HEAP_ARITY
+	#define ZF_HEAP_ARITY 4
+#endif
+
+/* index of node that is not in a heap */
+#define ZF_HEAP_UNLINKED ((size_t)-1)
+
+typedef struct zf_heap_node
+{
+	size_t index;
+}
+zf_heap_node;
+
+typedef struct zf_heap
+{
+	struct zf_heap_node **nodes;
+	size_t count;
+	size_t capacity;
+	int (*cmp)(struct zf_heap_node *, struct zf_heap_node *, void *);
+	void *ctx;
+}
+zf_heap;
+
+_ZF_QUEUE_DECL
+void zf_heap_init(struct zf_heap *const h,
+				  struct zf_heap_node **const nodes, const size_t capacity,
+				  int (*const cmp)(struct zf_heap_node *,
+								   struct zf_heap_node *, void *),
+				  void *const ctx)
+	_ZF_QUEUE_NOEXCEPT
+{
+	h->nodes = nodes;
+	h->count = 0;
+	h->capacity = capacity;
+	h->cmp = cmp;
+	h->ctx = ctx;
+}
+
+/* move nodes to another array with at least count pointers */
+_ZF_QUEUE_DECL
+void zf_heap_reserve(struct zf_heap *const h,
+					 struct zf_heap_node **const nodes, const size_t capacity)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (nodes != h->nodes)
+	{
+		memcpy(nodes, h->nodes, h->count * sizeof(*nodes));
+		h->nodes = nodes;
+	}
+	h->capacity = capacity;
+}
+
+_ZF_QUEUE_DECL
+void zf_heap_node_init(struct zf_heap_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	n->index = ZF_HEAP_UNLINKED;
+}
+
+/* true when node is in a heap (node must be initialized or popped before) */
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+bool zf_heap_linked(const struct zf_heap_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return ZF_HEAP_UNLINKED != n->index;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+bool zf_heap_empty(const struct zf_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return 0 == h->count;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+size_t zf_heap_count(const struct zf_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return h->count;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+struct zf_heap_node *zf_heap_top(const struct zf_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return 0 == h->count? 0: h->nodes[0];
+}
+
+_ZF_QUEUE_DECL
+void _zf_heap_set(struct zf_heap *const h, const size_t i,
+				  struct zf_heap_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	h->nodes[i] = n;
+	n->index = i;
+}
+
+/* put n into hole at i, moving parents that go after it down */
+_ZF_QUEUE_DECL
+void _zf_heap_sift_up(struct zf_heap *const h, size_t i,
+					  struct zf_heap_node *const n)
+{
+	while (0 < i)
+	{
+		const size_t p = (i - 1) / ZF_HEAP_ARITY;
+		if (0 <= h->cmp(n, h->nodes[p], h->ctx))
+		{
+			break;
+		}
+		_zf_heap_set(h, i, h->nodes[p]);
+		i = p;
+	}
+	_zf_heap_set(h, i, n);
+}
+
+/* put n into hole at i, moving the first of children that go before it up */
+_ZF_QUEUE_DECL
+void _zf_heap_sift_down(struct zf_heap *const h, size_t i,
+						struct zf_heap_node *const n)
+{
+	for (;;)
+	{
+		const size_t c = i * ZF_HEAP_ARITY + 1;
+		if (c >= h->count)
+		{
+			break;
+		}
+		const size_t end =
+				h->count - c > ZF_HEAP_ARITY? c + ZF_HEAP_ARITY: h->count;
+		size_t m = c;
+		for (size_t k = c + 1; end > k; ++k)
+		{
+			if (0 > h->cmp(h->nodes[k], h->nodes[m], h->ctx))
+			{
+				m = k;
+			}
+		}
+		if (0 <= h->cmp(h->nodes[m], n, h->ctx))
+		{
+			break;
+		}
+		_zf_heap_set(h, i, h->nodes[m]);
+		i = m;
+	}
+	_zf_heap_set(h, i, n);
+}
+
+/* put n into hole at i, where it could need to go either way */
+_ZF_QUEUE_DECL
+void _zf_heap_fix(struct zf_heap *const h, const size_t i,
+				  struct zf_heap_node *const n)
+{
+	if (0 < i && 0 > h->cmp(n, h->nodes[(i - 1) / ZF_HEAP_ARITY], h->ctx))
+	{
+		_zf_heap_sift_up(h, i, n);
+	}
+	else
+	{
+		_zf_heap_sift_down(h, i, n);
+	}
+}
+
+/* returns false when heap is full */
+_ZF_QUEUE_DECL
+bool zf_heap_insert(struct zf_heap *const h, struct zf_heap_node *const n)
+{
+	if (h->capacity == h->count)
+	{
+		return false;
+	}
+	_zf_heap_sift_up(h, h->count++, n);
+	return true;
+}
+
+_ZF_QUEUE_DECL
+void zf_heap_remove(struct zf_heap *const h, struct zf_heap_node *const n)
+{
+	struct zf_heap_node *const last = h->nodes[--h->count];
+	if (last != n)
+	{
+		_zf_heap_fix(h, n->index, last);
+	}
+	n->index = ZF_HEAP_UNLINKED;
+}
+
+/* removes and returns the first node or returns 0 when heap is empty */
+_ZF_QUEUE_DECL
+struct zf_heap_node *zf_heap_pop(struct zf_heap *const h)
+{
+	if (0 == h->count)
+	{
+		return 0;
+	}
+	struct zf_heap_node *const n = h->nodes[0];
+	struct zf_heap_node *const last = h->nodes[--h->count];
+	if (last != n)
+	{
+		_zf_heap_sift_down(h, 0, last);
+	}
+	n->index = ZF_HEAP_UNLINKED;
+	return n;
+}
+
+/* restores order after key of n changed */
+_ZF_QUEUE_DECL
+void zf_heap_update(struct zf_heap *const h, struct zf_heap_node *const n)
+{
+	_zf_heap_fix(h, n->index, n);
+}
+
+/* C++ support */
+#if defined(__cplusplus)
+
+/* Heap of entries T ordered by less(a, b), which returns true when entry a
+ * goes before entry b. Has the same layout as zf_heap (plus less), but cmp is
+ * 0 and arity may differ from ZF_HEAP_ARITY, so only zf_heap_empty(),
+ * zf_heap_count(), zf_heap_top() and zf_heap_reserve() could be called on it
+ * from C. Everything else must go through the C++ functions below.
+ */
+template <typename T, zf_heap_node T:: *node, typename L,
+		  unsigned arity = ZF_HEAP_ARITY>
+struct zf_heap_: zf_heap
+{
+	L less;
+
+	zf_heap_(zf_heap_node **const nodes, const size_t capacity,
+			 const L &l = L()) _ZF_QUEUE_NOEXCEPT: less(l)
+	{
+		zf_heap_init(this, nodes, capacity, 0, 0);
+	}
+};
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+bool _zf_heap_before_(zf_heap_<T, node, L, arity> *const h,
+					  zf_heap_node *const a, zf_heap_node *const b)
+{
+	return h->less(zf_entry_(a, node), zf_entry_(b, node));
+}
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+void _zf_heap_sift_up_(zf_heap_<T, node, L, arity> *const h, size_t i,
+					   zf_heap_node *const n)
+{
+	while (0 < i)
+	{
+		const size_t p = (i - 1) / arity;
+		if (!_zf_heap_before_(h, n, h->nodes[p]))
+		{
+			break;
+		}
+		_zf_heap_set(h, i, h->nodes[p]);
+		i = p;
+	}
+	_zf_heap_set(h, i, n);
+}
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+void _zf_heap_sift_down_(zf_heap_<T, node, L, arity> *const h, size_t i,
+						 zf_heap_node *const n)
+{
+	for (;;)
+	{
+		const size_t c = i * arity + 1;
+		if (c >= h->count)
+		{
+			break;
+		}
+		const size_t end = h->count - c > arity? c + arity: h->count;
+		size_t m = c;
+		for (size_t k = c + 1; end > k; ++k)
+		{
+			if (_zf_heap_before_(h, h->nodes[k], h->nodes[m]))
+			{
+				m = k;
+			}
+		}
+		if (!_zf_heap_before_(h, h->nodes[m], n))
+		{
+			break;
+		}
+		_zf_heap_set(h, i, h->nodes[m]);
+		i = m;
+	}
+	_zf_heap_set(h, i, n);
+}
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+void _zf_heap_fix_(zf_heap_<T, node, L, arity> *const h, const size_t i,
+				   zf_heap_node *const n)
+{
+	if (0 < i && _zf_heap_before_(h, n, h->nodes[(i - 1) / arity]))
+	{
+		_zf_heap_sift_up_(h, i, n);
+	}
+	else
+	{
+		_zf_heap_sift_down_(h, i, n);
+	}
+}
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+T *zf_heap_top_(const zf_heap_<T, node, L, arity> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return 0 == h->count? 0: zf_entry_(h->nodes[0], node);
+}
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+bool zf_heap_insert_(zf_heap_<T, node, L, arity> *const h, T *const e)
+{
+	if (h->capacity == h->count)
+	{
+		return false;
+	}
+	_zf_heap_sift_up_(h, h->count++, &(e->*node));
+	return true;
+}
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+void zf_heap_remove_(zf_heap_<T, node, L, arity> *const h, T *const e)
+{
+	zf_heap_node *const n = &(e->*node);
+	zf_heap_node *const last = h->nodes[--h->count];
+	if (last != n)
+	{
+		_zf_heap_fix_(h, n->index, last);
+	}
+	n->index = ZF_HEAP_UNLINKED;
+}
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+T *zf_heap_pop_(zf_heap_<T, node, L, arity> *const h)
+{
+	if (0 == h->count)
+	{
+		return 0;
+	}
+	zf_heap_node *const n = h->nodes[0];
+	zf_heap_node *const last = h->nodes[--h->count];
+	if (last != n)
+	{
+		_zf_heap_sift_down_(h, 0, last);
+	}
+	n->index = ZF_HEAP_UNLINKED;
+	return zf_entry_(n, node);
+}
+
+template <typename T, zf_heap_node T:: *node, typename L, unsigned arity>
+void zf_heap_update_(zf_heap_<T, node, L, arity> *const h, T *const e)
+{
+	_zf_heap_fix_(h, (e->*node).index, &(e->*node));
+}
+
+#endif // __cplusplus
+
+#endif // _ZF_HEAP_H_
@@ -0,0 +1,531 @@
+#pragma once
+
+#ifndef _ZF_INTERVAL_TREE_H_
+#define _ZF_INTERVAL_TREE_H_
+
+/* Intrusive interval tree: red-black tree of closed intervals [start, last]
+ * ordered by start, where each node also keeps the maximum last of its
+ * subtree. Entries embed zf_interval_node, so insert and remove by node are
+ * O(log n) and don't allocate.
+ *
+ * Overlap queries skip subtrees whose maximum last is before the query and
+ * stop at the first node whose start is after it, so finding each of k
+ * overlapping intervals is O(log n) and the whole query is O(k log n) at
+ * most, without visiting unrelated intervals:
+ *
+ *   zf_interval_tree_foreach_overlap(&t, start, last, n)
+ *   {
+ *       mapping *m = zf_entry(n, mapping, node);
+ *   }
+ *
+ * Stabbing query (intervals that contain point p) is overlap with [p, p].
+ * Overlapping intervals are visited in order of their start. Tree must not be
+ * modified during the query.
+ */
+
+#include "zf_queue.h"
+
+typedef struct zf_interval_node
+{
+	struct zf_interval_node *left;
+	struct zf_interval_node *right;
+	struct zf_interval_node *parent;
+	uint64_t start;
+	uint64_t last;
+	/* maximum last in the subtree of this node */
+	uint64_t max;
+	bool red;
+}
+zf_interval_node;
+
+typedef struct zf_interval_tree
+{
+	struct zf_interval_node *root;
+	size_t count;
+}
+zf_interval_tree;
+
+#define ZF_INTERVAL_TREE_INITIALIZER() {0, 0}
+
+_ZF_QUEUE_DECL
+void zf_interval_tree_init(struct zf_interval_tree *const t)
+	_ZF_QUEUE_NOEXCEPT
+{
+	t->root = 0;
+	t->count = 0;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+bool zf_interval_tree_empty(const struct zf_interval_tree *const t)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return 0 == t->root;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+size_t zf_interval_tree_count(const struct zf_interval_tree *const t)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return t->count;
+}
+
+_ZF_QUEUE_DECL
+void _zf_interval_update(struct zf_interval_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	uint64_t max = n->last;
+	if (0 != n->left && max < n->left->max)
+	{
+		max = n->left->max;
+	}
+	if (0 != n->right && max < n->right->max)
+	{
+		max = n->right->max;
+	}
+	n->max = max;
+}
+
+/* put n in place of child c of parent p (or of the root when p is 0) */
+_ZF_QUEUE_DECL
+void _zf_interval_replace(struct zf_interval_tree *const t,
+						  struct zf_interval_node *const p,
+						  struct zf_interval_node *const c,
+						  struct zf_interval_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 == p)
+	{
+		t->root = n;
+	}
+	else if (c == p->left)
+	{
+		p->left = n;
+	}
+	else
+	{
+		p->right = n;
+	}
+}
+
+_ZF_QUEUE_DECL
+void _zf_interval_rotate_left(struct zf_interval_tree *const t,
+							  struct zf_interval_node *const x)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_interval_node *const y = x->right;
+	if (0 != (x->right = y->left))
+	{
+		y->left->parent = x;
+	}
+	y->parent = x->parent;
+	_zf_interval_replace(t, x->parent, x, y);
+	y->left = x;
+	x->parent = y;
+	_zf_interval_update(x);
+	_zf_interval_update(y);
+}
+
+_ZF_QUEUE_DECL
+void _zf_interval_rotate_right(struct zf_interval_tree *const t,
+							   struct zf_interval_node *const x)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_interval_node *const y = x->left;
+	if (0 != (x->left = y->right))
+	{
+		y->right->parent = x;
+	}
+	y->parent = x->parent;
+	_zf_interval_replace(t, x->parent, x, y);
+	y->right = x;
+	x->parent = y;
+	_zf_interval_update(x);
+	_zf_interval_update(y);
+}
+
+_ZF_QUEUE_DECL
+void _zf_interval_insert_fixup(struct zf_interval_tree *const t,
+							   struct zf_interval_node *n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_interval_node *p;
+	while (0 != (p = n->parent) && p->red)
+	{
+		struct zf_interval_node *const g = p->parent;
+		if (p == g->left)
+		{
+			struct zf_interval_node *const u = g->right;
+			if (0 != u && u->red)
+			{
+				p->red = false;
+				u->red = false;
+				g->red = true;
+				n = g;
+				continue;
+			}
+			if (n == p->right)
+			{
+				_zf_interval_rotate_left(t, p);
+				n = p;
+				p = n->parent;
+			}
+			p->red = false;
+			g->red = true;
+			_zf_interval_rotate_right(t, g);
+		}
+		else
+		{
+			struct zf_interval_node *const u = g->left;
+			if (0 != u && u->red)
+			{
+				p->red = false;
+				u->red = false;
+				g->red = true;
+				n = g;
+				continue;
+			}
+			if (n == p->left)
+			{
+				_zf_interval_rotate_right(t, p);
+				n = p;
+				p = n->parent;
+			}
+			p->red = false;
+			g->red = true;
+			_zf_interval_rotate_left(t, g);
+		}
+	}
+	t->root->red = false;
+}
+
+/* adds interval [start, last] (start <= last) */
+_ZF_QUEUE_DECL
+void zf_interval_tree_insert(struct zf_interval_tree *const t,
+							 struct zf_interval_node *const n,
+							 const uint64_t start, const uint64_t last)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_interval_node *p = 0;
+	struct zf_interval_node **link = &t->root;
+	while (0 != *link)
+	{
+		p = *link;
+		if (p->max < last)
+		{
+			p->max = last;
+		}
+		link = start < p->start? &p->left: &p->right;
+	}
+	n->left = 0;
+	n->right = 0;
+	n->parent = p;
+	n->start = start;
+	n->last = last;
+	n->max = last;
+	n->red = true;
+	*link = n;
+	++t->count;
+	_zf_interval_insert_fixup(t, n);
+}
+
+/* x (could be 0) has one black node less on its path, p is its parent */
+_ZF_QUEUE_DECL
+void _zf_interval_remove_fixup(struct zf_interval_tree *const t,
+							   struct zf_interval_node *x,
+							   struct zf_interval_node *p)
+	_ZF_QUEUE_NOEXCEPT
+{
+	while (t->root != x && (0 == x || !x->red))
+	{
+		if (x == p->left)
+		{
+			struct zf_interval_node *w = p->right;
+			if (w->red)
+			{
+				w->red = false;
+				p->red = true;
+				_zf_interval_rotate_left(t, p);
+				w = p->right;
+			}
+			if ((0 == w->left || !w->left->red) &&
+				(0 == w->right || !w->right->red))
+			{
+				w->red = true;
+				x = p;
+				p = x->parent;
+				continue;
+			}
+			if (0 == w->right || !w->right->red)
+			{
+				w->left->red = false;
+				w->red = true;
+				_zf_interval_rotate_right(t, w);
+				w = p->right;
+			}
+			w->red = p->red;
+			p->red = false;
+			w->right->red = false;
+			_zf_interval_rotate_left(t, p);
+		}
+		else
+		{
+			struct zf_interval_node *w = p->left;
+			if (w->red)
+			{
+				w->red = false;
+				p->red = true;
+				_zf_interval_rotate_right(t, p);
+				w = p->left;
+			}
+			if ((0 == w->left || !w->left->red) &&
+				(0 == w->right || !w->right->red))
+			{
+				w->red = true;
+				x = p;
+				p = x->parent;
+				continue;
+			}
+			if (0 == w->left || !w->left->red)
+			{
+				w->right->red = false;
+				w->red = true;
+				_zf_interval_rotate_left(t, w);
+				w = p->left;
+			}
+			w->red = p->red;
+			p->red = false;
+			w->left->red = false;
+			_zf_interval_rotate_right(t, p);
+		}
+		x = t->root;
+	}
+	if (0 != x)
+	{
+		x->red = false;
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_interval_tree_remove(struct zf_interval_tree *const t,
+							 struct zf_interval_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_interval_node *child, *parent;
+	bool red;
+	if (0 == n->left || 0 == n->right)
+	{
+		child = 0 != n->left? n->left: n->right;
+		parent = n->parent;
+		red = n->red;
+		if (0 != child)
+		{
+			child->parent = parent;
+		}
+		_zf_interval_replace(t, parent, n, child);
+	}
+	else
+	{
+		/* successor takes place of n */
+		struct zf_interval_node *s = n->right;
+		while (0 != s->left)
+		{
+			s = s->left;
+		}
+		red = s->red;
+		child = s->right;
+		if (n == s->parent)
+		{
+			parent = s;
+		}
+		else
+		{
+			parent = s->parent;
+			if (0 != child)
+			{
+				child->parent = parent;
+			}
+			parent->left = child;
+			s->right = n->right;
+			n->right->parent = s;
+		}
+		s->left = n->left;
+		n->left->parent = s;
+		s->parent = n->parent;
+		s->red = n->red;
+		_zf_interval_replace(t, n->parent, n, s);
+	}
+	for (struct zf_interval_node *p = parent; 0 != p; p = p->parent)
+	{
+		_zf_interval_update(p);
+	}
+	--t->count;
+	if (!red)
+	{
+		_zf_interval_remove_fixup(t, child, parent);
+	}
+}
+
+/* the first (by start) node in subtree of n that overlaps [start, last] */
+_ZF_QUEUE_DECL
+struct zf_interval_node *_zf_interval_search(struct zf_interval_node *n,
+											 const uint64_t start,
+											 const uint64_t last)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (;;)
+	{
+		if (0 != n->left && start <= n->left->max)
+		{
+			/* if nothing in left subtree overlaps, nothing to the right will */
+			n = n->left;
+			continue;
+		}
+		if (n->start > last)
+		{
+			return 0;
+		}
+		if (start <= n->last)
+		{
+			return n;
+		}
+		if (0 == n->right || start > n->right->max)
+		{
+			return 0;
+		}
+		n = n->right;
+	}
+}
+
+/* the first (by start) node that overlaps [start, last] or 0 */
+_ZF_QUEUE_DECL
+struct zf_interval_node *zf_interval_tree_first(struct zf_interval_tree *const t,
+												const uint64_t start,
+												const uint64_t last)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 == t->root || start > t->root->max)
+	{
+		return 0;
+	}
+	return _zf_interval_search(t->root, start, last);
+}
+
+/* the next node after n that overlaps [start, last] or 0 */
+_ZF_QUEUE_DECL
+struct zf_interval_node *zf_interval_tree_next(struct zf_interval_node *n,
+											   const uint64_t start,
+											   const uint64_t last)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_interval_node *r = n->right;
+	for (;;)
+	{
+		/* n->start <= last, look into its right subtree first */
+		if (0 != r && start <= r->max)
+		{
+			return _zf_interval_search(r, start, last);
+		}
+		/* go up until coming from the left child */
+		struct zf_interval_node *prev;
+		do
+		{
+			prev = n;
+			if (0 == (n = n->parent))
+			{
+				return 0;
+			}
+			r = n->right;
+		}
+		while (prev == r);
+		if (n->start > last)
+		{
+			return 0;
+		}
+		if (start <= n->last)
+		{
+			return n;
+		}
+	}
+}
+
+/* stabbing query: the first node that contains point p or 0 */
+_ZF_QUEUE_DECL
+struct zf_interval_node *zf_interval_tree_stab(struct zf_interval_tree *const t,
+											   const uint64_t p)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_interval_tree_first(t, p, p);
+}
+
+#define zf_interval_tree_foreach_overlap(t, start, last, n) \
+	for (struct zf_interval_node *n = zf_interval_tree_first((t), (start), (last)); \
+		 0 != n; n = zf_interval_tree_next(n, (start), (last)))
+
+/* C++ support */
+#ifdef __cplusplus
+
+template <typename T, zf_interval_node T:: *node>
+struct zf_interval_tree_: zf_interval_tree
+{
+	zf_interval_tree_() _ZF_QUEUE_NOEXCEPT { zf_interval_tree_init(this); }
+};
+
+template <typename T, zf_interval_node T:: *node>
+void zf_interval_tree_insert_(zf_interval_tree_<T, node> *const t, T *const e,
+							  const uint64_t start, const uint64_t last)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_interval_tree_insert(t, &(e->*node), start, last);
+}
+
+template <typename T, zf_interval_node T:: *node>
+void zf_interval_tree_remove_(zf_interval_tree_<T, node> *const t, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_interval_tree_remove(t, &(e->*node));
+}
+
+template <typename T, zf_interval_node T:: *node>
+T *zf_interval_tree_first_(zf_interval_tree_<T, node> *const t,
+						   const uint64_t start, const uint64_t last)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_interval_node *const n = zf_interval_tree_first(t, start, last);
+	return 0 == n? 0: zf_entry_(n, node);
+}
+
+template <typename T, zf_interval_node T:: *node>
+T *zf_interval_tree_next_(const zf_interval_tree_<T, node> *const, T *const e,
+						  const uint64_t start, const uint64_t last)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_interval_node *const n = zf_interval_tree_next(&(e->*node), start, last);
+	return 0 == n? 0: zf_entry_(n, node);
+}
+
+template <typename T, zf_interval_node T:: *node>
+T *zf_interval_tree_stab_(zf_interval_tree_<T, node> *const t, const uint64_t p)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_interval_tree_first_(t, p, p);
+}
+
+/* calls f(e) for each entry that overlaps [start, last], returns their number */
+template <typename T, zf_interval_node T:: *node, typename F>
+size_t zf_interval_tree_foreach_overlap_(zf_interval_tree_<T, node> *const t,
+										 const uint64_t start,
+										 const uint64_t last, F f)
+{
+	size_t count = 0;
+	for (zf_interval_node *n = zf_interval_tree_first(t, start, last); 0 != n;
+		 n = zf_interval_tree_next(n, start, last))
+	{
+		f(zf_entry_(n, node));
+		++count;
+	}
+	return count;
+}
+
+#endif // __cplusplus
+
+#endif // _ZF_INTERVAL_TREE_H_
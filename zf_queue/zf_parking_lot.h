@@ -0,0 +1,505 @@
+#pragma once
+
+#ifndef _ZF_PARKING_LOT_H_
+#define _ZF_PARKING_LOT_H_
+
+/* Parking lot: global hash table of wait queues keyed by address. It allows
+ * synchronization primitives to keep only a few bits of state (zf_mutex_ and
+ * zf_condvar_ take one byte each), everything needed to block threads lives
+ * in the parking lot.
+ *
+ * Thread parks on address with zf_park_(addr, validate, before_sleep,
+ * deadline). Bucket of addr is locked and validate() is called, thread is
+ * enqueued only when it returns true. Then bucket is unlocked, before_sleep()
+ * is called and thread sleeps until it is unparked or deadline expires. Waiter
+ * (with its zf_tailq_node) lives on the stack of parked thread, so parking
+ * doesn't allocate memory. Sleep is futex based on Linux.
+ *
+ * zf_unpark_one_(addr, callback) dequeues the first thread parked on addr and
+ * calls callback(result) with bucket still locked, value returned by callback
+ * is passed to unparked thread as token. Result tells whether there are more
+ * threads parked on addr and whether it is time to be fair: each bucket asks
+ * for fairness about once per ZF_PARKING_LOT_FAIR_NS nanoseconds, so locks
+ * hand ownership directly to the waiter instead of letting a running thread
+ * barge in forever.
+ *
+ * Buckets table is fixed (ZF_PARKING_LOT_BUCKETS), addresses that collide
+ * share the bucket queue. Functions are inline (not static), so all
+ * translation units share the same table.
+ */
+
+#include "zf_queue.h"
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#if defined(__linux__)
+	#include <time.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#include <linux/futex.h>
+#else
+	#include <condition_variable>
+#endif
+
+#ifndef ZF_PARKING_LOT_BUCKETS
+	#define ZF_PARKING_LOT_BUCKETS 512
+#endif
+#ifndef ZF_PARKING_LOT_FAIR_NS
+	#define ZF_PARKING_LOT_FAIR_NS 1000000
+#endif
+
+typedef std::chrono::steady_clock::time_point zf_park_deadline_;
+
+struct zf_park_result_
+{
+	bool was_unparked;
+	/* value returned by unpark callback */
+	uintptr_t token;
+};
+
+struct zf_unpark_result_
+{
+	bool did_unpark;
+	bool may_have_more;
+	bool be_fair;
+};
+
+struct _zf_parking_waiter
+{
+	zf_tailq_node node;
+	const void *addr;
+	uintptr_t token;
+	/* set by unparker with bucket locked */
+	bool dequeued;
+	/* 0 while parked, 1 when unparked */
+	std::atomic<int> state;
+#if !defined(__linux__)
+	std::mutex m;
+	std::condition_variable cv;
+#endif
+};
+
+struct alignas(64) _zf_parking_bucket
+{
+	std::mutex lock;
+	zf_tailq_head queue;
+	zf_park_deadline_ fair_time;
+	uint64_t seed;
+
+	_zf_parking_bucket(): seed((uint64_t)(uintptr_t)this)
+	{
+		zf_tailq_init(&queue);
+	}
+};
+
+inline _zf_parking_bucket *_zf_parking_bucket_for(const void *const addr)
+{
+	static _zf_parking_bucket buckets[ZF_PARKING_LOT_BUCKETS];
+	const uint64_t k = (uint64_t)(uintptr_t)addr * 0x9e3779b97f4a7c15ULL;
+	return &buckets[(k >> 32) % ZF_PARKING_LOT_BUCKETS];
+}
+
+/* returns false when deadline expired before waiter was unparked */
+inline bool _zf_parking_sleep(_zf_parking_waiter *const w,
+							  const zf_park_deadline_ *const deadline)
+{
+	typedef std::chrono::steady_clock clock;
+#if defined(__linux__)
+	while (0 == w->state.load(std::memory_order_acquire))
+	{
+		struct timespec ts, *pts = 0;
+		if (0 != deadline)
+		{
+			const clock::duration left = *deadline - clock::now();
+			if (clock::duration::zero() >= left)
+			{
+				return false;
+			}
+			const long long ns =
+					std::chrono::duration_cast<std::chrono::nanoseconds>(left)
+					.count();
+			ts.tv_sec = (time_t)(ns / 1000000000);
+			ts.tv_nsec = (long)(ns % 1000000000);
+			pts = &ts;
+		}
+		syscall(SYS_futex, (int *)&w->state, FUTEX_WAIT_PRIVATE, 0, pts, 0, 0);
+	}
+	return true;
+#else
+	std::unique_lock<std::mutex> l(w->m);
+	while (0 == w->state.load(std::memory_order_acquire))
+	{
+		if (0 == deadline)
+		{
+			w->cv.wait(l);
+		}
+		else if (std::cv_status::timeout == w->cv.wait_until(l, *deadline) &&
+				 0 == w->state.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+	}
+	return true;
+#endif
+}
+
+/* waiter must be dequeued, it could be gone when this returns */
+inline void _zf_parking_wake(_zf_parking_waiter *const w)
+{
+#if defined(__linux__)
+	/* waking futex at address that is no longer used is harmless */
+	w->state.store(1, std::memory_order_release);
+	syscall(SYS_futex, (int *)&w->state, FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
+#else
+	std::lock_guard<std::mutex> l(w->m);
+	w->state.store(1, std::memory_order_release);
+	w->cv.notify_one();
+#endif
+}
+
+inline void _zf_parking_nop()
+{
+}
+
+inline bool _zf_parking_true()
+{
+	return true;
+}
+
+template <typename V, typename B>
+zf_park_result_ zf_park_(const void *const addr, V validate, B before_sleep,
+						 const zf_park_deadline_ *const deadline = 0)
+{
+	zf_park_result_ r = {false, 0};
+	_zf_parking_waiter w;
+	w.addr = addr;
+	w.token = 0;
+	w.dequeued = false;
+	w.state.store(0, std::memory_order_relaxed);
+	_zf_parking_bucket *const b = _zf_parking_bucket_for(addr);
+	b->lock.lock();
+	if (!validate())
+	{
+		b->lock.unlock();
+		return r;
+	}
+	zf_tailq_insert_tail(&b->queue, &w.node);
+	b->lock.unlock();
+	before_sleep();
+	if (!_zf_parking_sleep(&w, deadline))
+	{
+		b->lock.lock();
+		if (!w.dequeued)
+		{
+			zf_tailq_remove(&b->queue, &w.node);
+			b->lock.unlock();
+			return r;
+		}
+		b->lock.unlock();
+		/* unparker already dequeued us and is about to wake us up */
+		_zf_parking_sleep(&w, 0);
+	}
+	r.was_unparked = true;
+	r.token = w.token;
+	return r;
+}
+
+/* callback(const zf_unpark_result_ &) is called even if nobody was unparked */
+template <typename C>
+zf_unpark_result_ zf_unpark_one_(const void *const addr, C callback)
+{
+	zf_unpark_result_ r = {false, false, false};
+	_zf_parking_bucket *const b = _zf_parking_bucket_for(addr);
+	_zf_parking_waiter *w = 0;
+	b->lock.lock();
+	zf_tailq_foreach(&b->queue, n)
+	{
+		_zf_parking_waiter *const p = zf_entry_(n, &_zf_parking_waiter::node);
+		if (addr != p->addr)
+		{
+			continue;
+		}
+		if (0 != w)
+		{
+			r.may_have_more = true;
+			break;
+		}
+		w = p;
+	}
+	if (0 != w)
+	{
+		r.did_unpark = true;
+		const zf_park_deadline_ now = std::chrono::steady_clock::now();
+		if (now > b->fair_time)
+		{
+			r.be_fair = true;
+			b->seed ^= b->seed << 13;
+			b->seed ^= b->seed >> 7;
+			b->seed ^= b->seed << 17;
+			b->fair_time = now + std::chrono::nanoseconds(
+					b->seed % ZF_PARKING_LOT_FAIR_NS);
+		}
+		zf_tailq_remove(&b->queue, &w->node);
+		w->dequeued = true;
+		w->token = callback(r);
+	}
+	else
+	{
+		callback(r);
+	}
+	b->lock.unlock();
+	if (0 != w)
+	{
+		_zf_parking_wake(w);
+	}
+	return r;
+}
+
+inline uintptr_t _zf_parking_token_none(const zf_unpark_result_ &)
+{
+	return 0;
+}
+
+inline bool zf_unpark_one_(const void *const addr)
+{
+	return zf_unpark_one_(addr, _zf_parking_token_none).did_unpark;
+}
+
+/* callback(count) is called with bucket still locked, returns number of
+ * unparked threads */
+template <typename C>
+size_t zf_unpark_all_(const void *const addr, C callback)
+{
+	_zf_parking_bucket *const b = _zf_parking_bucket_for(addr);
+	zf_tailq_head wake;
+	zf_tailq_init(&wake);
+	size_t count = 0;
+	b->lock.lock();
+	for (zf_tailq_node *n = zf_tailq_first(&b->queue), *next; 0 != n; n = next)
+	{
+		next = n->next;
+		_zf_parking_waiter *const w = zf_entry_(n, &_zf_parking_waiter::node);
+		if (addr == w->addr)
+		{
+			zf_tailq_remove(&b->queue, n);
+			zf_tailq_insert_tail(&wake, n);
+			w->dequeued = true;
+			++count;
+		}
+	}
+	callback(count);
+	b->lock.unlock();
+	for (zf_tailq_node *n = zf_tailq_first(&wake), *next; 0 != n; n = next)
+	{
+		/* waiter could be gone after wake */
+		next = n->next;
+		_zf_parking_wake(zf_entry_(n, &_zf_parking_waiter::node));
+	}
+	return count;
+}
+
+inline void _zf_parking_count_nop(size_t)
+{
+}
+
+inline size_t zf_unpark_all_(const void *const addr)
+{
+	return zf_unpark_all_(addr, _zf_parking_count_nop);
+}
+
+/* One byte mutex. Spins for a while, then parks. Unlock hands the lock over
+ * to the parked thread when parking lot asks for fairness.
+ */
+class zf_mutex_
+{
+public:
+	zf_mutex_() noexcept: bits(0) {}
+	zf_mutex_(const zf_mutex_ &) = delete;
+	zf_mutex_ &operator=(const zf_mutex_ &) = delete;
+
+	void lock() noexcept
+	{
+		uint8_t e = 0;
+		if (!bits.compare_exchange_weak(e, c_locked, std::memory_order_acquire,
+										std::memory_order_relaxed))
+		{
+			lock_slow();
+		}
+	}
+	bool try_lock() noexcept
+	{
+		uint8_t e = bits.load(std::memory_order_relaxed);
+		while (0 == (c_locked & e))
+		{
+			if (bits.compare_exchange_weak(e, e | c_locked,
+										   std::memory_order_acquire,
+										   std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+	void unlock() noexcept
+	{
+		uint8_t e = c_locked;
+		if (!bits.compare_exchange_strong(e, 0, std::memory_order_release,
+										  std::memory_order_relaxed))
+		{
+			unlock_slow();
+		}
+	}
+private:
+	enum
+	{
+		c_locked = 1,
+		c_parked = 2,
+		c_spins = 40,
+		c_handoff = 1,
+	};
+
+	void lock_slow() noexcept
+	{
+		unsigned spins = 0;
+		for (;;)
+		{
+			uint8_t e = bits.load(std::memory_order_relaxed);
+			if (0 == (c_locked & e))
+			{
+				if (bits.compare_exchange_weak(e, e | c_locked,
+											   std::memory_order_acquire,
+											   std::memory_order_relaxed))
+				{
+					return;
+				}
+				continue;
+			}
+			if (0 == (c_parked & e))
+			{
+				if (c_spins > spins)
+				{
+					++spins;
+					std::this_thread::yield();
+					continue;
+				}
+				if (!bits.compare_exchange_weak(e, e | c_parked,
+												std::memory_order_relaxed,
+												std::memory_order_relaxed))
+				{
+					continue;
+				}
+			}
+			const zf_park_result_ r = zf_park_(&bits, [this]()
+			{
+				return (c_locked | c_parked) ==
+						bits.load(std::memory_order_relaxed);
+			}, _zf_parking_nop);
+			if (r.was_unparked && (uintptr_t)c_handoff == r.token)
+			{
+				/* lock bit was kept set for us */
+				return;
+			}
+		}
+	}
+	void unlock_slow() noexcept
+	{
+		zf_unpark_one_(&bits, [this](const zf_unpark_result_ &r) -> uintptr_t
+		{
+			const uint8_t parked = r.may_have_more? c_parked: 0;
+			if (r.did_unpark && r.be_fair)
+			{
+				bits.store(c_locked | parked, std::memory_order_relaxed);
+				return c_handoff;
+			}
+			bits.store(parked, std::memory_order_release);
+			return 0;
+		});
+	}
+
+	std::atomic<uint8_t> bits;
+};
+
+/* One byte condition variable, works with any lockable (zf_mutex_,
+ * std::unique_lock, etc.). Waiters flag is set and cleared only with bucket
+ * locked, so it can't be cleared while another thread is about to park.
+ */
+class zf_condvar_
+{
+public:
+	zf_condvar_() noexcept: waiters(0) {}
+	zf_condvar_(const zf_condvar_ &) = delete;
+	zf_condvar_ &operator=(const zf_condvar_ &) = delete;
+
+	template <typename L>
+	void wait(L &lock)
+	{
+		wait_until(lock, 0);
+	}
+	/* returns false on timeout */
+	template <typename L>
+	bool wait_until(L &lock, const zf_park_deadline_ &deadline)
+	{
+		return wait_until(lock, &deadline);
+	}
+	template <typename L, typename P>
+	void wait(L &lock, P pred)
+	{
+		while (!pred())
+		{
+			wait(lock);
+		}
+	}
+	/* returns true when a thread was unparked */
+	bool notify_one() noexcept
+	{
+		if (0 == waiters.load(std::memory_order_relaxed))
+		{
+			return false;
+		}
+		return zf_unpark_one_(this, [this](const zf_unpark_result_ &r)
+				-> uintptr_t
+		{
+			if (!r.may_have_more)
+			{
+				waiters.store(0, std::memory_order_relaxed);
+			}
+			return 0;
+		}).did_unpark;
+	}
+	void notify_all() noexcept
+	{
+		if (0 == waiters.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+		zf_unpark_all_(this, [this](size_t)
+		{
+			waiters.store(0, std::memory_order_relaxed);
+		});
+	}
+private:
+	template <typename L>
+	bool wait_until(L &lock, const zf_park_deadline_ *const deadline)
+	{
+		const zf_park_result_ r = zf_park_(this, [this]()
+		{
+			waiters.store(1, std::memory_order_relaxed);
+			return true;
+		}, [&lock]()
+		{
+			lock.unlock();
+		}, deadline);
+		lock.lock();
+		return r.was_unparked;
+	}
+
+	std::atomic<uint8_t> waiters;
+};
+
+#endif // __cplusplus
+
+#endif // _ZF_PARKING_LOT_H_
@@ -73,8 +73,25 @@
  * _remove                      -       +       -       +
  * _remove_head                 +       -       +       -
  * _remove_after                +       -       +       -
- * _concat                      -       #       #       #
- * _swap                        +       #       #       #
+ * _concat                      -       +       +       +
+ * _swap                        +       +       +       +
+ * _splice_head                 -       +       +       +
+ * _splice_tail                 -       -       +       +
+ * _splice_after                -       +       +       +
+ * _split                       -       +       -       +
+ * _split_after                 -       -       +       -
+ * _insert_head_bulk            +       +       +       +
+ * _insert_tail_bulk            -       -       +       +
+ * _insert_after_bulk           +       +       +       +
+ * _radix_sort                  -       -       +       +
+ * _merge                       -       -       +       +
+ * _foreach_prefetch            +       +       +       +
+ * _relink                      +       +       +       +
+ * _compact                     +       +       +       +
+ * _disorder                    +       +       +       +
+ * _partition                   +       +       +       +
+ * _remove_if                   +       +       +       +
+ * _unique                      +       +       +       +
  * Experimental (no tests):
  * _foreach                     #       #       #       +
  * _foreach_from                #       #       #       +
@@ -121,10 +138,137 @@
  *   e - some entry
  *   a - node or entry that goes after
  *   b - node or entry that goes before
+ *
+ * Functions zf_xxx_concat(h1, h2) move all entries of h2 to the tail of h1,
+ * h2 becomes empty. Functions zf_xxx_splice_yyy() move range of entries from
+ * first (f) to last (l) inclusively to the head, to the tail or after some
+ * node of h. Range could be moved within the same list, but insert position
+ * must not be inside the range. Singly-linked tail queue identifies the range
+ * by node before the first node (p) or by 0 when range starts at the head.
+ * Functions zf_xxx_split() move entry n and all entries after it to h2,
+ * zf_stailq_split_after() moves all entries after p (or all entries when p is
+ * 0). Previous content of h2 is discarded. All these operations are O(1),
+ * except zf_list_concat() which is O(n) in length of h1, since list doesn't
+ * have a pointer to its last node, and split and splice between lists when
+ * ZF_QUEUE_STATS is defined (see below).
+ *
+ * Functions zf_xxx_insert_yyy_bulk(..., n, count) insert count nodes from
+ * array n[] (order is preserved, n[0] goes first). Nodes are linked to each
+ * other first (with software prefetch of nodes that go next) and then the
+ * whole chain is linked into the list with a single update of the head (or
+ * of the node it goes after). Functions zf_xxx_insert_yyy_bulk_strided(...,
+ * n, stride, count) do the same for count nodes that are stride bytes apart
+ * starting from node n (e.g. nodes of entries in an array). C++ versions
+ * accept array of entry pointers or pointer to array of entries.
+ *
+ * Macros zf_xxx_foreach_prefetch(h, n, k, offset) iterate over nodes of h like
+ * zf_tailq_foreach() does, but keep a lookahead node k steps ahead of n and
+ * issue software prefetch for it and for the byte at offset from it (offset
+ * is relative to the node and could be negative, e.g. offsetof(entry, data) -
+ * offsetof(entry, node)), so cache misses of the next entries overlap with the
+ * loop body. k should be a constant. C++ versions zf_xxx_foreach_prefetch_<K>(
+ * h, f, offset) call f(e) for each entry, offset there is relative to entry.
+ * List must not be modified during iteration.
+ *
+ * Functions zf_xxx_relink() reorder nodes by their addresses (LSD radix sort
+ * by address), so traversal goes forward in memory. Functions zf_xxx_compact(
+ * h, slab, capacity, entry_size, node_offset, move, ctx) instead move entries
+ * into slab array in list order using move(dst, src, ctx) callback (that must
+ * copy at least the node) and link them in that order. Slab must not overlap
+ * entries of the list. When list has more than capacity entries nothing is
+ * moved. Both return number of entries. Functions zf_xxx_disorder(h, max_gap,
+ * count) return number of steps from node to next node that go backward or
+ * more than max_gap bytes forward (and total number of nodes in *count when
+ * count is not 0), which is a cheap metric to decide whether relink is
+ * worthwhile.
+ *
+ * Functions zf_xxx_partition(h, h2, pred, ctx) move nodes for which pred(n,
+ * ctx) is true to h2, zf_xxx_unique(h, h2, eq, ctx) move nodes that are equal
+ * (eq(p, n, ctx) is true) to the previous node p that stays in h to h2. Order
+ * of nodes is preserved in both lists, previous content of h2 is discarded.
+ * Functions zf_xxx_remove_if(h, pred, dispose, ctx) remove nodes for which
+ * pred(n, ctx) is true and then call dispose(n, ctx) for each of them, when
+ * list h is already consistent (so dispose could free the node). All of them
+ * relink the list in a single pass and return number of moved nodes. C++
+ * versions accept functors that take entries.
+ *
+ * C++ heads zf_xxx_head_ have begin() and end() that return STL compatible
+ * iterators over entries (T &), so range-based for loops and <algorithm> work
+ * with them. Tail queue iterators are bidirectional (there are also rbegin()
+ * and rend()), others are forward. Iterators are invalidated when the entry
+ * they point to is removed.
+ *
+ * C++ list and tail queue heads have optional third template parameter that
+ * selects link policy at compile time:
+ *  - zf_link_fast_ (default) is what C functions do: removed node keeps stale
+ *    pointers.
+ *  - zf_link_safe_: zf_xxx_remove_() and zf_xxx_remove_if_() also zero pointers
+ *    of removed nodes, so zf_xxx_linked_(h, e) tells in O(1) whether entry is
+ *    in a list. Nodes must be zero-initialized before the first insertion.
+ *  - zf_link_auto_ (lists only): same as safe, in addition entries wrapped into
+ *    zf_list_auto_unlink_<T, node> (C++11) remove themselves from the list when
+ *    destroyed and the head unlinks remaining entries when it is destroyed.
+ *    Wrapped entries are passed to head functions as T *.
+ * Policy checks are resolved at compile time, so fast heads have no overhead.
+ * Tail queue nodes can't unlink without the head (last node is referenced by
+ * the head), so there is no auto unlink for them.
+ *
+ * Functions zf_xxx_radix_sort() perform stable LSD radix sort by unsigned
+ * integer key (up to 64 bits) provided by key(n, ctx) callback. Each pass
+ * distributes nodes into 256 buckets by one byte of the key and then links
+ * buckets back together. Bytes that are the same in all keys are skipped, so
+ * 32-bit keys take at most 4 passes (first pass is always performed). Key
+ * callback is invoked once per node per pass.
+ *
+ * Functions zf_xxx_merge() move entries from k sorted lists in[] to the tail
+ * of h in sorted order, until all lists are empty or limit entries are moved
+ * (entries that were not moved stay in in[]). Order is defined by cmp(a, b,
+ * ctx) callback that returns negative, zero or positive value (like strcmp()
+ * does). Merge is stable, equal entries from in[i] go before the ones from
+ * in[j] when i < j. Tournament (loser) tree is used, so each entry costs
+ * O(log k) comparisons. Tree is stored in caller provided array of k elements,
+ * these functions do not allocate memory. Returns number of moved entries.
+ *
+ * When ZF_QUEUE_STATS is defined (must be the same in all translation units,
+ * since it changes layout of heads), each head has stats field of type struct
+ * zf_queue_stats with number of inserted and removed entries, current and
+ * high-water length and number of traversal steps (by foreach macros, C++
+ * iterators and functions that walk the list). Entries moved between lists
+ * (concat, splice, split, partition, unique, merge) are counted as removed
+ * from one list and inserted into another, swap exchanges lengths, sort,
+ * relink and compact keep counters as they were. Split and splice of a range
+ * between different lists count moved entries, so with ZF_QUEUE_STATS they
+ * are O(number of moved entries) instead of O(1). Counters other than steps
+ * are updated with relaxed atomic stores by the thread that modifies the list
+ * (which must hold whatever lock protects the list anyway). Steps are also
+ * counted by traversals that only read the list (possibly concurrently, e.g.
+ * under shared lock, and through const head), so they are incremented with
+ * relaxed atomic read-modify-write and stats field of C++ heads is mutable
+ * (in C head that is traversed must not be defined const).
+ * zf_queue_stats_snapshot(&h->stats) could be called from other threads.
+ * zf_queue_stats_reset(&h->stats) zeroes counters and sets high-water length
+ * to current length.
+ * C functions that don't take the head (zf_slist_insert_after(), zf_list_
+ * insert_before(), zf_list_remove(), zf_list_splice_yyy(), zf_tailq_insert_
+ * before() and alike) can't count, C++ versions that take the head do count
+ * (except list splice, that doesn't know source list). When ZF_QUEUE_STATS is
+ * not defined, none of this code is compiled in.
+ *
+ * When ZF_QUEUE_USDT is defined, list operations have USDT (user statically
+ * defined tracing) probes from <sys/sdt.h> (header only, part of SystemTap
+ * development files), so they could be traced with bpftrace or perf without
+ * rebuilding. Provider is zf_queue, probes are xxx_insert, xxx_remove,
+ * xxx_dequeue (removal of the first entry) and xxx_concat (list, stailq and
+ * tailq). Arguments are head address (0 for functions that don't take the
+ * head) and node address (for concat, address of the second head):
+ *   bpftrace -e 'usdt:./app:zf_queue:tailq_insert { @[arg0] = count(); }'
+ * Probe that is not attached is a single nop. When ZF_QUEUE_USDT is not
+ * defined, probes are not compiled in.
  */
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #define _ZF_QUEUE_DECL static inline
 
@@ -142,9 +286,248 @@
 	#define _ZF_QUEUE_NOEXCEPT
 #endif
 
+/* Number of entries to prefetch ahead in bulk operations */
+#if !defined(ZF_QUEUE_PREFETCH_DISTANCE)
+	#define ZF_QUEUE_PREFETCH_DISTANCE 8
+#endif
+
+#if defined(__GNUC__)
+	#define _ZF_QUEUE_PREFETCH(p) __builtin_prefetch((p), 0)
+	#define _ZF_QUEUE_PREFETCH_W(p) __builtin_prefetch((p), 1)
+#else
+	#define _ZF_QUEUE_PREFETCH(p) ((void)(p))
+	#define _ZF_QUEUE_PREFETCH_W(p) ((void)(p))
+#endif
+
 #define zf_entry(node, entry_type, entry_member) \
 	((entry_type *)((char *)node - offsetof(entry_type, entry_member)))
 
+#define _ZF_QUEUE_RADIX_BITS 8
+#define _ZF_QUEUE_RADIX_BUCKETS (1 << _ZF_QUEUE_RADIX_BITS)
+#define _ZF_QUEUE_RADIX_MASK (_ZF_QUEUE_RADIX_BUCKETS - 1)
+#define _ZF_QUEUE_RADIX_KEY_BITS 64
+
+/* Use as limit argument for zf_xxx_merge() to move all entries */
+#define ZF_MERGE_ALL ((size_t)-1)
+
+/* USDT probes, see ZF_QUEUE_USDT above */
+#if defined(ZF_QUEUE_USDT)
+	#include <sys/sdt.h>
+	#define _ZF_QUEUE_PROBE(name, h, n) DTRACE_PROBE2(zf_queue, name, h, n)
+#else
+	#define _ZF_QUEUE_PROBE(name, h, n)
+#endif
+
+/* Operation statistics, see ZF_QUEUE_STATS above */
+#if defined(ZF_QUEUE_STATS)
+
+struct zf_queue_stats
+{
+	size_t inserts;
+	size_t removes;
+	size_t length;
+	size_t max_length;
+	size_t steps;
+};
+
+/* only the thread that modifies the list writes counters, so relaxed load and
+ * store are enough to read them from other threads (no lock prefix) */
+#if defined(__GNUC__)
+	#define _ZF_QUEUE_STATS_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+	#define _ZF_QUEUE_STATS_STORE(p, v) \
+		__atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#else
+	#define _ZF_QUEUE_STATS_LOAD(p) (*(p))
+	#define _ZF_QUEUE_STATS_STORE(p, v) ((void)(*(p) = (v)))
+#endif
+
+_ZF_QUEUE_DECL
+void _zf_queue_stats_add(size_t *const p, const size_t k)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_STATS_STORE(p, _ZF_QUEUE_STATS_LOAD(p) + k);
+}
+
+/* steps could be counted by concurrent readers, so increment is atomic */
+_ZF_QUEUE_DECL
+void _zf_queue_stats_step(size_t *const p, const size_t k)
+	_ZF_QUEUE_NOEXCEPT
+{
+#if defined(__GNUC__)
+	__atomic_fetch_add(p, k, __ATOMIC_RELAXED);
+#else
+	*p += k;
+#endif
+}
+
+_ZF_QUEUE_DECL
+void _zf_queue_stats_length(struct zf_queue_stats *const s, const size_t length)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_STATS_STORE(&s->length, length);
+	if (length > _ZF_QUEUE_STATS_LOAD(&s->max_length))
+	{
+		_ZF_QUEUE_STATS_STORE(&s->max_length, length);
+	}
+}
+
+_ZF_QUEUE_DECL
+void _zf_queue_stats_init(struct zf_queue_stats *const s)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_STATS_STORE(&s->inserts, 0);
+	_ZF_QUEUE_STATS_STORE(&s->removes, 0);
+	_ZF_QUEUE_STATS_STORE(&s->length, 0);
+	_ZF_QUEUE_STATS_STORE(&s->max_length, 0);
+	_ZF_QUEUE_STATS_STORE(&s->steps, 0);
+}
+
+_ZF_QUEUE_DECL
+void _zf_queue_stats_insert(struct zf_queue_stats *const s, const size_t k)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_queue_stats_add(&s->inserts, k);
+	_zf_queue_stats_length(s, _ZF_QUEUE_STATS_LOAD(&s->length) + k);
+}
+
+_ZF_QUEUE_DECL
+void _zf_queue_stats_remove(struct zf_queue_stats *const s, const size_t k)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_queue_stats_add(&s->removes, k);
+	_ZF_QUEUE_STATS_STORE(&s->length, _ZF_QUEUE_STATS_LOAD(&s->length) - k);
+}
+
+/* k entries moved from s to s2 (nothing when range moved within a list) */
+_ZF_QUEUE_DECL
+void _zf_queue_stats_move(struct zf_queue_stats *const s,
+						  struct zf_queue_stats *const s2, const size_t k)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (s != s2)
+	{
+		_zf_queue_stats_remove(s, k);
+		_zf_queue_stats_insert(s2, k);
+	}
+}
+
+_ZF_QUEUE_DECL
+void _zf_queue_stats_swap(struct zf_queue_stats *const s1,
+						  struct zf_queue_stats *const s2)
+	_ZF_QUEUE_NOEXCEPT
+{
+	const size_t length = _ZF_QUEUE_STATS_LOAD(&s1->length);
+	_zf_queue_stats_length(s1, _ZF_QUEUE_STATS_LOAD(&s2->length));
+	_zf_queue_stats_length(s2, length);
+}
+
+/* returns copy of counters (could be called from any thread), each counter is
+ * read atomically, but independently, so they are not consistent with each
+ * other when the list is modified concurrently */
+_ZF_QUEUE_DECL
+struct zf_queue_stats zf_queue_stats_snapshot(const struct zf_queue_stats *const s)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_queue_stats r;
+	r.inserts = _ZF_QUEUE_STATS_LOAD(&s->inserts);
+	r.removes = _ZF_QUEUE_STATS_LOAD(&s->removes);
+	r.length = _ZF_QUEUE_STATS_LOAD(&s->length);
+	r.max_length = _ZF_QUEUE_STATS_LOAD(&s->max_length);
+	r.steps = _ZF_QUEUE_STATS_LOAD(&s->steps);
+	return r;
+}
+
+/* zero counters, length stays and becomes new high-water mark */
+_ZF_QUEUE_DECL
+void zf_queue_stats_reset(struct zf_queue_stats *const s)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_STATS_STORE(&s->inserts, 0);
+	_ZF_QUEUE_STATS_STORE(&s->removes, 0);
+	_ZF_QUEUE_STATS_STORE(&s->max_length, _ZF_QUEUE_STATS_LOAD(&s->length));
+	_ZF_QUEUE_STATS_STORE(&s->steps, 0);
+}
+
+_ZF_QUEUE_DECL
+void _zf_queue_stats_restore(struct zf_queue_stats *const s,
+							 const struct zf_queue_stats *const saved)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_STATS_STORE(&s->inserts, saved->inserts);
+	_ZF_QUEUE_STATS_STORE(&s->removes, saved->removes);
+	_ZF_QUEUE_STATS_STORE(&s->length, saved->length);
+	_ZF_QUEUE_STATS_STORE(&s->max_length, saved->max_length);
+	_ZF_QUEUE_STATS_STORE(&s->steps, saved->steps);
+}
+
+/* cast allows to count steps of traversals of const head */
+#define _ZF_QUEUE_STATS(h) ((struct zf_queue_stats *)&(h)->stats)
+#if defined(__cplusplus)
+	#define _ZF_QUEUE_STATS_FIELD mutable struct zf_queue_stats stats;
+#else
+	#define _ZF_QUEUE_STATS_FIELD struct zf_queue_stats stats;
+#endif
+#define _ZF_QUEUE_STATS_INITIALIZER , {0, 0, 0, 0, 0}
+/* extra argument of C++ iterator constructor in head begin() */
+#define _ZF_QUEUE_STATS_ARG , _ZF_QUEUE_STATS(this)
+#define _ZF_QUEUE_STATS_INIT(h) _zf_queue_stats_init(_ZF_QUEUE_STATS(h))
+#define _ZF_QUEUE_STATS_INSERT(h, k) \
+	_zf_queue_stats_insert(_ZF_QUEUE_STATS(h), (k))
+#define _ZF_QUEUE_STATS_REMOVE(h, k) \
+	_zf_queue_stats_remove(_ZF_QUEUE_STATS(h), (k))
+/* k entries moved from h to h2 */
+#define _ZF_QUEUE_STATS_MOVE(h, h2, k) \
+	_zf_queue_stats_move(_ZF_QUEUE_STATS(h), _ZF_QUEUE_STATS(h2), (k))
+/* all entries moved from h to h2 */
+#define _ZF_QUEUE_STATS_MOVE_ALL(h, h2) \
+	_ZF_QUEUE_STATS_MOVE(h, h2, _ZF_QUEUE_STATS_LOAD(&_ZF_QUEUE_STATS(h)->length))
+/* previous content of h is discarded */
+#define _ZF_QUEUE_STATS_DISCARD(h) \
+	_zf_queue_stats_remove(_ZF_QUEUE_STATS(h), \
+						   _ZF_QUEUE_STATS_LOAD(&_ZF_QUEUE_STATS(h)->length))
+#define _ZF_QUEUE_STATS_SWAP(h1, h2) \
+	_zf_queue_stats_swap(_ZF_QUEUE_STATS(h1), _ZF_QUEUE_STATS(h2))
+#define _ZF_QUEUE_STATS_STEP(h, k) \
+	_zf_queue_stats_step(&_ZF_QUEUE_STATS(h)->steps, (k))
+/* next node n in loops over h, counts the step */
+#define _ZF_QUEUE_STATS_NEXT(h, n) (_ZF_QUEUE_STATS_STEP(h, 1), (n))
+/* operations that relink entries in place keep counters as they were */
+#define _ZF_QUEUE_STATS_SAVE(h) \
+	const struct zf_queue_stats _zf_stats = \
+			zf_queue_stats_snapshot(_ZF_QUEUE_STATS(h))
+#define _ZF_QUEUE_STATS_RESTORE(h) \
+	_zf_queue_stats_restore(_ZF_QUEUE_STATS(h), &_zf_stats)
+
+#else
+
+#define _ZF_QUEUE_STATS_FIELD
+#define _ZF_QUEUE_STATS_INITIALIZER
+#define _ZF_QUEUE_STATS_ARG
+#define _ZF_QUEUE_STATS_INIT(h)
+/* head is still used, so functions that only count could name it */
+#define _ZF_QUEUE_STATS_INSERT(h, k) ((void)(h))
+#define _ZF_QUEUE_STATS_REMOVE(h, k) ((void)(h))
+#define _ZF_QUEUE_STATS_MOVE(h, h2, k)
+#define _ZF_QUEUE_STATS_MOVE_ALL(h, h2)
+#define _ZF_QUEUE_STATS_DISCARD(h)
+#define _ZF_QUEUE_STATS_SWAP(h1, h2)
+#define _ZF_QUEUE_STATS_STEP(h, k)
+#define _ZF_QUEUE_STATS_NEXT(h, n) (n)
+#define _ZF_QUEUE_STATS_SAVE(h)
+#define _ZF_QUEUE_STATS_RESTORE(h)
+
+#endif
+
+/* returns true when going from node a to node b is not a short step forward */
+_ZF_QUEUE_DECL
+bool _zf_queue_disorder_step(const void *const a, const void *const b,
+							 const size_t max_gap)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return (uintptr_t)b < (uintptr_t)a ||
+		   (uintptr_t)b - (uintptr_t)a > max_gap;
+}
+
 /*
  * Singly-linked list
  */
@@ -157,10 +540,11 @@ zf_slist_node;
 typedef struct zf_slist_head
 {
 	struct zf_slist_node *first;
+	_ZF_QUEUE_STATS_FIELD
 }
 zf_slist_head;
 
-#define ZF_SLIST_INITIALIZER() {0}
+#define ZF_SLIST_INITIALIZER() {0 _ZF_QUEUE_STATS_INITIALIZER}
 
 #ifdef __cplusplus
 	_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
@@ -183,6 +567,7 @@ void zf_slist_init(struct zf_slist_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
 	h->first = 0;
+	_ZF_QUEUE_STATS_INIT(h);
 }
 
 _ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
@@ -225,8 +610,10 @@ void zf_slist_insert_head(struct zf_slist_head *const h,
 						  struct zf_slist_node *const n)
 	_ZF_QUEUE_NOEXCEPT
 {
+	_ZF_QUEUE_PROBE(slist_insert, h, n);
 	n->next = h->first;
 	h->first = n;
+	_ZF_QUEUE_STATS_INSERT(h, 1);
 }
 
 /* insert a after b */
@@ -235,6 +622,7 @@ void zf_slist_insert_after(struct zf_slist_node *const b,
 						   struct zf_slist_node *const a)
 	_ZF_QUEUE_NOEXCEPT
 {
+	_ZF_QUEUE_PROBE(slist_insert, 0, a);
 	a->next = b->next;
 	b->next = a;
 }
@@ -243,13 +631,16 @@ _ZF_QUEUE_DECL
 void zf_slist_remove_head(struct zf_slist_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
+	_ZF_QUEUE_PROBE(slist_dequeue, h, h->first);
 	h->first = h->first->next;
+	_ZF_QUEUE_STATS_REMOVE(h, 1);
 }
 
 _ZF_QUEUE_DECL
 void zf_slist_remove_after(struct zf_slist_node *const n)
 	_ZF_QUEUE_NOEXCEPT
 {
+	_ZF_QUEUE_PROBE(slist_remove, 0, n->next);
 	n->next = n->next->next;
 }
 
@@ -261,6 +652,315 @@ void zf_slist_swap(struct zf_slist_head *const h1,
 	struct zf_slist_node *const n = h1->first;
 	h1->first = h2->first;
 	h2->first = n;
+	_ZF_QUEUE_STATS_SWAP(h1, h2);
+}
+
+/* link n[0] -> ... -> n[count - 1], count must be > 0 */
+_ZF_QUEUE_DECL
+void _zf_slist_chain_bulk(struct zf_slist_node *const *const n,
+						  const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		if (count > i + ZF_QUEUE_PREFETCH_DISTANCE)
+		{
+			_ZF_QUEUE_PREFETCH_W(n[i + ZF_QUEUE_PREFETCH_DISTANCE]);
+		}
+		n[i - 1]->next = n[i];
+	}
+}
+
+/* link count > 0 nodes stride bytes apart, return the last one */
+_ZF_QUEUE_DECL
+struct zf_slist_node *_zf_slist_chain_strided(struct zf_slist_node *n,
+											  const size_t stride,
+											  const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		n = n->next = (struct zf_slist_node *)((char *)n + stride);
+	}
+	return n;
+}
+
+_ZF_QUEUE_DECL
+void zf_slist_insert_head_bulk(struct zf_slist_head *const h,
+							   struct zf_slist_node *const *const n,
+							   const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_slist_chain_bulk(n, count);
+		n[count - 1]->next = h->first;
+		h->first = n[0];
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+/* insert n[] after b */
+_ZF_QUEUE_DECL
+void zf_slist_insert_after_bulk(struct zf_slist_node *const b,
+								struct zf_slist_node *const *const n,
+								const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_slist_chain_bulk(n, count);
+		n[count - 1]->next = b->next;
+		b->next = n[0];
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_slist_insert_head_bulk_strided(struct zf_slist_head *const h,
+									   struct zf_slist_node *const n,
+									   const size_t stride, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_slist_chain_strided(n, stride, count)->next = h->first;
+		h->first = n;
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+/* insert nodes starting from n after b */
+_ZF_QUEUE_DECL
+void zf_slist_insert_after_bulk_strided(struct zf_slist_node *const b,
+										struct zf_slist_node *const n,
+										const size_t stride, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_slist_chain_strided(n, stride, count)->next = b->next;
+		b->next = n;
+	}
+}
+
+/* prefetch up to k nodes after n and their payload, return the last one */
+_ZF_QUEUE_DECL
+struct zf_slist_node *_zf_slist_prefetch_lead(struct zf_slist_node *n,
+											  unsigned k,
+											  const ptrdiff_t offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (; 0 != n && 0 != k; --k)
+	{
+		if (0 != (n = n->next))
+		{
+			_ZF_QUEUE_PREFETCH(n);
+			_ZF_QUEUE_PREFETCH((char *)n + offset);
+		}
+	}
+	return n;
+}
+
+#define zf_slist_foreach_prefetch(h, n, k, offset) \
+	for (struct zf_slist_node *n = (h)->first, \
+		 *_zf_lead_##n = _zf_slist_prefetch_lead(n, (k), (offset)); \
+		 0 != n; \
+		 n = _ZF_QUEUE_STATS_NEXT(h, n->next), \
+		 _zf_lead_##n = _zf_slist_prefetch_lead(_zf_lead_##n, 1, (offset)))
+
+/* relink nodes in order of their addresses (LSD radix sort by address) */
+_ZF_QUEUE_DECL
+void zf_slist_relink(struct zf_slist_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_slist_node *bf[_ZF_QUEUE_RADIX_BUCKETS];
+	struct zf_slist_node **bl[_ZF_QUEUE_RADIX_BUCKETS];
+	uintptr_t k_or = 0, k_and = ~(uintptr_t)0;
+	for (struct zf_slist_node *n = h->first; 0 != n; n = n->next)
+	{
+		k_or |= (uintptr_t)n;
+		k_and &= (uintptr_t)n;
+	}
+	for (unsigned shift = 0; 8 * sizeof(uintptr_t) > shift;
+		 shift += _ZF_QUEUE_RADIX_BITS)
+	{
+		if (0 == (_ZF_QUEUE_RADIX_MASK & ((k_or ^ k_and) >> shift)))
+		{
+			continue;
+		}
+		for (unsigned i = 0; _ZF_QUEUE_RADIX_BUCKETS > i; ++i)
+		{
+			bl[i] = &bf[i];
+		}
+		for (struct zf_slist_node *n = h->first; 0 != n; n = n->next)
+		{
+			const uintptr_t i = _ZF_QUEUE_RADIX_MASK & ((uintptr_t)n >> shift);
+			*bl[i] = n;
+			bl[i] = &n->next;
+		}
+		struct zf_slist_node **pl = &h->first;
+		for (unsigned i = 0; _ZF_QUEUE_RADIX_BUCKETS > i; ++i)
+		{
+			if (&bf[i] != bl[i])
+			{
+				*pl = bf[i];
+				pl = bl[i];
+			}
+		}
+		*pl = 0;
+	}
+}
+
+/* returns number of steps that go backward or more than max_gap bytes forward */
+_ZF_QUEUE_DECL
+size_t zf_slist_disorder(struct zf_slist_head *const h, const size_t max_gap,
+						 size_t *const count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t breaks = 0, total = 0;
+	for (struct zf_slist_node *n = h->first; 0 != n; n = n->next)
+	{
+		++total;
+		if (0 != n->next && _zf_queue_disorder_step(n, n->next, max_gap))
+		{
+			++breaks;
+		}
+	}
+	_ZF_QUEUE_STATS_STEP(h, total);
+	if (0 != count)
+	{
+		*count = total;
+	}
+	return breaks;
+}
+
+/* move entries into slab in list order, returns number of entries */
+_ZF_QUEUE_DECL
+size_t zf_slist_compact(struct zf_slist_head *const h, void *const slab,
+						const size_t capacity, const size_t entry_size,
+						const size_t node_offset,
+						void (*const move)(void *dst, void *src, void *ctx),
+						void *const ctx)
+{
+	size_t count = 0;
+	for (struct zf_slist_node *n = h->first; 0 != n; n = n->next)
+	{
+		++count;
+	}
+	if (count > capacity)
+	{
+		return count;
+	}
+	char *dst = (char *)slab;
+	struct zf_slist_node *lead = _zf_slist_prefetch_lead(
+			h->first, ZF_QUEUE_PREFETCH_DISTANCE, -(ptrdiff_t)node_offset);
+	for (struct zf_slist_node *n = h->first, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_slist_prefetch_lead(lead, 1, -(ptrdiff_t)node_offset);
+		move(dst, (char *)n - node_offset, ctx);
+		dst += entry_size;
+	}
+	struct zf_slist_node *const f =
+			(struct zf_slist_node *)((char *)slab + node_offset);
+	_ZF_QUEUE_STATS_SAVE(h);
+	zf_slist_init(h);
+	zf_slist_insert_head_bulk_strided(h, f, entry_size, count);
+	_ZF_QUEUE_STATS_RESTORE(h);
+	return count;
+}
+
+/* move nodes for which pred(n, ctx) is true to h2 (in the same order) */
+_ZF_QUEUE_DECL
+size_t zf_slist_partition(struct zf_slist_head *const h,
+						  struct zf_slist_head *const h2,
+						  bool (*const pred)(struct zf_slist_node *, void *),
+						  void *const ctx)
+{
+	size_t moved = 0;
+	struct zf_slist_node **t1 = &h->first, **t2 = &h2->first;
+	struct zf_slist_node *lead = _zf_slist_prefetch_lead(
+			h->first, ZF_QUEUE_PREFETCH_DISTANCE, 0);
+	for (struct zf_slist_node *n = h->first, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_slist_prefetch_lead(lead, 1, 0);
+		if (pred(n, ctx))
+		{
+			*t2 = n;
+			t2 = &n->next;
+			++moved;
+		}
+		else
+		{
+			*t1 = n;
+			t1 = &n->next;
+		}
+	}
+	*t1 = 0;
+	*t2 = 0;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, moved);
+	return moved;
+}
+
+/* remove nodes for which pred(n, ctx) is true, then call dispose(n, ctx) for
+ * each of them (when dispose is not 0) */
+_ZF_QUEUE_DECL
+size_t zf_slist_remove_if(struct zf_slist_head *const h,
+						  bool (*const pred)(struct zf_slist_node *, void *),
+						  void (*const dispose)(struct zf_slist_node *, void *),
+						  void *const ctx)
+{
+	struct zf_slist_head d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	const size_t removed = zf_slist_partition(h, &d, pred, ctx);
+	if (0 != dispose)
+	{
+		for (struct zf_slist_node *n = d.first, *next; 0 != n; n = next)
+		{
+			next = n->next;
+			dispose(n, ctx);
+		}
+	}
+	return removed;
+}
+
+/* move nodes for which eq(p, n, ctx) is true for previous kept node p to h2 */
+_ZF_QUEUE_DECL
+size_t zf_slist_unique(struct zf_slist_head *const h,
+					   struct zf_slist_head *const h2,
+					   bool (*const eq)(struct zf_slist_node *,
+										struct zf_slist_node *, void *),
+					   void *const ctx)
+{
+	size_t moved = 0;
+	struct zf_slist_node **t1 = &h->first, **t2 = &h2->first;
+	struct zf_slist_node *p = 0;
+	struct zf_slist_node *lead = _zf_slist_prefetch_lead(
+			h->first, ZF_QUEUE_PREFETCH_DISTANCE, 0);
+	for (struct zf_slist_node *n = h->first, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_slist_prefetch_lead(lead, 1, 0);
+		if (0 != p && eq(p, n, ctx))
+		{
+			*t2 = n;
+			t2 = &n->next;
+			++moved;
+		}
+		else
+		{
+			*t1 = n;
+			t1 = &n->next;
+			p = n;
+		}
+	}
+	*t1 = 0;
+	*t2 = 0;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, moved);
+	return moved;
 }
 
 /*
@@ -276,10 +976,11 @@ zf_list_node;
 typedef struct zf_list_head
 {
 	struct zf_list_node *first;
+	_ZF_QUEUE_STATS_FIELD
 }
 zf_list_head;
 
-#define ZF_LIST_INITIALIZER() {0}
+#define ZF_LIST_INITIALIZER() {0 _ZF_QUEUE_STATS_INITIALIZER}
 
 #ifdef __cplusplus
 	_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
@@ -302,6 +1003,7 @@ void zf_list_init(struct zf_list_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
 	h->first = 0;
+	_ZF_QUEUE_STATS_INIT(h);
 }
 
 _ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
@@ -360,12 +1062,14 @@ void zf_list_insert_head(struct zf_list_head *const h,
 						 struct zf_list_node *const n)
 	_ZF_QUEUE_NOEXCEPT
 {
+	_ZF_QUEUE_PROBE(list_insert, h, n);
 	if (0 != (n->next = h->first))
 	{
 		h->first->pprev = &n->next;
 	}
 	h->first = n;
 	n->pprev = &h->first;
+	_ZF_QUEUE_STATS_INSERT(h, 1);
 }
 
 /* insert b before a */
@@ -374,6 +1078,7 @@ void zf_list_insert_before(struct zf_list_node *const a,
 						   struct zf_list_node *const b)
 	_ZF_QUEUE_NOEXCEPT
 {
+	_ZF_QUEUE_PROBE(list_insert, 0, b);
 	b->pprev = a->pprev;
 	b->next = a;
 	*a->pprev = b;
@@ -386,6 +1091,7 @@ void zf_list_insert_after(struct zf_list_node *const b,
 						  struct zf_list_node *const a)
 	_ZF_QUEUE_NOEXCEPT
 {
+	_ZF_QUEUE_PROBE(list_insert, 0, a);
 	if (0 != (a->next = b->next))
 	{
 		b->next->pprev = &a->next;
@@ -398,6 +1104,7 @@ _ZF_QUEUE_DECL
 void zf_list_remove(struct zf_list_node *const n)
 	_ZF_QUEUE_NOEXCEPT
 {
+	_ZF_QUEUE_PROBE(list_remove, 0, n);
 	if (0 != n->next)
 	{
 		n->next->pprev = n->pprev;
@@ -405,591 +1112,3419 @@ void zf_list_remove(struct zf_list_node *const n)
 	*n->pprev = n->next;
 }
 
-/*
- * Singly-linked tail queue
- */
-typedef struct zf_stailq_node
+_ZF_QUEUE_DECL
+void zf_list_swap(struct zf_list_head *const h1,
+				  struct zf_list_head *const h2)
+	_ZF_QUEUE_NOEXCEPT
 {
-	struct zf_stailq_node *next;
+	struct zf_list_node *const n = h1->first;
+	if (0 != (h1->first = h2->first))
+	{
+		h1->first->pprev = &h1->first;
+	}
+	if (0 != (h2->first = n))
+	{
+		n->pprev = &h2->first;
+	}
+	_ZF_QUEUE_STATS_SWAP(h1, h2);
 }
-zf_stailq_node;
 
-typedef struct zf_stailq_head
+_ZF_QUEUE_DECL
+void zf_list_concat(struct zf_list_head *const h1,
+					struct zf_list_head *const h2)
+	_ZF_QUEUE_NOEXCEPT
 {
-	struct zf_stailq_node first;
-	struct zf_stailq_node *last;
-}
-zf_stailq_head;
-
-#define ZF_STAILQ_INITIALIZER(h) {{0}, &(h)->first}
-
-#ifdef __cplusplus
-	_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-	zf_stailq_head _zf_stailq_initializer(zf_stailq_head *const h)
-		_ZF_QUEUE_NOEXCEPT
+	_ZF_QUEUE_PROBE(list_concat, h1, h2);
+	if (0 != h2->first)
 	{
-	#if __cplusplus >= 201103L
-		return ZF_STAILQ_INITIALIZER(h);
-	#else
-		const zf_stailq_head init = ZF_STAILQ_INITIALIZER(h);
-		return init;
-	#endif
+		struct zf_list_node **pnext = &h1->first;
+		while (0 != *pnext)
+		{
+			pnext = &(*pnext)->next;
+		}
+		*pnext = h2->first;
+		h2->first->pprev = pnext;
+		h2->first = 0;
+		_ZF_QUEUE_STATS_MOVE_ALL(h2, h1);
 	}
-	#undef ZF_STAILQ_INITIALIZER
-	#define ZF_STAILQ_INITIALIZER(h) _zf_stailq_initializer(h)
-#endif
+}
 
+/* link chain [f, l] to position pointed by pnext */
 _ZF_QUEUE_DECL
-void zf_stailq_init(struct zf_stailq_head *const h)
+void _zf_list_link(struct zf_list_node **const pnext,
+				   struct zf_list_node *const f,
+				   struct zf_list_node *const l)
 	_ZF_QUEUE_NOEXCEPT
 {
-	h->first.next = 0;
-	h->last = &h->first;
+	if (0 != (l->next = *pnext))
+	{
+		l->next->pprev = &l->next;
+	}
+	*pnext = f;
+	f->pprev = pnext;
 }
 
-_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-bool zf_stailq_empty(struct zf_stailq_head *const h)
+/* unlink range [f, l] and link it to position pointed by pnext */
+_ZF_QUEUE_DECL
+void _zf_list_splice(struct zf_list_node **const pnext,
+					 struct zf_list_node *const f,
+					 struct zf_list_node *const l)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return 0 == h->first.next;
+	if (0 != l->next)
+	{
+		l->next->pprev = f->pprev;
+	}
+	*f->pprev = l->next;
+	_zf_list_link(pnext, f, l);
 }
 
-_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_stailq_node *zf_stailq_first(struct zf_stailq_head *const h)
+_ZF_QUEUE_DECL
+void zf_list_splice_head(struct zf_list_head *const h,
+						 struct zf_list_node *const f,
+						 struct zf_list_node *const l)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return h->first.next;
+	_zf_list_splice(&h->first, f, l);
 }
 
-_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_stailq_node *zf_stailq_last(struct zf_stailq_head *const h)
+/* move range [f, l] after b */
+_ZF_QUEUE_DECL
+void zf_list_splice_after(struct zf_list_node *const b,
+						  struct zf_list_node *const f,
+						  struct zf_list_node *const l)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return 0 == h->first.next? 0: h->last;
+	_zf_list_splice(&b->next, f, l);
 }
 
-_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_stailq_node *zf_stailq_begin(struct zf_stailq_head *const h)
+#if defined(ZF_QUEUE_STATS)
+/* number of nodes from n to the end */
+_ZF_QUEUE_DECL
+size_t _zf_list_length(struct zf_list_node *n)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return h->first.next;
+	size_t count = 0;
+	for (; 0 != n; n = n->next)
+	{
+		++count;
+	}
+	return count;
 }
+#endif
 
-_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_stailq_node *zf_stailq_end(struct zf_stailq_head *const h)
+_ZF_QUEUE_DECL
+void zf_list_split(struct zf_list_head *const h,
+				   struct zf_list_node *const n,
+				   struct zf_list_head *const h2)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return (void)h, (zf_stailq_node *)0;
+	(void)h;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, _zf_list_length(n));
+	*n->pprev = 0;
+	h2->first = n;
+	n->pprev = &h2->first;
 }
 
-_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_stailq_node *zf_stailq_next(struct zf_stailq_node *const n)
+/* link n[0] <-> ... <-> n[count - 1], count must be > 0 */
+_ZF_QUEUE_DECL
+void _zf_list_chain_bulk(struct zf_list_node *const *const n,
+						 const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return n->next;
+	for (size_t i = 1; count > i; ++i)
+	{
+		if (count > i + ZF_QUEUE_PREFETCH_DISTANCE)
+		{
+			_ZF_QUEUE_PREFETCH_W(n[i + ZF_QUEUE_PREFETCH_DISTANCE]);
+		}
+		n[i - 1]->next = n[i];
+		n[i]->pprev = &n[i - 1]->next;
+	}
 }
 
+/* link count > 0 nodes stride bytes apart, return the last one */
 _ZF_QUEUE_DECL
-void zf_stailq_insert_head(struct zf_stailq_head *const h,
-						   struct zf_stailq_node *const n)
+struct zf_list_node *_zf_list_chain_strided(struct zf_list_node *n,
+											const size_t stride,
+											const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	if (0 == (n->next = h->first.next))
+	for (size_t i = 1; count > i; ++i)
 	{
-		h->last = n;
+		struct zf_list_node *const next =
+				(struct zf_list_node *)((char *)n + stride);
+		n->next = next;
+		next->pprev = &n->next;
+		n = next;
 	}
-	h->first.next = n;
+	return n;
 }
 
 _ZF_QUEUE_DECL
-void zf_stailq_insert_tail(struct zf_stailq_head *const h,
-						   struct zf_stailq_node *const n)
+void zf_list_insert_head_bulk(struct zf_list_head *const h,
+							  struct zf_list_node *const *const n,
+							  const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	n->next = 0;
-	h->last->next = n;
-	h->last = n;
+	if (0 != count)
+	{
+		_zf_list_chain_bulk(n, count);
+		_zf_list_link(&h->first, n[0], n[count - 1]);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
 }
 
+/* insert n[] after b */
 _ZF_QUEUE_DECL
-void zf_stailq_insert_after(struct zf_stailq_head *const h,
-							struct zf_stailq_node *const p,
-							struct zf_stailq_node *const n)
+void zf_list_insert_after_bulk(struct zf_list_node *const b,
+							   struct zf_list_node *const *const n,
+							   const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	if (0 == (n->next = p->next))
+	if (0 != count)
 	{
-		h->last = n;
+		_zf_list_chain_bulk(n, count);
+		_zf_list_link(&b->next, n[0], n[count - 1]);
 	}
-	p->next = n;
 }
 
 _ZF_QUEUE_DECL
-void zf_stailq_remove_head(struct zf_stailq_head *const h)
+void zf_list_insert_head_bulk_strided(struct zf_list_head *const h,
+									  struct zf_list_node *const n,
+									  const size_t stride, const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	if (0 == (h->first.next = h->first.next->next))
+	if (0 != count)
 	{
-		h->last = &h->first;
+		_zf_list_link(&h->first, n, _zf_list_chain_strided(n, stride, count));
+		_ZF_QUEUE_STATS_INSERT(h, count);
 	}
 }
 
+/* insert nodes starting from n after b */
 _ZF_QUEUE_DECL
-void zf_stailq_remove_after(struct zf_stailq_head *const h,
-							struct zf_stailq_node *const n)
+void zf_list_insert_after_bulk_strided(struct zf_list_node *const b,
+									   struct zf_list_node *const n,
+									   const size_t stride, const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	if (0 == (n->next = n->next->next))
+	if (0 != count)
 	{
-		h->last = n;
+		_zf_list_link(&b->next, n, _zf_list_chain_strided(n, stride, count));
+	}
+}
+
+/* prefetch up to k nodes after n and their payload, return the last one */
+_ZF_QUEUE_DECL
+struct zf_list_node *_zf_list_prefetch_lead(struct zf_list_node *n,
+											unsigned k,
+											const ptrdiff_t offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (; 0 != n && 0 != k; --k)
+	{
+		if (0 != (n = n->next))
+		{
+			_ZF_QUEUE_PREFETCH(n);
+			_ZF_QUEUE_PREFETCH((char *)n + offset);
+		}
+	}
+	return n;
+}
+
+#define zf_list_foreach_prefetch(h, n, k, offset) \
+	for (struct zf_list_node *n = (h)->first, \
+		 *_zf_lead_##n = _zf_list_prefetch_lead(n, (k), (offset)); \
+		 0 != n; \
+		 n = _ZF_QUEUE_STATS_NEXT(h, n->next), \
+		 _zf_lead_##n = _zf_list_prefetch_lead(_zf_lead_##n, 1, (offset)))
+
+/* relink nodes in order of their addresses (LSD radix sort by address) */
+_ZF_QUEUE_DECL
+void zf_list_relink(struct zf_list_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_list_node *bf[_ZF_QUEUE_RADIX_BUCKETS];
+	struct zf_list_node **bl[_ZF_QUEUE_RADIX_BUCKETS];
+	uintptr_t k_or = 0, k_and = ~(uintptr_t)0;
+	for (struct zf_list_node *n = h->first; 0 != n; n = n->next)
+	{
+		k_or |= (uintptr_t)n;
+		k_and &= (uintptr_t)n;
+	}
+	for (unsigned shift = 0; 8 * sizeof(uintptr_t) > shift;
+		 shift += _ZF_QUEUE_RADIX_BITS)
+	{
+		if (0 == (_ZF_QUEUE_RADIX_MASK & ((k_or ^ k_and) >> shift)))
+		{
+			continue;
+		}
+		for (unsigned i = 0; _ZF_QUEUE_RADIX_BUCKETS > i; ++i)
+		{
+			bl[i] = &bf[i];
+		}
+		for (struct zf_list_node *n = h->first; 0 != n; n = n->next)
+		{
+			const uintptr_t i = _ZF_QUEUE_RADIX_MASK & ((uintptr_t)n >> shift);
+			*bl[i] = n;
+			bl[i] = &n->next;
+		}
+		struct zf_list_node **pl = &h->first;
+		for (unsigned i = 0; _ZF_QUEUE_RADIX_BUCKETS > i; ++i)
+		{
+			if (&bf[i] != bl[i])
+			{
+				*pl = bf[i];
+				pl = bl[i];
+			}
+		}
+		*pl = 0;
+	}
+	for (struct zf_list_node **pp = &h->first; 0 != *pp; pp = &(*pp)->next)
+	{
+		(*pp)->pprev = pp;
+	}
+}
+
+/* returns number of steps that go backward or more than max_gap bytes forward */
+_ZF_QUEUE_DECL
+size_t zf_list_disorder(struct zf_list_head *const h, const size_t max_gap,
+						size_t *const count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t breaks = 0, total = 0;
+	for (struct zf_list_node *n = h->first; 0 != n; n = n->next)
+	{
+		++total;
+		if (0 != n->next && _zf_queue_disorder_step(n, n->next, max_gap))
+		{
+			++breaks;
+		}
+	}
+	_ZF_QUEUE_STATS_STEP(h, total);
+	if (0 != count)
+	{
+		*count = total;
+	}
+	return breaks;
+}
+
+/* move entries into slab in list order, returns number of entries */
+_ZF_QUEUE_DECL
+size_t zf_list_compact(struct zf_list_head *const h, void *const slab,
+					   const size_t capacity, const size_t entry_size,
+					   const size_t node_offset,
+					   void (*const move)(void *dst, void *src, void *ctx),
+					   void *const ctx)
+{
+	size_t count = 0;
+	for (struct zf_list_node *n = h->first; 0 != n; n = n->next)
+	{
+		++count;
+	}
+	if (count > capacity)
+	{
+		return count;
+	}
+	char *dst = (char *)slab;
+	struct zf_list_node *lead = _zf_list_prefetch_lead(
+			h->first, ZF_QUEUE_PREFETCH_DISTANCE, -(ptrdiff_t)node_offset);
+	for (struct zf_list_node *n = h->first, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_list_prefetch_lead(lead, 1, -(ptrdiff_t)node_offset);
+		move(dst, (char *)n - node_offset, ctx);
+		dst += entry_size;
+	}
+	struct zf_list_node *const f =
+			(struct zf_list_node *)((char *)slab + node_offset);
+	_ZF_QUEUE_STATS_SAVE(h);
+	zf_list_init(h);
+	zf_list_insert_head_bulk_strided(h, f, entry_size, count);
+	_ZF_QUEUE_STATS_RESTORE(h);
+	return count;
+}
+
+/* move nodes for which pred(n, ctx) is true to h2 (in the same order) */
+_ZF_QUEUE_DECL
+size_t zf_list_partition(struct zf_list_head *const h,
+						 struct zf_list_head *const h2,
+						 bool (*const pred)(struct zf_list_node *, void *),
+						 void *const ctx)
+{
+	size_t moved = 0;
+	struct zf_list_node **t1 = &h->first, **t2 = &h2->first;
+	struct zf_list_node *lead = _zf_list_prefetch_lead(
+			h->first, ZF_QUEUE_PREFETCH_DISTANCE, 0);
+	for (struct zf_list_node *n = h->first, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_list_prefetch_lead(lead, 1, 0);
+		if (pred(n, ctx))
+		{
+			*t2 = n;
+			n->pprev = t2;
+			t2 = &n->next;
+			++moved;
+		}
+		else
+		{
+			*t1 = n;
+			n->pprev = t1;
+			t1 = &n->next;
+		}
+	}
+	*t1 = 0;
+	*t2 = 0;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, moved);
+	return moved;
+}
+
+/* remove nodes for which pred(n, ctx) is true, then call dispose(n, ctx) for
+ * each of them (when dispose is not 0) */
+_ZF_QUEUE_DECL
+size_t zf_list_remove_if(struct zf_list_head *const h,
+						 bool (*const pred)(struct zf_list_node *, void *),
+						 void (*const dispose)(struct zf_list_node *, void *),
+						 void *const ctx)
+{
+	struct zf_list_head d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	const size_t removed = zf_list_partition(h, &d, pred, ctx);
+	if (0 != dispose)
+	{
+		for (struct zf_list_node *n = d.first, *next; 0 != n; n = next)
+		{
+			next = n->next;
+			dispose(n, ctx);
+		}
+	}
+	return removed;
+}
+
+/* move nodes for which eq(p, n, ctx) is true for previous kept node p to h2 */
+_ZF_QUEUE_DECL
+size_t zf_list_unique(struct zf_list_head *const h,
+					  struct zf_list_head *const h2,
+					  bool (*const eq)(struct zf_list_node *,
+									   struct zf_list_node *, void *),
+					  void *const ctx)
+{
+	size_t moved = 0;
+	struct zf_list_node **t1 = &h->first, **t2 = &h2->first;
+	struct zf_list_node *p = 0;
+	struct zf_list_node *lead = _zf_list_prefetch_lead(
+			h->first, ZF_QUEUE_PREFETCH_DISTANCE, 0);
+	for (struct zf_list_node *n = h->first, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_list_prefetch_lead(lead, 1, 0);
+		if (0 != p && eq(p, n, ctx))
+		{
+			*t2 = n;
+			n->pprev = t2;
+			t2 = &n->next;
+			++moved;
+		}
+		else
+		{
+			*t1 = n;
+			n->pprev = t1;
+			t1 = &n->next;
+			p = n;
+		}
 	}
+	*t1 = 0;
+	*t2 = 0;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, moved);
+	return moved;
 }
 
 /*
- * Tail queue
+ * Singly-linked tail queue
  */
-typedef struct zf_tailq_node
+typedef struct zf_stailq_node
 {
-	struct zf_tailq_node *next;
-	struct zf_tailq_node *prev;
+	struct zf_stailq_node *next;
 }
-zf_tailq_node;
+zf_stailq_node;
 
-typedef struct zf_tailq_head
+typedef struct zf_stailq_head
 {
-	struct zf_tailq_node head;
+	struct zf_stailq_node first;
+	struct zf_stailq_node *last;
+	_ZF_QUEUE_STATS_FIELD
 }
-zf_tailq_head;
+zf_stailq_head;
 
-#define ZF_TAILQ_INITIALIZER(h) {{0, &(h)->head}}
+#define ZF_STAILQ_INITIALIZER(h) \
+	{{0}, &(h)->first _ZF_QUEUE_STATS_INITIALIZER}
 
 #ifdef __cplusplus
 	_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-	zf_tailq_head _zf_tailq_initializer(zf_tailq_head *const h)
+	zf_stailq_head _zf_stailq_initializer(zf_stailq_head *const h)
 		_ZF_QUEUE_NOEXCEPT
 	{
 	#if __cplusplus >= 201103L
-		return ZF_TAILQ_INITIALIZER(h);
+		return ZF_STAILQ_INITIALIZER(h);
 	#else
-		const zf_tailq_head init = ZF_TAILQ_INITIALIZER(h);
+		const zf_stailq_head init = ZF_STAILQ_INITIALIZER(h);
 		return init;
 	#endif
 	}
-	#undef ZF_TAILQ_INITIALIZER
-	#define ZF_TAILQ_INITIALIZER(h) _zf_tailq_initializer((h))
+	#undef ZF_STAILQ_INITIALIZER
+	#define ZF_STAILQ_INITIALIZER(h) _zf_stailq_initializer(h)
 #endif
 
 _ZF_QUEUE_DECL
-void zf_tailq_init(struct zf_tailq_head *const h)
+void zf_stailq_init(struct zf_stailq_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	h->head.next = 0;
-	h->head.prev = &h->head;
+	h->first.next = 0;
+	h->last = &h->first;
+	_ZF_QUEUE_STATS_INIT(h);
 }
 
 _ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-bool zf_tailq_empty(struct zf_tailq_head *const h)
+bool zf_stailq_empty(struct zf_stailq_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return 0 == h->head.next;
+	return 0 == h->first.next;
 }
 
 _ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_tailq_node *zf_tailq_first(struct zf_tailq_head *const h)
+struct zf_stailq_node *zf_stailq_first(struct zf_stailq_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return h->head.next;
+	return h->first.next;
 }
 
 _ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_tailq_node *zf_tailq_last(struct zf_tailq_head *const h)
+struct zf_stailq_node *zf_stailq_last(struct zf_stailq_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return h->head.prev->prev->next;
+	return 0 == h->first.next? 0: h->last;
 }
 
 _ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_tailq_node *zf_tailq_begin(struct zf_tailq_head *const h)
+struct zf_stailq_node *zf_stailq_begin(struct zf_stailq_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return h->head.next;
+	return h->first.next;
 }
 
 _ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_tailq_node *zf_tailq_end(struct zf_tailq_head *const h)
+struct zf_stailq_node *zf_stailq_end(struct zf_stailq_head *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return (void)h, (zf_tailq_node *)0;
+	return (void)h, (zf_stailq_node *)0;
 }
 
 _ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_tailq_node *zf_tailq_next(struct zf_tailq_node *const n)
+struct zf_stailq_node *zf_stailq_next(struct zf_stailq_node *const n)
 	_ZF_QUEUE_NOEXCEPT
 {
 	return n->next;
 }
 
-_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
-struct zf_tailq_node *zf_tailq_prev(struct zf_tailq_node *const n)
+_ZF_QUEUE_DECL
+void zf_stailq_insert_head(struct zf_stailq_head *const h,
+						   struct zf_stailq_node *const n)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return n->prev->prev->next;
+	_ZF_QUEUE_PROBE(stailq_insert, h, n);
+	if (0 == (n->next = h->first.next))
+	{
+		h->last = n;
+	}
+	h->first.next = n;
+	_ZF_QUEUE_STATS_INSERT(h, 1);
 }
 
 _ZF_QUEUE_DECL
-void zf_tailq_insert_head(struct zf_tailq_head *const h,
-						  struct zf_tailq_node *const n)
+void zf_stailq_insert_tail(struct zf_stailq_head *const h,
+						   struct zf_stailq_node *const n)
 	_ZF_QUEUE_NOEXCEPT
 {
-	if (0 != (n->next = h->head.next))
+	_ZF_QUEUE_PROBE(stailq_insert, h, n);
+	n->next = 0;
+	h->last->next = n;
+	h->last = n;
+	_ZF_QUEUE_STATS_INSERT(h, 1);
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_insert_after(struct zf_stailq_head *const h,
+							struct zf_stailq_node *const p,
+							struct zf_stailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_PROBE(stailq_insert, h, n);
+	if (0 == (n->next = p->next))
 	{
-		h->head.next->prev = n;
+		h->last = n;
 	}
-	else
+	p->next = n;
+	_ZF_QUEUE_STATS_INSERT(h, 1);
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_remove_head(struct zf_stailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_PROBE(stailq_dequeue, h, h->first.next);
+	if (0 == (h->first.next = h->first.next->next))
 	{
-		h->head.prev = n;
+		h->last = &h->first;
 	}
-	h->head.next = n;
-	n->prev = &(h->head);
+	_ZF_QUEUE_STATS_REMOVE(h, 1);
 }
 
 _ZF_QUEUE_DECL
-void zf_tailq_insert_tail(struct zf_tailq_head *const h,
-						  struct zf_tailq_node *const n)
+void zf_stailq_remove_after(struct zf_stailq_head *const h,
+							struct zf_stailq_node *const n)
 	_ZF_QUEUE_NOEXCEPT
 {
-	n->next = 0;
-	n->prev = h->head.prev;
-	h->head.prev->next = n;
-	h->head.prev = n;
+	_ZF_QUEUE_PROBE(stailq_remove, h, n->next);
+	if (0 == (n->next = n->next->next))
+	{
+		h->last = n;
+	}
+	_ZF_QUEUE_STATS_REMOVE(h, 1);
 }
 
 _ZF_QUEUE_DECL
-void zf_tailq_insert_before(struct zf_tailq_node *const p,
-							struct zf_tailq_node *const n)
+void zf_stailq_swap(struct zf_stailq_head *const h1,
+					struct zf_stailq_head *const h2)
 	_ZF_QUEUE_NOEXCEPT
 {
-	n->next = p;
-	n->prev = p->prev;
-	p->prev->next = n;
-	p->prev = n;
+	struct zf_stailq_node *const first = h1->first.next;
+	struct zf_stailq_node *const last = h1->last;
+	h1->first.next = h2->first.next;
+	h1->last = 0 == h2->first.next? &h1->first: h2->last;
+	h2->first.next = first;
+	h2->last = 0 == first? &h2->first: last;
+	_ZF_QUEUE_STATS_SWAP(h1, h2);
 }
 
 _ZF_QUEUE_DECL
-void zf_tailq_insert_after(struct zf_tailq_head *const h,
-						   struct zf_tailq_node *const p,
-						   struct zf_tailq_node *const n)
+void zf_stailq_concat(struct zf_stailq_head *const h1,
+					  struct zf_stailq_head *const h2)
 	_ZF_QUEUE_NOEXCEPT
 {
-	if (0 != (n->next = p->next))
+	_ZF_QUEUE_PROBE(stailq_concat, h1, h2);
+	if (0 != h2->first.next)
 	{
-		n->next->prev = n;
+		h1->last->next = h2->first.next;
+		h1->last = h2->last;
+		h2->first.next = 0;
+		h2->last = &h2->first;
+		_ZF_QUEUE_STATS_MOVE_ALL(h2, h1);
 	}
-	else
+}
+
+/* link chain [f, l] after b in h */
+_ZF_QUEUE_DECL
+void _zf_stailq_link(struct zf_stailq_head *const h,
+					 struct zf_stailq_node *const b,
+					 struct zf_stailq_node *const f,
+					 struct zf_stailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 == (l->next = b->next))
 	{
-		h->head.prev = n;
+		h->last = l;
 	}
-	p->next = n;
-	n->prev = p;
+	b->next = f;
 }
 
+#if defined(ZF_QUEUE_STATS)
+/* number of nodes in range [f, l] (from f to the end when l is 0) */
 _ZF_QUEUE_DECL
-void zf_tailq_remove(struct zf_tailq_head *const h,
-					 struct zf_tailq_node *const n)
+size_t _zf_stailq_range_length(struct zf_stailq_node *f,
+							   struct zf_stailq_node *const l)
 	_ZF_QUEUE_NOEXCEPT
 {
-	if (0 != n->next)
+	size_t count = 0;
+	for (; 0 != f; f = f->next)
 	{
-		n->next->prev = n->prev;
+		++count;
+		if (l == f)
+		{
+			break;
+		}
 	}
-	else
+	return count;
+}
+#endif
+
+/* unlink range (p, l] from h2 and link it after b in h */
+_ZF_QUEUE_DECL
+void _zf_stailq_splice(struct zf_stailq_head *const h,
+					   struct zf_stailq_node *const b,
+					   struct zf_stailq_head *const h2,
+					   struct zf_stailq_node *p,
+					   struct zf_stailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 == p)
 	{
-		h->head.prev = n->prev;
+		p = &h2->first;
 	}
-	n->prev->next = n->next;
+	struct zf_stailq_node *const f = p->next;
+	_ZF_QUEUE_STATS_MOVE(h2, h, _zf_stailq_range_length(f, l));
+	if (0 == (p->next = l->next))
+	{
+		h2->last = p;
+	}
+	_zf_stailq_link(h, b, f, l);
 }
 
-#define zf_tailq_foreach(h, n) \
-	for (struct zf_tailq_node *n = (h)->head.next; 0 != n; n = n->next)
-
-#define zf_tailq_foreach_from(f, n) \
-	for (struct zf_tailq_node *n = (f); 0 != n; n = n->next)
-
-/* C++ support */
-#ifdef __cplusplus
+_ZF_QUEUE_DECL
+void zf_stailq_splice_head(struct zf_stailq_head *const h,
+						   struct zf_stailq_head *const h2,
+						   struct zf_stailq_node *const p,
+						   struct zf_stailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_stailq_splice(h, &h->first, h2, p, l);
+}
 
-template <typename Entry, typename Node>
-_ZF_QUEUE_CONSTEXPR
-Entry *zf_entry_(Node *const node, Node Entry::* field)
+_ZF_QUEUE_DECL
+void zf_stailq_splice_tail(struct zf_stailq_head *const h,
+						   struct zf_stailq_head *const h2,
+						   struct zf_stailq_node *const p,
+						   struct zf_stailq_node *const l)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return (Entry* )((char *)node - (size_t)&((Entry *)0->*field));
+	if (l != h->last)
+	{
+		_zf_stailq_splice(h, h->last, h2, p, l);
+	}
+}
+
+/* move range (p, l] from h2 after b in h */
+_ZF_QUEUE_DECL
+void zf_stailq_splice_after(struct zf_stailq_head *const h,
+							struct zf_stailq_node *const b,
+							struct zf_stailq_head *const h2,
+							struct zf_stailq_node *const p,
+							struct zf_stailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_stailq_splice(h, b, h2, p, l);
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_split_after(struct zf_stailq_head *const h,
+						   struct zf_stailq_node *p,
+						   struct zf_stailq_head *const h2)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 == p)
+	{
+		p = &h->first;
+	}
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, _zf_stailq_range_length(p->next, 0));
+	if (0 == (h2->first.next = p->next))
+	{
+		h2->last = &h2->first;
+	}
+	else
+	{
+		h2->last = h->last;
+		p->next = 0;
+		h->last = p;
+	}
+}
+
+/* link n[0] -> ... -> n[count - 1], count must be > 0 */
+_ZF_QUEUE_DECL
+void _zf_stailq_chain_bulk(struct zf_stailq_node *const *const n,
+						   const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		if (count > i + ZF_QUEUE_PREFETCH_DISTANCE)
+		{
+			_ZF_QUEUE_PREFETCH_W(n[i + ZF_QUEUE_PREFETCH_DISTANCE]);
+		}
+		n[i - 1]->next = n[i];
+	}
+}
+
+/* link count > 0 nodes stride bytes apart, return the last one */
+_ZF_QUEUE_DECL
+struct zf_stailq_node *_zf_stailq_chain_strided(struct zf_stailq_node *n,
+												const size_t stride,
+												const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		n = n->next = (struct zf_stailq_node *)((char *)n + stride);
+	}
+	return n;
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_insert_head_bulk(struct zf_stailq_head *const h,
+								struct zf_stailq_node *const *const n,
+								const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_stailq_chain_bulk(n, count);
+		_zf_stailq_link(h, &h->first, n[0], n[count - 1]);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_insert_tail_bulk(struct zf_stailq_head *const h,
+								struct zf_stailq_node *const *const n,
+								const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_stailq_chain_bulk(n, count);
+		_zf_stailq_link(h, h->last, n[0], n[count - 1]);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_insert_after_bulk(struct zf_stailq_head *const h,
+								 struct zf_stailq_node *const p,
+								 struct zf_stailq_node *const *const n,
+								 const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_stailq_chain_bulk(n, count);
+		_zf_stailq_link(h, p, n[0], n[count - 1]);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_insert_head_bulk_strided(struct zf_stailq_head *const h,
+										struct zf_stailq_node *const n,
+										const size_t stride,
+										const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_stailq_link(h, &h->first, n,
+						_zf_stailq_chain_strided(n, stride, count));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_insert_tail_bulk_strided(struct zf_stailq_head *const h,
+										struct zf_stailq_node *const n,
+										const size_t stride,
+										const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_stailq_link(h, h->last, n,
+						_zf_stailq_chain_strided(n, stride, count));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_insert_after_bulk_strided(struct zf_stailq_head *const h,
+										 struct zf_stailq_node *const p,
+										 struct zf_stailq_node *const n,
+										 const size_t stride,
+										 const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_stailq_link(h, p, n, _zf_stailq_chain_strided(n, stride, count));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+/* true when first entry of a goes before first entry of b */
+_ZF_QUEUE_DECL
+bool _zf_stailq_merge_before(struct zf_stailq_head *const in,
+							 const size_t a, const size_t b,
+							 int (*const cmp)(struct zf_stailq_node *,
+											  struct zf_stailq_node *, void *),
+							 void *const ctx)
+{
+	if (0 == in[a].first.next)
+	{
+		return false;
+	}
+	if (0 == in[b].first.next)
+	{
+		return true;
+	}
+	const int c = cmp(in[a].first.next, in[b].first.next, ctx);
+	return 0 > c || (0 == c && a < b);
+}
+
+/* store losers of subtree t in tree[], return the winner */
+_ZF_QUEUE_DECL
+size_t _zf_stailq_merge_build(struct zf_stailq_head *const in, const size_t k,
+							  size_t *const tree, const size_t t,
+							  int (*const cmp)(struct zf_stailq_node *,
+											   struct zf_stailq_node *, void *),
+							  void *const ctx)
+{
+	if (k <= t)
+	{
+		return t - k;
+	}
+	const size_t a = _zf_stailq_merge_build(in, k, tree, 2 * t, cmp, ctx);
+	const size_t b = _zf_stailq_merge_build(in, k, tree, 2 * t + 1, cmp, ctx);
+	if (_zf_stailq_merge_before(in, b, a, cmp, ctx))
+	{
+		tree[t] = a;
+		return b;
+	}
+	tree[t] = b;
+	return a;
+}
+
+_ZF_QUEUE_DECL
+size_t zf_stailq_merge(struct zf_stailq_head *const h,
+					   struct zf_stailq_head *const in, const size_t k,
+					   size_t *const tree,
+					   int (*const cmp)(struct zf_stailq_node *,
+										struct zf_stailq_node *, void *),
+					   void *const ctx, const size_t limit)
+{
+	if (0 == k)
+	{
+		return 0;
+	}
+	size_t w = _zf_stailq_merge_build(in, k, tree, 1, cmp, ctx);
+	size_t count = 0;
+	for (; limit > count && 0 != in[w].first.next; ++count)
+	{
+		struct zf_stailq_node *const n = in[w].first.next;
+		zf_stailq_remove_head(&in[w]);
+		zf_stailq_insert_tail(h, n);
+		for (size_t t = (w + k) / 2; 0 < t; t /= 2)
+		{
+			if (_zf_stailq_merge_before(in, tree[t], w, cmp, ctx))
+			{
+				const size_t l = tree[t];
+				tree[t] = w;
+				w = l;
+			}
+		}
+	}
+	return count;
+}
+
+_ZF_QUEUE_DECL
+void zf_stailq_radix_sort(struct zf_stailq_head *const h,
+						  uint64_t (*const key)(struct zf_stailq_node *, void *),
+						  void *const ctx)
+{
+	/* buckets are linked directly, temporary heads would fire probes and
+	 * update stats */
+	struct zf_stailq_node bf[_ZF_QUEUE_RADIX_BUCKETS];
+	struct zf_stailq_node *bl[_ZF_QUEUE_RADIX_BUCKETS];
+	uint64_t k_or = 0, k_and = ~(uint64_t)0;
+	for (unsigned shift = 0; _ZF_QUEUE_RADIX_KEY_BITS > shift;
+		 shift += _ZF_QUEUE_RADIX_BITS)
+	{
+		if (0 != shift && 0 == (_ZF_QUEUE_RADIX_MASK & ((k_or ^ k_and) >> shift)))
+		{
+			continue;
+		}
+		for (unsigned i = 0; _ZF_QUEUE_RADIX_BUCKETS > i; ++i)
+		{
+			bl[i] = &bf[i];
+		}
+		for (struct zf_stailq_node *n = h->first.next; 0 != n; n = n->next)
+		{
+			const uint64_t k = key(n, ctx);
+			const unsigned i = _ZF_QUEUE_RADIX_MASK & (unsigned)(k >> shift);
+			k_or |= k;
+			k_and &= k;
+			bl[i]->next = n;
+			bl[i] = n;
+		}
+		struct zf_stailq_node *t = &h->first;
+		for (unsigned i = 0; _ZF_QUEUE_RADIX_BUCKETS > i; ++i)
+		{
+			if (&bf[i] != bl[i])
+			{
+				t->next = bf[i].next;
+				t = bl[i];
+			}
+		}
+		t->next = 0;
+		h->last = t;
+	}
+}
+
+/* prefetch up to k nodes after n and their payload, return the last one */
+_ZF_QUEUE_DECL
+struct zf_stailq_node *_zf_stailq_prefetch_lead(struct zf_stailq_node *n,
+												unsigned k,
+												const ptrdiff_t offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (; 0 != n && 0 != k; --k)
+	{
+		if (0 != (n = n->next))
+		{
+			_ZF_QUEUE_PREFETCH(n);
+			_ZF_QUEUE_PREFETCH((char *)n + offset);
+		}
+	}
+	return n;
+}
+
+#define zf_stailq_foreach_prefetch(h, n, k, offset) \
+	for (struct zf_stailq_node *n = (h)->first.next, \
+		 *_zf_lead_##n = _zf_stailq_prefetch_lead(n, (k), (offset)); \
+		 0 != n; \
+		 n = _ZF_QUEUE_STATS_NEXT(h, n->next), \
+		 _zf_lead_##n = _zf_stailq_prefetch_lead(_zf_lead_##n, 1, (offset)))
+
+_ZF_QUEUE_DECL
+uint64_t _zf_stailq_address_key(struct zf_stailq_node *const n, void *const ctx)
+	_ZF_QUEUE_NOEXCEPT
+{
+	(void)ctx;
+	return (uintptr_t)n;
+}
+
+/* relink nodes in order of their addresses */
+_ZF_QUEUE_DECL
+void zf_stailq_relink(struct zf_stailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_stailq_radix_sort(h, _zf_stailq_address_key, 0);
+}
+
+/* returns number of steps that go backward or more than max_gap bytes forward */
+_ZF_QUEUE_DECL
+size_t zf_stailq_disorder(struct zf_stailq_head *const h, const size_t max_gap,
+						  size_t *const count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t breaks = 0, total = 0;
+	for (struct zf_stailq_node *n = h->first.next; 0 != n; n = n->next)
+	{
+		++total;
+		if (0 != n->next && _zf_queue_disorder_step(n, n->next, max_gap))
+		{
+			++breaks;
+		}
+	}
+	_ZF_QUEUE_STATS_STEP(h, total);
+	if (0 != count)
+	{
+		*count = total;
+	}
+	return breaks;
+}
+
+/* move entries into slab in list order, returns number of entries */
+_ZF_QUEUE_DECL
+size_t zf_stailq_compact(struct zf_stailq_head *const h, void *const slab,
+						 const size_t capacity, const size_t entry_size,
+						 const size_t node_offset,
+						 void (*const move)(void *dst, void *src, void *ctx),
+						 void *const ctx)
+{
+	size_t count = 0;
+	for (struct zf_stailq_node *n = h->first.next; 0 != n; n = n->next)
+	{
+		++count;
+	}
+	if (count > capacity)
+	{
+		return count;
+	}
+	char *dst = (char *)slab;
+	struct zf_stailq_node *lead = _zf_stailq_prefetch_lead(
+			h->first.next, ZF_QUEUE_PREFETCH_DISTANCE, -(ptrdiff_t)node_offset);
+	for (struct zf_stailq_node *n = h->first.next, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_stailq_prefetch_lead(lead, 1, -(ptrdiff_t)node_offset);
+		move(dst, (char *)n - node_offset, ctx);
+		dst += entry_size;
+	}
+	struct zf_stailq_node *const f =
+			(struct zf_stailq_node *)((char *)slab + node_offset);
+	_ZF_QUEUE_STATS_SAVE(h);
+	zf_stailq_init(h);
+	zf_stailq_insert_tail_bulk_strided(h, f, entry_size, count);
+	_ZF_QUEUE_STATS_RESTORE(h);
+	return count;
+}
+
+/* move nodes for which pred(n, ctx) is true to h2 (in the same order) */
+_ZF_QUEUE_DECL
+size_t zf_stailq_partition(struct zf_stailq_head *const h,
+						   struct zf_stailq_head *const h2,
+						   bool (*const pred)(struct zf_stailq_node *, void *),
+						   void *const ctx)
+{
+	size_t moved = 0;
+	struct zf_stailq_node *t1 = &h->first, *t2 = &h2->first;
+	struct zf_stailq_node *lead = _zf_stailq_prefetch_lead(
+			h->first.next, ZF_QUEUE_PREFETCH_DISTANCE, 0);
+	for (struct zf_stailq_node *n = h->first.next, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_stailq_prefetch_lead(lead, 1, 0);
+		if (pred(n, ctx))
+		{
+			t2->next = n;
+			t2 = n;
+			++moved;
+		}
+		else
+		{
+			t1->next = n;
+			t1 = n;
+		}
+	}
+	t1->next = 0;
+	h->last = t1;
+	t2->next = 0;
+	h2->last = t2;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, moved);
+	return moved;
+}
+
+/* remove nodes for which pred(n, ctx) is true, then call dispose(n, ctx) for
+ * each of them (when dispose is not 0) */
+_ZF_QUEUE_DECL
+size_t zf_stailq_remove_if(struct zf_stailq_head *const h,
+						   bool (*const pred)(struct zf_stailq_node *, void *),
+						   void (*const dispose)(struct zf_stailq_node *, void *),
+						   void *const ctx)
+{
+	struct zf_stailq_head d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	const size_t removed = zf_stailq_partition(h, &d, pred, ctx);
+	if (0 != dispose)
+	{
+		for (struct zf_stailq_node *n = d.first.next, *next; 0 != n; n = next)
+		{
+			next = n->next;
+			dispose(n, ctx);
+		}
+	}
+	return removed;
+}
+
+/* move nodes for which eq(p, n, ctx) is true for previous kept node p to h2 */
+_ZF_QUEUE_DECL
+size_t zf_stailq_unique(struct zf_stailq_head *const h,
+						struct zf_stailq_head *const h2,
+						bool (*const eq)(struct zf_stailq_node *,
+										 struct zf_stailq_node *, void *),
+						void *const ctx)
+{
+	size_t moved = 0;
+	struct zf_stailq_node *t1 = &h->first, *t2 = &h2->first;
+	struct zf_stailq_node *p = 0;
+	struct zf_stailq_node *lead = _zf_stailq_prefetch_lead(
+			h->first.next, ZF_QUEUE_PREFETCH_DISTANCE, 0);
+	for (struct zf_stailq_node *n = h->first.next, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_stailq_prefetch_lead(lead, 1, 0);
+		if (0 != p && eq(p, n, ctx))
+		{
+			t2->next = n;
+			t2 = n;
+			++moved;
+		}
+		else
+		{
+			t1->next = n;
+			t1 = n;
+			p = n;
+		}
+	}
+	t1->next = 0;
+	h->last = t1;
+	t2->next = 0;
+	h2->last = t2;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, moved);
+	return moved;
+}
+
+/*
+ * Tail queue
+ */
+typedef struct zf_tailq_node
+{
+	struct zf_tailq_node *next;
+	struct zf_tailq_node *prev;
+}
+zf_tailq_node;
+
+typedef struct zf_tailq_head
+{
+	struct zf_tailq_node head;
+	_ZF_QUEUE_STATS_FIELD
+}
+zf_tailq_head;
+
+#define ZF_TAILQ_INITIALIZER(h) {{0, &(h)->head} _ZF_QUEUE_STATS_INITIALIZER}
+
+#ifdef __cplusplus
+	_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+	zf_tailq_head _zf_tailq_initializer(zf_tailq_head *const h)
+		_ZF_QUEUE_NOEXCEPT
+	{
+	#if __cplusplus >= 201103L
+		return ZF_TAILQ_INITIALIZER(h);
+	#else
+		const zf_tailq_head init = ZF_TAILQ_INITIALIZER(h);
+		return init;
+	#endif
+	}
+	#undef ZF_TAILQ_INITIALIZER
+	#define ZF_TAILQ_INITIALIZER(h) _zf_tailq_initializer((h))
+#endif
+
+_ZF_QUEUE_DECL
+void zf_tailq_init(struct zf_tailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	h->head.next = 0;
+	h->head.prev = &h->head;
+	_ZF_QUEUE_STATS_INIT(h);
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+bool zf_tailq_empty(struct zf_tailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return 0 == h->head.next;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+struct zf_tailq_node *zf_tailq_first(struct zf_tailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return h->head.next;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+struct zf_tailq_node *zf_tailq_last(struct zf_tailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return h->head.prev->prev->next;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+struct zf_tailq_node *zf_tailq_begin(struct zf_tailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return h->head.next;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+struct zf_tailq_node *zf_tailq_end(struct zf_tailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return (void)h, (zf_tailq_node *)0;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+struct zf_tailq_node *zf_tailq_next(struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return n->next;
+}
+
+_ZF_QUEUE_DECL _ZF_QUEUE_CONSTEXPR
+struct zf_tailq_node *zf_tailq_prev(struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return n->prev->prev->next;
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_head(struct zf_tailq_head *const h,
+						  struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_PROBE(tailq_insert, h, n);
+	if (0 != (n->next = h->head.next))
+	{
+		h->head.next->prev = n;
+	}
+	else
+	{
+		h->head.prev = n;
+	}
+	h->head.next = n;
+	n->prev = &(h->head);
+	_ZF_QUEUE_STATS_INSERT(h, 1);
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_tail(struct zf_tailq_head *const h,
+						  struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_PROBE(tailq_insert, h, n);
+	n->next = 0;
+	n->prev = h->head.prev;
+	h->head.prev->next = n;
+	h->head.prev = n;
+	_ZF_QUEUE_STATS_INSERT(h, 1);
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_before(struct zf_tailq_node *const p,
+							struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_PROBE(tailq_insert, 0, n);
+	n->next = p;
+	n->prev = p->prev;
+	p->prev->next = n;
+	p->prev = n;
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_after(struct zf_tailq_head *const h,
+						   struct zf_tailq_node *const p,
+						   struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_PROBE(tailq_insert, h, n);
+	if (0 != (n->next = p->next))
+	{
+		n->next->prev = n;
+	}
+	else
+	{
+		h->head.prev = n;
+	}
+	p->next = n;
+	n->prev = p;
+	_ZF_QUEUE_STATS_INSERT(h, 1);
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_remove(struct zf_tailq_head *const h,
+					 struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_PROBE(tailq_remove, h, n);
+	if (0 != n->next)
+	{
+		n->next->prev = n->prev;
+	}
+	else
+	{
+		h->head.prev = n->prev;
+	}
+	n->prev->next = n->next;
+	_ZF_QUEUE_STATS_REMOVE(h, 1);
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_swap(struct zf_tailq_head *const h1,
+				   struct zf_tailq_head *const h2)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_tailq_node *const first = h1->head.next;
+	struct zf_tailq_node *const last = h1->head.prev;
+	if (0 != (h1->head.next = h2->head.next))
+	{
+		h1->head.next->prev = &h1->head;
+		h1->head.prev = h2->head.prev;
+	}
+	else
+	{
+		h1->head.prev = &h1->head;
+	}
+	if (0 != (h2->head.next = first))
+	{
+		first->prev = &h2->head;
+		h2->head.prev = last;
+	}
+	else
+	{
+		h2->head.prev = &h2->head;
+	}
+	_ZF_QUEUE_STATS_SWAP(h1, h2);
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_concat(struct zf_tailq_head *const h1,
+					 struct zf_tailq_head *const h2)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_PROBE(tailq_concat, h1, h2);
+	if (0 != h2->head.next)
+	{
+		h1->head.prev->next = h2->head.next;
+		h2->head.next->prev = h1->head.prev;
+		h1->head.prev = h2->head.prev;
+		h2->head.next = 0;
+		h2->head.prev = &h2->head;
+		_ZF_QUEUE_STATS_MOVE_ALL(h2, h1);
+	}
+}
+
+/* link chain [f, l] after b in h */
+_ZF_QUEUE_DECL
+void _zf_tailq_link(struct zf_tailq_head *const h,
+					struct zf_tailq_node *const b,
+					struct zf_tailq_node *const f,
+					struct zf_tailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != (l->next = b->next))
+	{
+		l->next->prev = l;
+	}
+	else
+	{
+		h->head.prev = l;
+	}
+	b->next = f;
+	f->prev = b;
+}
+
+#if defined(ZF_QUEUE_STATS)
+/* number of nodes in range [f, l] (from f to the end when l is 0) */
+_ZF_QUEUE_DECL
+size_t _zf_tailq_range_length(struct zf_tailq_node *f,
+							  struct zf_tailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t count = 0;
+	for (; 0 != f; f = f->next)
+	{
+		++count;
+		if (l == f)
+		{
+			break;
+		}
+	}
+	return count;
+}
+#endif
+
+/* unlink range [f, l] from h2 and link it after b in h */
+_ZF_QUEUE_DECL
+void _zf_tailq_splice(struct zf_tailq_head *const h,
+					  struct zf_tailq_node *const b,
+					  struct zf_tailq_head *const h2,
+					  struct zf_tailq_node *const f,
+					  struct zf_tailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_STATS_MOVE(h2, h, _zf_tailq_range_length(f, l));
+	if (0 != l->next)
+	{
+		l->next->prev = f->prev;
+	}
+	else
+	{
+		h2->head.prev = f->prev;
+	}
+	f->prev->next = l->next;
+	_zf_tailq_link(h, b, f, l);
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_splice_head(struct zf_tailq_head *const h,
+						  struct zf_tailq_head *const h2,
+						  struct zf_tailq_node *const f,
+						  struct zf_tailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_tailq_splice(h, &h->head, h2, f, l);
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_splice_tail(struct zf_tailq_head *const h,
+						  struct zf_tailq_head *const h2,
+						  struct zf_tailq_node *const f,
+						  struct zf_tailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (l != h->head.prev)
+	{
+		_zf_tailq_splice(h, h->head.prev, h2, f, l);
+	}
+}
+
+/* move range [f, l] from h2 after b in h */
+_ZF_QUEUE_DECL
+void zf_tailq_splice_after(struct zf_tailq_head *const h,
+						   struct zf_tailq_node *const b,
+						   struct zf_tailq_head *const h2,
+						   struct zf_tailq_node *const f,
+						   struct zf_tailq_node *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_tailq_splice(h, b, h2, f, l);
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_split(struct zf_tailq_head *const h,
+					struct zf_tailq_node *const n,
+					struct zf_tailq_head *const h2)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, _zf_tailq_range_length(n, 0));
+	h2->head.next = n;
+	h2->head.prev = h->head.prev;
+	h->head.prev = n->prev;
+	n->prev->next = 0;
+	n->prev = &h2->head;
+}
+
+/* link n[0] <-> ... <-> n[count - 1], count must be > 0 */
+_ZF_QUEUE_DECL
+void _zf_tailq_chain_bulk(struct zf_tailq_node *const *const n,
+						  const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		if (count > i + ZF_QUEUE_PREFETCH_DISTANCE)
+		{
+			_ZF_QUEUE_PREFETCH_W(n[i + ZF_QUEUE_PREFETCH_DISTANCE]);
+		}
+		n[i - 1]->next = n[i];
+		n[i]->prev = n[i - 1];
+	}
+}
+
+/* link count > 0 nodes stride bytes apart, return the last one */
+_ZF_QUEUE_DECL
+struct zf_tailq_node *_zf_tailq_chain_strided(struct zf_tailq_node *n,
+											  const size_t stride,
+											  const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		struct zf_tailq_node *const next =
+				(struct zf_tailq_node *)((char *)n + stride);
+		n->next = next;
+		next->prev = n;
+		n = next;
+	}
+	return n;
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_head_bulk(struct zf_tailq_head *const h,
+							   struct zf_tailq_node *const *const n,
+							   const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_tailq_chain_bulk(n, count);
+		_zf_tailq_link(h, &h->head, n[0], n[count - 1]);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_tail_bulk(struct zf_tailq_head *const h,
+							   struct zf_tailq_node *const *const n,
+							   const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_tailq_chain_bulk(n, count);
+		_zf_tailq_link(h, h->head.prev, n[0], n[count - 1]);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_after_bulk(struct zf_tailq_head *const h,
+								struct zf_tailq_node *const p,
+								struct zf_tailq_node *const *const n,
+								const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_tailq_chain_bulk(n, count);
+		_zf_tailq_link(h, p, n[0], n[count - 1]);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_head_bulk_strided(struct zf_tailq_head *const h,
+									   struct zf_tailq_node *const n,
+									   const size_t stride, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_tailq_link(h, &h->head, n,
+					   _zf_tailq_chain_strided(n, stride, count));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_tail_bulk_strided(struct zf_tailq_head *const h,
+									   struct zf_tailq_node *const n,
+									   const size_t stride, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_tailq_link(h, h->head.prev, n,
+					   _zf_tailq_chain_strided(n, stride, count));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_insert_after_bulk_strided(struct zf_tailq_head *const h,
+										struct zf_tailq_node *const p,
+										struct zf_tailq_node *const n,
+										const size_t stride,
+										const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_tailq_link(h, p, n, _zf_tailq_chain_strided(n, stride, count));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+/* true when first entry of a goes before first entry of b */
+_ZF_QUEUE_DECL
+bool _zf_tailq_merge_before(struct zf_tailq_head *const in,
+							const size_t a, const size_t b,
+							int (*const cmp)(struct zf_tailq_node *,
+											 struct zf_tailq_node *, void *),
+							void *const ctx)
+{
+	if (0 == in[a].head.next)
+	{
+		return false;
+	}
+	if (0 == in[b].head.next)
+	{
+		return true;
+	}
+	const int c = cmp(in[a].head.next, in[b].head.next, ctx);
+	return 0 > c || (0 == c && a < b);
+}
+
+/* store losers of subtree t in tree[], return the winner */
+_ZF_QUEUE_DECL
+size_t _zf_tailq_merge_build(struct zf_tailq_head *const in, const size_t k,
+							 size_t *const tree, const size_t t,
+							 int (*const cmp)(struct zf_tailq_node *,
+											  struct zf_tailq_node *, void *),
+							 void *const ctx)
+{
+	if (k <= t)
+	{
+		return t - k;
+	}
+	const size_t a = _zf_tailq_merge_build(in, k, tree, 2 * t, cmp, ctx);
+	const size_t b = _zf_tailq_merge_build(in, k, tree, 2 * t + 1, cmp, ctx);
+	if (_zf_tailq_merge_before(in, b, a, cmp, ctx))
+	{
+		tree[t] = a;
+		return b;
+	}
+	tree[t] = b;
+	return a;
+}
+
+_ZF_QUEUE_DECL
+size_t zf_tailq_merge(struct zf_tailq_head *const h,
+					  struct zf_tailq_head *const in, const size_t k,
+					  size_t *const tree,
+					  int (*const cmp)(struct zf_tailq_node *,
+										struct zf_tailq_node *, void *),
+					  void *const ctx, const size_t limit)
+{
+	if (0 == k)
+	{
+		return 0;
+	}
+	size_t w = _zf_tailq_merge_build(in, k, tree, 1, cmp, ctx);
+	size_t count = 0;
+	for (; limit > count && 0 != in[w].head.next; ++count)
+	{
+		struct zf_tailq_node *const n = in[w].head.next;
+		zf_tailq_remove(&in[w], n);
+		zf_tailq_insert_tail(h, n);
+		for (size_t t = (w + k) / 2; 0 < t; t /= 2)
+		{
+			if (_zf_tailq_merge_before(in, tree[t], w, cmp, ctx))
+			{
+				const size_t l = tree[t];
+				tree[t] = w;
+				w = l;
+			}
+		}
+	}
+	return count;
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_radix_sort(struct zf_tailq_head *const h,
+						 uint64_t (*const key)(struct zf_tailq_node *, void *),
+						 void *const ctx)
+{
+	/* buckets are linked directly through next pointers (prev pointers are
+	 * restored once at the end), temporary heads would fire probes and update
+	 * stats */
+	struct zf_tailq_node *bf[_ZF_QUEUE_RADIX_BUCKETS];
+	struct zf_tailq_node **bl[_ZF_QUEUE_RADIX_BUCKETS];
+	uint64_t k_or = 0, k_and = ~(uint64_t)0;
+	for (unsigned shift = 0; _ZF_QUEUE_RADIX_KEY_BITS > shift;
+		 shift += _ZF_QUEUE_RADIX_BITS)
+	{
+		if (0 != shift && 0 == (_ZF_QUEUE_RADIX_MASK & ((k_or ^ k_and) >> shift)))
+		{
+			continue;
+		}
+		for (unsigned i = 0; _ZF_QUEUE_RADIX_BUCKETS > i; ++i)
+		{
+			bl[i] = &bf[i];
+		}
+		for (struct zf_tailq_node *n = h->head.next; 0 != n; n = n->next)
+		{
+			const uint64_t k = key(n, ctx);
+			const unsigned i = _ZF_QUEUE_RADIX_MASK & (unsigned)(k >> shift);
+			k_or |= k;
+			k_and &= k;
+			*bl[i] = n;
+			bl[i] = &n->next;
+		}
+		struct zf_tailq_node **pl = &h->head.next;
+		for (unsigned i = 0; _ZF_QUEUE_RADIX_BUCKETS > i; ++i)
+		{
+			if (&bf[i] != bl[i])
+			{
+				*pl = bf[i];
+				pl = bl[i];
+			}
+		}
+		*pl = 0;
+	}
+	struct zf_tailq_node *p = &h->head;
+	for (struct zf_tailq_node *n = h->head.next; 0 != n; n = n->next)
+	{
+		n->prev = p;
+		p = n;
+	}
+	h->head.prev = p;
+}
+
+#define zf_tailq_foreach(h, n) \
+	for (struct zf_tailq_node *n = (h)->head.next; 0 != n; \
+		 n = _ZF_QUEUE_STATS_NEXT(h, n->next))
+
+#define zf_tailq_foreach_from(f, n) \
+	for (struct zf_tailq_node *n = (f); 0 != n; n = n->next)
+
+/* prefetch up to k nodes after n and their payload, return the last one */
+_ZF_QUEUE_DECL
+struct zf_tailq_node *_zf_tailq_prefetch_lead(struct zf_tailq_node *n,
+											  unsigned k,
+											  const ptrdiff_t offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (; 0 != n && 0 != k; --k)
+	{
+		if (0 != (n = n->next))
+		{
+			_ZF_QUEUE_PREFETCH(n);
+			_ZF_QUEUE_PREFETCH((char *)n + offset);
+		}
+	}
+	return n;
+}
+
+#define zf_tailq_foreach_prefetch(h, n, k, offset) \
+	for (struct zf_tailq_node *n = (h)->head.next, \
+		 *_zf_lead_##n = _zf_tailq_prefetch_lead(n, (k), (offset)); \
+		 0 != n; \
+		 n = _ZF_QUEUE_STATS_NEXT(h, n->next), \
+		 _zf_lead_##n = _zf_tailq_prefetch_lead(_zf_lead_##n, 1, (offset)))
+
+_ZF_QUEUE_DECL
+uint64_t _zf_tailq_address_key(struct zf_tailq_node *const n, void *const ctx)
+	_ZF_QUEUE_NOEXCEPT
+{
+	(void)ctx;
+	return (uintptr_t)n;
+}
+
+/* relink nodes in order of their addresses */
+_ZF_QUEUE_DECL
+void zf_tailq_relink(struct zf_tailq_head *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_tailq_radix_sort(h, _zf_tailq_address_key, 0);
+}
+
+/* returns number of steps that go backward or more than max_gap bytes forward */
+_ZF_QUEUE_DECL
+size_t zf_tailq_disorder(struct zf_tailq_head *const h, const size_t max_gap,
+						 size_t *const count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t breaks = 0, total = 0;
+	for (struct zf_tailq_node *n = h->head.next; 0 != n; n = n->next)
+	{
+		++total;
+		if (0 != n->next && _zf_queue_disorder_step(n, n->next, max_gap))
+		{
+			++breaks;
+		}
+	}
+	_ZF_QUEUE_STATS_STEP(h, total);
+	if (0 != count)
+	{
+		*count = total;
+	}
+	return breaks;
+}
+
+/* move entries into slab in list order, returns number of entries */
+_ZF_QUEUE_DECL
+size_t zf_tailq_compact(struct zf_tailq_head *const h, void *const slab,
+						const size_t capacity, const size_t entry_size,
+						const size_t node_offset,
+						void (*const move)(void *dst, void *src, void *ctx),
+						void *const ctx)
+{
+	size_t count = 0;
+	for (struct zf_tailq_node *n = h->head.next; 0 != n; n = n->next)
+	{
+		++count;
+	}
+	if (count > capacity)
+	{
+		return count;
+	}
+	char *dst = (char *)slab;
+	struct zf_tailq_node *lead = _zf_tailq_prefetch_lead(
+			h->head.next, ZF_QUEUE_PREFETCH_DISTANCE, -(ptrdiff_t)node_offset);
+	for (struct zf_tailq_node *n = h->head.next, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_tailq_prefetch_lead(lead, 1, -(ptrdiff_t)node_offset);
+		move(dst, (char *)n - node_offset, ctx);
+		dst += entry_size;
+	}
+	struct zf_tailq_node *const f =
+			(struct zf_tailq_node *)((char *)slab + node_offset);
+	_ZF_QUEUE_STATS_SAVE(h);
+	zf_tailq_init(h);
+	zf_tailq_insert_tail_bulk_strided(h, f, entry_size, count);
+	_ZF_QUEUE_STATS_RESTORE(h);
+	return count;
+}
+
+/* move nodes for which pred(n, ctx) is true to h2 (in the same order) */
+_ZF_QUEUE_DECL
+size_t zf_tailq_partition(struct zf_tailq_head *const h,
+						  struct zf_tailq_head *const h2,
+						  bool (*const pred)(struct zf_tailq_node *, void *),
+						  void *const ctx)
+{
+	size_t moved = 0;
+	struct zf_tailq_node *t1 = &h->head, *t2 = &h2->head;
+	struct zf_tailq_node *lead = _zf_tailq_prefetch_lead(
+			h->head.next, ZF_QUEUE_PREFETCH_DISTANCE, 0);
+	for (struct zf_tailq_node *n = h->head.next, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_tailq_prefetch_lead(lead, 1, 0);
+		if (pred(n, ctx))
+		{
+			t2->next = n;
+			n->prev = t2;
+			t2 = n;
+			++moved;
+		}
+		else
+		{
+			t1->next = n;
+			n->prev = t1;
+			t1 = n;
+		}
+	}
+	t1->next = 0;
+	h->head.prev = t1;
+	t2->next = 0;
+	h2->head.prev = t2;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, moved);
+	return moved;
+}
+
+/* remove nodes for which pred(n, ctx) is true, then call dispose(n, ctx) for
+ * each of them (when dispose is not 0) */
+_ZF_QUEUE_DECL
+size_t zf_tailq_remove_if(struct zf_tailq_head *const h,
+						  bool (*const pred)(struct zf_tailq_node *, void *),
+						  void (*const dispose)(struct zf_tailq_node *, void *),
+						  void *const ctx)
+{
+	struct zf_tailq_head d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	const size_t removed = zf_tailq_partition(h, &d, pred, ctx);
+	if (0 != dispose)
+	{
+		for (struct zf_tailq_node *n = d.head.next, *next; 0 != n; n = next)
+		{
+			next = n->next;
+			dispose(n, ctx);
+		}
+	}
+	return removed;
+}
+
+/* move nodes for which eq(p, n, ctx) is true for previous kept node p to h2 */
+_ZF_QUEUE_DECL
+size_t zf_tailq_unique(struct zf_tailq_head *const h,
+					   struct zf_tailq_head *const h2,
+					   bool (*const eq)(struct zf_tailq_node *,
+										struct zf_tailq_node *, void *),
+					   void *const ctx)
+{
+	size_t moved = 0;
+	struct zf_tailq_node *t1 = &h->head, *t2 = &h2->head;
+	struct zf_tailq_node *p = 0;
+	struct zf_tailq_node *lead = _zf_tailq_prefetch_lead(
+			h->head.next, ZF_QUEUE_PREFETCH_DISTANCE, 0);
+	for (struct zf_tailq_node *n = h->head.next, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		lead = _zf_tailq_prefetch_lead(lead, 1, 0);
+		if (0 != p && eq(p, n, ctx))
+		{
+			t2->next = n;
+			n->prev = t2;
+			t2 = n;
+			++moved;
+		}
+		else
+		{
+			t1->next = n;
+			n->prev = t1;
+			t1 = n;
+			p = n;
+		}
+	}
+	t1->next = 0;
+	h->head.prev = t1;
+	t2->next = 0;
+	h2->head.prev = t2;
+	_ZF_QUEUE_STATS_DISCARD(h2);
+	_ZF_QUEUE_STATS_MOVE(h, h2, moved);
+	return moved;
+}
+
+/* C++ support */
+#ifdef __cplusplus
+
+#include <iterator>
+#include <utility>
+
+/* Offset of field inside the entry. Itanium C++ ABI (GCC, Clang) represents
+ * pointer to data member as the offset itself, so it is read directly instead
+ * of accessing member of null pointer (undefined behaviour that sanitizers
+ * report). Both forms fold to a constant when field is known at compile time.
+ */
+template <typename Entry, typename Node>
+inline size_t _zf_member_offset(Node Entry::* field)
+	_ZF_QUEUE_NOEXCEPT
+{
+#if defined(__GNUC__) && !defined(_MSC_VER)
+	ptrdiff_t offset;
+	typedef char check_size[sizeof(offset) == sizeof(field)? 1: -1];
+	(void)sizeof(check_size);
+	__builtin_memcpy(&offset, &field, sizeof(offset));
+	return (size_t)offset;
+#else
+	return (size_t)&((Entry *)0->*field);
+#endif
+}
+
+template <typename Entry, typename Node>
+_ZF_QUEUE_CONSTEXPR
+Entry *zf_entry_(Node *const node, Node Entry::* field)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return (Entry* )((char *)node - _zf_member_offset(field));
+}
+
+/* Callbacks for C functions that take function pointer and ctx, ctx points to
+ * the C++ functor that is called with entries instead of nodes.
+ */
+template <typename T, typename Node, Node T:: *node, typename P>
+bool _zf_pred_(Node *const n, void *const ctx)
+{
+	return (*(P *)ctx)(zf_entry_(n, node));
+}
+
+template <typename T, typename Node, Node T:: *node, typename E>
+bool _zf_eq_(Node *const a, Node *const b, void *const ctx)
+{
+	return (*(E *)ctx)(zf_entry_(a, node), zf_entry_(b, node));
+}
+
+/* three-way comparison from less(a, b) */
+template <typename T, typename Node, Node T:: *node, typename L>
+int _zf_cmp_(Node *const a, Node *const b, void *const ctx)
+{
+	L &less = *(L *)ctx;
+	T *const ea = zf_entry_(a, node);
+	T *const eb = zf_entry_(b, node);
+	return less(ea, eb)? -1: less(eb, ea)? 1: 0;
+}
+
+template <typename T, typename Node, Node T:: *node, typename K>
+uint64_t _zf_key_(Node *const n, void *const ctx)
+{
+	return (*(K *)ctx)(zf_entry_(n, node));
+}
+
+template <typename T, typename M>
+void _zf_move_(void *const dst, void *const src, void *const ctx)
+{
+	(*(M *)ctx)((T *)dst, (T *)src);
+}
+
+/* Forward iterator over entries of singly-linked list, list or singly-linked
+ * tail queue (all of them have next pointer and 0 at the end). It is a thin
+ * wrapper around node pointer, so loops compile to the same code as loops
+ * over nodes. V is T for iterator and const T for const_iterator, iterator
+ * converts to const_iterator.
+ */
+template <typename T, typename Node, Node T:: *node, typename V = T>
+struct zf_forward_iterator_
+{
+	typedef std::forward_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef ptrdiff_t difference_type;
+	typedef V *pointer;
+	typedef V &reference;
+
+	Node *n;
+#if defined(ZF_QUEUE_STATS)
+	zf_queue_stats *stats;
+
+	zf_forward_iterator_() _ZF_QUEUE_NOEXCEPT: n(0), stats(0) {}
+	explicit zf_forward_iterator_(Node *const n, zf_queue_stats *const s = 0)
+		_ZF_QUEUE_NOEXCEPT: n(n), stats(s) {}
+	zf_forward_iterator_(const zf_forward_iterator_<T, Node, node> &i)
+		_ZF_QUEUE_NOEXCEPT: n(i.n), stats(i.stats) {}
+#else
+	zf_forward_iterator_() _ZF_QUEUE_NOEXCEPT: n(0) {}
+	explicit zf_forward_iterator_(Node *const n) _ZF_QUEUE_NOEXCEPT: n(n) {}
+	zf_forward_iterator_(const zf_forward_iterator_<T, Node, node> &i)
+		_ZF_QUEUE_NOEXCEPT: n(i.n) {}
+#endif
+	V &operator*() const _ZF_QUEUE_NOEXCEPT { return *zf_entry_(n, node); }
+	V *operator->() const _ZF_QUEUE_NOEXCEPT { return zf_entry_(n, node); }
+	zf_forward_iterator_ &operator++() _ZF_QUEUE_NOEXCEPT
+	{
+		n = n->next;
+#if defined(ZF_QUEUE_STATS)
+		if (0 != stats)
+		{
+			_zf_queue_stats_step(&stats->steps, 1);
+		}
+#endif
+		return *this;
+	}
+	zf_forward_iterator_ operator++(int) _ZF_QUEUE_NOEXCEPT
+	{
+		const zf_forward_iterator_ i(*this);
+		++*this;
+		return i;
+	}
+	/* any of iterator and const_iterator on both sides */
+	template <typename W>
+	bool operator==(const zf_forward_iterator_<T, Node, node, W> &i) const
+		_ZF_QUEUE_NOEXCEPT
+	{
+		return n == i.n;
+	}
+	template <typename W>
+	bool operator!=(const zf_forward_iterator_<T, Node, node, W> &i) const
+		_ZF_QUEUE_NOEXCEPT
+	{
+		return n != i.n;
+	}
+};
+
+/* Link policies of C++ list and tail queue heads */
+struct zf_link_fast_
+{
+	enum {safe = 0, auto_unlink = 0};
+};
+
+struct zf_link_safe_
+{
+	enum {safe = 1, auto_unlink = 0};
+};
+
+struct zf_link_auto_
+{
+	enum {safe = 1, auto_unlink = 1};
+};
+
+struct _zf_dispose_none_
+{
+	template <typename T>
+	void operator()(T *const) const _ZF_QUEUE_NOEXCEPT {}
+};
+
+/*
+ * Singly-linked list C++ support
+ */
+template <typename T, zf_slist_node T:: *node>
+struct zf_slist_head_: zf_slist_head
+{
+	typedef zf_forward_iterator_<T, zf_slist_node, node> iterator;
+	typedef zf_forward_iterator_<T, zf_slist_node, node, const T>
+			const_iterator;
+
+	zf_slist_head_() {}
+	zf_slist_head_(const zf_slist_head &h) _ZF_QUEUE_NOEXCEPT: zf_slist_head(h) {}
+	iterator begin() _ZF_QUEUE_NOEXCEPT
+	{
+		return iterator(first _ZF_QUEUE_STATS_ARG);
+	}
+	iterator end() _ZF_QUEUE_NOEXCEPT { return iterator(); }
+	const_iterator begin() const _ZF_QUEUE_NOEXCEPT
+	{
+		return const_iterator(first _ZF_QUEUE_STATS_ARG);
+	}
+	const_iterator end() const _ZF_QUEUE_NOEXCEPT { return const_iterator(); }
+	const_iterator cbegin() const _ZF_QUEUE_NOEXCEPT { return begin(); }
+	const_iterator cend() const _ZF_QUEUE_NOEXCEPT { return end(); }
+};
+
+template <typename T, zf_slist_node T:: *node>
+_ZF_QUEUE_CONSTEXPR
+T *zf_slist_first_(zf_slist_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_slist_first(h), node);
+}
+
+template <typename T, zf_slist_node T:: *node>
+_ZF_QUEUE_CONSTEXPR
+T *zf_slist_begin_(zf_slist_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_slist_begin(h), node);
+}
+
+template <typename T, zf_slist_node T:: *node>
+_ZF_QUEUE_CONSTEXPR
+T *zf_slist_end_(zf_slist_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_slist_end(h), node);
+}
+
+template <typename T, zf_slist_node T:: *node>
+T *zf_slist_next_(const zf_slist_head_<T, node> *const, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_slist_next(&(e->*node)), node);
+}
+
+template <typename T, zf_slist_node T:: *node>
+void zf_slist_insert_head_(zf_slist_head_<T, node> *const h, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_slist_insert_head(h, &(e->*node));
+}
+
+/* insert a after b */
+template <typename T, zf_slist_node T:: *node>
+void zf_slist_insert_after_(zf_slist_head_<T, node> *const h,
+							T *const b, T *const a)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_slist_insert_after(&(b->*node), &(a->*node));
+	_ZF_QUEUE_STATS_INSERT(h, 1);
+}
+
+template <typename T, zf_slist_node T:: *node>
+void zf_slist_remove_after_(zf_slist_head_<T, node> *const h, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_slist_remove_after(&(e->*node));
+	_ZF_QUEUE_STATS_REMOVE(h, 1);
+}
+
+/* link entries e[0] -> ... -> e[count - 1], count must be > 0 */
+template <typename T, zf_slist_node T:: *node>
+void _zf_slist_chain_bulk_(T *const *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		if (count > i + ZF_QUEUE_PREFETCH_DISTANCE)
+		{
+			_ZF_QUEUE_PREFETCH_W(&(e[i + ZF_QUEUE_PREFETCH_DISTANCE]->*node));
+		}
+		(e[i - 1]->*node).next = &(e[i]->*node);
+	}
+}
+
+template <typename T, zf_slist_node T:: *node>
+void zf_slist_insert_head_bulk_(zf_slist_head_<T, node> *const h,
+								T *const *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_slist_chain_bulk_<T, node>(e, count);
+		(e[count - 1]->*node).next = h->first;
+		h->first = &(e[0]->*node);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+template <typename T, zf_slist_node T:: *node>
+void zf_slist_insert_head_bulk_(zf_slist_head_<T, node> *const h,
+								T *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_slist_insert_head_bulk_strided(h, &(e->*node), sizeof(T), count);
+}
+
+/* insert entries e[] after b */
+template <typename T, zf_slist_node T:: *node>
+void zf_slist_insert_after_bulk_(zf_slist_head_<T, node> *const h, T *const b,
+								 T *const *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_slist_chain_bulk_<T, node>(e, count);
+		(e[count - 1]->*node).next = (b->*node).next;
+		(b->*node).next = &(e[0]->*node);
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+template <typename T, zf_slist_node T:: *node>
+void zf_slist_insert_after_bulk_(zf_slist_head_<T, node> *const h, T *const b,
+								 T *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_slist_insert_after_bulk_strided(&(b->*node), &(e->*node),
+									   sizeof(T), count);
+	_ZF_QUEUE_STATS_INSERT(h, count);
+}
+
+/* call f(e) for each entry, prefetch K entries ahead and offset bytes into
+ * each of them */
+template <unsigned K, typename T, zf_slist_node T:: *node, typename F>
+void zf_slist_foreach_prefetch_(zf_slist_head_<T, node> *const h, F f,
+								const ptrdiff_t offset = 0)
+{
+	/* offset of node inside the entry, like zf_entry_() computes it */
+	const ptrdiff_t node_offset =
+			offset - (ptrdiff_t)_zf_member_offset(node);
+	zf_slist_foreach_prefetch(h, n, K, node_offset)
+	{
+		f(zf_entry_(n, node));
+	}
+}
+
+template <typename T, zf_slist_node T:: *node>
+void zf_slist_relink_(zf_slist_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_slist_relink(h);
+}
+
+template <typename T, zf_slist_node T:: *node>
+size_t zf_slist_disorder_(zf_slist_head_<T, node> *const h, const size_t max_gap,
+						  size_t *const count = 0)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_slist_disorder(h, max_gap, count);
+}
+
+/* move entries into slab in list order with move(dst, src) */
+template <typename T, zf_slist_node T:: *node, typename M>
+size_t zf_slist_compact_(zf_slist_head_<T, node> *const h, T *const slab,
+						 const size_t capacity, M move)
+{
+	return zf_slist_compact(h, slab, capacity, sizeof(T),
+							_zf_member_offset(node), _zf_move_<T, M>, &move);
+}
+
+/* move entries for which pred(e) is true to h2 (in the same order) */
+template <typename T, zf_slist_node T:: *node, typename P>
+size_t zf_slist_partition_(zf_slist_head_<T, node> *const h,
+						   zf_slist_head_<T, node> *const h2, P pred)
+{
+	return zf_slist_partition(h, h2, _zf_pred_<T, zf_slist_node, node, P>,
+							  &pred);
+}
+
+/* remove entries for which pred(e) is true, then call dispose(e) for each */
+template <typename T, zf_slist_node T:: *node, typename P, typename D>
+size_t zf_slist_remove_if_(zf_slist_head_<T, node> *const h,
+						   P pred, D dispose)
+{
+	zf_slist_head_<T, node> d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	const size_t removed = zf_slist_partition_(h, &d, pred);
+	for (zf_slist_node *n = d.first, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		dispose(zf_entry_(n, node));
+	}
+	return removed;
+}
+
+template <typename T, zf_slist_node T:: *node, typename P>
+size_t zf_slist_remove_if_(zf_slist_head_<T, node> *const h, P pred)
+{
+	zf_slist_head_<T, node> d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	return zf_slist_partition_(h, &d, pred);
+}
+
+/* move entries for which eq(p, e) is true for previous kept entry p to h2 */
+template <typename T, zf_slist_node T:: *node, typename E>
+size_t zf_slist_unique_(zf_slist_head_<T, node> *const h,
+						zf_slist_head_<T, node> *const h2, E eq)
+{
+	return zf_slist_unique(h, h2, _zf_eq_<T, zf_slist_node, node, E>, &eq);
 }
 
 /*
- * Singly-linked list C++ support
+ * List C++ support
  */
-template <typename T, zf_slist_node T:: *node>
-struct zf_slist_head_: zf_slist_head
+template <typename T, zf_list_node T:: *node, typename Link = zf_link_fast_>
+struct zf_list_head_: zf_list_head
 {
-	zf_slist_head_() {}
-	zf_slist_head_(const zf_slist_head &h) _ZF_QUEUE_NOEXCEPT: zf_slist_head(h) {}
+	typedef zf_forward_iterator_<T, zf_list_node, node> iterator;
+	typedef zf_forward_iterator_<T, zf_list_node, node, const T>
+			const_iterator;
+
+	zf_list_head_() {}
+	zf_list_head_(const zf_list_head &h) _ZF_QUEUE_NOEXCEPT: zf_list_head(h) {}
+	iterator begin() _ZF_QUEUE_NOEXCEPT
+	{
+		return iterator(first _ZF_QUEUE_STATS_ARG);
+	}
+	iterator end() _ZF_QUEUE_NOEXCEPT { return iterator(); }
+	const_iterator begin() const _ZF_QUEUE_NOEXCEPT
+	{
+		return const_iterator(first _ZF_QUEUE_STATS_ARG);
+	}
+	const_iterator end() const _ZF_QUEUE_NOEXCEPT { return const_iterator(); }
+	const_iterator cbegin() const _ZF_QUEUE_NOEXCEPT { return begin(); }
+	const_iterator cend() const _ZF_QUEUE_NOEXCEPT { return end(); }
 };
 
-template <typename T, zf_slist_node T:: *node>
+/* zero pointers of nodes from n to the end of the list */
+_ZF_QUEUE_DECL
+void _zf_list_unlink_all(struct zf_list_node *n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (struct zf_list_node *next; 0 != n; n = next)
+	{
+		next = n->next;
+		n->next = 0;
+		n->pprev = 0;
+	}
+}
+
+template <typename T, zf_list_node T:: *node>
+struct zf_list_head_<T, node, zf_link_auto_>: zf_list_head
+{
+	typedef zf_forward_iterator_<T, zf_list_node, node> iterator;
+	typedef zf_forward_iterator_<T, zf_list_node, node, const T>
+			const_iterator;
+
+	zf_list_head_() {}
+	zf_list_head_(const zf_list_head &h) _ZF_QUEUE_NOEXCEPT: zf_list_head(h) {}
+	~zf_list_head_() { _zf_list_unlink_all(first); }
+	iterator begin() _ZF_QUEUE_NOEXCEPT
+	{
+		return iterator(first _ZF_QUEUE_STATS_ARG);
+	}
+	iterator end() _ZF_QUEUE_NOEXCEPT { return iterator(); }
+	const_iterator begin() const _ZF_QUEUE_NOEXCEPT
+	{
+		return const_iterator(first _ZF_QUEUE_STATS_ARG);
+	}
+	const_iterator end() const _ZF_QUEUE_NOEXCEPT { return const_iterator(); }
+	const_iterator cbegin() const _ZF_QUEUE_NOEXCEPT { return begin(); }
+	const_iterator cend() const _ZF_QUEUE_NOEXCEPT { return end(); }
+};
+
+#if __cplusplus >= 201103L
+/* Entry that removes itself from the list when destroyed. Must be inserted
+ * only into zf_link_auto_ heads. Constructors forward arguments to T and start
+ * unlinked, assignment copies T but keeps node (and position in the list) of
+ * the target.
+ */
+template <typename T, zf_list_node T:: *node>
+struct zf_list_auto_unlink_: T
+{
+	zf_list_auto_unlink_() _ZF_QUEUE_NOEXCEPT
+	{
+		(this->*node).next = 0;
+		(this->*node).pprev = 0;
+	}
+	template <typename A, typename... Args>
+	zf_list_auto_unlink_(A &&a, Args &&...args):
+		T(std::forward<A>(a), std::forward<Args>(args)...)
+	{
+		(this->*node).next = 0;
+		(this->*node).pprev = 0;
+	}
+	zf_list_auto_unlink_(const zf_list_auto_unlink_ &e): T(e)
+	{
+		(this->*node).next = 0;
+		(this->*node).pprev = 0;
+	}
+	zf_list_auto_unlink_ &operator=(const zf_list_auto_unlink_ &e)
+	{
+		const zf_list_node n = this->*node;
+		T::operator=(e);
+		this->*node = n;
+		return *this;
+	}
+	~zf_list_auto_unlink_()
+	{
+		zf_list_node *const n = &(this->*node);
+		if (0 != n->pprev)
+		{
+			zf_list_remove(n);
+		}
+	}
+};
+#endif
+
+template <typename T, zf_list_node T:: *node, typename Link>
 _ZF_QUEUE_CONSTEXPR
-T *zf_slist_first_(zf_slist_head_<T, node> *const h)
+T *zf_list_first_(zf_list_head_<T, node, Link> *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_slist_first(h), node);
+	return zf_entry_(zf_list_first(h), node);
 }
 
-template <typename T, zf_slist_node T:: *node>
+template <typename T, zf_list_node T:: *node, typename Link>
 _ZF_QUEUE_CONSTEXPR
-T *zf_slist_begin_(zf_slist_head_<T, node> *const h)
+T *zf_list_begin_(zf_list_head_<T, node, Link> *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_slist_begin(h), node);
+	return zf_entry_(zf_list_begin(h), node);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+_ZF_QUEUE_CONSTEXPR
+T *zf_list_end_(zf_list_head_<T, node, Link> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_list_end(h), node);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+_ZF_QUEUE_CONSTEXPR
+T *zf_list_rend_(zf_list_head_<T, node, Link> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_list_rend(h), node);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+_ZF_QUEUE_CONSTEXPR
+T *zf_list_next_(const zf_list_head_<T, node, Link> *const, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_list_next(&(e->*node)), node);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+_ZF_QUEUE_CONSTEXPR
+T *zf_list_prev_(zf_list_head_<T, node, Link> *const h, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_list_prev(h, &(e->*node)), node);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_insert_head_(zf_list_head_<T, node, Link> *const h, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_insert_head(h,  &(e->*node));
+}
+
+/* insert b before a */
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_insert_before_(const zf_list_head_<T, node, Link> *const h,
+							T *const a, T *const b)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_insert_before(&(a->*node), &(b->*node));
+	_ZF_QUEUE_STATS_INSERT(h, 1);
+}
+
+/* insert a after b */
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_insert_after_(const zf_list_head_<T, node, Link> *const h,
+						   T *const b, T *const a)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_insert_after(&(b->*node), &(a->*node));
+	_ZF_QUEUE_STATS_INSERT(h, 1);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_remove_(const zf_list_head_<T, node, Link> *const h, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_remove(&(e->*node));
+	_ZF_QUEUE_STATS_REMOVE(h, 1);
+	if (Link::safe)
+	{
+		(e->*node).next = 0;
+		(e->*node).pprev = 0;
+	}
+}
+
+/* requires zf_link_safe_ or zf_link_auto_ head */
+template <typename T, zf_list_node T:: *node, typename Link>
+_ZF_QUEUE_CONSTEXPR
+bool zf_list_linked_(const zf_list_head_<T, node, Link> *const,
+					 const T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+#if __cplusplus >= 201103L
+	static_assert(Link::safe, "zf_list_linked_() requires safe link policy");
+#endif
+	return 0 != (e->*node).pprev;
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_swap_(zf_list_head_<T, node, Link> *const h1,
+				   zf_list_head_<T, node, Link> *const h2)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_swap(h1, h2);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_concat_(zf_list_head_<T, node, Link> *const h1,
+					 zf_list_head_<T, node, Link> *const h2)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_concat(h1, h2);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_splice_head_(zf_list_head_<T, node, Link> *const h,
+						  T *const f, T *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_splice_head(h, &(f->*node), &(l->*node));
+}
+
+/* move range [f, l] after b */
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_splice_after_(const zf_list_head_<T, node, Link> *const,
+						   T *const b, T *const f, T *const l)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_splice_after(&(b->*node), &(f->*node), &(l->*node));
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_split_(zf_list_head_<T, node, Link> *const h, T *const e,
+					zf_list_head_<T, node, Link> *const h2)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_split(h, &(e->*node), h2);
+}
+
+/* link entries e[0] <-> ... <-> e[count - 1], count must be > 0 */
+template <typename T, zf_list_node T:: *node>
+void _zf_list_chain_bulk_(T *const *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		if (count > i + ZF_QUEUE_PREFETCH_DISTANCE)
+		{
+			_ZF_QUEUE_PREFETCH_W(&(e[i + ZF_QUEUE_PREFETCH_DISTANCE]->*node));
+		}
+		(e[i - 1]->*node).next = &(e[i]->*node);
+		(e[i]->*node).pprev = &(e[i - 1]->*node).next;
+	}
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_insert_head_bulk_(zf_list_head_<T, node, Link> *const h,
+							   T *const *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_list_chain_bulk_<T, node>(e, count);
+		_zf_list_link(&h->first, &(e[0]->*node), &(e[count - 1]->*node));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_insert_head_bulk_(zf_list_head_<T, node, Link> *const h,
+							   T *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_insert_head_bulk_strided(h, &(e->*node), sizeof(T), count);
+}
+
+/* insert entries e[] after b */
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_insert_after_bulk_(const zf_list_head_<T, node, Link> *const h,
+								T *const b, T *const *const e,
+								const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (0 != count)
+	{
+		_zf_list_chain_bulk_<T, node>(e, count);
+		_zf_list_link(&(b->*node).next, &(e[0]->*node),
+					  &(e[count - 1]->*node));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_insert_after_bulk_(const zf_list_head_<T, node, Link> *const h,
+								T *const b, T *const e, const size_t count)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_insert_after_bulk_strided(&(b->*node), &(e->*node),
+									  sizeof(T), count);
+	_ZF_QUEUE_STATS_INSERT(h, count);
+}
+
+/* call f(e) for each entry, prefetch K entries ahead and offset bytes into
+ * each of them */
+template <unsigned K, typename T, zf_list_node T:: *node, typename Link,
+		  typename F>
+void zf_list_foreach_prefetch_(zf_list_head_<T, node, Link> *const h, F f,
+							   const ptrdiff_t offset = 0)
+{
+	/* offset of node inside the entry, like zf_entry_() computes it */
+	const ptrdiff_t node_offset =
+			offset - (ptrdiff_t)_zf_member_offset(node);
+	zf_list_foreach_prefetch(h, n, K, node_offset)
+	{
+		f(zf_entry_(n, node));
+	}
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+void zf_list_relink_(zf_list_head_<T, node, Link> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_list_relink(h);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+size_t zf_list_disorder_(zf_list_head_<T, node, Link> *const h,
+						 const size_t max_gap, size_t *const count = 0)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_list_disorder(h, max_gap, count);
+}
+
+/* move entries into slab in list order with move(dst, src) */
+template <typename T, zf_list_node T:: *node, typename Link, typename M>
+size_t zf_list_compact_(zf_list_head_<T, node, Link> *const h, T *const slab,
+						const size_t capacity, M move)
+{
+	return zf_list_compact(h, slab, capacity, sizeof(T),
+						   _zf_member_offset(node), _zf_move_<T, M>, &move);
+}
+
+/* move entries for which pred(e) is true to h2 (in the same order) */
+template <typename T, zf_list_node T:: *node, typename Link, typename P>
+size_t zf_list_partition_(zf_list_head_<T, node, Link> *const h,
+						  zf_list_head_<T, node, Link> *const h2, P pred)
+{
+	return zf_list_partition(h, h2, _zf_pred_<T, zf_list_node, node, P>, &pred);
+}
+
+/* remove entries for which pred(e) is true, then call dispose(e) for each */
+template <typename T, zf_list_node T:: *node, typename Link,
+		  typename P, typename D>
+size_t zf_list_remove_if_(zf_list_head_<T, node, Link> *const h,
+						  P pred, D dispose)
+{
+	zf_list_head_<T, node, Link> d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	const size_t removed = zf_list_partition_(h, &d, pred);
+	zf_list_node *n = d.first;
+	d.first = 0;
+	for (zf_list_node *next; 0 != n; n = next)
+	{
+		next = n->next;
+		if (Link::safe)
+		{
+			n->next = 0;
+			n->pprev = 0;
+		}
+		dispose(zf_entry_(n, node));
+	}
+	return removed;
+}
+
+template <typename T, zf_list_node T:: *node, typename Link, typename P>
+size_t zf_list_remove_if_(zf_list_head_<T, node, Link> *const h, P pred)
+{
+	if (Link::safe)
+	{
+		return zf_list_remove_if_(h, pred, _zf_dispose_none_());
+	}
+	zf_list_head_<T, node, Link> d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	return zf_list_partition_(h, &d, pred);
+}
+
+/* move entries for which eq(p, e) is true for previous kept entry p to h2 */
+template <typename T, zf_list_node T:: *node, typename Link, typename E>
+size_t zf_list_unique_(zf_list_head_<T, node, Link> *const h,
+					   zf_list_head_<T, node, Link> *const h2, E eq)
+{
+	return zf_list_unique(h, h2, _zf_eq_<T, zf_list_node, node, E>, &eq);
+}
+
+/*
+ * Singly-linked tail queue C++ support
+ */
+template <typename T, zf_stailq_node T:: *node>
+struct zf_stailq_head_: zf_stailq_head
+{
+	typedef zf_forward_iterator_<T, zf_stailq_node, node> iterator;
+	typedef zf_forward_iterator_<T, zf_stailq_node, node, const T>
+			const_iterator;
+
+	zf_stailq_head_() {}
+	zf_stailq_head_(const zf_stailq_head &h) _ZF_QUEUE_NOEXCEPT: zf_stailq_head(h) {}
+	iterator begin() _ZF_QUEUE_NOEXCEPT
+	{
+		return iterator(first.next _ZF_QUEUE_STATS_ARG);
+	}
+	iterator end() _ZF_QUEUE_NOEXCEPT { return iterator(); }
+	const_iterator begin() const _ZF_QUEUE_NOEXCEPT
+	{
+		return const_iterator(first.next _ZF_QUEUE_STATS_ARG);
+	}
+	const_iterator end() const _ZF_QUEUE_NOEXCEPT { return const_iterator(); }
+	const_iterator cbegin() const _ZF_QUEUE_NOEXCEPT { return begin(); }
+	const_iterator cend() const _ZF_QUEUE_NOEXCEPT { return end(); }
+};
+
+template <typename T, zf_stailq_node T:: *node>
+_ZF_QUEUE_CONSTEXPR
+T *zf_stailq_begin_(zf_stailq_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_stailq_begin(h), node);
+}
+
+template <typename T, zf_stailq_node T:: *node>
+_ZF_QUEUE_CONSTEXPR
+T *zf_stailq_end_(zf_stailq_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_stailq_end(h), node);
+}
+
+template <typename T, zf_stailq_node T:: *node>
+_ZF_QUEUE_CONSTEXPR
+T *zf_stailq_first_(zf_stailq_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_stailq_first(h), node);
+}
+
+template <typename T, zf_stailq_node T:: *node>
+_ZF_QUEUE_CONSTEXPR
+T *zf_stailq_last_(zf_stailq_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_stailq_last(h), node);
+}
+
+template <typename T, zf_stailq_node T:: *node>
+T *zf_stailq_next_(const zf_stailq_head_<T, node> *const, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_entry_(zf_stailq_next(&(e->*node)), node);
+}
+
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_head_(zf_stailq_head_<T, node> *const h, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_stailq_insert_head(h, &(e->*node));
+}
+
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_tail_(zf_stailq_head_<T, node> *const h, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_stailq_insert_tail(h, &(e->*node));
+}
+
+/* insert a after b */
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_after_(zf_stailq_head_<T, node> *const h,
+							 T *const b, T *const a)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_stailq_insert_after(h, &(b->*node), &(a->*node));
 }
 
-template <typename T, zf_slist_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_slist_end_(zf_slist_head_<T, node> *const h)
+template <typename T, zf_stailq_node T:: *node>
+zf_stailq_node *_zf_stailq_node_(T *const e)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_slist_end(h), node);
+	return 0 == e? 0: &(e->*node);
 }
 
-template <typename T, zf_slist_node T:: *node>
-T *zf_slist_next_(const zf_slist_head_<T, node> *const, T *const e)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_swap_(zf_stailq_head_<T, node> *const h1,
+					 zf_stailq_head_<T, node> *const h2)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_slist_next(&(e->*node)), node);
+	zf_stailq_swap(h1, h2);
 }
 
-template <typename T, zf_slist_node T:: *node>
-void zf_slist_insert_head_(zf_slist_head_<T, node> *const h, T *const e)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_concat_(zf_stailq_head_<T, node> *const h1,
+					   zf_stailq_head_<T, node> *const h2)
 	_ZF_QUEUE_NOEXCEPT
 {
-	zf_slist_insert_head(h, &(e->*node));
+	zf_stailq_concat(h1, h2);
 }
 
-/* insert a after b */
-template <typename T, zf_slist_node T:: *node>
-void zf_slist_insert_after_(zf_slist_head_<T, node> *const,
-							T *const b, T *const a)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_splice_head_(zf_stailq_head_<T, node> *const h,
+							zf_stailq_head_<T, node> *const h2,
+							T *const p, T *const l)
 	_ZF_QUEUE_NOEXCEPT
 {
-	zf_slist_insert_after(&(b->*node), &(a->*node));
+	zf_stailq_splice_head(h, h2, _zf_stailq_node_<T, node>(p), &(l->*node));
 }
 
-template <typename T, zf_slist_node T:: *node>
-void zf_slist_remove_after_(zf_slist_head_<T, node> *const, T *const e)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_splice_tail_(zf_stailq_head_<T, node> *const h,
+							zf_stailq_head_<T, node> *const h2,
+							T *const p, T *const l)
 	_ZF_QUEUE_NOEXCEPT
 {
-	zf_slist_remove_after(&(e->*node));
+	zf_stailq_splice_tail(h, h2, _zf_stailq_node_<T, node>(p), &(l->*node));
 }
 
-/*
- * List C++ support
- */
-template <typename T, zf_list_node T:: *node>
-struct zf_list_head_: zf_list_head
+/* move range (p, l] from h2 after b in h */
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_splice_after_(zf_stailq_head_<T, node> *const h, T *const b,
+							 zf_stailq_head_<T, node> *const h2,
+							 T *const p, T *const l)
+	_ZF_QUEUE_NOEXCEPT
 {
-	zf_list_head_() {}
-	zf_list_head_(const zf_list_head &h) _ZF_QUEUE_NOEXCEPT: zf_list_head(h) {}
-};
+	zf_stailq_splice_after(h, &(b->*node), h2,
+						   _zf_stailq_node_<T, node>(p), &(l->*node));
+}
 
-template <typename T, zf_list_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_list_first_(zf_list_head_<T, node> *const h)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_split_after_(zf_stailq_head_<T, node> *const h, T *const p,
+							zf_stailq_head_<T, node> *const h2)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_list_first(h), node);
+	zf_stailq_split_after(h, _zf_stailq_node_<T, node>(p), h2);
 }
 
-template <typename T, zf_list_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_list_begin_(zf_list_head_<T, node> *const h)
+/* link entries e[0] -> ... -> e[count - 1], count must be > 0 */
+template <typename T, zf_stailq_node T:: *node>
+void _zf_stailq_chain_bulk_(T *const *const e, const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_list_begin(h), node);
+	for (size_t i = 1; count > i; ++i)
+	{
+		if (count > i + ZF_QUEUE_PREFETCH_DISTANCE)
+		{
+			_ZF_QUEUE_PREFETCH_W(&(e[i + ZF_QUEUE_PREFETCH_DISTANCE]->*node));
+		}
+		(e[i - 1]->*node).next = &(e[i]->*node);
+	}
 }
 
-template <typename T, zf_list_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_list_end_(zf_list_head_<T, node> *const h)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_head_bulk_(zf_stailq_head_<T, node> *const h,
+								 T *const *const e, const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_list_end(h), node);
+	if (0 != count)
+	{
+		_zf_stailq_chain_bulk_<T, node>(e, count);
+		_zf_stailq_link(h, &h->first, &(e[0]->*node), &(e[count - 1]->*node));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
 }
 
-template <typename T, zf_list_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_list_rend_(zf_list_head_<T, node> *const h)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_head_bulk_(zf_stailq_head_<T, node> *const h,
+								 T *const e, const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_list_rend(h), node);
+	zf_stailq_insert_head_bulk_strided(h, &(e->*node), sizeof(T), count);
 }
 
-template <typename T, zf_list_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_list_next_(const zf_list_head_<T, node> *const, T *const e)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_tail_bulk_(zf_stailq_head_<T, node> *const h,
+								 T *const *const e, const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_list_next(&(e->*node)), node);
+	if (0 != count)
+	{
+		_zf_stailq_chain_bulk_<T, node>(e, count);
+		_zf_stailq_link(h, h->last, &(e[0]->*node), &(e[count - 1]->*node));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
 }
 
-template <typename T, zf_list_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_list_prev_(zf_list_head_<T, node> *const h, T *const e)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_tail_bulk_(zf_stailq_head_<T, node> *const h,
+								 T *const e, const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_list_prev(h, &(e->*node)), node);
+	zf_stailq_insert_tail_bulk_strided(h, &(e->*node), sizeof(T), count);
 }
 
-template <typename T, zf_list_node T:: *node>
-void zf_list_insert_head_(zf_list_head_<T, node> *const h, T *const e)
+/* insert entries e[] after p */
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_after_bulk_(zf_stailq_head_<T, node> *const h,
+								  T *const p, T *const *const e,
+								  const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	zf_list_insert_head(h,  &(e->*node));
+	if (0 != count)
+	{
+		_zf_stailq_chain_bulk_<T, node>(e, count);
+		_zf_stailq_link(h, &(p->*node), &(e[0]->*node),
+						&(e[count - 1]->*node));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
 }
 
-/* insert b before a */
-template <typename T, zf_list_node T:: *node>
-void zf_list_insert_before_(const zf_list_head_<T, node> *const,
-							T *const a, T *const b)
+template <typename T, zf_stailq_node T:: *node>
+void zf_stailq_insert_after_bulk_(zf_stailq_head_<T, node> *const h,
+								  T *const p, T *const e, const size_t count)
 	_ZF_QUEUE_NOEXCEPT
 {
-	zf_list_insert_before(&(a->*node), &(b->*node));
+	zf_stailq_insert_after_bulk_strided(h, &(p->*node), &(e->*node),
+										sizeof(T), count);
 }
 
-/* insert a after b */
-template <typename T, zf_list_node T:: *node>
-void zf_list_insert_after_(const zf_list_head_<T, node> *const,
-						   T *const b, T *const a)
-	_ZF_QUEUE_NOEXCEPT
+/* less(a, b) returns true when entry a goes before entry b */
+template <typename T, zf_stailq_node T:: *node, typename L>
+size_t zf_stailq_merge_(zf_stailq_head_<T, node> *const h,
+						zf_stailq_head_<T, node> *const in, const size_t k,
+						size_t *const tree, L less,
+						const size_t limit = ZF_MERGE_ALL)
 {
-	zf_list_insert_after(&(b->*node), &(a->*node));
+	return zf_stailq_merge(h, in, k, tree, _zf_cmp_<T, zf_stailq_node, node, L>,
+						   &less, limit);
 }
 
-template <typename T, zf_list_node T:: *node>
-void zf_list_remove_(const zf_list_head_<T, node> *const, T *const e)
-	_ZF_QUEUE_NOEXCEPT
+/* key(e) returns unsigned integer key of entry e */
+template <typename T, zf_stailq_node T:: *node, typename K>
+void zf_stailq_radix_sort_(zf_stailq_head_<T, node> *const h, K key)
 {
-	zf_list_remove(&(e->*node));
+	zf_stailq_radix_sort(h, _zf_key_<T, zf_stailq_node, node, K>, &key);
 }
 
-/*
- * Singly-linked tail queue C++ support
- */
-template <typename T, zf_stailq_node T:: *node>
-struct zf_stailq_head_: zf_stailq_head {
-	zf_stailq_head_() {}
-	zf_stailq_head_(const zf_stailq_head &h) _ZF_QUEUE_NOEXCEPT: zf_stailq_head(h) {}
-};
+/* call f(e) for each entry, prefetch K entries ahead and offset bytes into
+ * each of them */
+template <unsigned K, typename T, zf_stailq_node T:: *node, typename F>
+void zf_stailq_foreach_prefetch_(zf_stailq_head_<T, node> *const h, F f,
+								 const ptrdiff_t offset = 0)
+{
+	/* offset of node inside the entry, like zf_entry_() computes it */
+	const ptrdiff_t node_offset =
+			offset - (ptrdiff_t)_zf_member_offset(node);
+	zf_stailq_foreach_prefetch(h, n, K, node_offset)
+	{
+		f(zf_entry_(n, node));
+	}
+}
 
 template <typename T, zf_stailq_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_stailq_begin_(zf_stailq_head_<T, node> *const h)
+void zf_stailq_relink_(zf_stailq_head_<T, node> *const h)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_stailq_begin(h), node);
+	zf_stailq_relink(h);
 }
 
 template <typename T, zf_stailq_node T:: *node>
-_ZF_QUEUE_CONSTEXPR
-T *zf_stailq_end_(zf_stailq_head_<T, node> *const h)
+size_t zf_stailq_disorder_(zf_stailq_head_<T, node> *const h, const size_t max_gap,
+						   size_t *const count = 0)
 	_ZF_QUEUE_NOEXCEPT
 {
-	return zf_entry_(zf_stailq_end(h), node);
+	return zf_stailq_disorder(h, max_gap, count);
+}
+
+/* move entries into slab in list order with move(dst, src) */
+template <typename T, zf_stailq_node T:: *node, typename M>
+size_t zf_stailq_compact_(zf_stailq_head_<T, node> *const h, T *const slab,
+						  const size_t capacity, M move)
+{
+	return zf_stailq_compact(h, slab, capacity, sizeof(T),
+							 _zf_member_offset(node), _zf_move_<T, M>, &move);
+}
+
+/* move entries for which pred(e) is true to h2 (in the same order) */
+template <typename T, zf_stailq_node T:: *node, typename P>
+size_t zf_stailq_partition_(zf_stailq_head_<T, node> *const h,
+							zf_stailq_head_<T, node> *const h2, P pred)
+{
+	return zf_stailq_partition(h, h2, _zf_pred_<T, zf_stailq_node, node, P>,
+							   &pred);
+}
+
+/* remove entries for which pred(e) is true, then call dispose(e) for each */
+template <typename T, zf_stailq_node T:: *node, typename P, typename D>
+size_t zf_stailq_remove_if_(zf_stailq_head_<T, node> *const h,
+							P pred, D dispose)
+{
+	zf_stailq_head_<T, node> d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	const size_t removed = zf_stailq_partition_(h, &d, pred);
+	for (zf_stailq_node *n = d.first.next, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		dispose(zf_entry_(n, node));
+	}
+	return removed;
+}
+
+template <typename T, zf_stailq_node T:: *node, typename P>
+size_t zf_stailq_remove_if_(zf_stailq_head_<T, node> *const h, P pred)
+{
+	zf_stailq_head_<T, node> d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	return zf_stailq_partition_(h, &d, pred);
+}
+
+/* move entries for which eq(p, e) is true for previous kept entry p to h2 */
+template <typename T, zf_stailq_node T:: *node, typename E>
+size_t zf_stailq_unique_(zf_stailq_head_<T, node> *const h,
+						 zf_stailq_head_<T, node> *const h2, E eq)
+{
+	return zf_stailq_unique(h, h2, _zf_eq_<T, zf_stailq_node, node, E>, &eq);
 }
 
 /*
  * Tail queue C++ support
  */
-template <typename T, zf_tailq_node T:: *node>
-struct zf_tailq_head_: zf_tailq_head {
+/* Bidirectional iterator over entries of tail queue. Keeps pointer to the
+ * head, so end() could be decremented. V is T for iterator and const T for
+ * const_iterator, iterator converts to const_iterator.
+ */
+template <typename T, zf_tailq_node T:: *node, typename V = T>
+struct zf_tailq_iterator_
+{
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef ptrdiff_t difference_type;
+	typedef V *pointer;
+	typedef V &reference;
+
+	const zf_tailq_head *h;
+	zf_tailq_node *n;
+
+	zf_tailq_iterator_() _ZF_QUEUE_NOEXCEPT: h(0), n(0) {}
+	zf_tailq_iterator_(const zf_tailq_head *const h, zf_tailq_node *const n)
+		_ZF_QUEUE_NOEXCEPT: h(h), n(n) {}
+	zf_tailq_iterator_(const zf_tailq_iterator_<T, node> &i)
+		_ZF_QUEUE_NOEXCEPT: h(i.h), n(i.n) {}
+	V &operator*() const _ZF_QUEUE_NOEXCEPT { return *zf_entry_(n, node); }
+	V *operator->() const _ZF_QUEUE_NOEXCEPT { return zf_entry_(n, node); }
+	zf_tailq_iterator_ &operator++() _ZF_QUEUE_NOEXCEPT
+	{
+		n = _ZF_QUEUE_STATS_NEXT(h, n->next);
+		return *this;
+	}
+	zf_tailq_iterator_ operator++(int) _ZF_QUEUE_NOEXCEPT
+	{
+		const zf_tailq_iterator_ i(*this);
+		++*this;
+		return i;
+	}
+	zf_tailq_iterator_ &operator--() _ZF_QUEUE_NOEXCEPT
+	{
+		n = _ZF_QUEUE_STATS_NEXT(h, 0 == n? h->head.prev: n->prev);
+		return *this;
+	}
+	zf_tailq_iterator_ operator--(int) _ZF_QUEUE_NOEXCEPT
+	{
+		const zf_tailq_iterator_ i(*this);
+		--*this;
+		return i;
+	}
+	/* any of iterator and const_iterator on both sides */
+	template <typename W>
+	bool operator==(const zf_tailq_iterator_<T, node, W> &i) const
+		_ZF_QUEUE_NOEXCEPT
+	{
+		return n == i.n;
+	}
+	template <typename W>
+	bool operator!=(const zf_tailq_iterator_<T, node, W> &i) const
+		_ZF_QUEUE_NOEXCEPT
+	{
+		return n != i.n;
+	}
+};
+
+template <typename T, zf_tailq_node T:: *node, typename Link = zf_link_fast_>
+struct zf_tailq_head_: zf_tailq_head
+{
+#if __cplusplus >= 201103L
+	static_assert(!Link::auto_unlink, "tail queue doesn't support auto unlink");
+#endif
+	typedef zf_tailq_iterator_<T, node> iterator;
+	typedef zf_tailq_iterator_<T, node, const T> const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
 	zf_tailq_head_() {}
 	zf_tailq_head_(const zf_tailq_head &h) _ZF_QUEUE_NOEXCEPT: zf_tailq_head(h) {}
+	iterator begin() _ZF_QUEUE_NOEXCEPT { return iterator(this, head.next); }
+	iterator end() _ZF_QUEUE_NOEXCEPT { return iterator(this, 0); }
+	reverse_iterator rbegin() _ZF_QUEUE_NOEXCEPT
+	{
+		return reverse_iterator(end());
+	}
+	reverse_iterator rend() _ZF_QUEUE_NOEXCEPT
+	{
+		return reverse_iterator(begin());
+	}
+	const_iterator begin() const _ZF_QUEUE_NOEXCEPT
+	{
+		return const_iterator(this, head.next);
+	}
+	const_iterator end() const _ZF_QUEUE_NOEXCEPT
+	{
+		return const_iterator(this, 0);
+	}
+	const_reverse_iterator rbegin() const _ZF_QUEUE_NOEXCEPT
+	{
+		return const_reverse_iterator(end());
+	}
+	const_reverse_iterator rend() const _ZF_QUEUE_NOEXCEPT
+	{
+		return const_reverse_iterator(begin());
+	}
+	const_iterator cbegin() const _ZF_QUEUE_NOEXCEPT { return begin(); }
+	const_iterator cend() const _ZF_QUEUE_NOEXCEPT { return end(); }
+	const_reverse_iterator crbegin() const _ZF_QUEUE_NOEXCEPT
+	{
+		return rbegin();
+	}
+	const_reverse_iterator crend() const _ZF_QUEUE_NOEXCEPT
+	{
+		return rend();
+	}
 };
 
-template <typename T, zf_tailq_node T:: *node>
-T *zf_tailq_entry_(zf_tailq_head_<T, node> *const, zf_tailq_node *const n)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+T *zf_tailq_entry_(zf_tailq_head_<T, node, Link> *const, zf_tailq_node *const n)
 {
 	return zf_entry_(n, node);
 }
 
-template <typename T, zf_tailq_node T:: *node>
-T *zf_tailq_first_(zf_tailq_head_<T, node> *const h)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+T *zf_tailq_first_(zf_tailq_head_<T, node, Link> *const h)
 {
 	return zf_entry_(zf_tailq_first(h), node);
 }
 
-template <typename T, zf_tailq_node T:: *node>
-T *zf_tailq_last_(zf_tailq_head_<T, node> *const h)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+T *zf_tailq_last_(zf_tailq_head_<T, node, Link> *const h)
 {
 	return zf_entry_(zf_tailq_last(h), node);
 }
 
-template <typename T, zf_tailq_node T:: *node>
-T *zf_tailq_begin_(zf_tailq_head_<T, node> *const h)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+T *zf_tailq_begin_(zf_tailq_head_<T, node, Link> *const h)
 {
 	return zf_entry_(zf_tailq_begin(h), node);
 }
 
-template <typename T, zf_tailq_node T:: *node>
-T *zf_tailq_end_(zf_tailq_head_<T, node> *const h)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+T *zf_tailq_end_(zf_tailq_head_<T, node, Link> *const h)
 {
 	return zf_entry_(zf_tailq_end(h), node);
 }
 
-template <typename T, zf_tailq_node T:: *node>
-T *zf_tailq_next_(zf_tailq_head_<T, node> *const, T *const e)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+T *zf_tailq_next_(zf_tailq_head_<T, node, Link> *const, T *const e)
 {
 	return zf_entry_(zf_tailq_next(&(e->*node)), node);
 }
 
-template <typename T, zf_tailq_node T:: *node>
-T *zf_tailq_prev_(zf_tailq_head_<T, node> *const, T *const e)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+T *zf_tailq_prev_(zf_tailq_head_<T, node, Link> *const, T *const e)
 {
 	return zf_entry_(zf_tailq_prev(&(e->*node)), node);
 }
 
-template <typename T, zf_tailq_node T:: *node>
-void zf_tailq_insert_head_(zf_tailq_head_<T, node> *const h, T *const e)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_head_(zf_tailq_head_<T, node, Link> *const h, T *const e)
 {
 	zf_tailq_insert_head(h, &(e->*node));
 }
 
-template <typename T, zf_tailq_node T:: *node>
-void zf_tailq_insert_tail_(zf_tailq_head_<T, node> *const h, T *const e)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_tail_(zf_tailq_head_<T, node, Link> *const h, T *const e)
 {
 	zf_tailq_insert_tail(h, &(e->*node));
 }
 
-template <typename T, zf_tailq_node T:: *node>
-void zf_tailq_insert_before_(zf_tailq_head_<T, node> *const,
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_before_(zf_tailq_head_<T, node, Link> *const h,
 							 T *const a, T *const e)
 {
 	zf_tailq_insert_before(&(a->*node), &(e->*node));
+	_ZF_QUEUE_STATS_INSERT(h, 1);
 }
 
-template <typename T, zf_tailq_node T:: *node>
-void zf_tailq_insert_after_(zf_tailq_head_<T, node> *const h,
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_after_(zf_tailq_head_<T, node, Link> *const h,
 							 T *const b, T *const e)
 {
 	zf_tailq_insert_after(h, &(b->*node), &(e->*node));
 }
 
-template <typename T, zf_tailq_node T:: *node>
-void zf_tailq_remove_(zf_tailq_head_<T, node> *const h, T *const e)
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_remove_(zf_tailq_head_<T, node, Link> *const h, T *const e)
 {
 	zf_tailq_remove(h, &(e->*node));
+	if (Link::safe)
+	{
+		(e->*node).next = 0;
+		(e->*node).prev = 0;
+	}
+}
+
+/* requires zf_link_safe_ head */
+template <typename T, zf_tailq_node T:: *node, typename Link>
+bool zf_tailq_linked_(const zf_tailq_head_<T, node, Link> *const,
+					  const T *const e)
+{
+#if __cplusplus >= 201103L
+	static_assert(Link::safe, "zf_tailq_linked_() requires safe link policy");
+#endif
+	return 0 != (e->*node).prev;
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_swap_(zf_tailq_head_<T, node, Link> *const h1,
+					zf_tailq_head_<T, node, Link> *const h2)
+{
+	zf_tailq_swap(h1, h2);
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_concat_(zf_tailq_head_<T, node, Link> *const h1,
+					  zf_tailq_head_<T, node, Link> *const h2)
+{
+	zf_tailq_concat(h1, h2);
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_splice_head_(zf_tailq_head_<T, node, Link> *const h,
+						   zf_tailq_head_<T, node, Link> *const h2,
+						   T *const f, T *const l)
+{
+	zf_tailq_splice_head(h, h2, &(f->*node), &(l->*node));
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_splice_tail_(zf_tailq_head_<T, node, Link> *const h,
+						   zf_tailq_head_<T, node, Link> *const h2,
+						   T *const f, T *const l)
+{
+	zf_tailq_splice_tail(h, h2, &(f->*node), &(l->*node));
+}
+
+/* move range [f, l] from h2 after b in h */
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_splice_after_(zf_tailq_head_<T, node, Link> *const h, T *const b,
+							zf_tailq_head_<T, node, Link> *const h2,
+							T *const f, T *const l)
+{
+	zf_tailq_splice_after(h, &(b->*node), h2, &(f->*node), &(l->*node));
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_split_(zf_tailq_head_<T, node, Link> *const h, T *const e,
+					 zf_tailq_head_<T, node, Link> *const h2)
+{
+	zf_tailq_split(h, &(e->*node), h2);
+}
+
+/* link entries e[0] <-> ... <-> e[count - 1], count must be > 0 */
+template <typename T, zf_tailq_node T:: *node>
+void _zf_tailq_chain_bulk_(T *const *const e, const size_t count)
+{
+	for (size_t i = 1; count > i; ++i)
+	{
+		if (count > i + ZF_QUEUE_PREFETCH_DISTANCE)
+		{
+			_ZF_QUEUE_PREFETCH_W(&(e[i + ZF_QUEUE_PREFETCH_DISTANCE]->*node));
+		}
+		(e[i - 1]->*node).next = &(e[i]->*node);
+		(e[i]->*node).prev = &(e[i - 1]->*node);
+	}
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_head_bulk_(zf_tailq_head_<T, node, Link> *const h,
+								T *const *const e, const size_t count)
+{
+	if (0 != count)
+	{
+		_zf_tailq_chain_bulk_<T, node>(e, count);
+		_zf_tailq_link(h, &h->head, &(e[0]->*node), &(e[count - 1]->*node));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_head_bulk_(zf_tailq_head_<T, node, Link> *const h,
+								T *const e, const size_t count)
+{
+	zf_tailq_insert_head_bulk_strided(h, &(e->*node), sizeof(T), count);
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_tail_bulk_(zf_tailq_head_<T, node, Link> *const h,
+								T *const *const e, const size_t count)
+{
+	if (0 != count)
+	{
+		_zf_tailq_chain_bulk_<T, node>(e, count);
+		_zf_tailq_link(h, h->head.prev, &(e[0]->*node),
+					   &(e[count - 1]->*node));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_tail_bulk_(zf_tailq_head_<T, node, Link> *const h,
+								T *const e, const size_t count)
+{
+	zf_tailq_insert_tail_bulk_strided(h, &(e->*node), sizeof(T), count);
+}
+
+/* insert entries e[] after p */
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_after_bulk_(zf_tailq_head_<T, node, Link> *const h,
+								 T *const p, T *const *const e,
+								 const size_t count)
+{
+	if (0 != count)
+	{
+		_zf_tailq_chain_bulk_<T, node>(e, count);
+		_zf_tailq_link(h, &(p->*node), &(e[0]->*node),
+					   &(e[count - 1]->*node));
+		_ZF_QUEUE_STATS_INSERT(h, count);
+	}
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_insert_after_bulk_(zf_tailq_head_<T, node, Link> *const h,
+								 T *const p, T *const e, const size_t count)
+{
+	zf_tailq_insert_after_bulk_strided(h, &(p->*node), &(e->*node),
+									   sizeof(T), count);
+}
+
+/* less(a, b) returns true when entry a goes before entry b */
+template <typename T, zf_tailq_node T:: *node, typename Link, typename L>
+size_t zf_tailq_merge_(zf_tailq_head_<T, node, Link> *const h,
+						zf_tailq_head_<T, node, Link> *const in, const size_t k,
+						size_t *const tree, L less,
+						const size_t limit = ZF_MERGE_ALL)
+{
+	return zf_tailq_merge(h, in, k, tree, _zf_cmp_<T, zf_tailq_node, node, L>,
+						  &less, limit);
+}
+
+/* key(e) returns unsigned integer key of entry e */
+template <typename T, zf_tailq_node T:: *node, typename Link, typename K>
+void zf_tailq_radix_sort_(zf_tailq_head_<T, node, Link> *const h, K key)
+{
+	zf_tailq_radix_sort(h, _zf_key_<T, zf_tailq_node, node, K>, &key);
 }
 
-template <typename T, zf_tailq_node T:: *node, typename F>
-void zf_tailq_foreach_(zf_tailq_head_<T, node> *const h, F f)
+template <typename T, zf_tailq_node T:: *node, typename Link, typename F>
+void zf_tailq_foreach_(zf_tailq_head_<T, node, Link> *const h, F f)
 {
 	zf_tailq_foreach(h, n)
 	{
@@ -997,6 +4532,95 @@ void zf_tailq_foreach_(zf_tailq_head_<T, node> *const h, F f)
 	}
 }
 
+/* call f(e) for each entry, prefetch K entries ahead and offset bytes into
+ * each of them */
+template <unsigned K, typename T, zf_tailq_node T:: *node, typename Link,
+		  typename F>
+void zf_tailq_foreach_prefetch_(zf_tailq_head_<T, node, Link> *const h, F f,
+								const ptrdiff_t offset = 0)
+{
+	/* offset of node inside the entry, like zf_entry_() computes it */
+	const ptrdiff_t node_offset =
+			offset - (ptrdiff_t)_zf_member_offset(node);
+	zf_tailq_foreach_prefetch(h, n, K, node_offset)
+	{
+		f(zf_entry_(n, node));
+	}
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+void zf_tailq_relink_(zf_tailq_head_<T, node, Link> *const h)
+{
+	zf_tailq_relink(h);
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+size_t zf_tailq_disorder_(zf_tailq_head_<T, node, Link> *const h,
+						  const size_t max_gap, size_t *const count = 0)
+{
+	return zf_tailq_disorder(h, max_gap, count);
+}
+
+/* move entries into slab in list order with move(dst, src) */
+template <typename T, zf_tailq_node T:: *node, typename Link, typename M>
+size_t zf_tailq_compact_(zf_tailq_head_<T, node, Link> *const h, T *const slab,
+						 const size_t capacity, M move)
+{
+	return zf_tailq_compact(h, slab, capacity, sizeof(T),
+							_zf_member_offset(node), _zf_move_<T, M>, &move);
+}
+
+/* move entries for which pred(e) is true to h2 (in the same order) */
+template <typename T, zf_tailq_node T:: *node, typename Link, typename P>
+size_t zf_tailq_partition_(zf_tailq_head_<T, node, Link> *const h,
+						   zf_tailq_head_<T, node, Link> *const h2, P pred)
+{
+	return zf_tailq_partition(h, h2, _zf_pred_<T, zf_tailq_node, node, P>,
+							  &pred);
+}
+
+/* remove entries for which pred(e) is true, then call dispose(e) for each */
+template <typename T, zf_tailq_node T:: *node, typename Link,
+		  typename P, typename D>
+size_t zf_tailq_remove_if_(zf_tailq_head_<T, node, Link> *const h,
+						   P pred, D dispose)
+{
+	zf_tailq_head_<T, node, Link> d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	const size_t removed = zf_tailq_partition_(h, &d, pred);
+	for (zf_tailq_node *n = d.head.next, *next; 0 != n; n = next)
+	{
+		next = n->next;
+		if (Link::safe)
+		{
+			n->next = 0;
+			n->prev = 0;
+		}
+		dispose(zf_entry_(n, node));
+	}
+	return removed;
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link, typename P>
+size_t zf_tailq_remove_if_(zf_tailq_head_<T, node, Link> *const h, P pred)
+{
+	if (Link::safe)
+	{
+		return zf_tailq_remove_if_(h, pred, _zf_dispose_none_());
+	}
+	zf_tailq_head_<T, node, Link> d;
+	_ZF_QUEUE_STATS_INIT(&d);
+	return zf_tailq_partition_(h, &d, pred);
+}
+
+/* move entries for which eq(p, e) is true for previous kept entry p to h2 */
+template <typename T, zf_tailq_node T:: *node, typename Link, typename E>
+size_t zf_tailq_unique_(zf_tailq_head_<T, node, Link> *const h,
+						zf_tailq_head_<T, node, Link> *const h2, E eq)
+{
+	return zf_tailq_unique(h, h2, _zf_eq_<T, zf_tailq_node, node, E>, &eq);
+}
+
 #endif // __cplusplus
 
 /* C/C++ type macros are convenient when code will be used from both C and C++.
@@ -0,0 +1,297 @@
+#pragma once
+
+#ifndef _ZF_RADIX_HEAP_H_
+#define _ZF_RADIX_HEAP_H_
+
+/* Intrusive radix heap: priority queue for monotone integer keys, where key
+ * of inserted entry is never less than key of the last popped one (Dijkstra
+ * shortest paths, discrete event simulation). Entries embed
+ * zf_radix_heap_node, which is tailq node plus the key.
+ *
+ * Entries are kept in tail queues (buckets) by the highest bit where their key
+ * differs from the last popped key: bucket 0 has keys equal to it, bucket i
+ * keys that differ in bit i - 1 and above. Insert appends entry to its bucket
+ * in O(1). Pop takes entry from bucket 0. When bucket 0 is empty, the first
+ * non-empty bucket is redistributed: its minimum becomes the last key and all
+ * its entries go to lower buckets. Each entry moves down at most 64 times, so
+ * pop is amortized O(log C), where C is the maximum difference between keys.
+ * Decrease key is remove from its bucket (zf_tailq_remove()) and insert.
+ *
+ * Buckets are walked sequentially and only when redistributed, so radix heap
+ * does far fewer comparisons and random accesses than binary heap.
+ */
+
+#include "zf_queue.h"
+
+#define ZF_RADIX_HEAP_BUCKETS 65
+
+typedef struct zf_radix_heap_node
+{
+	struct zf_tailq_node node;
+	uint64_t key;
+}
+zf_radix_heap_node;
+
+typedef struct zf_radix_heap
+{
+	struct zf_tailq_head buckets[ZF_RADIX_HEAP_BUCKETS];
+	/* bit i - 1 is set when bucket i is not empty (bucket 0 is not tracked) */
+	uint64_t used;
+	/* last popped key, keys of all entries are not less than it */
+	uint64_t last;
+	size_t count;
+}
+zf_radix_heap;
+
+_ZF_QUEUE_DECL
+void zf_radix_heap_init(struct zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (unsigned i = 0; ZF_RADIX_HEAP_BUCKETS > i; ++i)
+	{
+		zf_tailq_init(&h->buckets[i]);
+	}
+	h->used = 0;
+	h->last = 0;
+	h->count = 0;
+}
+
+_ZF_QUEUE_DECL
+bool zf_radix_heap_empty(const struct zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return 0 == h->count;
+}
+
+_ZF_QUEUE_DECL
+size_t zf_radix_heap_count(const struct zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return h->count;
+}
+
+/* the last popped key, insert must not use smaller keys */
+_ZF_QUEUE_DECL
+uint64_t zf_radix_heap_last(const struct zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return h->last;
+}
+
+/* number of the highest set bit plus one, 0 for 0 */
+_ZF_QUEUE_DECL
+unsigned _zf_radix_heap_bits(const uint64_t v)
+	_ZF_QUEUE_NOEXCEPT
+{
+#if defined(__GNUC__)
+	return 0 == v? 0: 64 - (unsigned)__builtin_clzll(v);
+#else
+	unsigned i = 0;
+	for (uint64_t x = v; 0 != x; x >>= 1)
+	{
+		++i;
+	}
+	return i;
+#endif
+}
+
+_ZF_QUEUE_DECL
+unsigned _zf_radix_heap_bucket(const struct zf_radix_heap *const h,
+							   const uint64_t key)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return _zf_radix_heap_bits(key ^ h->last);
+}
+
+_ZF_QUEUE_DECL
+void _zf_radix_heap_link(struct zf_radix_heap *const h,
+						 struct zf_radix_heap_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	const unsigned b = _zf_radix_heap_bucket(h, n->key);
+	zf_tailq_insert_tail(&h->buckets[b], &n->node);
+	if (0 != b)
+	{
+		h->used |= (uint64_t)1 << (b - 1);
+	}
+}
+
+_ZF_QUEUE_DECL
+void _zf_radix_heap_unlink(struct zf_radix_heap *const h,
+						   struct zf_radix_heap_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	const unsigned b = _zf_radix_heap_bucket(h, n->key);
+	zf_tailq_remove(&h->buckets[b], &n->node);
+	if (0 != b && zf_tailq_empty(&h->buckets[b]))
+	{
+		h->used &= ~((uint64_t)1 << (b - 1));
+	}
+}
+
+/* key must not be less than zf_radix_heap_last() */
+_ZF_QUEUE_DECL
+void zf_radix_heap_insert(struct zf_radix_heap *const h,
+						  struct zf_radix_heap_node *const n,
+						  const uint64_t key)
+	_ZF_QUEUE_NOEXCEPT
+{
+	n->key = key;
+	_zf_radix_heap_link(h, n);
+	++h->count;
+}
+
+_ZF_QUEUE_DECL
+void zf_radix_heap_remove(struct zf_radix_heap *const h,
+						  struct zf_radix_heap_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_radix_heap_unlink(h, n);
+	--h->count;
+}
+
+/* key must not be less than zf_radix_heap_last() (could be greater than
+ * current key of n, so it's not only decrease) */
+_ZF_QUEUE_DECL
+void zf_radix_heap_update(struct zf_radix_heap *const h,
+						  struct zf_radix_heap_node *const n,
+						  const uint64_t key)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_radix_heap_unlink(h, n);
+	n->key = key;
+	_zf_radix_heap_link(h, n);
+}
+
+/* the first non-empty bucket other than 0, h->used must not be 0 */
+_ZF_QUEUE_DECL
+unsigned _zf_radix_heap_lowest(const struct zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return _zf_radix_heap_bits(h->used & (~h->used + 1));
+}
+
+/* the first entry with the smallest key in non-empty bucket */
+_ZF_QUEUE_DECL
+struct zf_radix_heap_node *_zf_radix_heap_min(struct zf_tailq_head *const b)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_radix_heap_node *min = 0;
+	zf_tailq_foreach(b, n)
+	{
+		struct zf_radix_heap_node *const e =
+				zf_entry(n, zf_radix_heap_node, node);
+		if (0 == min || min->key > e->key)
+		{
+			min = e;
+		}
+	}
+	return min;
+}
+
+/* makes bucket 0 non-empty (when heap is not empty), so it must be followed
+ * by pop of the minimum: it becomes the last popped key */
+_ZF_QUEUE_DECL
+void _zf_radix_heap_settle(struct zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (!zf_tailq_empty(&h->buckets[0]) || 0 == h->used)
+	{
+		return;
+	}
+	const unsigned b = _zf_radix_heap_lowest(h);
+	struct zf_tailq_head *const bucket = &h->buckets[b];
+	const uint64_t min = _zf_radix_heap_min(bucket)->key;
+	struct zf_tailq_head t;
+	zf_tailq_init(&t);
+	zf_tailq_swap(&t, bucket);
+	h->used &= ~((uint64_t)1 << (b - 1));
+	h->last = min;
+	for (struct zf_tailq_node *n; 0 != (n = zf_tailq_first(&t));)
+	{
+		zf_tailq_remove(&t, n);
+		_zf_radix_heap_link(h, zf_entry(n, zf_radix_heap_node, node));
+	}
+}
+
+/* returns entry with the smallest key without removing it or 0 when heap is
+ * empty (the one pop would return). Doesn't redistribute entries, so the last
+ * popped key stays the same and smaller keys still could be inserted. When
+ * bucket 0 is empty it is O(size of the first non-empty bucket).
+ */
+_ZF_QUEUE_DECL
+struct zf_radix_heap_node *zf_radix_heap_top(struct zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	struct zf_tailq_node *const n = zf_tailq_first(&h->buckets[0]);
+	if (0 != n)
+	{
+		return zf_entry(n, zf_radix_heap_node, node);
+	}
+	return 0 == h->used? 0:
+			_zf_radix_heap_min(&h->buckets[_zf_radix_heap_lowest(h)]);
+}
+
+/* removes and returns entry with the smallest key or returns 0 when heap is
+ * empty */
+_ZF_QUEUE_DECL
+struct zf_radix_heap_node *zf_radix_heap_pop(struct zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	_zf_radix_heap_settle(h);
+	struct zf_tailq_node *const f = zf_tailq_first(&h->buckets[0]);
+	struct zf_radix_heap_node *const n =
+			0 == f? 0: zf_entry(f, zf_radix_heap_node, node);
+	if (0 != n)
+	{
+		zf_tailq_remove(&h->buckets[0], &n->node);
+		--h->count;
+	}
+	return n;
+}
+
+/* C++ support */
+#ifdef __cplusplus
+
+template <typename T, zf_radix_heap_node T:: *node>
+void zf_radix_heap_insert_(zf_radix_heap *const h, T *const e,
+						   const uint64_t key)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_radix_heap_insert(h, &(e->*node), key);
+}
+
+template <typename T, zf_radix_heap_node T:: *node>
+void zf_radix_heap_remove_(zf_radix_heap *const h, T *const e)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_radix_heap_remove(h, &(e->*node));
+}
+
+template <typename T, zf_radix_heap_node T:: *node>
+void zf_radix_heap_update_(zf_radix_heap *const h, T *const e,
+						   const uint64_t key)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_radix_heap_update(h, &(e->*node), key);
+}
+
+template <typename T, zf_radix_heap_node T:: *node>
+T *zf_radix_heap_top_(zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_radix_heap_node *const n = zf_radix_heap_top(h);
+	return 0 == n? 0: zf_entry_(n, node);
+}
+
+template <typename T, zf_radix_heap_node T:: *node>
+T *zf_radix_heap_pop_(zf_radix_heap *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	zf_radix_heap_node *const n = zf_radix_heap_pop(h);
+	return 0 == n? 0: zf_entry_(n, node);
+}
+
+#endif // __cplusplus
+
+#endif // _ZF_RADIX_HEAP_H_
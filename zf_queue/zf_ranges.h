@@ -0,0 +1,160 @@
+#pragma once
+
+#ifndef _ZF_RANGES_H_
+#define _ZF_RANGES_H_
+
+/* C++20 ranges support. C++ heads zf_xxx_head_ already model
+ * std::ranges::forward_range (zf_tailq_head_ models bidirectional_range), so
+ * they could be used in pipelines directly:
+ *
+ *   for (T &e: items | std::views::filter(pred) | std::views::take(n))
+ *
+ * Heads of singly-linked lists, lists and singly-linked tail queues are also
+ * borrowed ranges: their iterators hold only node pointer and stay valid when
+ * the head is gone. Tail queue iterator needs the head to step back from
+ * end(), so use it via std::views::all() (which is borrowed).
+ *
+ * This file also provides lightweight views (they keep only pointer to the
+ * head, so they are borrowed, cheap to copy and never allocate):
+ *  - zf_xxx_safe_(h) reads pointer to the next node before current entry is
+ *    visited, so current entry could be removed from the list (or freed).
+ *    Other entries must not be removed during iteration.
+ *  - zf_tailq_reverse_(h) iterates tail queue from the last entry to the first
+ *    one. It steps over prev pointers directly, so it is cheaper than
+ *    std::views::reverse.
+ *  - zf_tailq_safe_reverse_(h) is the same, but safe against removal.
+ * Iteration starts from the list state at the time begin() is called, not
+ * when view was created.
+ */
+
+#include "zf_queue.h"
+
+#if defined(__cplusplus) && __cplusplus >= 202002L
+
+#include <ranges>
+
+template <typename T, zf_slist_node T:: *node>
+inline constexpr bool
+std::ranges::enable_borrowed_range<zf_slist_head_<T, node>> = true;
+
+template <typename T, zf_list_node T:: *node, typename Link>
+inline constexpr bool
+std::ranges::enable_borrowed_range<zf_list_head_<T, node, Link>> = true;
+
+template <typename T, zf_stailq_node T:: *node>
+inline constexpr bool
+std::ranges::enable_borrowed_range<zf_stailq_head_<T, node>> = true;
+
+/* Forward iterator that moves from node n to step(n). When Safe is true,
+ * step(n) is read before n is visited.
+ */
+template <typename T, typename Node, Node T:: *node, Node *(*step)(Node *),
+		  bool Safe>
+struct zf_step_iterator_
+{
+	typedef std::forward_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef ptrdiff_t difference_type;
+	typedef T *pointer;
+	typedef T &reference;
+
+	Node *n = 0;
+	Node *next = 0;
+
+	zf_step_iterator_() noexcept = default;
+	explicit zf_step_iterator_(Node *const n) noexcept:
+		n(n), next(Safe && 0 != n? step(n): 0)
+	{
+	}
+	T &operator*() const noexcept { return *zf_entry_(n, node); }
+	T *operator->() const noexcept { return zf_entry_(n, node); }
+	zf_step_iterator_ &operator++() noexcept
+	{
+		if constexpr (Safe)
+		{
+			if (0 != (n = next))
+			{
+				next = step(n);
+			}
+		}
+		else
+		{
+			n = step(n);
+		}
+		return *this;
+	}
+	zf_step_iterator_ operator++(int) noexcept
+	{
+		const zf_step_iterator_ i(*this);
+		++*this;
+		return i;
+	}
+	bool operator==(const zf_step_iterator_ &i) const noexcept
+	{
+		return n == i.n;
+	}
+};
+
+/* View over entries from first(h) to the end of the list */
+template <typename Head, typename Iterator, auto first>
+class zf_step_view_:
+	public std::ranges::view_interface<zf_step_view_<Head, Iterator, first>>
+{
+public:
+	zf_step_view_() noexcept = default;
+	explicit zf_step_view_(Head *const h) noexcept: h(h) {}
+	Iterator begin() const noexcept { return Iterator(first(h)); }
+	Iterator end() const noexcept { return Iterator(); }
+private:
+	Head *h = 0;
+};
+
+template <typename Head, typename Iterator, auto first>
+inline constexpr bool
+std::ranges::enable_borrowed_range<zf_step_view_<Head, Iterator, first>> = true;
+
+template <typename T, zf_slist_node T:: *node>
+auto zf_slist_safe_(zf_slist_head_<T, node> *const h) noexcept
+{
+	typedef zf_step_iterator_<T, zf_slist_node, node, zf_slist_next, true> I;
+	return zf_step_view_<zf_slist_head, I, zf_slist_first>(h);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+auto zf_list_safe_(zf_list_head_<T, node, Link> *const h) noexcept
+{
+	typedef zf_step_iterator_<T, zf_list_node, node, zf_list_next, true> I;
+	return zf_step_view_<zf_list_head, I, zf_list_first>(h);
+}
+
+template <typename T, zf_stailq_node T:: *node>
+auto zf_stailq_safe_(zf_stailq_head_<T, node> *const h) noexcept
+{
+	typedef zf_step_iterator_<T, zf_stailq_node, node, zf_stailq_next, true> I;
+	return zf_step_view_<zf_stailq_head, I, zf_stailq_first>(h);
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+auto zf_tailq_safe_(zf_tailq_head_<T, node, Link> *const h) noexcept
+{
+	typedef zf_step_iterator_<T, zf_tailq_node, node, zf_tailq_next, true> I;
+	return zf_step_view_<zf_tailq_head, I, zf_tailq_first>(h);
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+auto zf_tailq_reverse_(zf_tailq_head_<T, node, Link> *const h) noexcept
+{
+	typedef zf_step_iterator_<T, zf_tailq_node, node, zf_tailq_prev, false> I;
+	return zf_step_view_<zf_tailq_head, I, zf_tailq_last>(h);
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+auto zf_tailq_safe_reverse_(zf_tailq_head_<T, node, Link> *const h) noexcept
+{
+	typedef zf_step_iterator_<T, zf_tailq_node, node, zf_tailq_prev, true> I;
+	return zf_step_view_<zf_tailq_head, I, zf_tailq_last>(h);
+}
+
+#endif // __cplusplus
+
+#endif // _ZF_RANGES_H_
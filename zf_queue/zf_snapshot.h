@@ -0,0 +1,359 @@
+#pragma once
+
+#ifndef _ZF_SNAPSHOT_H_
+#define _ZF_SNAPSHOT_H_
+
+/* Snapshot captures order of list entries into contiguous array of entry
+ * pointers, so repeated scans of a list that rarely changes become sequential
+ * array walks instead of chasing next pointers through cold memory.
+ * Optionally fixed size "hot" key (key_size bytes at key_offset inside each
+ * entry) is copied into another contiguous array, so scans that only look at
+ * the key don't touch entries at all.
+ *
+ * Snapshot doesn't know when list changes. Owner of the list keeps generation
+ * counter (uint64_t) and increments it on each modification of the list.
+ * Snapshot remembers value of the counter when it was taken and becomes stale
+ * when counter changes (see zf_snapshot_stale()). List functions don't touch
+ * the counter: with C API staleness detection is entirely up to the caller,
+ * modification without increment leaves snapshot looking fresh. In C++
+ * zf_snapshot_source_<Head> owns both the head and the counter and gives
+ * access to the head only through modify(), which increments the counter.
+ *
+ * Functions zf_snapshot_xxx(s, h, node_offset) take snapshot of the list h,
+ * where node_offset is offset of the node inside the entry (as offsetof()
+ * returns). They return number of entries in the list. When it is greater than
+ * capacity, only first capacity entries are captured and snapshot is stale.
+ *
+ * Snapshot doesn't allocate memory, all buffers are provided by the caller.
+ */
+
+#include <string.h>
+#include "zf_queue.h"
+
+typedef struct zf_snapshot
+{
+	/* caller provided array of capacity entry pointers */
+	void **entries;
+	/* caller provided array of capacity * key_size bytes or 0 */
+	void *keys;
+	size_t capacity;
+	size_t count;
+	size_t key_offset;
+	size_t key_size;
+	/* list generation counter and its value when snapshot was taken */
+	const uint64_t *source;
+	uint64_t generation;
+	bool complete;
+}
+zf_snapshot;
+
+_ZF_QUEUE_DECL
+void zf_snapshot_init(struct zf_snapshot *const s,
+					  void **const entries, const size_t capacity,
+					  const uint64_t *const source)
+	_ZF_QUEUE_NOEXCEPT
+{
+	s->entries = entries;
+	s->keys = 0;
+	s->capacity = capacity;
+	s->count = 0;
+	s->key_offset = 0;
+	s->key_size = 0;
+	s->source = source;
+	s->generation = *source;
+	s->complete = false;
+}
+
+/* also copy key_size bytes at key_offset of each entry into keys */
+_ZF_QUEUE_DECL
+void zf_snapshot_set_keys(struct zf_snapshot *const s, void *const keys,
+						  const size_t key_offset, const size_t key_size)
+	_ZF_QUEUE_NOEXCEPT
+{
+	s->keys = keys;
+	s->key_offset = key_offset;
+	s->key_size = key_size;
+	s->complete = false;
+}
+
+_ZF_QUEUE_DECL
+bool zf_snapshot_stale(const struct zf_snapshot *const s)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return !s->complete || *s->source != s->generation;
+}
+
+_ZF_QUEUE_DECL
+size_t zf_snapshot_count(const struct zf_snapshot *const s)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return s->count;
+}
+
+_ZF_QUEUE_DECL
+void *zf_snapshot_entry(const struct zf_snapshot *const s, const size_t i)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return s->entries[i];
+}
+
+_ZF_QUEUE_DECL
+void *zf_snapshot_key(const struct zf_snapshot *const s, const size_t i)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return (char *)s->keys + i * s->key_size;
+}
+
+_ZF_QUEUE_DECL
+void _zf_snapshot_begin(struct zf_snapshot *const s)
+	_ZF_QUEUE_NOEXCEPT
+{
+	s->count = 0;
+	s->generation = *s->source;
+}
+
+/* add entry that has node n, returns total number of seen entries */
+_ZF_QUEUE_DECL
+size_t _zf_snapshot_add(struct zf_snapshot *const s, const size_t total,
+						void *const n, const size_t node_offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (s->capacity > total)
+	{
+		char *const e = (char *)n - node_offset;
+		s->entries[total] = e;
+		if (0 != s->keys)
+		{
+			memcpy(zf_snapshot_key(s, total), e + s->key_offset, s->key_size);
+		}
+		s->count = total + 1;
+	}
+	return total + 1;
+}
+
+_ZF_QUEUE_DECL
+size_t _zf_snapshot_end(struct zf_snapshot *const s, const size_t total)
+	_ZF_QUEUE_NOEXCEPT
+{
+	s->complete = s->count == total;
+	return total;
+}
+
+_ZF_QUEUE_DECL
+size_t zf_snapshot_slist(struct zf_snapshot *const s,
+						 struct zf_slist_head *const h,
+						 const size_t node_offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t total = 0;
+	_zf_snapshot_begin(s);
+	for (struct zf_slist_node *n = h->first; 0 != n; n = n->next)
+	{
+		total = _zf_snapshot_add(s, total, n, node_offset);
+	}
+	return _zf_snapshot_end(s, total);
+}
+
+_ZF_QUEUE_DECL
+size_t zf_snapshot_list(struct zf_snapshot *const s,
+						struct zf_list_head *const h,
+						const size_t node_offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t total = 0;
+	_zf_snapshot_begin(s);
+	for (struct zf_list_node *n = h->first; 0 != n; n = n->next)
+	{
+		total = _zf_snapshot_add(s, total, n, node_offset);
+	}
+	return _zf_snapshot_end(s, total);
+}
+
+_ZF_QUEUE_DECL
+size_t zf_snapshot_stailq(struct zf_snapshot *const s,
+						  struct zf_stailq_head *const h,
+						  const size_t node_offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t total = 0;
+	_zf_snapshot_begin(s);
+	for (struct zf_stailq_node *n = h->first.next; 0 != n; n = n->next)
+	{
+		total = _zf_snapshot_add(s, total, n, node_offset);
+	}
+	return _zf_snapshot_end(s, total);
+}
+
+_ZF_QUEUE_DECL
+size_t zf_snapshot_tailq(struct zf_snapshot *const s,
+						 struct zf_tailq_head *const h,
+						 const size_t node_offset)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t total = 0;
+	_zf_snapshot_begin(s);
+	zf_tailq_foreach(h, n)
+	{
+		total = _zf_snapshot_add(s, total, n, node_offset);
+	}
+	return _zf_snapshot_end(s, total);
+}
+
+/* C++ support */
+#ifdef __cplusplus
+
+template <typename T, typename Node>
+size_t _zf_snapshot_offset_(Node T:: *const node)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return _zf_member_offset(node);
+}
+
+template <typename T, zf_slist_node T:: *node>
+size_t zf_snapshot_slist_(zf_snapshot *const s,
+						  zf_slist_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_snapshot_slist(s, h, _zf_snapshot_offset_(node));
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+size_t zf_snapshot_list_(zf_snapshot *const s,
+						 zf_list_head_<T, node, Link> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_snapshot_list(s, h, _zf_snapshot_offset_(node));
+}
+
+template <typename T, zf_stailq_node T:: *node>
+size_t zf_snapshot_stailq_(zf_snapshot *const s,
+						   zf_stailq_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_snapshot_stailq(s, h, _zf_snapshot_offset_(node));
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+size_t zf_snapshot_tailq_(zf_snapshot *const s,
+						  zf_tailq_head_<T, node, Link> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_snapshot_tailq(s, h, _zf_snapshot_offset_(node));
+}
+
+/* zf_snapshot_take_() picks zf_snapshot_xxx_() by type of the head */
+template <typename T, zf_slist_node T:: *node>
+size_t zf_snapshot_take_(zf_snapshot *const s, zf_slist_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_snapshot_slist_(s, h);
+}
+
+template <typename T, zf_list_node T:: *node, typename Link>
+size_t zf_snapshot_take_(zf_snapshot *const s,
+						 zf_list_head_<T, node, Link> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_snapshot_list_(s, h);
+}
+
+template <typename T, zf_stailq_node T:: *node>
+size_t zf_snapshot_take_(zf_snapshot *const s,
+						 zf_stailq_head_<T, node> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_snapshot_stailq_(s, h);
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link>
+size_t zf_snapshot_take_(zf_snapshot *const s,
+						 zf_tailq_head_<T, node, Link> *const h)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return zf_snapshot_tailq_(s, h);
+}
+
+inline void _zf_snapshot_head_init(zf_slist_head *const h) _ZF_QUEUE_NOEXCEPT
+{
+	zf_slist_init(h);
+}
+
+inline void _zf_snapshot_head_init(zf_list_head *const h) _ZF_QUEUE_NOEXCEPT
+{
+	zf_list_init(h);
+}
+
+inline void _zf_snapshot_head_init(zf_stailq_head *const h) _ZF_QUEUE_NOEXCEPT
+{
+	zf_stailq_init(h);
+}
+
+inline void _zf_snapshot_head_init(zf_tailq_head *const h) _ZF_QUEUE_NOEXCEPT
+{
+	zf_tailq_init(h);
+}
+
+/* List head (zf_xxx_head_<T, node>) together with its generation counter.
+ * modify(f) increments the counter and calls f(head), so list can't be
+ * changed without making snapshots stale. read(f) calls f(head) without
+ * increment, f must not modify the list.
+ */
+template <typename Head>
+class zf_snapshot_source_
+{
+public:
+	zf_snapshot_source_() _ZF_QUEUE_NOEXCEPT: generation(0)
+	{
+		_zf_snapshot_head_init(&head);
+	}
+
+	const uint64_t *counter() const _ZF_QUEUE_NOEXCEPT
+	{
+		return &generation;
+	}
+	void init(zf_snapshot *const s, void **const entries,
+			  const size_t capacity) const _ZF_QUEUE_NOEXCEPT
+	{
+		zf_snapshot_init(s, entries, capacity, &generation);
+	}
+	/* returns number of entries in the list */
+	size_t take(zf_snapshot *const s) _ZF_QUEUE_NOEXCEPT
+	{
+		return zf_snapshot_take_(s, &head);
+	}
+	template <typename F>
+	void modify(F f)
+	{
+		++generation;
+		f(&head);
+	}
+	template <typename F>
+	void read(F f)
+	{
+		f(&head);
+	}
+private:
+	zf_snapshot_source_(const zf_snapshot_source_ &);
+	zf_snapshot_source_ &operator=(const zf_snapshot_source_ &);
+
+	Head head;
+	uint64_t generation;
+};
+
+template <typename T>
+T *zf_snapshot_entry_(const zf_snapshot *const s, const size_t i)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return (T *)zf_snapshot_entry(s, i);
+}
+
+template <typename K>
+const K *zf_snapshot_key_(const zf_snapshot *const s, const size_t i)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return (const K *)zf_snapshot_key(s, i);
+}
+
+#endif // __cplusplus
+
+#endif // _ZF_SNAPSHOT_H_
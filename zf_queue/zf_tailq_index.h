@@ -0,0 +1,368 @@
+#pragma once
+
+#ifndef _ZF_TAILQ_INDEX_H_
+#define _ZF_TAILQ_INDEX_H_
+
+/* Skip index for tail queues. Index keeps every stride-th node of the tail
+ * queue (marks) in caller provided array, so the queue could be split into
+ * count + 1 disjoint segments without walking it:
+ *   segment 0 = [first node, marks[0])
+ *   segment i = [marks[i - 1], marks[i]), last segment ends at the tail.
+ * Segments could be processed in parallel (see zf_tailq_index_for_each_()).
+ *
+ * Function zf_tailq_index_build() walks the queue once and picks stride so
+ * that marks fit into capacity. After that:
+ *  - zf_tailq_insert_yyy() do not affect index: new nodes just become part of
+ *    the segment they were inserted into (segments become uneven, but remain
+ *    disjoint and cover the whole queue).
+ *  - nodes should be removed with zf_tailq_index_remove(), which moves the
+ *    mark to the next node when removed node is a mark. Marks are looked up
+ *    by address in the second caller provided array (order), so removal of
+ *    a node that is not a mark is O(log(number of marks)).
+ *  - any other modification (plain zf_tailq_remove(), splice, sort, moving
+ *    nodes to other queues) must increment modification counter of the
+ *    queue (uint64_t owned by the caller and passed to
+ *    zf_tailq_index_init(), as in zf_snapshot.h) or be followed by
+ *    zf_tailq_index_invalidate(). zf_tailq_index_check() compares the counter
+ *    with its value when index was built, stale index is rebuilt lazily.
+ *    Counter is the only reliable detection: mark that was removed and
+ *    inserted again looks linked. As a cheap extra, check also catches marks
+ *    that are no longer linked (their previous node doesn't point back), if
+ *    removed marks are not freed until the check.
+ * Generation is incremented on each change of the index, so concurrent users
+ * could detect that segments they got are no longer valid.
+ *
+ * Index doesn't allocate memory. C++11 zf_tailq_index_for_each_() hands
+ * segments to an executor, for example zf_thread_pool_ (zf_thread_pool.h).
+ */
+
+#include "zf_queue.h"
+
+typedef struct zf_tailq_index
+{
+	struct zf_tailq_head *h;
+	/* caller provided arrays of capacity elements: marks in queue order and
+	 * positions of marks in marks array sorted by mark address */
+	struct zf_tailq_node **marks;
+	size_t *order;
+	size_t capacity;
+	/* number of valid marks */
+	size_t count;
+	/* number of nodes between marks when index was built */
+	size_t stride;
+	uint64_t generation;
+	/* modification counter of the queue and its value when index was built */
+	const uint64_t *source;
+	uint64_t source_generation;
+	bool stale;
+}
+zf_tailq_index;
+
+_ZF_QUEUE_DECL
+void zf_tailq_index_init(struct zf_tailq_index *const ix,
+						 struct zf_tailq_head *const h,
+						 struct zf_tailq_node **const marks,
+						 size_t *const order,
+						 const size_t capacity,
+						 const uint64_t *const source)
+	_ZF_QUEUE_NOEXCEPT
+{
+	ix->h = h;
+	ix->marks = marks;
+	ix->order = order;
+	ix->capacity = capacity;
+	ix->count = 0;
+	ix->stride = 0;
+	ix->generation = 0;
+	ix->source = source;
+	ix->source_generation = *source;
+	ix->stale = true;
+}
+
+_ZF_QUEUE_DECL
+bool zf_tailq_index_stale(const struct zf_tailq_index *const ix)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return ix->stale;
+}
+
+_ZF_QUEUE_DECL
+void zf_tailq_index_invalidate(struct zf_tailq_index *const ix)
+	_ZF_QUEUE_NOEXCEPT
+{
+	ix->stale = true;
+	++ix->generation;
+}
+
+/* returns false and invalidates index when it is stale, modification counter
+ * of the queue changed or any mark is no longer linked */
+_ZF_QUEUE_DECL
+bool zf_tailq_index_check(struct zf_tailq_index *const ix)
+	_ZF_QUEUE_NOEXCEPT
+{
+	if (ix->stale)
+	{
+		return false;
+	}
+	if (*ix->source != ix->source_generation)
+	{
+		zf_tailq_index_invalidate(ix);
+		return false;
+	}
+	for (size_t i = 0; ix->count > i; ++i)
+	{
+		const struct zf_tailq_node *const m = ix->marks[i];
+		if (m != m->prev->next)
+		{
+			zf_tailq_index_invalidate(ix);
+			return false;
+		}
+	}
+	return true;
+}
+
+_ZF_QUEUE_DECL
+size_t zf_tailq_index_segments(const struct zf_tailq_index *const ix)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return ix->count + 1;
+}
+
+/* position in order array of the first mark with address not less than n */
+_ZF_QUEUE_DECL
+size_t _zf_tailq_index_find(const struct zf_tailq_index *const ix,
+							const struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t lo = 0, hi = ix->count;
+	while (lo < hi)
+	{
+		const size_t mid = lo + (hi - lo) / 2;
+		if ((uintptr_t)ix->marks[ix->order[mid]] < (uintptr_t)n)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/* adds mark i to order array that has count - 1 elements */
+_ZF_QUEUE_DECL
+void _zf_tailq_index_order_insert(struct zf_tailq_index *const ix,
+								  const size_t i)
+	_ZF_QUEUE_NOEXCEPT
+{
+	const size_t last = ix->count - 1;
+	--ix->count;
+	const size_t k = _zf_tailq_index_find(ix, ix->marks[i]);
+	++ix->count;
+	for (size_t j = last; k < j; --j)
+	{
+		ix->order[j] = ix->order[j - 1];
+	}
+	ix->order[k] = i;
+}
+
+_ZF_QUEUE_DECL
+void _zf_tailq_index_order_remove(struct zf_tailq_index *const ix,
+								  const size_t k)
+	_ZF_QUEUE_NOEXCEPT
+{
+	for (size_t j = k; ix->count > j + 1; ++j)
+	{
+		ix->order[j] = ix->order[j + 1];
+	}
+}
+
+/* sift order[k] down in max-heap of n elements keyed by mark address */
+_ZF_QUEUE_DECL
+void _zf_tailq_index_order_sift(struct zf_tailq_index *const ix, size_t k,
+								const size_t n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	const size_t v = ix->order[k];
+	for (size_t c; n > (c = 2 * k + 1); k = c)
+	{
+		if (n > c + 1 && (uintptr_t)ix->marks[ix->order[c]] <
+						 (uintptr_t)ix->marks[ix->order[c + 1]])
+		{
+			++c;
+		}
+		if ((uintptr_t)ix->marks[ix->order[c]] <= (uintptr_t)ix->marks[v])
+		{
+			break;
+		}
+		ix->order[k] = ix->order[c];
+	}
+	ix->order[k] = v;
+}
+
+/* fills order array for all marks, heap sort is O(count * log(count)) */
+_ZF_QUEUE_DECL
+void _zf_tailq_index_order_build(struct zf_tailq_index *const ix)
+	_ZF_QUEUE_NOEXCEPT
+{
+	const size_t n = ix->count;
+	for (size_t i = 0; n > i; ++i)
+	{
+		ix->order[i] = i;
+	}
+	for (size_t i = n / 2; 0 < i--;)
+	{
+		_zf_tailq_index_order_sift(ix, i, n);
+	}
+	for (size_t i = n; 1 < i--;)
+	{
+		const size_t t = ix->order[0];
+		ix->order[0] = ix->order[i];
+		ix->order[i] = t;
+		_zf_tailq_index_order_sift(ix, 0, i);
+	}
+}
+
+/* returns number of segments */
+_ZF_QUEUE_DECL
+size_t zf_tailq_index_build(struct zf_tailq_index *const ix)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t total = 0;
+	zf_tailq_foreach(ix->h, n)
+	{
+		++total;
+	}
+	const size_t segments = ix->capacity + 1;
+	const size_t stride = total > segments?
+				(total + segments - 1) / segments: 1;
+	size_t count = 0, i = 0;
+	zf_tailq_foreach(ix->h, n)
+	{
+		if (0 != i && 0 == i % stride && ix->capacity > count)
+		{
+			ix->marks[count++] = n;
+		}
+		++i;
+	}
+	ix->count = count;
+	_zf_tailq_index_order_build(ix);
+	ix->stride = stride;
+	ix->source_generation = *ix->source;
+	ix->stale = false;
+	++ix->generation;
+	return zf_tailq_index_segments(ix);
+}
+
+/* first node of segment i */
+_ZF_QUEUE_DECL
+struct zf_tailq_node *zf_tailq_index_begin(const struct zf_tailq_index *const ix,
+										   const size_t i)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return 0 == i? ix->h->head.next: ix->marks[i - 1];
+}
+
+/* node after the last node of segment i */
+_ZF_QUEUE_DECL
+struct zf_tailq_node *zf_tailq_index_end(const struct zf_tailq_index *const ix,
+										 const size_t i)
+	_ZF_QUEUE_NOEXCEPT
+{
+	return ix->count > i? ix->marks[i]: 0;
+}
+
+/* remove n from the queue and keep index valid */
+_ZF_QUEUE_DECL
+void zf_tailq_index_remove(struct zf_tailq_index *const ix,
+						   struct zf_tailq_node *const n)
+	_ZF_QUEUE_NOEXCEPT
+{
+	size_t k;
+	if (!ix->stale && ix->count > (k = _zf_tailq_index_find(ix, n)) &&
+		n == ix->marks[ix->order[k]])
+	{
+		const size_t i = ix->order[k];
+		_zf_tailq_index_order_remove(ix, k);
+		if (0 != n->next && zf_tailq_index_end(ix, i + 1) != n->next)
+		{
+			ix->marks[i] = n->next;
+			_zf_tailq_index_order_insert(ix, i);
+		}
+		else
+		{
+			/* segment becomes empty */
+			--ix->count;
+			for (size_t j = i; ix->count > j; ++j)
+			{
+				ix->marks[j] = ix->marks[j + 1];
+			}
+			for (size_t j = 0; ix->count > j; ++j)
+			{
+				if (i < ix->order[j])
+				{
+					--ix->order[j];
+				}
+			}
+		}
+		++ix->generation;
+	}
+	zf_tailq_remove(ix->h, n);
+}
+
+/* C++ support */
+#if defined(__cplusplus) && __cplusplus >= 201103L
+
+/* Executor that runs all parts in the calling thread. */
+struct zf_tailq_index_serial_
+{
+	template <typename G>
+	void parallel_for(const size_t n, G g)
+	{
+		for (size_t i = 0; n > i; ++i)
+		{
+			g(i);
+		}
+	}
+};
+
+/* Calls f(e) for each entry of h. Each segment is one part handed to
+ * executor.parallel_for(n, g), which must call g(i) for each i in [0, n)
+ * (possibly in parallel) and return when all calls are done. Index ix must
+ * be built for h, it is checked and rebuilt when stale. Queue must not be
+ * modified during the call.
+ */
+template <typename T, zf_tailq_node T:: *node, typename Link, typename F,
+		  typename E>
+void zf_tailq_index_for_each_(zf_tailq_index *const ix,
+							  zf_tailq_head_<T, node, Link> *const h, F f,
+							  E &executor)
+{
+	if (!zf_tailq_index_check(ix))
+	{
+		zf_tailq_index_build(ix);
+	}
+	executor.parallel_for(zf_tailq_index_segments(ix), [ix, h, &f](const size_t i)
+	{
+		/* also stops at the tail if index missed a modification */
+		zf_tailq_node *const end = zf_tailq_index_end(ix, i);
+		for (zf_tailq_node *n = zf_tailq_index_begin(ix, i);
+			 end != n && 0 != n; n = n->next)
+		{
+			f(zf_tailq_entry_(h, n));
+		}
+	});
+}
+
+template <typename T, zf_tailq_node T:: *node, typename Link, typename F>
+void zf_tailq_index_for_each_(zf_tailq_index *const ix,
+							  zf_tailq_head_<T, node, Link> *const h, F f)
+{
+	zf_tailq_index_serial_ executor;
+	zf_tailq_index_for_each_(ix, h, f, executor);
+}
+
+#endif // __cplusplus
+
+#endif // _ZF_TAILQ_INDEX_H_
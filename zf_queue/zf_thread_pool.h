@@ -0,0 +1,442 @@
+#pragma once
+
+#ifndef _ZF_THREAD_POOL_H_
+#define _ZF_THREAD_POOL_H_
+
+/* Thread pool that runs intrusive tasks. Task is zf_task_ embedded into the
+ * user object, it has zf_stailq_node and pointer to function that runs it:
+ *
+ *   struct job { zf_task_ task; int arg; };
+ *   static void run_job(zf_task_ *const t)
+ *   {
+ *       job *const j = zf_entry_(t, &job::task);
+ *       ...
+ *   }
+ *   j->task.run = run_job;
+ *   pool.submit(&j->task);
+ *
+ * Pool never allocates memory after construction: tasks are linked into the
+ * queues through their own nodes. Task object must stay alive until its run()
+ * is called, run() could free or resubmit it. parallel_for() is the only
+ * exception, it allocates helper tasks for the call.
+ *
+ * Each worker has local queue. Tasks submitted from the worker thread go to
+ * its local queue until it holds ZF_THREAD_POOL_LOCAL_MAX tasks, the rest (and
+ * everything submitted from other threads) goes to the shared overflow queue.
+ * Worker runs tasks from its local queue first, then moves a batch (its fair
+ * share, but no more than ZF_THREAD_POOL_BATCH) from the shared queue into the
+ * local one, then steals from local queues of other workers and only then
+ * sleeps.
+ *
+ * Wakeups are batched: pool counts sleeping workers and wakeups that are
+ * already in flight, so it doesn't notify when there is nobody to wake or
+ * when enough workers are already waking up. submit_all() links prelinked
+ * list of tasks into the shared queue at once and wakes at most one worker
+ * per task. Worker that takes a batch and leaves more tasks behind wakes the
+ * next one.
+ *
+ * Destructor waits until all submitted tasks (including those submitted by
+ * tasks) are done. Tasks must not be submitted from other threads once
+ * destruction started.
+ */
+
+#include "zf_queue.h"
+#include "zf_parking_lot.h"
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef ZF_THREAD_POOL_LOCAL_MAX
+	#define ZF_THREAD_POOL_LOCAL_MAX 256
+#endif
+#ifndef ZF_THREAD_POOL_BATCH
+	#define ZF_THREAD_POOL_BATCH 32
+#endif
+
+struct zf_task_
+{
+	zf_stailq_node node;
+	void (*run)(zf_task_ *);
+};
+
+typedef zf_stailq_head_<zf_task_, &zf_task_::node> zf_task_list_;
+
+class zf_thread_pool_;
+
+struct _zf_thread_pool_worker
+{
+	zf_mutex_ lock;
+	zf_stailq_head tasks;
+	size_t count;
+	zf_thread_pool_ *pool;
+	/* keeps locks of neighbour workers in different cache lines */
+	char pad[64];
+};
+
+/* worker of the current thread, 0 when thread is not a worker */
+inline _zf_thread_pool_worker *&_zf_thread_pool_current()
+{
+	static thread_local _zf_thread_pool_worker *w = 0;
+	return w;
+}
+
+class zf_thread_pool_
+{
+public:
+	/* 0 threads means std::thread::hardware_concurrency() */
+	explicit zf_thread_pool_(unsigned count = 0):
+		shared_count(0), sleeping(0), pending(0), stopping(false)
+	{
+		if (0 == count && 0 == (count = std::thread::hardware_concurrency()))
+		{
+			count = 1;
+		}
+		zf_stailq_init(&shared);
+		workers_count = count;
+		workers.reset(new _zf_thread_pool_worker[count]);
+		for (unsigned i = 0; count > i; ++i)
+		{
+			zf_stailq_init(&workers[i].tasks);
+			workers[i].count = 0;
+			workers[i].pool = this;
+		}
+		threads.reserve(count);
+		for (unsigned i = 0; count > i; ++i)
+		{
+			threads.emplace_back(&zf_thread_pool_::work, this, &workers[i]);
+		}
+	}
+	zf_thread_pool_(const zf_thread_pool_ &) = delete;
+	zf_thread_pool_ &operator=(const zf_thread_pool_ &) = delete;
+	~zf_thread_pool_()
+	{
+		lock.lock();
+		stopping = true;
+		lock.unlock();
+		wakeup.notify_all();
+		for (std::thread &t: threads)
+		{
+			t.join();
+		}
+	}
+
+	unsigned size() const noexcept
+	{
+		return workers_count;
+	}
+	void submit(zf_task_ *const t) noexcept
+	{
+		_zf_thread_pool_worker *const w = _zf_thread_pool_current();
+		if (0 != w && this == w->pool)
+		{
+			w->lock.lock();
+			if (ZF_THREAD_POOL_LOCAL_MAX > w->count)
+			{
+				zf_stailq_insert_tail(&w->tasks, &t->node);
+				++w->count;
+				w->lock.unlock();
+				/* idle workers will steal it */
+				if (sleeping.load(std::memory_order_relaxed) >
+					pending.load(std::memory_order_relaxed))
+				{
+					lock.lock();
+					const unsigned k = wake(1);
+					lock.unlock();
+					notify(k);
+				}
+				return;
+			}
+			w->lock.unlock();
+		}
+		lock.lock();
+		zf_stailq_insert_tail(&shared, &t->node);
+		++shared_count;
+		const unsigned k = wake(1);
+		lock.unlock();
+		notify(k);
+	}
+	/* moves all tasks from h to the shared queue, h becomes empty */
+	void submit_all(zf_task_list_ *const h) noexcept
+	{
+		size_t n = 0;
+		for (zf_stailq_node *i = zf_stailq_first(h); 0 != i; i = i->next)
+		{
+			++n;
+		}
+		lock.lock();
+		zf_stailq_concat(&shared, h);
+		shared_count += n;
+		const unsigned k = wake(n);
+		lock.unlock();
+		notify(k);
+	}
+	/* Calls g(i) for each i in [0, n) on the workers and on the calling
+	 * thread, returns when all calls are done. Indices are taken one at a
+	 * time, so uneven parts are balanced. When called from a task, calling
+	 * worker runs other tasks while it waits for the helpers.
+	 */
+	template <typename G>
+	void parallel_for(const size_t n, G g)
+	{
+		struct state
+		{
+			std::atomic<size_t> next;
+			size_t n;
+			G *g;
+			zf_mutex_ lock;
+			zf_condvar_ done;
+			unsigned running;
+		};
+		struct helper
+		{
+			zf_task_ task;
+			state *s;
+			static void run(zf_task_ *const t)
+			{
+				state *const s = zf_entry_(t, &helper::task)->s;
+				for (size_t i; s->n > (i = s->next.fetch_add(1));)
+				{
+					(*s->g)(i);
+				}
+				s->lock.lock();
+				if (0 == --s->running)
+				{
+					/* under lock, so state is alive until unlock */
+					s->done.notify_all();
+				}
+				s->lock.unlock();
+			}
+		};
+		if (0 == n)
+		{
+			return;
+		}
+		const size_t k = n - 1 < workers_count? n - 1: workers_count;
+		state s;
+		s.next.store(0, std::memory_order_relaxed);
+		s.n = n;
+		s.g = &g;
+		s.running = (unsigned)k;
+		std::unique_ptr<helper[]> helpers(new helper[k]);
+		for (size_t i = 0; k > i; ++i)
+		{
+			helpers[i].task.run = helper::run;
+			helpers[i].s = &s;
+			submit(&helpers[i].task);
+		}
+		for (size_t i; n > (i = s.next.fetch_add(1));)
+		{
+			g(i);
+		}
+		_zf_thread_pool_worker *const w = _zf_thread_pool_current();
+		if (0 != w && this == w->pool)
+		{
+			/* helpers could wait in queues behind this worker */
+			for (;;)
+			{
+				s.lock.lock();
+				const unsigned running = s.running;
+				s.lock.unlock();
+				if (0 == running)
+				{
+					break;
+				}
+				zf_task_ *const t = find(w);
+				if (0 != t)
+				{
+					t->run(t);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+			return;
+		}
+		std::unique_lock<zf_mutex_> l(s.lock);
+		s.done.wait(l, [&s]() { return 0 == s.running; });
+	}
+private:
+	/* Must be called with lock locked, returns number of workers to notify
+	 * (after lock is unlocked, so they don't block on it right away).
+	 */
+	unsigned wake(const size_t n) noexcept
+	{
+		const unsigned s = sleeping.load(std::memory_order_relaxed);
+		const unsigned p = pending.load(std::memory_order_relaxed);
+		if (s <= p || 0 == n)
+		{
+			return 0;
+		}
+		const unsigned k = s - p <= n? s - p: (unsigned)n;
+		pending.store(p + k, std::memory_order_relaxed);
+		return k;
+	}
+	void notify(unsigned k) noexcept
+	{
+		if (0 == k)
+		{
+			return;
+		}
+		if (k == sleeping.load(std::memory_order_relaxed))
+		{
+			wakeup.notify_all();
+			return;
+		}
+		unsigned missed = 0;
+		while (0 != k--)
+		{
+			if (!wakeup.notify_one())
+			{
+				++missed;
+			}
+		}
+		if (0 != missed)
+		{
+			/* nobody was parked, so nobody will take these wakeups back */
+			lock.lock();
+			const unsigned p = pending.load(std::memory_order_relaxed);
+			pending.store(missed < p? p - missed: 0, std::memory_order_relaxed);
+			lock.unlock();
+		}
+	}
+	zf_task_ *pop(_zf_thread_pool_worker *const w) noexcept
+	{
+		zf_stailq_node *const n = zf_stailq_first(&w->tasks);
+		if (0 == n)
+		{
+			return 0;
+		}
+		zf_stailq_remove_head(&w->tasks);
+		--w->count;
+		return zf_entry_(n, &zf_task_::node);
+	}
+	zf_task_ *pop_local(_zf_thread_pool_worker *const w) noexcept
+	{
+		w->lock.lock();
+		zf_task_ *const t = pop(w);
+		w->lock.unlock();
+		return t;
+	}
+	zf_task_ *take_shared(_zf_thread_pool_worker *const w) noexcept
+	{
+		lock.lock();
+		zf_stailq_node *const f = zf_stailq_first(&shared);
+		if (0 == f)
+		{
+			lock.unlock();
+			return 0;
+		}
+		size_t k = (shared_count + workers_count - 1) / workers_count;
+		if (ZF_THREAD_POOL_BATCH < k)
+		{
+			k = ZF_THREAD_POOL_BATCH;
+		}
+		zf_stailq_node *l = f;
+		size_t taken = 1;
+		for (; k > taken && 0 != l->next; ++taken)
+		{
+			l = l->next;
+		}
+		zf_stailq_head batch;
+		zf_stailq_init(&batch);
+		zf_stailq_splice_tail(&batch, &shared, 0, l);
+		shared_count -= taken;
+		const unsigned woken = 0 != shared_count? wake(1): 0;
+		lock.unlock();
+		notify(woken);
+		zf_stailq_remove_head(&batch);
+		if (1 < taken)
+		{
+			w->lock.lock();
+			zf_stailq_concat(&w->tasks, &batch);
+			w->count += taken - 1;
+			w->lock.unlock();
+		}
+		return zf_entry_(f, &zf_task_::node);
+	}
+	zf_task_ *steal(_zf_thread_pool_worker *const w) noexcept
+	{
+		const size_t self = (size_t)(w - workers.get());
+		for (size_t i = 1; workers_count > i; ++i)
+		{
+			_zf_thread_pool_worker *const v =
+					&workers[(self + i) % workers_count];
+			if (!v->lock.try_lock())
+			{
+				continue;
+			}
+			zf_task_ *const t = pop(v);
+			v->lock.unlock();
+			if (0 != t)
+			{
+				return t;
+			}
+		}
+		return 0;
+	}
+	zf_task_ *find(_zf_thread_pool_worker *const w) noexcept
+	{
+		zf_task_ *t = pop_local(w);
+		if (0 == t && 0 == (t = take_shared(w)))
+		{
+			t = steal(w);
+		}
+		return t;
+	}
+	void work(_zf_thread_pool_worker *const w) noexcept
+	{
+		_zf_thread_pool_current() = w;
+		for (;;)
+		{
+			zf_task_ *const t = find(w);
+			if (0 != t)
+			{
+				t->run(t);
+				continue;
+			}
+			lock.lock();
+			if (zf_stailq_empty(&shared))
+			{
+				if (stopping)
+				{
+					lock.unlock();
+					break;
+				}
+				sleeping.store(sleeping.load(std::memory_order_relaxed) + 1,
+							   std::memory_order_relaxed);
+				wakeup.wait(lock);
+				sleeping.store(sleeping.load(std::memory_order_relaxed) - 1,
+							   std::memory_order_relaxed);
+				const unsigned p = pending.load(std::memory_order_relaxed);
+				if (0 != p)
+				{
+					pending.store(p - 1, std::memory_order_relaxed);
+				}
+			}
+			lock.unlock();
+		}
+		_zf_thread_pool_current() = 0;
+	}
+
+	zf_mutex_ lock;
+	zf_condvar_ wakeup;
+	zf_stailq_head shared;
+	size_t shared_count;
+	/* modified under lock, read without it to skip needless locking */
+	std::atomic<unsigned> sleeping;
+	std::atomic<unsigned> pending;
+	bool stopping;
+	unsigned workers_count;
+	std::unique_ptr<_zf_thread_pool_worker[]> workers;
+	std::vector<std::thread> threads;
+};
+
+#endif // __cplusplus
+
+#endif // _ZF_THREAD_POOL_H_